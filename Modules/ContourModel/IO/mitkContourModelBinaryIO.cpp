@@ -0,0 +1,229 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkContourModelBinaryIO.h"
+
+#include <mitkCustomMimeType.h>
+
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+  const char MAGIC[8] = {'M', 'I', 'T', 'K', 'B', 'C', 'N', 'T'};
+  const uint32_t VERSION = 1;
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  template <typename T>
+  void WriteValue(std::ostream &stream, const T &value)
+  {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  void WriteArray(std::ostream &stream, const std::vector<T> &values)
+  {
+    if (!values.empty())
+      stream.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+  }
+
+  template <typename T>
+  T ReadValue(std::istream &stream)
+  {
+    T value;
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!stream)
+      mitkThrow() << "Unexpected end of binary contour file.";
+    return value;
+  }
+
+  template <typename T>
+  void ReadArray(std::istream &stream, std::vector<T> &values, std::size_t size)
+  {
+    values.resize(size);
+    if (size == 0)
+      return;
+
+    stream.read(reinterpret_cast<char *>(values.data()), size * sizeof(T));
+    if (!stream)
+      mitkThrow() << "Unexpected end of binary contour file.";
+  }
+}
+
+mitk::ContourModelBinaryIO::ContourModelBinaryIO()
+  : AbstractFileIO(ContourModel::GetStaticNameOfClass())
+{
+  std::string category = "Binary Contour File";
+  mitk::CustomMimeType customMimeType;
+  customMimeType.SetCategory(category);
+  customMimeType.AddExtension("cntb");
+
+  this->SetMimeType(customMimeType);
+  this->SetReaderDescription(category);
+  this->SetWriterDescription(category);
+
+  this->RegisterService();
+}
+
+std::vector<itk::SmartPointer<mitk::BaseData>> mitk::ContourModelBinaryIO::Read()
+{
+  InputStream stream(this, std::ios_base::in | std::ios_base::binary);
+
+  if (!ReadHeader(stream, MAGIC))
+    mitkThrow() << "Not a MITK binary contour file.";
+
+  std::vector<itk::SmartPointer<BaseData>> result;
+  result.push_back(ReadContour(stream).GetPointer());
+  return result;
+}
+
+mitk::IFileIO::ConfidenceLevel mitk::ContourModelBinaryIO::GetReaderConfidenceLevel() const
+{
+  if (AbstractFileIO::GetReaderConfidenceLevel() == Unsupported)
+    return Unsupported;
+
+  if (this->GetInputStream() == nullptr)
+  {
+    std::ifstream file(this->GetInputLocation().c_str(), std::ios::in | std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    file.read(magic, sizeof(MAGIC));
+    return file && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0 ? Supported : Unsupported;
+  }
+
+  return Supported;
+}
+
+void mitk::ContourModelBinaryIO::Write()
+{
+  const auto *contour = dynamic_cast<const ContourModel *>(this->GetInput());
+  if (contour == nullptr)
+    mitkThrow() << "Cannot write non-contour data";
+
+  OutputStream stream(this, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+
+  WriteHeader(stream, MAGIC);
+  WriteContour(stream, contour);
+
+  if (!stream.good())
+    mitkThrow() << "Some error during contour writing.";
+}
+
+void mitk::ContourModelBinaryIO::WriteHeader(std::ostream &stream, const char *magic)
+{
+  stream.write(magic, sizeof(MAGIC));
+  WriteValue(stream, VERSION);
+  WriteValue(stream, BYTE_ORDER_MARK);
+}
+
+bool mitk::ContourModelBinaryIO::ReadHeader(std::istream &stream, const char *magic)
+{
+  char fileMagic[sizeof(MAGIC)];
+  stream.read(fileMagic, sizeof(MAGIC));
+  if (!stream || std::memcmp(fileMagic, magic, sizeof(MAGIC)) != 0)
+    return false;
+
+  if (ReadValue<uint32_t>(stream) != VERSION)
+    mitkThrow() << "Unsupported version of binary contour file.";
+
+  if (ReadValue<uint32_t>(stream) != BYTE_ORDER_MARK)
+    mitkThrow() << "Binary contour file was written with a different byte order.";
+
+  return true;
+}
+
+uint64_t mitk::ContourModelBinaryIO::GetContourSize(const ContourModel *contour)
+{
+  uint64_t size = sizeof(uint32_t);
+
+  const unsigned int numberOfTimeSteps = contour->GetTimeSteps();
+  for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+  {
+    const uint64_t numberOfVertices = contour->GetNumberOfVertices(t);
+    size += sizeof(uint8_t) + sizeof(uint32_t) + numberOfVertices * (3 * sizeof(float) + sizeof(uint8_t));
+  }
+
+  return size;
+}
+
+void mitk::ContourModelBinaryIO::WriteContour(std::ostream &stream, const ContourModel *contour)
+{
+  const unsigned int numberOfTimeSteps = contour->GetTimeSteps();
+  WriteValue(stream, static_cast<uint32_t>(numberOfTimeSteps));
+
+  std::vector<float> coordinates;
+  std::vector<uint8_t> controlPoints;
+
+  for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+  {
+    const int numberOfVertices = contour->GetNumberOfVertices(t);
+
+    coordinates.clear();
+    controlPoints.clear();
+    coordinates.reserve(3 * numberOfVertices);
+    controlPoints.reserve(numberOfVertices);
+
+    for (auto it = contour->IteratorBegin(t), end = contour->IteratorEnd(t); it != end; ++it)
+    {
+      const ContourModel::VertexType *vertex = *it;
+      coordinates.push_back(vertex->Coordinates[0]);
+      coordinates.push_back(vertex->Coordinates[1]);
+      coordinates.push_back(vertex->Coordinates[2]);
+      controlPoints.push_back(vertex->IsControlPoint);
+    }
+
+    WriteValue(stream, static_cast<uint8_t>(contour->IsClosed(t)));
+    WriteValue(stream, static_cast<uint32_t>(controlPoints.size()));
+    WriteArray(stream, coordinates);
+    WriteArray(stream, controlPoints);
+  }
+}
+
+mitk::ContourModel::Pointer mitk::ContourModelBinaryIO::ReadContour(std::istream &stream)
+{
+  ContourModel::Pointer contour = ContourModel::New();
+
+  const auto numberOfTimeSteps = ReadValue<uint32_t>(stream);
+  if (numberOfTimeSteps > 1)
+    contour->Expand(numberOfTimeSteps);
+
+  std::vector<float> coordinates;
+  std::vector<uint8_t> controlPoints;
+
+  for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+  {
+    const bool isClosed = ReadValue<uint8_t>(stream) != 0;
+    const auto numberOfVertices = ReadValue<uint32_t>(stream);
+    ReadArray(stream, coordinates, 3 * static_cast<std::size_t>(numberOfVertices));
+    ReadArray(stream, controlPoints, numberOfVertices);
+
+    for (std::size_t i = 0; i < numberOfVertices; ++i)
+    {
+      Point3D point;
+      FillVector3D(point, coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]);
+      contour->AddVertex(point, controlPoints[i] != 0, t);
+    }
+
+    contour->SetClosed(isClosed, t);
+  }
+
+  contour->UpdateOutputInformation();
+  return contour;
+}
+
+mitk::ContourModelBinaryIO *mitk::ContourModelBinaryIO::IOClone() const
+{
+  return new ContourModelBinaryIO(*this);
+}
@@ -0,0 +1,85 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_CONTOURMODEL_BINARY_IO__H_
+#define _MITK_CONTOURMODEL_BINARY_IO__H_
+
+#include <mitkAbstractFileIO.h>
+#include <mitkContourModel.h>
+
+#include <cstdint>
+
+namespace mitk
+{
+  /**
+   * @brief Binary reader and writer for mitk::ContourModels
+   *
+   * Stores every time step of a contour as a block with the closed flag, the number
+   * of vertices n, the vertex coordinates as packed float array (3n) and the control
+   * point flags (n bytes). Blocks are written and read with one stream operation per
+   * array, which makes this format much faster than the XML format for contours with
+   * many vertices.
+   *
+   * \verbatim
+   * header      magic "MITKBCNT", version, byte order mark
+   * contour     number of time steps, blocks of all time steps
+   * \endverbatim
+   *
+   * The contour encoding is shared with mitk::ContourModelSetBinaryIO.
+   *
+   * @ingroup MitkContourModelModule
+   */
+  class ContourModelBinaryIO : public mitk::AbstractFileIO
+  {
+  public:
+    ContourModelBinaryIO();
+
+    // -------------- AbstractFileReader -------------
+
+    using AbstractFileReader::Read;
+    std::vector<itk::SmartPointer<BaseData>> Read() override;
+
+    ConfidenceLevel GetReaderConfidenceLevel() const override;
+
+    // -------------- AbstractFileWriter -------------
+
+    void Write() override;
+
+    /** @brief Writes the 8 byte magic, the version and the byte order mark. */
+    static void WriteHeader(std::ostream &stream, const char *magic);
+
+    /**
+     * @brief Reads the header written by WriteHeader().
+     * @return false if the magic does not match.
+     * @throw mitk::Exception if the version or byte order does not match.
+     */
+    static bool ReadHeader(std::istream &stream, const char *magic);
+
+    /** @brief Returns the number of bytes WriteContour() will write for the given contour. */
+    static uint64_t GetContourSize(const ContourModel *contour);
+
+    /** @brief Writes all time steps of the given contour. */
+    static void WriteContour(std::ostream &stream, const ContourModel *contour);
+
+    /** @brief Reads a contour written by WriteContour(). */
+    static ContourModel::Pointer ReadContour(std::istream &stream);
+
+  private:
+    ContourModelBinaryIO *IOClone() const override;
+  };
+}
+
+#endif
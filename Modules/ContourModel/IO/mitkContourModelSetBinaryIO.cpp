@@ -0,0 +1,127 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkContourModelSetBinaryIO.h"
+#include "mitkContourModelBinaryIO.h"
+
+#include <mitkCustomMimeType.h>
+
+#include <fstream>
+
+namespace
+{
+  const char MAGIC[8] = {'M', 'I', 'T', 'K', 'B', 'C', 'N', 'S'};
+
+  // magic, version and byte order mark
+  const uint64_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+}
+
+mitk::ContourModelSetBinaryIO::ContourModelSetBinaryIO()
+  : AbstractFileIO(ContourModelSet::GetStaticNameOfClass())
+{
+  std::string category = "Binary ContourModelSet File";
+  mitk::CustomMimeType customMimeType;
+  customMimeType.SetCategory(category);
+  customMimeType.AddExtension("cnt_setb");
+
+  this->SetMimeType(customMimeType);
+  this->SetReaderDescription(category);
+  this->SetWriterDescription(category);
+
+  this->RegisterService();
+}
+
+std::vector<itk::SmartPointer<mitk::BaseData>> mitk::ContourModelSetBinaryIO::Read()
+{
+  InputStream stream(this, std::ios_base::in | std::ios_base::binary);
+
+  if (!ContourModelBinaryIO::ReadHeader(stream, MAGIC))
+    mitkThrow() << "Not a MITK binary contour set file.";
+
+  uint32_t numberOfContours = 0;
+  stream.read(reinterpret_cast<char *>(&numberOfContours), sizeof(numberOfContours));
+
+  // the offsets allow random access, a complete read just streams through all contours
+  stream.ignore(numberOfContours * sizeof(uint64_t));
+  if (!stream)
+    mitkThrow() << "Unexpected end of binary contour set file.";
+
+  ContourModelSet::Pointer contourSet = ContourModelSet::New();
+  for (uint32_t i = 0; i < numberOfContours; ++i)
+  {
+    contourSet->AddContourModel(ContourModelBinaryIO::ReadContour(stream));
+  }
+
+  std::vector<itk::SmartPointer<BaseData>> result;
+  result.push_back(contourSet.GetPointer());
+  return result;
+}
+
+mitk::IFileIO::ConfidenceLevel mitk::ContourModelSetBinaryIO::GetReaderConfidenceLevel() const
+{
+  if (AbstractFileIO::GetReaderConfidenceLevel() == Unsupported)
+    return Unsupported;
+
+  if (this->GetInputStream() == nullptr)
+  {
+    std::ifstream file(this->GetInputLocation().c_str(), std::ios::in | std::ios::binary);
+    try
+    {
+      return ContourModelBinaryIO::ReadHeader(file, MAGIC) ? Supported : Unsupported;
+    }
+    catch (const mitk::Exception &)
+    {
+      return Unsupported;
+    }
+  }
+
+  return Supported;
+}
+
+void mitk::ContourModelSetBinaryIO::Write()
+{
+  const auto *contourSet = dynamic_cast<const ContourModelSet *>(this->GetInput());
+  if (contourSet == nullptr)
+    mitkThrow() << "Cannot write non-contour set data";
+
+  OutputStream stream(this, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+
+  ContourModelBinaryIO::WriteHeader(stream, MAGIC);
+
+  const auto numberOfContours = static_cast<uint32_t>(contourSet->GetSize());
+  stream.write(reinterpret_cast<const char *>(&numberOfContours), sizeof(numberOfContours));
+
+  // the contour sizes are known in advance, so the index can be written before the contours
+  uint64_t offset = HEADER_SIZE + sizeof(numberOfContours) + numberOfContours * sizeof(uint64_t);
+  for (uint32_t i = 0; i < numberOfContours; ++i)
+  {
+    stream.write(reinterpret_cast<const char *>(&offset), sizeof(offset));
+    offset += ContourModelBinaryIO::GetContourSize(contourSet->GetContourModelAt(i));
+  }
+
+  for (uint32_t i = 0; i < numberOfContours; ++i)
+  {
+    ContourModelBinaryIO::WriteContour(stream, contourSet->GetContourModelAt(i));
+  }
+
+  if (!stream.good())
+    mitkThrow() << "Some error during contour set writing.";
+}
+
+mitk::ContourModelSetBinaryIO *mitk::ContourModelSetBinaryIO::IOClone() const
+{
+  return new ContourModelSetBinaryIO(*this);
+}
@@ -0,0 +1,62 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef _MITK_CONTOURMODELSET_BINARY_IO__H_
+#define _MITK_CONTOURMODELSET_BINARY_IO__H_
+
+#include <mitkAbstractFileIO.h>
+#include <mitkContourModelSet.h>
+
+namespace mitk
+{
+  /**
+   * @brief Binary reader and writer for mitk::ContourModelSet
+   *
+   * The file starts with the number of contours and the byte offset of every contour,
+   * followed by the contours in the encoding of mitk::ContourModelBinaryIO. Contours
+   * are written one after another, so the whole set never has to be kept in memory
+   * twice.
+   *
+   * \verbatim
+   * header      magic "MITKBCNS", version, byte order mark
+   * index       number of contours n, offsets[n] (from the start of the file)
+   * contours    n contours
+   * \endverbatim
+   *
+   * @ingroup MitkContourModelModule
+   */
+  class ContourModelSetBinaryIO : public mitk::AbstractFileIO
+  {
+  public:
+    ContourModelSetBinaryIO();
+
+    // -------------- AbstractFileReader -------------
+
+    using AbstractFileReader::Read;
+    std::vector<itk::SmartPointer<BaseData>> Read() override;
+
+    ConfidenceLevel GetReaderConfidenceLevel() const override;
+
+    // -------------- AbstractFileWriter -------------
+
+    void Write() override;
+
+  private:
+    ContourModelSetBinaryIO *IOClone() const override;
+  };
+}
+
+#endif
@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <fstream>
 #include <iostream>
 #include <locale>
+#include <mitkContourModelSet.h>
 #include <mitkContourModelWriter.h>
 
 #include <mitkIOUtil.h>
@@ -86,6 +87,82 @@ static void TestContourModelIO_OneTimeStep()
   TestContourModel(contour.GetPointer(), "/contour.cnt");
 }
 
+static void TestContourModelIO_Binary()
+{
+  mitk::ContourModel::Pointer contour = mitk::ContourModel::New();
+  contour->Expand(2);
+
+  for (int t = 0; t < 2; ++t)
+  {
+    for (int i = 0; i < 100; ++i)
+    {
+      mitk::Point3D p;
+      mitk::FillVector3D(p, i * 0.5, -i * 0.25 + t, 3.0 * t);
+      contour->AddVertex(p, i % 10 == 0, t);
+    }
+  }
+  contour->Close(1);
+
+  std::string filename = std::string(MITK_TEST_OUTPUT_DIR) + "/contour.cntb";
+  mitk::IOUtil::Save(contour, filename);
+  mitk::ContourModel::Pointer contour2 = mitk::IOUtil::Load<mitk::ContourModel>(filename);
+
+  MITK_TEST_CONDITION_REQUIRED(contour2->GetTimeSteps() == 2, "binary contour has two time steps");
+
+  bool areEqual = true;
+  for (int t = 0; t < 2; ++t)
+  {
+    areEqual &= contour->GetNumberOfVertices(t) == contour2->GetNumberOfVertices(t);
+    areEqual &= contour->IsClosed(t) == contour2->IsClosed(t);
+
+    for (int i = 0; areEqual && i < contour->GetNumberOfVertices(t); ++i)
+    {
+      areEqual &= contour->GetVertexAt(i, t)->Coordinates == contour2->GetVertexAt(i, t)->Coordinates;
+      areEqual &= contour->GetVertexAt(i, t)->IsControlPoint == contour2->GetVertexAt(i, t)->IsControlPoint;
+    }
+  }
+
+  MITK_TEST_CONDITION(areEqual, "binary contours are equal");
+}
+
+static void TestContourModelSetIO_Binary()
+{
+  mitk::ContourModelSet::Pointer contourSet = mitk::ContourModelSet::New();
+
+  for (int c = 0; c < 5; ++c)
+  {
+    mitk::ContourModel::Pointer contour = mitk::ContourModel::New();
+    for (int i = 0; i < 10 * (c + 1); ++i)
+    {
+      mitk::Point3D p;
+      mitk::FillVector3D(p, i, c, i * c);
+      contour->AddVertex(p);
+    }
+    contourSet->AddContourModel(contour);
+  }
+
+  std::string filename = std::string(MITK_TEST_OUTPUT_DIR) + "/contourSet.cnt_setb";
+  mitk::IOUtil::Save(contourSet, filename);
+  mitk::ContourModelSet::Pointer contourSet2 = mitk::IOUtil::Load<mitk::ContourModelSet>(filename);
+
+  MITK_TEST_CONDITION_REQUIRED(contourSet->GetSize() == contourSet2->GetSize(), "binary contour sets have the same size");
+
+  bool areEqual = true;
+  for (int c = 0; c < contourSet->GetSize(); ++c)
+  {
+    mitk::ContourModel *contour = contourSet->GetContourModelAt(c);
+    mitk::ContourModel *contour2 = contourSet2->GetContourModelAt(c);
+    areEqual &= contour->GetNumberOfVertices() == contour2->GetNumberOfVertices();
+
+    for (int i = 0; areEqual && i < contour->GetNumberOfVertices(); ++i)
+    {
+      areEqual &= contour->GetVertexAt(i)->Coordinates == contour2->GetVertexAt(i)->Coordinates;
+    }
+  }
+
+  MITK_TEST_CONDITION(areEqual, "binary contour sets are equal");
+}
+
 static void TestContourModelIO_EmptyContourModel()
 {
   // Commented out: Saving of empty basedatas is invalid since Reader/Writer redesign
@@ -100,6 +177,8 @@ int mitkContourModelIOTest(int /*argc*/, char * /*argv*/ [])
 
   TestContourModelIO_OneTimeStep();
   TestContourModelIO_EmptyContourModel();
+  TestContourModelIO_Binary();
+  TestContourModelSetIO_Binary();
 
   MITK_TEST_END()
 }
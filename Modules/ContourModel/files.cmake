@@ -22,5 +22,7 @@ set(CPP_FILES
   IO/mitkContourModelSetSerializer.cpp
   IO/mitkContourModelSetReader.cpp
   IO/mitkContourModelSetWriter.cpp
+  IO/mitkContourModelBinaryIO.cpp
+  IO/mitkContourModelSetBinaryIO.cpp
   mitkContourModelActivator.cpp
 )
@@ -14,7 +14,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 ===================================================================*/
 
+#include "mitkContourModelBinaryIO.h"
 #include "mitkContourModelReader.h"
+#include "mitkContourModelSetBinaryIO.h"
 #include "mitkContourModelSetReader.h"
 #include "mitkContourModelSetWriter.h"
 #include "mitkContourModelWriter.h"
@@ -36,6 +38,8 @@ namespace mitk
       m_ContourModelSetReader = new ContourModelSetReader();
       m_ContourModelWriter = new ContourModelWriter();
       m_ContourModelSetWriter = new ContourModelSetWriter();
+      m_ContourModelBinaryIO = new ContourModelBinaryIO();
+      m_ContourModelSetBinaryIO = new ContourModelSetBinaryIO();
     }
 
     void Unload(us::ModuleContext *) override
@@ -44,6 +48,8 @@ namespace mitk
       delete m_ContourModelSetReader;
       delete m_ContourModelWriter;
       delete m_ContourModelSetWriter;
+      delete m_ContourModelBinaryIO;
+      delete m_ContourModelSetBinaryIO;
     }
 
   private:
@@ -51,6 +57,8 @@ namespace mitk
     mitk::ContourModelSetReader *m_ContourModelSetReader;
     mitk::ContourModelWriter *m_ContourModelWriter;
     mitk::ContourModelSetWriter *m_ContourModelSetWriter;
+    mitk::ContourModelBinaryIO *m_ContourModelBinaryIO;
+    mitk::ContourModelSetBinaryIO *m_ContourModelSetBinaryIO;
   };
 }
 
@@ -57,6 +57,12 @@ namespace mitk
      */
     static MimeType GetMimeTypeForFile(const std::string &path, us::ModuleContext *context = us::GetModuleContext());
 
+    /**
+     * @brief Get the references of all readers for the given mime-type, sorted by ascending rank.
+     *
+     * The references are cached per mime-type, the cache is cleared whenever a
+     * mitk::IFileReader service is registered, modified or unregistered.
+     */
     static std::vector<ReaderReference> GetReferences(const MimeType &mimeType,
                                                       us::ModuleContext *context = us::GetModuleContext());
 
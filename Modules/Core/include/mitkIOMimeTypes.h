@@ -82,9 +82,13 @@ namespace mitk
     // ------------------------------ MITK formats ----------------------------------
 
     static CustomMimeType POINTSET_MIMETYPE();      // mps
+    static CustomMimeType POINTSET_BINARY_MIMETYPE(); // mpsb
     static CustomMimeType GEOMETRY_DATA_MIMETYPE(); // .mitkgeometry
+    static CustomMimeType MITK_CHUNKED_IMAGE_MIMETYPE(); // (mitk::Image) mitkimg
 
     static std::string POINTSET_MIMETYPE_NAME(); // DEFAULT_BASE_NAME.pointset
+    static std::string POINTSET_BINARY_MIMETYPE_NAME(); // DEFAULT_BASE_NAME.pointset.binary
+    static std::string MITK_CHUNKED_IMAGE_NAME(); // DEFAULT_BASE_NAME.image.chunked
 
   private:
     // purposely not implemented
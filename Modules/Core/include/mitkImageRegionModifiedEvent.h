@@ -0,0 +1,60 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkImageRegionModifiedEvent_h
+#define mitkImageRegionModifiedEvent_h
+
+#include <itkEventObject.h>
+#include <itkImageRegion.h>
+
+namespace mitk
+{
+  /**
+    \brief Invoked by an image whose voxels were changed only within a region of one time step.
+
+    Tools that write back a slice invoke it before the image is marked modified, so observers that keep
+    results up to date (e.g. statistics of a segmentation) can visit only the changed region instead of
+    the whole image. Modifications without this event may have changed any voxel.
+  */
+  class ImageRegionModifiedEvent : public itk::AnyEvent
+  {
+  public:
+    typedef ImageRegionModifiedEvent Self;
+    typedef itk::AnyEvent Superclass;
+    typedef itk::ImageRegion<3> RegionType;
+
+    ImageRegionModifiedEvent(const RegionType &region = RegionType(), unsigned int timeStep = 0)
+      : m_Region(region), m_TimeStep(timeStep)
+    {
+    }
+    ~ImageRegionModifiedEvent() override {}
+    const char *GetEventName() const override { return "ImageRegionModifiedEvent"; }
+    bool CheckEvent(const ::itk::EventObject *e) const override { return dynamic_cast<const Self *>(e); }
+    ::itk::EventObject *MakeObject() const override { return new Self(m_Region, m_TimeStep); }
+    const RegionType &GetRegion() const { return m_Region; }
+    unsigned int GetTimeStep() const { return m_TimeStep; }
+    ImageRegionModifiedEvent(const Self &s) : itk::AnyEvent(s), m_Region(s.m_Region), m_TimeStep(s.m_TimeStep){};
+
+  protected:
+    RegionType m_Region;
+    unsigned int m_TimeStep;
+
+  private:
+    void operator=(const Self &);
+  };
+}
+
+#endif
@@ -27,6 +27,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkImageData.h>
 
 #include <vtkMarchingCubes.h>
+#include <vtkMatrix4x4.h>
+#include <vtkSmartPointer.h>
 #include <vtkSmoothPolyDataFilter.h>
 
 namespace mitk
@@ -47,6 +49,11 @@ namespace mitk
   * and connected in the common way of pipelining in ITK. It's also possible
   * to create time sliced surfaces.
   *
+  * The time steps are processed concurrently, each with its own VTK pipeline. For large volumes the
+  * isosurface can be extracted by vtkFlyingEdges3D instead of vtkMarchingCubes
+  * [SetIsosurface(mitk::ImageToSurfaceFilter::FlyingEdges)]. The time spent in each stage is
+  * available by GetStageTimings() after an update.
+  *
   * @ingroup ImageFilters
   * @ingroup Process
   */
@@ -67,6 +74,31 @@ namespace mitk
       QuadricDecimation
     };
 
+    /*
+  * The algorithm used to extract the isosurface. Both generate the same surface, vtkFlyingEdges3D
+  * visits every voxel edge only once and is considerably faster on large volumes.
+  */
+    enum IsosurfaceType
+    {
+      MarchingCubes,
+      FlyingEdges
+    };
+
+    /**
+     * Time in seconds spent in the stages of the last update. The stages are summed over all time
+     * steps, Total is the elapsed time of the whole update.
+     */
+    struct StageTimings
+    {
+      StageTimings() : Isosurface(0.0), Smoothing(0.0), Decimation(0.0), Transformation(0.0), Total(0.0) {}
+
+      double Isosurface;
+      double Smoothing;
+      double Decimation;
+      double Transformation;
+      double Total;
+    };
+
     mitkClassMacro(ImageToSurfaceFilter, SurfaceSource);
     itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
@@ -175,6 +207,21 @@ namespace mitk
      */
     itkGetConstMacro(TargetReduction, float);
 
+    /**
+     * Set the algorithm used to extract the isosurface, by default MarchingCubes.
+     */
+    itkSetMacro(Isosurface, IsosurfaceType);
+
+    /**
+     * Returns the algorithm used to extract the isosurface.
+     */
+    itkGetConstMacro(Isosurface, IsosurfaceType);
+
+    /**
+     * Returns the time spent in the stages of the last update.
+     */
+    const StageTimings &GetStageTimings() const { return m_StageTimings; }
+
     /**
      * Transforms a point by a 4x4 matrix
      */
@@ -213,6 +260,32 @@ namespace mitk
      */
     void CreateSurface(int time, vtkImageData *vtkimage, mitk::Surface *surface, const ScalarType threshold);
 
+    /**
+     * Extracts, smoothes, decimates and transforms the surface of a single time step. Only the given
+     * objects are accessed, so time steps can be processed by concurrent threads.
+     *
+     * @param vtkimage input image
+     * @param indexToWorld transformation of the points created from the image (see GetImageToWorldMatrix())
+     * @param threshold isovalue of the surface
+     * @param timings the time spent in each stage is added to it
+     */
+    vtkSmartPointer<vtkPolyData> CreatePolyData(vtkImageData *vtkimage,
+                                                vtkMatrix4x4 *indexToWorld,
+                                                const ScalarType threshold,
+                                                StageTimings &timings);
+
+    /**
+     * Returns the matrix which transforms points of the vtk image of a time step (origin at zero,
+     * scaled by the spacing) into world coordinates.
+     */
+    vtkSmartPointer<vtkMatrix4x4> GetImageToWorldMatrix(int time);
+
+    /**
+     * Called concurrently for every time step before the surface is created, returns the image the surface
+     * is extracted from. The default implementation returns the image of the time step unchanged.
+     */
+    virtual vtkSmartPointer<vtkImageData> PreprocessImage(vtkImageData *vtkimage);
+
     /**
     * Flag whether the created surface shall be smoothed or not (default is "false"). SetSmooth (bool _arg)
     * */
@@ -245,6 +318,17 @@ namespace mitk
     * smoothRelaxation)
     * */
     float m_SmoothRelaxation;
+
+    /**
+    * The algorithm used to extract the isosurface, default is "MarchingCubes". See also SetIsosurface
+    * (IsosurfaceType _arg)
+    * */
+    IsosurfaceType m_Isosurface;
+
+    /**
+    * The time spent in the stages of the last update
+    * */
+    StageTimings m_StageTimings;
   };
 
 } // namespace mitk
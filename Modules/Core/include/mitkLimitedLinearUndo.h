@@ -103,6 +103,20 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     void SetUndoLimit(std::size_t limit) override;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory of the undo history in bytes.
+    //## The memory of the items is determined by UndoStackItem::GetMemorySize().
+    //## If the value is 0 that means that there is no limit.
+    std::size_t GetUndoMemoryLimit() const override;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory of the undo history in bytes.
+    //## If the limit is exceeded, the oldest undo items will
+    //## be dropped from the bottom of the undo stack. The most recent item is always kept.
+    //## The 0 value means that there is no limit, the default is 1 GiB.
+    //## @param limit the maximum number of bytes held by the items on the stack
+    void SetUndoMemoryLimit(std::size_t limit) override;
+
     //##Documentation
     //## @brief Returns the ObjectEventId of the
     //## top element in the OperationHistory
@@ -131,6 +145,14 @@ namespace mitk
     //## elements in the list and to clear the list
     void ClearList(UndoContainer *list);
 
+    //## @brief Appends an element to the undo list, accounts for its memory
+    //## and drops the oldest elements if a limit is exceeded
+    void PushToUndoList(UndoStackItem *item);
+
+    //## @brief Drops the oldest elements of the undo list until
+    //## the undo limit and the undo memory limit are met
+    void LimitUndoList();
+
     UndoContainer m_UndoList;
 
     UndoContainer m_RedoList;
@@ -138,8 +160,14 @@ namespace mitk
   private:
     int FirstObjectEventIdOfCurrentGroup(UndoContainer &stack);
 
+    void PopFrontOfUndoList();
+
     std::size_t m_UndoLimit;
 
+    std::size_t m_UndoMemoryLimit;
+
+    //## Memory of the items in the undo list, updated whenever an item is added or removed
+    std::size_t m_UndoMemorySize;
   };
 
 #pragma GCC visibility push(default)
@@ -43,6 +43,13 @@ namespace mitk
 
     OperationType GetOperationType();
 
+    //##Documentation
+    //## @brief Returns the number of bytes held by the operation.
+    //##
+    //## Used by the undo models to limit the memory of the undo history. Operations holding
+    //## large data (e.g. image slices) have to override this method.
+    virtual std::size_t GetMemorySize() const;
+
   protected:
     OperationType m_OperationType;
   };
@@ -75,6 +75,10 @@ namespace mitk
     //## @brief Returns the textual description of this object
     std::string GetDescription();
 
+    //##Documentation
+    //## @brief Returns the number of bytes held by this object
+    virtual std::size_t GetMemorySize() const;
+
     virtual void ReverseOperations();
     virtual void ReverseAndExecute();
 
@@ -174,6 +178,9 @@ namespace mitk
     //## and false if it already has been deleted
     virtual bool IsValid();
 
+    //## @brief Returns the number of bytes held by this object including both operations
+    std::size_t GetMemorySize() const override;
+
   protected:
     void OnObjectDeleted();
 
@@ -0,0 +1,55 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __mitkParallelFor_h
+#define __mitkParallelFor_h
+
+#include "MitkCoreExports.h"
+
+#include <cstddef>
+#include <functional>
+
+namespace mitk
+{
+  /**
+    \brief Returns the number of chunks ParallelForChunks() splits count items into.
+
+    There is at most one chunk per core and, unless count is smaller, no chunk has less than
+    minimumChunkSize items. Use it to allocate per chunk results before calling ParallelForChunks().
+  */
+  MITKCORE_EXPORT std::size_t GetNumberOfParallelChunks(std::size_t count, std::size_t minimumChunkSize = 1);
+
+  /**
+    \brief Runs task(i) for all i in [0, count) on all available cores and returns when all of them are done.
+
+    Every thread takes the next unprocessed item, so items of different cost are balanced. The calling thread
+    takes part in the work. If a task throws, the items not started yet are skipped and the first exception is
+    rethrown in the calling thread.
+  */
+  MITKCORE_EXPORT void ParallelFor(std::size_t count, const std::function<void(std::size_t)> &task);
+
+  /**
+    \brief Splits [0, count) into GetNumberOfParallelChunks(count, minimumChunkSize) consecutive chunks of
+    nearly equal size and runs task(begin, end, chunk) for each of them like ParallelFor().
+
+    The chunk index is meant for per chunk results that are merged by the caller afterwards.
+  */
+  MITKCORE_EXPORT void ParallelForChunks(std::size_t count,
+                                         const std::function<void(std::size_t, std::size_t, std::size_t)> &task,
+                                         std::size_t minimumChunkSize = 1);
+}
+
+#endif
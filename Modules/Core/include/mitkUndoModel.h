@@ -75,6 +75,19 @@ namespace mitk
     //## @param limit the maximum number of items on the stack
     virtual void SetUndoLimit(std::size_t limit) = 0;
 
+    //##Documentation
+    //## @brief Gets the limit on the memory of the undo history in bytes.
+    //## If the value is 0 that means that there is no limit.
+    virtual std::size_t GetUndoMemoryLimit() const = 0;
+
+    //##Documentation
+    //## @brief Sets a limit on the memory of the undo history in bytes.
+    //## If the limit is exceeded, the oldest undo items will
+    //## be dropped from the bottom of the undo stack. The most recent item is always kept.
+    //## The 0 value means that there is no limit.
+    //## @param limit the maximum number of bytes held by the items on the stack
+    virtual void SetUndoMemoryLimit(std::size_t limit) = 0;
+
     //##Documentation
     //## @brief returns the ObjectEventId of the
     //## top Element in the OperationHistory of the selected
@@ -25,18 +25,24 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkQuadricDecimation.h>
 
 #include <vtkCleanPolyData.h>
+#include <vtkFlyingEdges3D.h>
 #include <vtkPolyDataNormals.h>
 #include <vtkSmartPointer.h>
 
+#include "mitkParallelFor.h"
 #include "mitkProgressBar.h"
 
+#include <algorithm>
+#include <chrono>
+
 mitk::ImageToSurfaceFilter::ImageToSurfaceFilter()
   : m_Smooth(false),
     m_Decimate(NoDecimation),
     m_Threshold(1.0),
     m_TargetReduction(0.95f),
     m_SmoothIteration(50),
-    m_SmoothRelaxation(0.1)
+    m_SmoothRelaxation(0.1),
+    m_Isosurface(MarchingCubes)
 {
 }
 
@@ -49,27 +55,61 @@ void mitk::ImageToSurfaceFilter::CreateSurface(int time,
                                                mitk::Surface *surface,
                                                const ScalarType threshold)
 {
-  vtkImageChangeInformation *indexCoordinatesImageFilter = vtkImageChangeInformation::New();
+  vtkSmartPointer<vtkMatrix4x4> imageToWorld = this->GetImageToWorldMatrix(time);
+
+  surface->SetVtkPolyData(this->CreatePolyData(vtkimage, imageToWorld, threshold, m_StageTimings), time);
+  ProgressBar::GetInstance()->Progress(3);
+}
+
+vtkSmartPointer<vtkPolyData> mitk::ImageToSurfaceFilter::CreatePolyData(vtkImageData *vtkimage,
+                                                                        vtkMatrix4x4 *indexToWorld,
+                                                                        const ScalarType threshold,
+                                                                        StageTimings &timings)
+{
+  auto stageStart = std::chrono::steady_clock::now();
+  auto elapsedSeconds = [&stageStart]() {
+    const auto now = std::chrono::steady_clock::now();
+    const double seconds = std::chrono::duration<double>(now - stageStart).count();
+    stageStart = now;
+    return seconds;
+  };
+
+  vtkSmartPointer<vtkImageChangeInformation> indexCoordinatesImageFilter =
+    vtkSmartPointer<vtkImageChangeInformation>::New();
   indexCoordinatesImageFilter->SetInputData(vtkimage);
   indexCoordinatesImageFilter->SetOutputOrigin(0.0, 0.0, 0.0);
 
-  // MarchingCube -->create Surface
-  vtkSmartPointer<vtkMarchingCubes> skinExtractor = vtkSmartPointer<vtkMarchingCubes>::New();
-  skinExtractor->ComputeScalarsOff();
-  skinExtractor->SetInputConnection(indexCoordinatesImageFilter->GetOutputPort()); // RC++
-  indexCoordinatesImageFilter->Delete();
-  skinExtractor->SetValue(0, threshold);
+  vtkSmartPointer<vtkPolyData> polydata;
+
+  if (m_Isosurface == FlyingEdges)
+  {
+    vtkSmartPointer<vtkFlyingEdges3D> skinExtractor = vtkSmartPointer<vtkFlyingEdges3D>::New();
+    skinExtractor->ComputeScalarsOff();
+    skinExtractor->ComputeNormalsOff();
+    skinExtractor->ComputeGradientsOff();
+    skinExtractor->SetInputConnection(indexCoordinatesImageFilter->GetOutputPort());
+    skinExtractor->SetValue(0, threshold);
+    skinExtractor->Update();
+    polydata = skinExtractor->GetOutput();
+  }
+  else
+  {
+    // MarchingCube -->create Surface
+    vtkSmartPointer<vtkMarchingCubes> skinExtractor = vtkSmartPointer<vtkMarchingCubes>::New();
+    skinExtractor->ComputeScalarsOff();
+    skinExtractor->SetInputConnection(indexCoordinatesImageFilter->GetOutputPort());
+    skinExtractor->SetValue(0, threshold);
+    skinExtractor->Update();
+    polydata = skinExtractor->GetOutput();
+  }
 
-  vtkPolyData *polydata;
-  skinExtractor->Update();
-  polydata = skinExtractor->GetOutput();
-  polydata->Register(nullptr); // RC++
+  timings.Isosurface += elapsedSeconds();
 
   if (m_Smooth)
   {
-    vtkSmoothPolyDataFilter *smoother = vtkSmoothPolyDataFilter::New();
+    vtkSmartPointer<vtkSmoothPolyDataFilter> smoother = vtkSmartPointer<vtkSmoothPolyDataFilter>::New();
     // read poly1 (poly1 can be the original polygon, or the decimated polygon)
-    smoother->SetInputConnection(skinExtractor->GetOutputPort()); // RC++
+    smoother->SetInputData(polydata);
     smoother->SetNumberOfIterations(m_SmoothIteration);
     smoother->SetRelaxationFactor(m_SmoothRelaxation);
     smoother->SetFeatureAngle(60);
@@ -78,17 +118,15 @@ void mitk::ImageToSurfaceFilter::CreateSurface(int time,
     smoother->SetConvergence(0);
     smoother->Update();
 
-    polydata->Delete(); // RC--
     polydata = smoother->GetOutput();
-    polydata->Register(nullptr); // RC++
-    smoother->Delete();
   }
-  ProgressBar::GetInstance()->Progress();
+
+  timings.Smoothing += elapsedSeconds();
 
   // decimate = to reduce number of polygons
   if (m_Decimate == DecimatePro)
   {
-    vtkDecimatePro *decimate = vtkDecimatePro::New();
+    vtkSmartPointer<vtkDecimatePro> decimate = vtkSmartPointer<vtkDecimatePro>::New();
     decimate->SplittingOff();
     decimate->SetErrorIsAbsolute(5);
     decimate->SetFeatureAngle(30);
@@ -96,57 +134,41 @@ void mitk::ImageToSurfaceFilter::CreateSurface(int time,
     decimate->BoundaryVertexDeletionOff();
     decimate->SetDegree(10); // std-value is 25!
 
-    decimate->SetInputData(polydata); // RC++
+    decimate->SetInputData(polydata);
     decimate->SetTargetReduction(m_TargetReduction);
     decimate->SetMaximumError(0.002);
     decimate->Update();
 
-    polydata->Delete(); // RC--
     polydata = decimate->GetOutput();
-    polydata->Register(nullptr); // RC++
-    decimate->Delete();
   }
   else if (m_Decimate == QuadricDecimation)
   {
-    vtkQuadricDecimation *decimate = vtkQuadricDecimation::New();
+    vtkSmartPointer<vtkQuadricDecimation> decimate = vtkSmartPointer<vtkQuadricDecimation>::New();
     decimate->SetTargetReduction(m_TargetReduction);
 
     decimate->SetInputData(polydata);
     decimate->Update();
-    polydata->Delete();
+
     polydata = decimate->GetOutput();
-    polydata->Register(nullptr);
-    decimate->Delete();
   }
 
-  ProgressBar::GetInstance()->Progress();
+  timings.Decimation += elapsedSeconds();
 
   if (polydata->GetNumberOfPoints() > 0)
   {
-    mitk::Vector3D spacing = GetInput()->GetGeometry(time)->GetSpacing();
-
     vtkPoints *points = polydata->GetPoints();
-    vtkMatrix4x4 *vtkmatrix = vtkMatrix4x4::New();
-    GetInput()->GetGeometry(time)->GetVtkTransform()->GetMatrix(vtkmatrix);
-    double(*matrix)[4] = vtkmatrix->Element;
+    double(*matrix)[4] = indexToWorld->Element;
 
-    unsigned int i, j;
-    for (i = 0; i < 3; ++i)
-      for (j = 0; j < 3; ++j)
-        matrix[i][j] /= spacing[j];
-
-    unsigned int n = points->GetNumberOfPoints();
+    const vtkIdType n = points->GetNumberOfPoints();
     double point[3];
 
-    for (i = 0; i < n; i++)
+    for (vtkIdType i = 0; i < n; i++)
     {
       points->GetPoint(i, point);
       mitkVtkLinearTransformPoint(matrix, point, point);
       points->SetPoint(i, point);
     }
-    vtkmatrix->Delete();
   }
-  ProgressBar::GetInstance()->Progress();
 
   // determine point_data normals for the poly data points.
   vtkSmartPointer<vtkPolyDataNormals> normalsGenerator = vtkSmartPointer<vtkPolyDataNormals>::New();
@@ -162,8 +184,31 @@ void mitk::ImageToSurfaceFilter::CreateSurface(int time,
   cleanPolyDataFilter->PointMergingOn();
   cleanPolyDataFilter->Update();
 
-  surface->SetVtkPolyData(cleanPolyDataFilter->GetOutput(), time);
-  polydata->UnRegister(nullptr);
+  timings.Transformation += elapsedSeconds();
+
+  return cleanPolyDataFilter->GetOutput();
+}
+
+vtkSmartPointer<vtkMatrix4x4> mitk::ImageToSurfaceFilter::GetImageToWorldMatrix(int time)
+{
+  mitk::BaseGeometry *geometry = this->GetInput()->GetGeometry(time);
+  mitk::Vector3D spacing = geometry->GetSpacing();
+
+  vtkSmartPointer<vtkMatrix4x4> vtkmatrix = vtkSmartPointer<vtkMatrix4x4>::New();
+  geometry->GetVtkTransform()->GetMatrix(vtkmatrix);
+  double(*matrix)[4] = vtkmatrix->Element;
+
+  // the points of the surface are scaled by the spacing but do not know about the origin
+  for (unsigned int i = 0; i < 3; ++i)
+    for (unsigned int j = 0; j < 3; ++j)
+      matrix[i][j] /= spacing[j];
+
+  return vtkmatrix;
+}
+
+vtkSmartPointer<vtkImageData> mitk::ImageToSurfaceFilter::PreprocessImage(vtkImageData *vtkimage)
+{
+  return vtkimage;
 }
 
 void mitk::ImageToSurfaceFilter::GenerateData()
@@ -178,18 +223,52 @@ void mitk::ImageToSurfaceFilter::GenerateData()
   int tstart = outputRegion.GetIndex(3);
   int tmax = tstart + outputRegion.GetSize(3); // GetSize()==1 - will aber 0 haben, wenn nicht zeitaufgeloest
 
-  if ((tmax - tstart) > 0)
+  if ((tmax - tstart) <= 0)
+    return;
+
+  ProgressBar::GetInstance()->AddStepsToDo(4 * (tmax - tstart));
+
+  const auto updateStart = std::chrono::steady_clock::now();
+  m_StageTimings = StageTimings();
+
+  // images and geometries are only accessed by this thread, the workers get their own VTK pipelines
+  const std::size_t numberOfTimeSteps = tmax - tstart;
+  std::vector<vtkSmartPointer<vtkImageData>> images(numberOfTimeSteps);
+  std::vector<vtkSmartPointer<vtkMatrix4x4>> imageToWorldMatrices(numberOfTimeSteps);
+
+  for (std::size_t i = 0; i < numberOfTimeSteps; ++i)
   {
-    ProgressBar::GetInstance()->AddStepsToDo(4 * (tmax - tstart));
+    images[i] = image->GetVtkImageData(tstart + i);
+    imageToWorldMatrices[i] = this->GetImageToWorldMatrix(tstart + i);
   }
 
-  int t;
-  for (t = tstart; t < tmax; ++t)
+  std::vector<vtkSmartPointer<vtkPolyData>> results(numberOfTimeSteps);
+  std::vector<StageTimings> timings(numberOfTimeSteps);
+
+  mitk::ParallelFor(numberOfTimeSteps, [&](std::size_t i) {
+    vtkSmartPointer<vtkImageData> preprocessedImage = this->PreprocessImage(images[i]);
+    results[i] = this->CreatePolyData(preprocessedImage, imageToWorldMatrices[i], m_Threshold, timings[i]);
+  });
+
+  for (std::size_t i = 0; i < numberOfTimeSteps; ++i)
   {
-    vtkImageData *vtkimagedata = image->GetVtkImageData(t);
-    CreateSurface(t, vtkimagedata, surface, m_Threshold);
-    ProgressBar::GetInstance()->Progress();
+    surface->SetVtkPolyData(results[i], tstart + i);
+
+    m_StageTimings.Isosurface += timings[i].Isosurface;
+    m_StageTimings.Smoothing += timings[i].Smoothing;
+    m_StageTimings.Decimation += timings[i].Decimation;
+    m_StageTimings.Transformation += timings[i].Transformation;
+
+    ProgressBar::GetInstance()->Progress(4);
   }
+
+  m_StageTimings.Total = std::chrono::duration<double>(std::chrono::steady_clock::now() - updateStart).count();
+  const std::size_t numberOfThreads = mitk::GetNumberOfParallelChunks(numberOfTimeSteps);
+
+  MITK_DEBUG << "Created surfaces of " << numberOfTimeSteps << " time steps with " << numberOfThreads
+             << " threads in " << m_StageTimings.Total << " s (isosurface " << m_StageTimings.Isosurface
+             << " s, smoothing " << m_StageTimings.Smoothing << " s, decimation " << m_StageTimings.Decimation
+             << " s, transformation " << m_StageTimings.Transformation << " s)";
 }
 
 void mitk::ImageToSurfaceFilter::SetSmoothIteration(int smoothIteration)
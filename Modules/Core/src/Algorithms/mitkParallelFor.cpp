@@ -0,0 +1,92 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkParallelFor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::size_t mitk::GetNumberOfParallelChunks(std::size_t count, std::size_t minimumChunkSize)
+{
+  if (0 == count)
+    return 0;
+
+  const std::size_t maximumNumberOfChunks =
+    std::max<std::size_t>(1, count / std::max<std::size_t>(1, minimumChunkSize));
+
+  return std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), maximumNumberOfChunks);
+}
+
+void mitk::ParallelFor(std::size_t count, const std::function<void(std::size_t)> &task)
+{
+  const std::size_t numberOfThreads = GetNumberOfParallelChunks(count);
+
+  if (numberOfThreads <= 1)
+  {
+    for (std::size_t i = 0; i < count; ++i)
+      task(i);
+    return;
+  }
+
+  std::atomic<std::size_t> next(0);
+  std::exception_ptr error;
+  std::mutex errorMutex;
+
+  auto worker = [&]() {
+    for (std::size_t i = next++; i < count; i = next++)
+    {
+      try
+      {
+        task(i);
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+          error = std::current_exception();
+
+        next = count;
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (std::size_t i = 1; i < numberOfThreads; ++i)
+    threads.emplace_back(worker);
+
+  worker();
+
+  for (auto &thread : threads)
+    thread.join();
+
+  if (error)
+    std::rethrow_exception(error);
+}
+
+void mitk::ParallelForChunks(std::size_t count,
+                             const std::function<void(std::size_t, std::size_t, std::size_t)> &task,
+                             std::size_t minimumChunkSize)
+{
+  const std::size_t numberOfChunks = GetNumberOfParallelChunks(count, minimumChunkSize);
+
+  ParallelFor(numberOfChunks, [&](std::size_t chunk) {
+    task(chunk * count / numberOfChunks, (chunk + 1) * count / numberOfChunks, chunk);
+  });
+}
@@ -17,8 +17,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLimitedLinearUndo.h"
 #include <mitkRenderingManager.h>
 
+#include <algorithm>
+
 mitk::LimitedLinearUndo::LimitedLinearUndo()
-: m_UndoLimit(0)
+: m_UndoLimit(0), m_UndoMemoryLimit(1024 * 1024 * 1024), m_UndoMemorySize(0)
 {
   // nothing to do
 }
@@ -32,6 +34,9 @@ mitk::LimitedLinearUndo::~LimitedLinearUndo()
 
 void mitk::LimitedLinearUndo::ClearList(UndoContainer *list)
 {
+  if (list == &m_UndoList)
+    m_UndoMemorySize = 0;
+
   while (!list->empty())
   {
     UndoStackItem *item = list->back();
@@ -53,13 +58,7 @@ bool mitk::LimitedLinearUndo::SetOperationEvent(UndoStackItem *stackItem)
     InvokeEvent(RedoEmptyEvent());
   }
 
-  if (0 != m_UndoLimit && m_UndoList.size() == m_UndoLimit)
-  {
-    auto item = m_UndoList.front();
-    m_UndoList.pop_front();
-    delete item;
-  }
-  m_UndoList.push_back(operationEvent);
+  this->PushToUndoList(operationEvent);
 
   InvokeEvent(UndoNotEmptyEvent());
 
@@ -101,6 +100,7 @@ bool mitk::LimitedLinearUndo::Undo(int oeid)
   {
     m_UndoList.back()->ReverseAndExecute();
 
+    m_UndoMemorySize -= std::min(m_UndoMemorySize, m_UndoList.back()->GetMemorySize());
     m_RedoList.push_back(m_UndoList.back()); // move to redo stack
     m_UndoList.pop_back();
     InvokeEvent(RedoNotEmptyEvent());
@@ -141,6 +141,7 @@ bool mitk::LimitedLinearUndo::Redo(int oeid)
   {
     m_RedoList.back()->ReverseAndExecute();
 
+    m_UndoMemorySize += m_RedoList.back()->GetMemorySize();
     m_UndoList.push_back(m_RedoList.back());
     m_RedoList.pop_back();
     InvokeEvent(UndoNotEmptyEvent());
@@ -186,14 +187,58 @@ void mitk::LimitedLinearUndo::SetUndoLimit(std::size_t undoLimit)
 {
   if (undoLimit != m_UndoLimit)
   {
-    if (m_UndoList.size() > undoLimit)
-    {
-      m_UndoList.erase(m_UndoList.begin(), m_UndoList.end() - undoLimit);
-    }
     m_UndoLimit = undoLimit;
+    this->LimitUndoList();
   }
 }
 
+std::size_t mitk::LimitedLinearUndo::GetUndoMemoryLimit() const
+{
+  return m_UndoMemoryLimit;
+}
+
+void mitk::LimitedLinearUndo::SetUndoMemoryLimit(std::size_t undoMemoryLimit)
+{
+  if (undoMemoryLimit != m_UndoMemoryLimit)
+  {
+    m_UndoMemoryLimit = undoMemoryLimit;
+    this->LimitUndoList();
+  }
+}
+
+void mitk::LimitedLinearUndo::PushToUndoList(UndoStackItem *item)
+{
+  m_UndoList.push_back(item);
+  m_UndoMemorySize += item->GetMemorySize();
+  this->LimitUndoList();
+}
+
+void mitk::LimitedLinearUndo::PopFrontOfUndoList()
+{
+  auto item = m_UndoList.front();
+  m_UndoMemorySize -= std::min(m_UndoMemorySize, item->GetMemorySize());
+  m_UndoList.pop_front();
+  delete item;
+}
+
+void mitk::LimitedLinearUndo::LimitUndoList()
+{
+  while (0 != m_UndoLimit && m_UndoList.size() > m_UndoLimit)
+    this->PopFrontOfUndoList();
+
+  if (0 == m_UndoMemoryLimit || m_UndoMemorySize <= m_UndoMemoryLimit)
+    return;
+
+  // items may shrink after they were added (e.g. by compression), so the running total only overestimates
+  // the memory; it is determined exactly before any item is dropped
+  m_UndoMemorySize = 0;
+  for (auto item : m_UndoList)
+    m_UndoMemorySize += item->GetMemorySize();
+
+  while (m_UndoMemorySize > m_UndoMemoryLimit && m_UndoList.size() > 1)
+    this->PopFrontOfUndoList();
+}
+
 int mitk::LimitedLinearUndo::GetLastObjectEventIdInList()
 {
   return m_UndoList.back()->GetObjectEventId();
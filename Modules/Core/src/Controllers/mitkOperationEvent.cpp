@@ -66,6 +66,11 @@ std::string mitk::UndoStackItem::GetDescription()
   return m_Description;
 }
 
+std::size_t mitk::UndoStackItem::GetMemorySize() const
+{
+  return sizeof(UndoStackItem) + m_Description.capacity();
+}
+
 void mitk::UndoStackItem::ReverseOperations()
 {
   m_Reversed = !m_Reversed;
@@ -131,6 +136,19 @@ void mitk::OperationEvent::ReverseOperations()
   UndoStackItem::ReverseOperations();
 }
 
+std::size_t mitk::OperationEvent::GetMemorySize() const
+{
+  std::size_t memorySize = UndoStackItem::GetMemorySize() + sizeof(OperationEvent) - sizeof(UndoStackItem);
+
+  if (m_Operation != nullptr)
+    memorySize += m_Operation->GetMemorySize();
+
+  if (m_UndoOperation != nullptr)
+    memorySize += m_UndoOperation->GetMemorySize();
+
+  return memorySize;
+}
+
 void mitk::OperationEvent::ReverseAndExecute()
 {
   ReverseOperations();
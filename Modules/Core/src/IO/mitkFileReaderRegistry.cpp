@@ -23,10 +23,92 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <usGetModuleContext.h>
 #include <usLDAPProp.h>
 #include <usModuleContext.h>
+#include <usServiceEvent.h>
 #include <usServiceProperties.h>
 
 #include "itksys/SystemTools.hxx"
 
+#include <mutex>
+
+namespace
+{
+  /**
+   * Caches the reader references of every mime-type, sorted by ascending rank.
+   * The cache is cleared whenever an mitk::IFileReader service is registered,
+   * modified or unregistered.
+   */
+  class ReaderReferenceCache
+  {
+  public:
+    typedef mitk::FileReaderRegistry::ReaderReference ReaderReference;
+
+    static ReaderReferenceCache &GetInstance()
+    {
+      // intentionally never deleted, service events may arrive during static de-initialization
+      static auto *instance = new ReaderReferenceCache;
+      return *instance;
+    }
+
+    std::vector<ReaderReference> GetReferences(const std::string &mimeTypeName, us::ModuleContext *context)
+    {
+      unsigned long generation = 0;
+      {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        this->AddServiceListener();
+
+        auto iter = m_References.find(mimeTypeName);
+        if (iter != m_References.end())
+          return iter->second;
+
+        generation = m_Generation;
+      }
+
+      // query the service registry without holding the lock, it may send service events
+      std::string filter =
+        us::LDAPProp(us::ServiceConstants::OBJECTCLASS()) == us_service_interface_iid<mitk::IFileReader>() &&
+        us::LDAPProp(mitk::IFileReader::PROP_MIMETYPE()) == mimeTypeName;
+      std::vector<ReaderReference> refs = context->GetServiceReferences<mitk::IFileReader>(filter);
+      std::sort(refs.begin(), refs.end());
+
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      if (generation == m_Generation && m_ListenerRegistered)
+        m_References[mimeTypeName] = refs;
+
+      return refs;
+    }
+
+  private:
+    ReaderReferenceCache() : m_ListenerRegistered(false), m_Generation(0) {}
+
+    void AddServiceListener()
+    {
+      if (m_ListenerRegistered)
+        return;
+
+      us::ModuleContext *context = us::GetModuleContext();
+      if (context == nullptr)
+        return;
+
+      std::string filter =
+        us::LDAPProp(us::ServiceConstants::OBJECTCLASS()) == us_service_interface_iid<mitk::IFileReader>();
+      context->AddServiceListener(this, &ReaderReferenceCache::ServiceChanged, filter);
+      m_ListenerRegistered = true;
+    }
+
+    void ServiceChanged(const us::ServiceEvent)
+    {
+      std::lock_guard<std::mutex> lock(m_Mutex);
+      m_References.clear();
+      ++m_Generation;
+    }
+
+    std::mutex m_Mutex;
+    bool m_ListenerRegistered;
+    unsigned long m_Generation;
+    std::map<std::string, std::vector<ReaderReference>> m_References;
+  };
+}
+
 mitk::FileReaderRegistry::FileReaderRegistry()
 {
 }
@@ -65,9 +147,7 @@ std::vector<mitk::FileReaderRegistry::ReaderReference> mitk::FileReaderRegistry:
   if (context == nullptr)
     context = us::GetModuleContext();
 
-  std::string filter = us::LDAPProp(us::ServiceConstants::OBJECTCLASS()) == us_service_interface_iid<IFileReader>() &&
-                       us::LDAPProp(IFileReader::PROP_MIMETYPE()) == mimeType.GetName();
-  return context->GetServiceReferences<IFileReader>(filter);
+  return ReaderReferenceCache::GetInstance().GetReferences(mimeType.GetName(), context);
 }
 
 mitk::IFileReader *mitk::FileReaderRegistry::GetReader(const mitk::FileReaderRegistry::ReaderReference &ref,
@@ -93,8 +173,8 @@ std::vector<mitk::IFileReader *> mitk::FileReaderRegistry::GetReaders(const Mime
   if (!mimeType.IsValid())
     return result;
 
+  // already sorted by ascending rank
   std::vector<us::ServiceReference<IFileReader>> refs = GetReferences(mimeType, context);
-  std::sort(refs.begin(), refs.end());
 
   result.reserve(refs.size());
 
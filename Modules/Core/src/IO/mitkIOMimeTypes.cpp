@@ -103,6 +103,8 @@ namespace mitk
     mimeTypes.push_back(VTK_PARALLEL_IMAGE_MIMETYPE().Clone());
     mimeTypes.push_back(VTK_IMAGE_LEGACY_MIMETYPE().Clone());
 
+    mimeTypes.push_back(MITK_CHUNKED_IMAGE_MIMETYPE().Clone());
+
     mimeTypes.push_back(DICOM_MIMETYPE().Clone());
 
     mimeTypes.push_back(VTK_POLYDATA_MIMETYPE().Clone());
@@ -115,6 +117,7 @@ namespace mitk
 
     mimeTypes.push_back(RAW_MIMETYPE().Clone());
     mimeTypes.push_back(POINTSET_MIMETYPE().Clone());
+    mimeTypes.push_back(POINTSET_BINARY_MIMETYPE().Clone());
     return mimeTypes;
   }
 
@@ -345,6 +348,21 @@ namespace mitk
     return name;
   }
 
+  CustomMimeType IOMimeTypes::POINTSET_BINARY_MIMETYPE()
+  {
+    CustomMimeType mimeType(POINTSET_BINARY_MIMETYPE_NAME());
+    mimeType.AddExtension("mpsb");
+    mimeType.SetCategory("Point Sets");
+    mimeType.SetComment("MITK Binary Point Set");
+    return mimeType;
+  }
+
+  std::string IOMimeTypes::POINTSET_BINARY_MIMETYPE_NAME()
+  {
+    static std::string name = DEFAULT_BASE_NAME() + ".pointset.binary";
+    return name;
+  }
+
   CustomMimeType IOMimeTypes::GEOMETRY_DATA_MIMETYPE()
   {
     mitk::CustomMimeType mimeType(DEFAULT_BASE_NAME() + ".geometrydata");
@@ -353,4 +371,19 @@ namespace mitk
     mimeType.SetComment("GeometryData object");
     return mimeType;
   }
+
+  CustomMimeType IOMimeTypes::MITK_CHUNKED_IMAGE_MIMETYPE()
+  {
+    CustomMimeType mimeType(MITK_CHUNKED_IMAGE_NAME());
+    mimeType.AddExtension("mitkimg");
+    mimeType.SetCategory(CATEGORY_IMAGES());
+    mimeType.SetComment("MITK Chunked Image");
+    return mimeType;
+  }
+
+  std::string IOMimeTypes::MITK_CHUNKED_IMAGE_NAME()
+  {
+    static std::string name = DEFAULT_BASE_NAME() + ".image.chunked";
+    return name;
+  }
 }
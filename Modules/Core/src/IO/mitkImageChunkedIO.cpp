@@ -0,0 +1,569 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImageChunkedIO.h"
+
+#include "mitkArbitraryTimeGeometry.h"
+#include "mitkIOMimeTypes.h"
+#include "mitkImage.h"
+#include "mitkImageReadAccessor.h"
+#include "mitkImageWriteAccessor.h"
+#include "mitkParallelFor.h"
+#include "mitkProportionalTimeGeometry.h"
+
+#include <itkMetaImageIO.h>
+#include <itk_zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+
+namespace
+{
+  const char MAGIC[8] = {'M', 'I', 'T', 'K', 'C', 'I', 'M', 'G'};
+  const uint32_t VERSION = 1;
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  // zlib passes sizes as uLong, which has 32 bits on Windows; half of it leaves room for compressBound()
+  const uint64_t MAXIMUM_CHUNK_SIZE = std::numeric_limits<uLong>::max() / 2;
+
+  // deflate cannot compress better than about 1:1032, larger uncompressed sizes indicate a corrupt chunk index
+  const uint64_t MAXIMUM_COMPRESSION_RATIO = 1032;
+
+  struct ChunkedImageHeader
+  {
+    int32_t componentType;
+    int32_t pixelType;
+    uint32_t numberOfComponents;
+    uint32_t dimension;
+    uint32_t dimensions[4];
+    double origin[3];
+    double spacing[3];
+    double direction[9];
+    uint32_t proportionalTimeGeometry;
+    std::vector<double> timeBounds; // minimum and maximum time point of every time step
+    uint32_t slicesPerChunk;
+  };
+
+  struct ChunkInfo
+  {
+    uint64_t offset;
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;
+  };
+
+  template <typename T>
+  void WriteValue(std::ostream &stream, const T &value)
+  {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  T ReadValue(std::istream &stream)
+  {
+    T value;
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!stream)
+      mitkThrow() << "Unexpected end of MITK chunked image file.";
+    return value;
+  }
+
+  void WriteHeader(std::ostream &stream, const ChunkedImageHeader &header)
+  {
+    stream.write(MAGIC, sizeof(MAGIC));
+    WriteValue(stream, VERSION);
+    WriteValue(stream, BYTE_ORDER_MARK);
+    WriteValue(stream, header.componentType);
+    WriteValue(stream, header.pixelType);
+    WriteValue(stream, header.numberOfComponents);
+    WriteValue(stream, header.dimension);
+    for (auto dimension : header.dimensions)
+      WriteValue(stream, dimension);
+    for (auto value : header.origin)
+      WriteValue(stream, value);
+    for (auto value : header.spacing)
+      WriteValue(stream, value);
+    for (auto value : header.direction)
+      WriteValue(stream, value);
+    WriteValue(stream, header.proportionalTimeGeometry);
+    for (auto value : header.timeBounds)
+      WriteValue(stream, value);
+    WriteValue(stream, header.slicesPerChunk);
+  }
+
+  bool ReadMagic(std::istream &stream)
+  {
+    char magic[sizeof(MAGIC)];
+    stream.read(magic, sizeof(MAGIC));
+    return stream && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+  }
+
+  /** Returns the number of bytes from the current position to the end of stream, keeps the position. */
+  uint64_t GetRemainingSize(std::istream &stream)
+  {
+    const std::streampos position = stream.tellg();
+    stream.seekg(0, std::ios::end);
+    const std::streampos end = stream.tellg();
+    stream.seekg(position);
+
+    if (!stream || position < 0 || end < position)
+      mitkThrow() << "Cannot determine the size of the MITK chunked image file.";
+
+    return static_cast<uint64_t>(end - position);
+  }
+
+  ChunkedImageHeader ReadHeader(std::istream &stream)
+  {
+    if (!ReadMagic(stream))
+      mitkThrow() << "Not a MITK chunked image file.";
+
+    if (ReadValue<uint32_t>(stream) != VERSION)
+      mitkThrow() << "Unsupported version of MITK chunked image file.";
+
+    if (ReadValue<uint32_t>(stream) != BYTE_ORDER_MARK)
+      mitkThrow() << "MITK chunked image file was written with a different byte order.";
+
+    ChunkedImageHeader header;
+    header.componentType = ReadValue<int32_t>(stream);
+    header.pixelType = ReadValue<int32_t>(stream);
+    header.numberOfComponents = ReadValue<uint32_t>(stream);
+    header.dimension = ReadValue<uint32_t>(stream);
+    for (auto &dimension : header.dimensions)
+      dimension = ReadValue<uint32_t>(stream);
+    for (auto &value : header.origin)
+      value = ReadValue<double>(stream);
+    for (auto &value : header.spacing)
+      value = ReadValue<double>(stream);
+    for (auto &value : header.direction)
+      value = ReadValue<double>(stream);
+    header.proportionalTimeGeometry = ReadValue<uint32_t>(stream);
+
+    // the number of time steps comes from the file, do not allocate more time bounds than the file can hold
+    if (header.dimensions[3] == 0 || 2 * sizeof(double) * header.dimensions[3] > GetRemainingSize(stream))
+      mitkThrow() << "Corrupt header in MITK chunked image file.";
+
+    header.timeBounds.resize(2 * header.dimensions[3]);
+    for (auto &value : header.timeBounds)
+      value = ReadValue<double>(stream);
+    header.slicesPerChunk = ReadValue<uint32_t>(stream);
+
+    if (header.dimension < 2 || header.dimension > 4 || header.slicesPerChunk == 0 || header.numberOfComponents == 0 ||
+        header.dimensions[0] == 0 || header.dimensions[1] == 0 || header.dimensions[2] == 0)
+      mitkThrow() << "Corrupt header in MITK chunked image file.";
+
+    return header;
+  }
+
+  mitk::PixelType MakePixelType(const ChunkedImageHeader &header)
+  {
+    // itk::ImageIOBase knows how to describe a pixel by component type, pixel type and number of components
+    itk::MetaImageIO::Pointer imageIO = itk::MetaImageIO::New();
+    imageIO->SetComponentType(static_cast<itk::ImageIOBase::IOComponentType>(header.componentType));
+    imageIO->SetPixelType(static_cast<itk::ImageIOBase::IOPixelType>(header.pixelType));
+    imageIO->SetNumberOfComponents(header.numberOfComponents);
+    return mitk::MakePixelType(imageIO.GetPointer());
+  }
+}
+
+namespace mitk
+{
+  ImageChunkedIO::ImageChunkedIO()
+    : AbstractFileIO(Image::GetStaticNameOfClass(), IOMimeTypes::MITK_CHUNKED_IMAGE_MIMETYPE(), "MITK Chunked Image")
+  {
+    Options defaultReaderOptions;
+    defaultReaderOptions[OPTION_TIME_STEP()] = -1;
+    defaultReaderOptions[OPTION_FIRST_SLICE()] = 0;
+    defaultReaderOptions[OPTION_NUMBER_OF_SLICES()] = 0;
+    this->SetDefaultReaderOptions(defaultReaderOptions);
+
+    Options defaultWriterOptions;
+    defaultWriterOptions[OPTION_SLICES_PER_CHUNK()] = 1;
+    defaultWriterOptions[OPTION_COMPRESSION_LEVEL()] = Z_BEST_SPEED;
+    this->SetDefaultWriterOptions(defaultWriterOptions);
+
+    this->RegisterService();
+  }
+
+  std::string ImageChunkedIO::OPTION_TIME_STEP()
+  {
+    static std::string option = "Time step";
+    return option;
+  }
+
+  std::string ImageChunkedIO::OPTION_FIRST_SLICE()
+  {
+    static std::string option = "First slice";
+    return option;
+  }
+
+  std::string ImageChunkedIO::OPTION_NUMBER_OF_SLICES()
+  {
+    static std::string option = "Number of slices";
+    return option;
+  }
+
+  std::string ImageChunkedIO::OPTION_SLICES_PER_CHUNK()
+  {
+    static std::string option = "Slices per chunk";
+    return option;
+  }
+
+  std::string ImageChunkedIO::OPTION_COMPRESSION_LEVEL()
+  {
+    static std::string option = "Compression level";
+    return option;
+  }
+
+  std::vector<BaseData::Pointer> ImageChunkedIO::Read()
+  {
+    std::ifstream file;
+    std::istream *stream = this->GetInputStream();
+    if (stream == nullptr)
+    {
+      file.open(this->GetInputLocation().c_str(), std::ios::in | std::ios::binary);
+      if (!file.is_open())
+        mitkThrow() << "Cannot open " << this->GetInputLocation() << " for reading.";
+      stream = &file;
+    }
+
+    // the chunk offsets are relative to the start of the chunked image, which may be embedded in a larger stream
+    const std::streamoff start = stream->tellg();
+    const uint64_t size = GetRemainingSize(*stream);
+    const ChunkedImageHeader header = ReadHeader(*stream);
+
+    const unsigned int numberOfSlices = header.dimensions[2];
+    const unsigned int numberOfTimeSteps = header.dimensions[3];
+    const size_t chunksPerTimeStep = (numberOfSlices + header.slicesPerChunk - 1) / header.slicesPerChunk;
+
+    const PixelType pixelType = MakePixelType(header);
+    const uint64_t pixelRowSize = static_cast<uint64_t>(pixelType.GetSize()) * header.dimensions[0];
+    if (pixelRowSize == 0 || header.dimensions[1] > MAXIMUM_CHUNK_SIZE / pixelRowSize)
+      mitkThrow() << "Corrupt header in MITK chunked image file.";
+
+    const uint64_t fullSliceSize = pixelRowSize * header.dimensions[1];
+
+    // all sizes of the index come from the file, check them before anything is allocated
+    const auto numberOfChunks = ReadValue<uint64_t>(*stream);
+    if (numberOfChunks != chunksPerTimeStep * numberOfTimeSteps ||
+        numberOfChunks > GetRemainingSize(*stream) / (3 * sizeof(uint64_t)))
+      mitkThrow() << "Corrupt chunk index in MITK chunked image file.";
+
+    std::vector<ChunkInfo> chunks(numberOfChunks);
+    for (size_t chunkIndex = 0; chunkIndex < numberOfChunks; ++chunkIndex)
+    {
+      ChunkInfo &chunk = chunks[chunkIndex];
+      chunk.offset = ReadValue<uint64_t>(*stream);
+      chunk.compressedSize = ReadValue<uint64_t>(*stream);
+      chunk.uncompressedSize = ReadValue<uint64_t>(*stream);
+
+      const unsigned int chunkFirstSlice = (chunkIndex % chunksPerTimeStep) * header.slicesPerChunk;
+      const unsigned int chunkNumberOfSlices = std::min(header.slicesPerChunk, numberOfSlices - chunkFirstSlice);
+
+      if (chunk.offset > size || chunk.compressedSize > size - chunk.offset ||
+          chunk.uncompressedSize % fullSliceSize != 0 ||
+          chunk.uncompressedSize / fullSliceSize != chunkNumberOfSlices || chunk.uncompressedSize > MAXIMUM_CHUNK_SIZE ||
+          chunk.uncompressedSize / MAXIMUM_COMPRESSION_RATIO > chunk.compressedSize)
+        mitkThrow() << "Corrupt chunk index in MITK chunked image file.";
+    }
+
+    // determine the requested region
+    const int requestedTimeStep = us::any_cast<int>(this->GetReaderOption(OPTION_TIME_STEP()));
+    const int requestedFirstSlice = us::any_cast<int>(this->GetReaderOption(OPTION_FIRST_SLICE()));
+    const int requestedNumberOfSlices = us::any_cast<int>(this->GetReaderOption(OPTION_NUMBER_OF_SLICES()));
+
+    if (requestedTimeStep < -1 || requestedTimeStep >= static_cast<int>(numberOfTimeSteps) || requestedFirstSlice < 0 ||
+        requestedFirstSlice >= static_cast<int>(numberOfSlices) || requestedNumberOfSlices < 0)
+      mitkThrow() << "Requested region is outside of the image.";
+
+    const unsigned int firstTimeStep = requestedTimeStep == -1 ? 0 : requestedTimeStep;
+    const unsigned int lastTimeStep = requestedTimeStep == -1 ? numberOfTimeSteps - 1 : requestedTimeStep;
+    const unsigned int firstSlice = requestedFirstSlice;
+    const unsigned int lastSlice =
+      requestedNumberOfSlices == 0 ? numberOfSlices - 1
+                                   : std::min(numberOfSlices, firstSlice + requestedNumberOfSlices) - 1;
+
+    unsigned int dimensions[4] = {header.dimensions[0],
+                                  header.dimensions[1],
+                                  lastSlice - firstSlice + 1,
+                                  lastTimeStep - firstTimeStep + 1};
+    unsigned int dimension = header.dimension;
+    if (dimension == 4 && dimensions[3] == 1)
+      dimension = 3;
+
+    const size_t sliceSize = pixelType.GetSize() * dimensions[0] * dimensions[1];
+
+    Image::Pointer image = Image::New();
+    image->Initialize(pixelType, dimension, dimensions);
+
+    // allocate the volumes up front, the threads only write into them
+    std::vector<std::unique_ptr<ImageWriteAccessor>> accessors;
+    for (unsigned int t = 0; t < dimensions[3]; ++t)
+      accessors.emplace_back(new ImageWriteAccessor(image, image->GetVolumeData(t)));
+
+    // read only the compressed chunks that intersect the requested region
+    std::vector<size_t> requiredChunks;
+    for (unsigned int t = firstTimeStep; t <= lastTimeStep; ++t)
+    {
+      for (size_t chunk = firstSlice / header.slicesPerChunk; chunk <= lastSlice / header.slicesPerChunk; ++chunk)
+        requiredChunks.push_back(t * chunksPerTimeStep + chunk);
+    }
+
+    std::vector<std::vector<Bytef>> compressedData(requiredChunks.size());
+    for (size_t i = 0; i < requiredChunks.size(); ++i)
+    {
+      const ChunkInfo &chunk = chunks[requiredChunks[i]];
+      compressedData[i].resize(chunk.compressedSize);
+      stream->seekg(start + static_cast<std::streamoff>(chunk.offset));
+      stream->read(reinterpret_cast<char *>(compressedData[i].data()), chunk.compressedSize);
+      if (!*stream)
+        mitkThrow() << "Unexpected end of MITK chunked image file.";
+    }
+
+    std::atomic<bool> decompressionFailed(false);
+    ParallelFor(requiredChunks.size(), [&](size_t i) {
+      const size_t chunkIndex = requiredChunks[i];
+      const ChunkInfo &chunk = chunks[chunkIndex];
+      const unsigned int timeStep = chunkIndex / chunksPerTimeStep;
+      const unsigned int chunkFirstSlice = (chunkIndex % chunksPerTimeStep) * header.slicesPerChunk;
+      const unsigned int chunkLastSlice = std::min(numberOfSlices, chunkFirstSlice + header.slicesPerChunk) - 1;
+
+      const unsigned int copyFirstSlice = std::max(firstSlice, chunkFirstSlice);
+      const unsigned int copyLastSlice = std::min(lastSlice, chunkLastSlice);
+
+      auto *target = static_cast<Bytef *>(accessors[timeStep - firstTimeStep]->GetData()) +
+                     (copyFirstSlice - firstSlice) * sliceSize;
+
+      uLongf destLen = chunk.uncompressedSize;
+      int zlibRetVal = Z_OK;
+
+      if (copyFirstSlice == chunkFirstSlice && copyLastSlice == chunkLastSlice)
+      {
+        // chunk is completely inside the requested region: decompress in place
+        zlibRetVal = ::uncompress(target, &destLen, compressedData[i].data(), chunk.compressedSize);
+      }
+      else
+      {
+        std::vector<Bytef> buffer(chunk.uncompressedSize);
+        zlibRetVal = ::uncompress(buffer.data(), &destLen, compressedData[i].data(), chunk.compressedSize);
+        std::memcpy(target,
+                    buffer.data() + (copyFirstSlice - chunkFirstSlice) * sliceSize,
+                    (copyLastSlice - copyFirstSlice + 1) * sliceSize);
+      }
+
+      if (zlibRetVal != Z_OK || destLen != chunk.uncompressedSize)
+        decompressionFailed = true;
+    });
+
+    accessors.clear();
+
+    if (decompressionFailed)
+      mitkThrow() << "Compressed data in MITK chunked image file is corrupted.";
+
+    // re-initialize geometry, the origin is moved to the first requested slice
+    mitk::Matrix3D matrix;
+    mitk::Point3D origin;
+    mitk::Vector3D spacing;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      for (unsigned int j = 0; j < 3; ++j)
+        matrix[i][j] = header.direction[i * 3 + j];
+
+      origin[i] = header.origin[i] + matrix[i][2] * header.spacing[2] * firstSlice;
+      spacing[i] = header.spacing[i];
+    }
+
+    PlaneGeometry *planeGeometry = image->GetSlicedGeometry(0)->GetPlaneGeometry(0);
+    planeGeometry->SetOrigin(origin);
+    planeGeometry->GetIndexToWorldTransform()->SetMatrix(matrix);
+
+    SlicedGeometry3D *slicedGeometry = image->GetSlicedGeometry(0);
+    slicedGeometry->InitializeEvenlySpaced(planeGeometry, image->GetDimension(2));
+    slicedGeometry->SetSpacing(spacing);
+
+    TimeGeometry::Pointer timeGeometry;
+    if (header.proportionalTimeGeometry)
+    {
+      ProportionalTimeGeometry::Pointer propTimeGeometry = ProportionalTimeGeometry::New();
+      propTimeGeometry->Initialize(slicedGeometry, dimensions[3]);
+      propTimeGeometry->SetFirstTimePoint(header.timeBounds[2 * firstTimeStep]);
+      propTimeGeometry->SetStepDuration(header.timeBounds[2 * firstTimeStep + 1] - header.timeBounds[2 * firstTimeStep]);
+      timeGeometry = propTimeGeometry;
+    }
+    else
+    {
+      ArbitraryTimeGeometry::Pointer arbitraryTimeGeometry = ArbitraryTimeGeometry::New();
+      for (unsigned int t = firstTimeStep; t <= lastTimeStep; ++t)
+        arbitraryTimeGeometry->AppendNewTimeStepClone(slicedGeometry, header.timeBounds[2 * t], header.timeBounds[2 * t + 1]);
+      timeGeometry = arbitraryTimeGeometry;
+    }
+
+    image->SetTimeGeometry(timeGeometry);
+
+    std::vector<BaseData::Pointer> result;
+    result.push_back(image.GetPointer());
+    return result;
+  }
+
+  IFileIO::ConfidenceLevel ImageChunkedIO::GetReaderConfidenceLevel() const
+  {
+    if (AbstractFileIO::GetReaderConfidenceLevel() == Unsupported)
+      return Unsupported;
+
+    std::istream *stream = this->GetInputStream();
+    if (stream == nullptr)
+    {
+      std::ifstream file(this->GetInputLocation().c_str(), std::ios::in | std::ios::binary);
+      return ReadMagic(file) ? Supported : Unsupported;
+    }
+
+    // peek at the magic and leave the stream at the start of the chunked image for Read()
+    const std::streampos position = stream->tellg();
+    const bool hasMagic = ReadMagic(*stream);
+    stream->clear();
+    stream->seekg(position);
+
+    return hasMagic ? Supported : Unsupported;
+  }
+
+  void ImageChunkedIO::Write()
+  {
+    ValidateOutputLocation();
+
+    const auto *input = dynamic_cast<const Image *>(this->GetInput());
+    if (input == nullptr)
+      mitkThrow() << "Cannot write non-image data";
+
+    const PixelType pixelType = input->GetPixelType();
+
+    ChunkedImageHeader header;
+    header.componentType = pixelType.GetComponentType();
+    header.pixelType = pixelType.GetPixelType();
+    header.numberOfComponents = pixelType.GetNumberOfComponents();
+    header.dimension = input->GetDimension();
+    for (unsigned int i = 0; i < 4; ++i)
+      header.dimensions[i] = i < header.dimension ? input->GetDimension(i) : 1;
+
+    const BaseGeometry *geometry = input->GetGeometry(0);
+    const Vector3D spacing = geometry->GetSpacing();
+    const Point3D origin = geometry->GetOrigin();
+    const AffineTransform3D::MatrixType &matrix = geometry->GetIndexToWorldTransform()->GetMatrix();
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      header.origin[i] = origin[i];
+      header.spacing[i] = spacing[i];
+      for (unsigned int j = 0; j < 3; ++j)
+        header.direction[i * 3 + j] = matrix[i][j] / spacing[j];
+    }
+
+    const TimeGeometry *timeGeometry = input->GetTimeGeometry();
+    header.proportionalTimeGeometry = dynamic_cast<const ProportionalTimeGeometry *>(timeGeometry) != nullptr;
+    for (unsigned int t = 0; t < header.dimensions[3]; ++t)
+    {
+      header.timeBounds.push_back(timeGeometry->GetMinimumTimePoint(t));
+      header.timeBounds.push_back(timeGeometry->GetMaximumTimePoint(t));
+    }
+
+    const int slicesPerChunk = us::any_cast<int>(this->GetWriterOption(OPTION_SLICES_PER_CHUNK()));
+    const int compressionLevel = us::any_cast<int>(this->GetWriterOption(OPTION_COMPRESSION_LEVEL()));
+    const size_t sliceSize = pixelType.GetSize() * header.dimensions[0] * header.dimensions[1];
+    if (sliceSize > MAXIMUM_CHUNK_SIZE)
+      mitkThrow() << "Slices larger than " << MAXIMUM_CHUNK_SIZE << " bytes cannot be written as MITK chunked image.";
+
+    // a chunk has to fit into a single zlib call
+    const auto maximumSlicesPerChunk =
+      static_cast<uint32_t>(std::min<uint64_t>(MAXIMUM_CHUNK_SIZE / sliceSize, header.dimensions[2]));
+    header.slicesPerChunk =
+      std::max(1u, std::min(maximumSlicesPerChunk, static_cast<uint32_t>(std::max(1, slicesPerChunk))));
+    const size_t chunksPerTimeStep = (header.dimensions[2] + header.slicesPerChunk - 1) / header.slicesPerChunk;
+    const size_t numberOfChunks = chunksPerTimeStep * header.dimensions[3];
+
+    std::vector<std::unique_ptr<ImageReadAccessor>> accessors;
+    for (unsigned int t = 0; t < header.dimensions[3]; ++t)
+      accessors.emplace_back(new ImageReadAccessor(input, input->GetVolumeData(t)));
+
+    // compress all chunks independently on all available cores
+    std::vector<std::vector<Bytef>> compressedData(numberOfChunks);
+    std::vector<uint64_t> uncompressedSizes(numberOfChunks);
+    std::atomic<bool> compressionFailed(false);
+
+    ParallelFor(numberOfChunks, [&](size_t chunkIndex) {
+      const unsigned int timeStep = chunkIndex / chunksPerTimeStep;
+      const unsigned int firstSlice = (chunkIndex % chunksPerTimeStep) * header.slicesPerChunk;
+      const unsigned int numberOfSlices = std::min(header.slicesPerChunk, header.dimensions[2] - firstSlice);
+
+      const auto *source = static_cast<const Bytef *>(accessors[timeStep]->GetData()) + firstSlice * sliceSize;
+      const uLong sourceLen = numberOfSlices * sliceSize;
+      uLongf destLen = ::compressBound(sourceLen);
+
+      compressedData[chunkIndex].resize(destLen);
+      if (::compress2(compressedData[chunkIndex].data(), &destLen, source, sourceLen, compressionLevel) != Z_OK)
+        compressionFailed = true;
+
+      compressedData[chunkIndex].resize(destLen);
+      uncompressedSizes[chunkIndex] = sourceLen;
+    });
+
+    accessors.clear();
+
+    if (compressionFailed)
+      mitkThrow() << "Compression of image data failed.";
+
+    std::ofstream file;
+    std::ostream *stream = this->GetOutputStream();
+    if (stream == nullptr)
+    {
+      file.open(this->GetOutputLocation().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!file.is_open())
+        mitkThrow() << "Cannot open " << this->GetOutputLocation() << " for writing.";
+      stream = &file;
+    }
+
+    const std::streamoff start = stream->tellp();
+    WriteHeader(*stream, header);
+    WriteValue(*stream, static_cast<uint64_t>(numberOfChunks));
+
+    uint64_t offset = static_cast<uint64_t>(stream->tellp() - start) + numberOfChunks * 3 * sizeof(uint64_t);
+    for (size_t chunkIndex = 0; chunkIndex < numberOfChunks; ++chunkIndex)
+    {
+      WriteValue(*stream, offset);
+      WriteValue(*stream, static_cast<uint64_t>(compressedData[chunkIndex].size()));
+      WriteValue(*stream, uncompressedSizes[chunkIndex]);
+      offset += compressedData[chunkIndex].size();
+    }
+
+    for (const auto &chunk : compressedData)
+      stream->write(reinterpret_cast<const char *>(chunk.data()), chunk.size());
+
+    if (!*stream)
+      mitkThrow() << "Error while writing MITK chunked image file.";
+  }
+
+  IFileIO::ConfidenceLevel ImageChunkedIO::GetWriterConfidenceLevel() const
+  {
+    if (AbstractFileIO::GetWriterConfidenceLevel() == Unsupported)
+      return Unsupported;
+    const auto *input = static_cast<const Image *>(this->GetInput());
+    if (input->GetDimension() >= 2 && input->GetDimension() <= 4)
+      return Supported;
+    return Unsupported;
+  }
+
+  ImageChunkedIO *ImageChunkedIO::IOClone() const { return new ImageChunkedIO(*this); }
+}
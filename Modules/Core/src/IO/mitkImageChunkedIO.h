@@ -0,0 +1,77 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKIMAGECHUNKEDIO_H
+#define MITKIMAGECHUNKEDIO_H
+
+#include "mitkAbstractFileIO.h"
+
+namespace mitk
+{
+  /**
+   * @ingroup IO
+   * @brief Reads and writes mitk::Image%s in the native, chunked MITK image format.
+   *
+   * The voxel data is split into chunks of a configurable number of slices of one
+   * time step. Every chunk is compressed (zlib) independently and an index of all chunks
+   * is stored behind the header. This allows to
+   *  - compress and decompress the chunks on all available cores and
+   *  - read single time steps or slice ranges without decompressing the whole file,
+   *    e.g. for previews (see the reader options "Time step", "First slice" and "Number of slices").
+   *
+   * File layout (all values in native byte order, checked by a byte order mark):
+   * \verbatim
+   * header   magic "MITKCIMG", version, byte order mark, pixel type, dimensions,
+   *          origin, spacing, direction, time bounds of every time step, slices per chunk
+   * index    offset, compressed size and uncompressed size of every chunk
+   * data     compressed chunks, ordered by time step and slice
+   * \endverbatim
+   */
+  class ImageChunkedIO : public mitk::AbstractFileIO
+  {
+  public:
+    ImageChunkedIO();
+
+    /** Reader option: time step to read, -1 reads all time steps. Other negative values are rejected. */
+    static std::string OPTION_TIME_STEP();
+    /** Reader option: first slice to read. */
+    static std::string OPTION_FIRST_SLICE();
+    /** Reader option: number of slices to read, 0 reads up to the last slice. */
+    static std::string OPTION_NUMBER_OF_SLICES();
+    /** Writer option: number of slices that are compressed together. It is reduced if a chunk would not fit into a
+    single zlib call, whose sizes have 32 bits on Windows. */
+    static std::string OPTION_SLICES_PER_CHUNK();
+    /** Writer option: zlib compression level (1 = fastest, 9 = smallest). */
+    static std::string OPTION_COMPRESSION_LEVEL();
+
+    // -------------- AbstractFileReader -------------
+
+    using AbstractFileReader::Read;
+    std::vector<BaseData::Pointer> Read() override;
+
+    ConfidenceLevel GetReaderConfidenceLevel() const override;
+
+    // -------------- AbstractFileWriter -------------
+
+    void Write() override;
+
+    ConfidenceLevel GetWriterConfidenceLevel() const override;
+
+  private:
+    ImageChunkedIO *IOClone() const override;
+  };
+}
+#endif // MITKIMAGECHUNKEDIO_H
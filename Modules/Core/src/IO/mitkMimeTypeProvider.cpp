@@ -23,14 +23,34 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itksys/SystemTools.hxx>
 
+#include <algorithm>
+#include <ctime>
+#include <typeinfo>
+
 #ifdef _MSC_VER
 #pragma warning(disable : 4503) // decorated name length exceeded, name was truncated
 #pragma warning(disable : 4355)
 #endif
 
+namespace
+{
+  // upper bound for the number of cached content checks, the cache is cleared when it is reached
+  const std::size_t MAX_CONTENT_CHECKS = 10000;
+
+  // files modified less than this number of seconds ago are not cached, many file systems store
+  // the modification time with a resolution of one or two seconds only
+  const long MIN_CONTENT_CHECK_AGE = 2;
+
+  std::string ToLower(std::string value)
+  {
+    std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+    return value;
+  }
+}
+
 namespace mitk
 {
-  MimeTypeProvider::MimeTypeProvider() : m_Tracker(nullptr) {}
+  MimeTypeProvider::MimeTypeProvider() : m_Tracker(nullptr), m_CacheValid(false) {}
   MimeTypeProvider::~MimeTypeProvider() { delete m_Tracker; }
   void MimeTypeProvider::Start()
   {
@@ -54,16 +74,46 @@ namespace mitk
 
   std::vector<MimeType> MimeTypeProvider::GetMimeTypesForFile(const std::string &filePath) const
   {
-    std::vector<MimeType> result;
-    for (const auto &elem : m_NameToMimeType)
+    std::vector<MimeType> rankedMimeTypes;
+    std::vector<bool> appliesTo;
+    std::vector<std::size_t> contentMimeTypes;
     {
-      if (elem.second.AppliesTo(filePath))
+      std::lock_guard<std::mutex> lock(m_CacheMutex);
+      this->UpdateCache();
+
+      rankedMimeTypes = m_RankedMimeTypes;
+      contentMimeTypes = m_ContentMimeTypes;
+      appliesTo.resize(rankedMimeTypes.size(), false);
+
+      // Mime-types which only check the extension are found by looking up
+      // every path suffix which has the length of a registered extension.
+      const std::string lowerCasePath = ToLower(filePath);
+      for (auto length : m_ExtensionLengths)
       {
-        result.push_back(elem.second);
+        if (length > lowerCasePath.size())
+          break;
+
+        auto iter = m_ExtensionToMimeTypes.find(lowerCasePath.substr(lowerCasePath.size() - length));
+        if (iter != m_ExtensionToMimeTypes.end())
+        {
+          for (auto index : iter->second)
+            appliesTo[index] = true;
+        }
       }
     }
-    std::sort(result.begin(), result.end());
-    std::reverse(result.begin(), result.end());
+
+    // Content checks may access the file, so they are done without holding the lock
+    for (auto index : contentMimeTypes)
+    {
+      appliesTo[index] = this->AppliesToFile(rankedMimeTypes[index], filePath);
+    }
+
+    std::vector<MimeType> result;
+    for (std::size_t i = 0; i < rankedMimeTypes.size(); ++i)
+    {
+      if (appliesTo[i])
+        result.push_back(rankedMimeTypes[i]);
+    }
     return result;
   }
 
@@ -106,11 +156,17 @@ namespace mitk
 
   MimeTypeProvider::TrackedType MimeTypeProvider::AddingService(const ServiceReferenceType &reference)
   {
-    MimeType result = this->GetMimeType(reference);
+    bool extensionOnly = false;
+    MimeType result = this->GetMimeType(reference, &extensionOnly);
     if (result.IsValid())
     {
+      std::lock_guard<std::mutex> lock(m_CacheMutex);
+      this->InvalidateCache();
+
       std::string name = result.GetName();
       m_NameToMimeTypes[name].insert(result);
+      if (extensionOnly)
+        m_ExtensionOnlyMimeTypes.insert(result);
 
       // get the highest ranked mime-type
       m_NameToMimeType[name] = *(m_NameToMimeTypes[name].rbegin());
@@ -125,6 +181,11 @@ namespace mitk
 
   void MimeTypeProvider::RemovedService(const ServiceReferenceType & /*reference*/, TrackedType mimeType)
   {
+    std::lock_guard<std::mutex> lock(m_CacheMutex);
+    this->InvalidateCache();
+
+    m_ExtensionOnlyMimeTypes.erase(mimeType);
+
     std::string name = mimeType.GetName();
     std::set<MimeType> &mimeTypes = m_NameToMimeTypes[name];
     mimeTypes.erase(mimeType);
@@ -140,7 +201,7 @@ namespace mitk
     }
   }
 
-  MimeType MimeTypeProvider::GetMimeType(const ServiceReferenceType &reference) const
+  MimeType MimeTypeProvider::GetMimeType(const ServiceReferenceType &reference, bool *extensionOnly) const
   {
     MimeType result;
     if (!reference)
@@ -159,6 +220,8 @@ namespace mitk
         }
         auto id = us::any_cast<long>(reference.GetProperty(us::ServiceConstants::SERVICE_ID()));
         result = MimeType(*mimeType, rank, id);
+        if (extensionOnly != nullptr)
+          *extensionOnly = typeid(*mimeType) == typeid(CustomMimeType);
       }
       catch (const us::BadAnyCastException &e)
       {
@@ -168,4 +231,81 @@ namespace mitk
     }
     return result;
   }
+
+  void MimeTypeProvider::UpdateCache() const
+  {
+    if (m_CacheValid)
+      return;
+
+    m_RankedMimeTypes.clear();
+    m_ExtensionToMimeTypes.clear();
+    m_ExtensionLengths.clear();
+    m_ContentMimeTypes.clear();
+
+    for (const auto &elem : m_NameToMimeType)
+    {
+      m_RankedMimeTypes.push_back(elem.second);
+    }
+    std::sort(m_RankedMimeTypes.begin(), m_RankedMimeTypes.end());
+    std::reverse(m_RankedMimeTypes.begin(), m_RankedMimeTypes.end());
+
+    for (std::size_t i = 0; i < m_RankedMimeTypes.size(); ++i)
+    {
+      if (m_ExtensionOnlyMimeTypes.find(m_RankedMimeTypes[i]) != m_ExtensionOnlyMimeTypes.end())
+      {
+        for (const auto &extension : m_RankedMimeTypes[i].GetExtensions())
+        {
+          if (extension.empty())
+            continue;
+
+          m_ExtensionToMimeTypes[ToLower(extension)].push_back(i);
+          m_ExtensionLengths.insert(extension.size());
+        }
+      }
+      else
+      {
+        m_ContentMimeTypes.push_back(i);
+      }
+    }
+
+    m_CacheValid = true;
+  }
+
+  void MimeTypeProvider::InvalidateCache()
+  {
+    m_CacheValid = false;
+    m_ContentChecks.clear();
+  }
+
+  bool MimeTypeProvider::AppliesToFile(const MimeType &mimeType, const std::string &filePath) const
+  {
+    // Only existing files are cached, the modification time and size detect changed files. A file
+    // rewritten within the resolution of the modification time is only detected if its size changes,
+    // so recently modified files are always checked.
+    const long modifiedTime = itksys::SystemTools::ModifiedTime(filePath.c_str());
+    if (modifiedTime == 0 || modifiedTime > static_cast<long>(std::time(nullptr)) - MIN_CONTENT_CHECK_AGE)
+      return mimeType.AppliesTo(filePath);
+
+    const unsigned long fileLength = itksys::SystemTools::FileLength(filePath.c_str());
+    const auto key = std::make_pair(mimeType.GetName(), filePath);
+    {
+      std::lock_guard<std::mutex> lock(m_CacheMutex);
+      auto iter = m_ContentChecks.find(key);
+      if (iter != m_ContentChecks.end() && iter->second.modifiedTime == modifiedTime &&
+          iter->second.fileLength == fileLength)
+        return iter->second.appliesTo;
+    }
+
+    const bool appliesTo = mimeType.AppliesTo(filePath);
+
+    std::lock_guard<std::mutex> lock(m_CacheMutex);
+    if (m_ContentChecks.size() >= MAX_CONTENT_CHECKS)
+      m_ContentChecks.clear();
+
+    ContentCheck &check = m_ContentChecks[key];
+    check.modifiedTime = modifiedTime;
+    check.fileLength = fileLength;
+    check.appliesTo = appliesTo;
+    return appliesTo;
+  }
 }
@@ -23,6 +23,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "usServiceTracker.h"
 #include "usServiceTrackerCustomizer.h"
 
+#include <mutex>
 #include <set>
 
 namespace mitk
@@ -57,7 +58,25 @@ namespace mitk
     void ModifiedService(const ServiceReferenceType &reference, TrackedType service) override;
     void RemovedService(const ServiceReferenceType &reference, TrackedType service) override;
 
-    MimeType GetMimeType(const ServiceReferenceType &reference) const;
+    MimeType GetMimeType(const ServiceReferenceType &reference, bool *extensionOnly = nullptr) const;
+
+    /**
+     * Sorts all mime-types by descending rank and builds the extension lookup table.
+     * Must be called with m_CacheMutex locked.
+     */
+    void UpdateCache() const;
+
+    /**
+     * Resets the cached lookup tables, called whenever a mime-type service is added or removed.
+     * Must be called with m_CacheMutex locked.
+     */
+    void InvalidateCache();
+
+    /**
+     * Calls mimeType.AppliesTo(filePath), re-using the result of earlier calls while the modification time and
+     * size of the file do not change. Files modified within the last two seconds are always checked.
+     */
+    bool AppliesToFile(const MimeType &mimeType, const std::string &filePath) const;
 
     us::ServiceTracker<CustomMimeType, MimeTypeTrackerTypeTraits> *m_Tracker;
 
@@ -65,6 +84,34 @@ namespace mitk
     MapType m_NameToMimeTypes;
 
     std::map<std::string, MimeType> m_NameToMimeType;
+
+    /** Registered mime-types which do not override CustomMimeType::AppliesTo(), i.e. only check the extension. */
+    std::set<MimeType> m_ExtensionOnlyMimeTypes;
+
+    mutable std::mutex m_CacheMutex;
+    mutable bool m_CacheValid;
+
+    /** All mime-types sorted by descending rank. */
+    mutable std::vector<MimeType> m_RankedMimeTypes;
+
+    /** Indices into m_RankedMimeTypes of mime-types which only check the file extension, by lower case extension. */
+    mutable std::map<std::string, std::vector<std::size_t>> m_ExtensionToMimeTypes;
+
+    /** All distinct extension lengths, used to look up the file path suffixes in m_ExtensionToMimeTypes. */
+    mutable std::set<std::string::size_type> m_ExtensionLengths;
+
+    /** Indices into m_RankedMimeTypes of mime-types which inspect the file (custom AppliesTo() implementation). */
+    mutable std::vector<std::size_t> m_ContentMimeTypes;
+
+    struct ContentCheck
+    {
+      long modifiedTime;
+      unsigned long fileLength;
+      bool appliesTo;
+    };
+
+    /** Results of content based AppliesTo() checks, by mime-type name and file path. */
+    mutable std::map<std::pair<std::string, std::string>, ContentCheck> m_ContentChecks;
   };
 }
 
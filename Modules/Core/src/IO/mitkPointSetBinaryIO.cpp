@@ -0,0 +1,270 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkPointSetBinaryIO.h"
+
+#include "mitkGeometry3D.h"
+#include "mitkIOMimeTypes.h"
+#include "mitkPointSet.h"
+#include "mitkProportionalTimeGeometry.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+  const char MAGIC[8] = {'M', 'I', 'T', 'K', 'B', 'P', 'T', 'S'};
+  const uint32_t VERSION = 1;
+  const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  template <typename T>
+  void WriteValue(std::ostream &stream, const T &value)
+  {
+    stream.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  template <typename T>
+  void WriteArray(std::ostream &stream, const std::vector<T> &values)
+  {
+    if (!values.empty())
+      stream.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+  }
+
+  template <typename T>
+  T ReadValue(std::istream &stream)
+  {
+    T value;
+    stream.read(reinterpret_cast<char *>(&value), sizeof(T));
+    if (!stream)
+      mitkThrow() << "Unexpected end of binary point set file.";
+    return value;
+  }
+
+  template <typename T>
+  void ReadArray(std::istream &stream, std::vector<T> &values, std::size_t size)
+  {
+    values.resize(size);
+    if (size == 0)
+      return;
+
+    stream.read(reinterpret_cast<char *>(values.data()), size * sizeof(T));
+    if (!stream)
+      mitkThrow() << "Unexpected end of binary point set file.";
+  }
+
+  bool ReadMagic(std::istream &stream)
+  {
+    char magic[sizeof(MAGIC)];
+    stream.read(magic, sizeof(MAGIC));
+    return stream && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+  }
+
+  void WriteGeometry(std::ostream &stream, const mitk::Geometry3D *geometry)
+  {
+    WriteValue(stream, static_cast<uint8_t>(geometry != nullptr));
+    if (geometry == nullptr)
+      return;
+
+    const mitk::AffineTransform3D *transform = geometry->GetIndexToWorldTransform();
+    const mitk::AffineTransform3D::MatrixType &matrix = transform->GetMatrix();
+    const mitk::AffineTransform3D::OffsetType &offset = transform->GetOffset();
+    const mitk::BaseGeometry::BoundsArrayType &bounds = geometry->GetBounds();
+
+    for (unsigned int i = 0; i < 3; ++i)
+      for (unsigned int j = 0; j < 3; ++j)
+        WriteValue(stream, static_cast<double>(matrix[i][j]));
+    for (unsigned int i = 0; i < 3; ++i)
+      WriteValue(stream, static_cast<double>(offset[i]));
+    for (unsigned int i = 0; i < 6; ++i)
+      WriteValue(stream, static_cast<double>(bounds[i]));
+    WriteValue(stream, static_cast<uint32_t>(geometry->GetFrameOfReferenceID()));
+    WriteValue(stream, static_cast<uint8_t>(geometry->GetImageGeometry()));
+  }
+
+  mitk::Geometry3D::Pointer ReadGeometry(std::istream &stream)
+  {
+    if (ReadValue<uint8_t>(stream) == 0)
+      return nullptr;
+
+    mitk::AffineTransform3D::MatrixType matrix;
+    mitk::AffineTransform3D::OffsetType offset;
+    mitk::BaseGeometry::BoundsArrayType bounds;
+
+    for (unsigned int i = 0; i < 3; ++i)
+      for (unsigned int j = 0; j < 3; ++j)
+        matrix[i][j] = ReadValue<double>(stream);
+    for (unsigned int i = 0; i < 3; ++i)
+      offset[i] = ReadValue<double>(stream);
+    for (unsigned int i = 0; i < 6; ++i)
+      bounds[i] = ReadValue<double>(stream);
+    const auto frameOfReferenceID = ReadValue<uint32_t>(stream);
+    const bool isImageGeometry = ReadValue<uint8_t>(stream) != 0;
+
+    mitk::AffineTransform3D::Pointer transform = mitk::AffineTransform3D::New();
+    transform->SetMatrix(matrix);
+    transform->SetOffset(offset);
+
+    mitk::Geometry3D::Pointer geometry = mitk::Geometry3D::New();
+    geometry->SetFrameOfReferenceID(frameOfReferenceID);
+    geometry->SetImageGeometry(isImageGeometry);
+    geometry->SetIndexToWorldTransform(transform);
+    geometry->SetBounds(bounds);
+    return geometry;
+  }
+}
+
+namespace mitk
+{
+  PointSetBinaryIO::PointSetBinaryIO()
+    : AbstractFileIO(PointSet::GetStaticNameOfClass(), IOMimeTypes::POINTSET_BINARY_MIMETYPE(), "MITK Binary Point Set")
+  {
+    this->RegisterService();
+  }
+
+  std::vector<BaseData::Pointer> PointSetBinaryIO::Read()
+  {
+    InputStream stream(this, std::ios_base::in | std::ios_base::binary);
+
+    if (!ReadMagic(stream))
+      mitkThrow() << "Not a MITK binary point set file.";
+
+    if (ReadValue<uint32_t>(stream) != VERSION)
+      mitkThrow() << "Unsupported version of MITK binary point set file.";
+
+    if (ReadValue<uint32_t>(stream) != BYTE_ORDER_MARK)
+      mitkThrow() << "MITK binary point set file was written with a different byte order.";
+
+    const auto numberOfTimeSteps = ReadValue<uint32_t>(stream);
+
+    PointSet::Pointer pointSet = PointSet::New();
+
+    // time geometry assembled for addition after all points
+    // else the SetPoint method would already transform the points that we provide it
+    ProportionalTimeGeometry::Pointer timeGeometry = ProportionalTimeGeometry::New();
+
+    std::vector<uint64_t> ids;
+    std::vector<int32_t> specifications;
+    std::vector<double> coordinates;
+
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      timeGeometry->Expand(t + 1);
+      Geometry3D::Pointer geometry = ReadGeometry(stream);
+      if (geometry.IsNotNull())
+        timeGeometry->SetTimeStepGeometry(geometry, t);
+
+      const auto numberOfPoints = ReadValue<uint32_t>(stream);
+      ReadArray(stream, ids, numberOfPoints);
+      ReadArray(stream, specifications, numberOfPoints);
+      ReadArray(stream, coordinates, 3 * static_cast<std::size_t>(numberOfPoints));
+
+      pointSet->Expand(t + 1);
+      for (std::size_t i = 0; i < numberOfPoints; ++i)
+      {
+        Point3D point;
+        FillVector3D(point, coordinates[3 * i], coordinates[3 * i + 1], coordinates[3 * i + 2]);
+        pointSet->SetPoint(ids[i], point, static_cast<PointSpecificationType>(specifications[i]), t);
+      }
+    }
+
+    pointSet->SetTimeGeometry(timeGeometry);
+
+    std::vector<BaseData::Pointer> result;
+    result.push_back(pointSet.GetPointer());
+    return result;
+  }
+
+  IFileIO::ConfidenceLevel PointSetBinaryIO::GetReaderConfidenceLevel() const
+  {
+    if (AbstractFileIO::GetReaderConfidenceLevel() == Unsupported)
+      return Unsupported;
+
+    if (this->GetInputStream() == nullptr)
+    {
+      std::ifstream file(this->GetInputLocation().c_str(), std::ios::in | std::ios::binary);
+      return ReadMagic(file) ? Supported : Unsupported;
+    }
+
+    return Supported;
+  }
+
+  void PointSetBinaryIO::Write()
+  {
+    const auto *pointSet = dynamic_cast<const PointSet *>(this->GetInput());
+    if (pointSet == nullptr)
+      mitkThrow() << "Cannot write non-point set data";
+
+    OutputStream stream(this, std::ios_base::out | std::ios_base::trunc | std::ios_base::binary);
+
+    stream.write(MAGIC, sizeof(MAGIC));
+    WriteValue(stream, VERSION);
+    WriteValue(stream, BYTE_ORDER_MARK);
+
+    const unsigned int numberOfTimeSteps = pointSet->GetTimeSteps();
+    WriteValue(stream, static_cast<uint32_t>(numberOfTimeSteps));
+
+    std::vector<uint64_t> ids;
+    std::vector<int32_t> specifications;
+    std::vector<double> coordinates;
+
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      const auto *geometry = dynamic_cast<const Geometry3D *>(pointSet->GetGeometry(t));
+      if (geometry == nullptr)
+      {
+        MITK_WARN << "Writing a PointSet with something other that a Geometry3D. This is not foreseen and not handled.";
+      }
+      WriteGeometry(stream, geometry);
+
+      const PointSet::DataType *mesh = pointSet->GetPointSet(t);
+      const PointSet::PointsContainer *points = mesh->GetPoints();
+      const PointSet::PointDataContainer *pointData = mesh->GetPointData();
+
+      ids.clear();
+      specifications.clear();
+      coordinates.clear();
+      ids.reserve(points->Size());
+      specifications.reserve(points->Size());
+      coordinates.reserve(3 * points->Size());
+
+      // points are stored in index coordinates, like in the XML format
+      for (auto it = points->Begin(); it != points->End(); ++it)
+      {
+        PointSet::PointDataType data;
+        data.pointSpec = PTUNDEFINED;
+        if (pointData != nullptr)
+          pointData->GetElementIfIndexExists(it->Index(), &data);
+
+        ids.push_back(it->Index());
+        specifications.push_back(data.pointSpec);
+        coordinates.push_back(it->Value()[0]);
+        coordinates.push_back(it->Value()[1]);
+        coordinates.push_back(it->Value()[2]);
+      }
+
+      WriteValue(stream, static_cast<uint32_t>(ids.size()));
+      WriteArray(stream, ids);
+      WriteArray(stream, specifications);
+      WriteArray(stream, coordinates);
+    }
+
+    if (!stream.good())
+      mitkThrow() << "Some error during point set writing.";
+  }
+
+  PointSetBinaryIO *PointSetBinaryIO::IOClone() const { return new PointSetBinaryIO(*this); }
+}
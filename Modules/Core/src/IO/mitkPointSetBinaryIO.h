@@ -0,0 +1,63 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKPOINTSETBINARYIO_H
+#define MITKPOINTSETBINARYIO_H
+
+#include "mitkAbstractFileIO.h"
+
+namespace mitk
+{
+  /**
+   * @internal
+   *
+   * @brief Binary reader and writer for mitk::PointSet
+   *
+   * Stores the same information as the XML format (geometry, point ids,
+   * specifications and coordinates of every time step), but as packed arrays
+   * which are written and read with one stream operation per time step.
+   *
+   * File layout (all values in native byte order, checked by a byte order mark):
+   * \verbatim
+   * header      magic "MITKBPTS", version, byte order mark, number of time steps
+   * time step   geometry flag, [index to world matrix and offset, bounds, frame of reference id, image geometry flag],
+   *             number of points n, ids[n], specifications[n], index coordinates[3n]
+   * \endverbatim
+   *
+   * @ingroup IO
+   */
+  class PointSetBinaryIO : public AbstractFileIO
+  {
+  public:
+    PointSetBinaryIO();
+
+    // -------------- AbstractFileReader -------------
+
+    using AbstractFileReader::Read;
+    std::vector<BaseData::Pointer> Read() override;
+
+    ConfidenceLevel GetReaderConfidenceLevel() const override;
+
+    // -------------- AbstractFileWriter -------------
+
+    void Write() override;
+
+  private:
+    PointSetBinaryIO *IOClone() const override;
+  };
+}
+
+#endif // MITKPOINTSETBINARYIO_H
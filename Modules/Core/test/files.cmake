@@ -36,6 +36,7 @@ set(MODULE_TESTS
   mitkGeometryDataIOTest.cpp
   mitkGeometryDataToSurfaceFilterTest.cpp
   mitkImageCastTest.cpp
+  mitkImageChunkedIOTest.cpp
   mitkImageEqualTest.cpp
   mitkImageDataItemTest.cpp
   mitkImageGeneratorTest.cpp
@@ -45,7 +46,10 @@ set(MODULE_TESTS
   mitkGrabItkImageMemoryTest.cpp
   mitkInstantiateAccessFunctionTest.cpp
   mitkLevelWindowTest.cpp
+  mitkLimitedLinearUndoTest.cpp
   mitkMessageTest.cpp
+  mitkMimeTypeProviderTest.cpp
+  mitkParallelForTest.cpp
   mitkPixelTypeTest.cpp
   mitkPlaneGeometryTest.cpp
   mitkPointSetTest.cpp
@@ -0,0 +1,216 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include "mitkFileReaderRegistry.h"
+#include "mitkFileWriterRegistry.h"
+#include "mitkIOMimeTypes.h"
+#include "mitkIOUtil.h"
+#include "mitkImageGenerator.h"
+#include "mitkImageReadAccessor.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+/**
+ \brief Reader/Writer test for the chunked MITK image format (via IOUtil).
+
+ Tests whether images survive a round trip through the chunked format,
+ whether single time steps and slice ranges can be read separately and
+ whether corrupt files are rejected before large amounts of memory are allocated.
+*/
+class mitkImageChunkedIOTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageChunkedIOTestSuite);
+  MITK_TEST(RoundTrip3D);
+  MITK_TEST(RoundTrip4D);
+  MITK_TEST(ReadSliceRange);
+  MITK_TEST(ReadTimeStep);
+  MITK_TEST(ReadFromStreamWithOffset);
+  MITK_TEST(ReadInvalidTimeStep);
+  MITK_TEST(ReadCorruptHeader);
+  MITK_TEST(ReadTruncatedFile);
+  MITK_TEST(StreamConfidenceLevel);
+  CPPUNIT_TEST_SUITE_END();
+
+  mitk::Image::Pointer m_Image3D;
+  mitk::Image::Pointer m_Image4D;
+  std::string m_FileName;
+
+public:
+  void setUp() override
+  {
+    m_Image3D = mitk::ImageGenerator::GenerateRandomImage<short>(20, 15, 11, 1, 0.5, 0.7, 1.5);
+    m_Image4D = mitk::ImageGenerator::GenerateRandomImage<float>(10, 12, 7, 3, 1.0, 1.0, 2.0);
+    m_FileName = mitk::IOUtil::CreateTemporaryFile("chunked-XXXXXX.mitkimg");
+  }
+
+  void tearDown() override
+  {
+    m_Image3D = nullptr;
+    m_Image4D = nullptr;
+    std::remove(m_FileName.c_str());
+  }
+
+  void Save(const mitk::Image *image, int slicesPerChunk)
+  {
+    mitk::IFileWriter::Options options;
+    options["Slices per chunk"] = slicesPerChunk;
+    mitk::IOUtil::Save(image, m_FileName, options);
+  }
+
+  mitk::Image::Pointer Load(int timeStep, int firstSlice, int numberOfSlices)
+  {
+    mitk::IFileReader::Options options;
+    options["Time step"] = timeStep;
+    options["First slice"] = firstSlice;
+    options["Number of slices"] = numberOfSlices;
+    return mitk::IOUtil::Load<mitk::Image>(m_FileName, options);
+  }
+
+  void RoundTrip3D()
+  {
+    this->Save(m_Image3D, 4);
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(m_FileName);
+    MITK_ASSERT_EQUAL(image, m_Image3D, "Read image should be equal to the written image.");
+  }
+
+  void RoundTrip4D()
+  {
+    this->Save(m_Image4D, 1);
+    mitk::Image::Pointer image = mitk::IOUtil::Load<mitk::Image>(m_FileName);
+    MITK_ASSERT_EQUAL(image, m_Image4D, "Read image should be equal to the written image.");
+  }
+
+  void ReadSliceRange()
+  {
+    this->Save(m_Image3D, 4);
+    mitk::Image::Pointer image = this->Load(-1, 3, 6);
+
+    CPPUNIT_ASSERT_EQUAL(6u, image->GetDimension(2));
+
+    const size_t sliceSize = sizeof(short) * m_Image3D->GetDimension(0) * m_Image3D->GetDimension(1);
+    mitk::ImageReadAccessor originalAccessor(m_Image3D);
+    mitk::ImageReadAccessor accessor(image);
+    CPPUNIT_ASSERT(std::memcmp(static_cast<const char *>(originalAccessor.GetData()) + 3 * sliceSize,
+                               accessor.GetData(),
+                               6 * sliceSize) == 0);
+
+    mitk::Point3D firstSliceIndex;
+    mitk::FillVector3D(firstSliceIndex, 0, 0, 3);
+    mitk::Point3D expectedOrigin;
+    m_Image3D->GetGeometry()->IndexToWorld(firstSliceIndex, expectedOrigin);
+    MITK_ASSERT_EQUAL(image->GetGeometry()->GetOrigin(), expectedOrigin, "Origin should be moved to the first slice.");
+  }
+
+  void ReadTimeStep()
+  {
+    this->Save(m_Image4D, 3);
+    mitk::Image::Pointer image = this->Load(2, 0, 0);
+
+    CPPUNIT_ASSERT_EQUAL(3u, image->GetDimension());
+    CPPUNIT_ASSERT_EQUAL(m_Image4D->GetDimension(2), image->GetDimension(2));
+
+    mitk::ImageReadAccessor originalAccessor(m_Image4D, m_Image4D->GetVolumeData(2));
+    mitk::ImageReadAccessor accessor(image);
+    const size_t volumeSize =
+      sizeof(float) * m_Image4D->GetDimension(0) * m_Image4D->GetDimension(1) * m_Image4D->GetDimension(2);
+    CPPUNIT_ASSERT(std::memcmp(originalAccessor.GetData(), accessor.GetData(), volumeSize) == 0);
+  }
+
+  void ReadFromStreamWithOffset()
+  {
+    // the chunked image does not start at the beginning of the stream
+    const std::string prefix = "other data";
+    std::stringstream stream;
+    stream << prefix;
+
+    mitk::FileWriterRegistry writerRegistry;
+    std::vector<mitk::IFileWriter *> writers =
+      writerRegistry.GetWriters(m_Image3D, mitk::IOMimeTypes::MITK_CHUNKED_IMAGE_MIMETYPE().GetName());
+    CPPUNIT_ASSERT(!writers.empty());
+    writers.front()->SetInput(m_Image3D);
+    writers.front()->SetOutputStream(m_FileName, &stream);
+    writers.front()->Write();
+
+    stream.seekg(prefix.size());
+    mitk::FileReaderRegistry readerRegistry;
+    std::vector<mitk::IFileReader *> readers =
+      readerRegistry.GetReaders(mitk::FileReaderRegistry::GetMimeTypeForFile(m_FileName));
+    CPPUNIT_ASSERT(!readers.empty());
+    readers.front()->SetInput(m_FileName, &stream);
+    std::vector<mitk::BaseData::Pointer> data = readers.front()->Read();
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), data.size());
+    mitk::Image::Pointer image = dynamic_cast<mitk::Image *>(data.front().GetPointer());
+    MITK_ASSERT_EQUAL(image, m_Image3D, "Read image should be equal to the written image.");
+  }
+
+  void ReadInvalidTimeStep()
+  {
+    this->Save(m_Image4D, 1);
+    CPPUNIT_ASSERT_THROW(this->Load(-2, 0, 0), mitk::Exception);
+  }
+
+  void ReadCorruptHeader()
+  {
+    this->Save(m_Image3D, 4);
+
+    // number of time steps: behind magic, version, byte order mark, pixel type and the first three dimensions
+    const std::streamoff timeStepsOffset = 8 + 4 * 4 + 4 * 2 + 4 * 3;
+    const uint32_t numberOfTimeSteps = 0xFFFFFFFF;
+    std::fstream file(m_FileName, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(timeStepsOffset);
+    file.write(reinterpret_cast<const char *>(&numberOfTimeSteps), sizeof(numberOfTimeSteps));
+    file.close();
+
+    CPPUNIT_ASSERT_THROW(mitk::IOUtil::Load<mitk::Image>(m_FileName), mitk::Exception);
+  }
+
+  void ReadTruncatedFile()
+  {
+    this->Save(m_Image3D, 4);
+
+    std::ifstream input(m_FileName, std::ios::in | std::ios::binary);
+    const std::string content((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+    input.close();
+
+    std::ofstream output(m_FileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    output.write(content.data(), content.size() / 2);
+    output.close();
+
+    CPPUNIT_ASSERT_THROW(mitk::IOUtil::Load<mitk::Image>(m_FileName), mitk::Exception);
+  }
+
+  void StreamConfidenceLevel()
+  {
+    std::stringstream stream("not a chunked image");
+
+    mitk::FileReaderRegistry readerRegistry;
+    std::vector<mitk::IFileReader *> readers =
+      readerRegistry.GetReaders(mitk::FileReaderRegistry::GetMimeTypeForFile(m_FileName));
+    CPPUNIT_ASSERT(!readers.empty());
+    readers.front()->SetInput(m_FileName, &stream);
+    CPPUNIT_ASSERT_EQUAL(mitk::IFileReader::Unsupported, readers.front()->GetConfidenceLevel());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageChunkedIO)
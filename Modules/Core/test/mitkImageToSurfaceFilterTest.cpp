@@ -19,6 +19,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkTestingMacros.h"
 
 #include <mitkIOUtil.h>
+#include <mitkImageReadAccessor.h>
 
 bool CompareSurfacePointPositions(mitk::Surface::Pointer s1, mitk::Surface::Pointer s2)
 {
@@ -48,6 +49,8 @@ class mitkImageToSurfaceFilterTestSuite : public mitk::TestFixture
   MITK_TEST(testDecimatePromeshDecimation);
   MITK_TEST(testQuadricDecimation);
   MITK_TEST(testSmoothingOfSurface);
+  MITK_TEST(testFlyingEdges);
+  MITK_TEST(testTimeSteps);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -149,6 +152,68 @@ public:
     CPPUNIT_ASSERT_MESSAGE("Testing smoothing of surface changes point data!",
                            CompareSurfacePointPositions(testSurface1, testSurface4));
   }
+
+  void testFlyingEdges()
+  {
+    mitk::ImageToSurfaceFilter::Pointer testObject = mitk::ImageToSurfaceFilter::New();
+    testObject->SetInput(m_BallImage);
+    testObject->Update();
+    mitk::Surface::Pointer marchingCubesSurface = testObject->GetOutput()->Clone();
+
+    testObject->SetIsosurface(mitk::ImageToSurfaceFilter::FlyingEdges);
+    testObject->Update();
+    mitk::Surface::Pointer flyingEdgesSurface = testObject->GetOutput()->Clone();
+
+    double marchingCubesBounds[6];
+    double flyingEdgesBounds[6];
+    marchingCubesSurface->GetVtkPolyData()->GetBounds(marchingCubesBounds);
+    flyingEdgesSurface->GetVtkPolyData()->GetBounds(flyingEdgesBounds);
+
+    CPPUNIT_ASSERT_MESSAGE("Testing flying edges creates the same number of points!",
+                           marchingCubesSurface->GetVtkPolyData()->GetNumberOfPoints() ==
+                             flyingEdgesSurface->GetVtkPolyData()->GetNumberOfPoints());
+    for (unsigned int i = 0; i < 6; ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Testing flying edges creates the same surface!",
+                             mitk::Equal(marchingCubesBounds[i], flyingEdgesBounds[i], mitk::eps));
+    }
+    CPPUNIT_ASSERT_MESSAGE("Testing stage timings are reported!",
+                           testObject->GetStageTimings().Total >= testObject->GetStageTimings().Isosurface);
+  }
+
+  void testTimeSteps()
+  {
+    const unsigned int numberOfTimeSteps = 4;
+
+    unsigned int dimensions[4];
+    std::copy(m_BallImage->GetDimensions(), m_BallImage->GetDimensions() + 3, dimensions);
+    dimensions[3] = numberOfTimeSteps;
+
+    mitk::Image::Pointer timeImage = mitk::Image::New();
+    timeImage->Initialize(m_BallImage->GetPixelType(), 4, dimensions);
+    timeImage->GetGeometry()->SetSpacing(m_BallImage->GetGeometry()->GetSpacing());
+
+    mitk::ImageReadAccessor readAccess(m_BallImage);
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+      timeImage->SetVolume(readAccess.GetData(), t);
+
+    mitk::ImageToSurfaceFilter::Pointer testObject = mitk::ImageToSurfaceFilter::New();
+    testObject->SetInput(m_BallImage);
+    testObject->Update();
+    const vtkIdType numberOfPoints = testObject->GetOutput()->GetVtkPolyData()->GetNumberOfPoints();
+
+    testObject->SetInput(timeImage);
+    testObject->Update();
+    mitk::Surface::Pointer resultSurface = testObject->GetOutput();
+
+    CPPUNIT_ASSERT_MESSAGE("Testing a surface is created for every time step!",
+                           resultSurface->GetTimeSteps() == numberOfTimeSteps);
+    for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Testing every time step is converted!",
+                             resultSurface->GetVtkPolyData(t)->GetNumberOfPoints() == numberOfPoints);
+    }
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkImageToSurfaceFilter)
@@ -0,0 +1,118 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkInteractionConst.h"
+#include "mitkLimitedLinearUndo.h"
+#include "mitkOperation.h"
+#include "mitkOperationEvent.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+namespace
+{
+  int g_NumberOfOperations = 0;
+
+  /**
+  * @brief Operation pretending to hold a large amount of memory, counts its instances
+  **/
+  class LargeTestOperation : public mitk::Operation
+  {
+  public:
+    LargeTestOperation() : Operation(mitk::OpTEST) { g_NumberOfOperations++; }
+    ~LargeTestOperation() override { g_NumberOfOperations--; }
+    std::size_t GetMemorySize() const override { return 1000; }
+  };
+} // namespace
+
+/**
+ * @brief Tests the limits on the number and on the memory of the items of mitk::LimitedLinearUndo.
+ */
+class mitkLimitedLinearUndoTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLimitedLinearUndoTestSuite);
+  MITK_TEST(SetUndoLimit_DeletesDroppedItems);
+  MITK_TEST(SetOperationEvent_ExceedingMemoryLimit_DropsOldestItems);
+  MITK_TEST(SetUndoMemoryLimit_BelowMostRecentItem_KeepsMostRecentItem);
+  MITK_TEST(SetUndoMemoryLimit_AfterUndoAndRedo_AccountsForMovedItems);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::LimitedLinearUndo::Pointer m_UndoModel;
+
+  void AddOperationEvent()
+  {
+    auto *operationEvent = new mitk::OperationEvent(nullptr, new LargeTestOperation, new LargeTestOperation, "Test");
+    m_UndoModel->SetOperationEvent(operationEvent);
+    mitk::OperationEvent::IncCurrObjectEventId();
+  }
+
+public:
+  void setUp() override
+  {
+    g_NumberOfOperations = 0;
+    m_UndoModel = mitk::LimitedLinearUndo::New();
+    m_UndoModel->SetUndoMemoryLimit(0);
+  }
+
+  void tearDown() override { m_UndoModel = nullptr; }
+
+  void SetUndoLimit_DeletesDroppedItems()
+  {
+    for (int i = 0; i < 3; ++i)
+      this->AddOperationEvent();
+
+    m_UndoModel->SetUndoLimit(1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Dropped operation events were not deleted", 2, g_NumberOfOperations);
+  }
+
+  void SetOperationEvent_ExceedingMemoryLimit_DropsOldestItems()
+  {
+    // a bit more than two operation events
+    m_UndoModel->SetUndoMemoryLimit(4500);
+
+    for (int i = 0; i < 3; ++i)
+      this->AddOperationEvent();
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Oldest operation event was not dropped", 4, g_NumberOfOperations);
+  }
+
+  void SetUndoMemoryLimit_BelowMostRecentItem_KeepsMostRecentItem()
+  {
+    for (int i = 0; i < 3; ++i)
+      this->AddOperationEvent();
+
+    m_UndoModel->SetUndoMemoryLimit(1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Most recent operation event was not kept", 2, g_NumberOfOperations);
+  }
+
+  void SetUndoMemoryLimit_AfterUndoAndRedo_AccountsForMovedItems()
+  {
+    for (int i = 0; i < 2; ++i)
+      this->AddOperationEvent();
+
+    // only a single item is left in the undo list, the redo list is not limited
+    m_UndoModel->Undo();
+    m_UndoModel->SetUndoMemoryLimit(2500);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Operation event in the redo list was dropped", 4, g_NumberOfOperations);
+
+    // the redone item is accounted for again
+    m_UndoModel->Redo();
+    m_UndoModel->SetUndoMemoryLimit(2600);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Redone operation event was not accounted for", 2, g_NumberOfOperations);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLimitedLinearUndo)
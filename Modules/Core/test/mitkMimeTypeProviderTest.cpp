@@ -0,0 +1,159 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <mitkCoreServices.h>
+#include <mitkCustomMimeType.h>
+#include <mitkIMimeTypeProvider.h>
+#include <mitkIOUtil.h>
+#include <usModuleContext.h>
+
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+
+#ifdef _WIN32
+#include <sys/utime.h>
+#else
+#include <utime.h>
+#endif
+
+namespace
+{
+  /** Mime-type with a content check which counts how often it is called. */
+  class CountingMimeType : public mitk::CustomMimeType
+  {
+  public:
+    CountingMimeType(int *numberOfChecks) : CustomMimeType("CountingTestMimeType"), m_NumberOfChecks(numberOfChecks)
+    {
+      this->SetCategory("Test");
+    }
+
+    bool AppliesTo(const std::string &path) const override
+    {
+      ++(*m_NumberOfChecks);
+      return path.find("mimetypeprovidertest") != std::string::npos;
+    }
+
+    CountingMimeType *Clone() const override { return new CountingMimeType(*this); }
+
+  private:
+    int *m_NumberOfChecks;
+  };
+
+  void WriteFile(const std::string &path, const std::string &content, std::time_t modifiedTime)
+  {
+    {
+      std::ofstream file(path.c_str(), std::ios::binary | std::ios::trunc);
+      file << content;
+    }
+
+    utimbuf times;
+    times.actime = modifiedTime;
+    times.modtime = modifiedTime;
+    utime(path.c_str(), &times);
+  }
+} // namespace
+
+/**
+ * @brief Tests that the content checks of mitk::MimeTypeProvider are cached only for unchanged files.
+ */
+class mitkMimeTypeProviderTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkMimeTypeProviderTestSuite);
+  MITK_TEST(GetMimeTypesForFile_UnchangedFile_IsCheckedOnce);
+  MITK_TEST(GetMimeTypesForFile_ChangedSize_IsCheckedAgain);
+  MITK_TEST(GetMimeTypesForFile_ChangedModificationTime_IsCheckedAgain);
+  MITK_TEST(GetMimeTypesForFile_RecentlyModifiedFile_IsAlwaysChecked);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  int m_NumberOfChecks;
+  CountingMimeType *m_MimeType;
+  us::ServiceRegistration<mitk::CustomMimeType> m_Registration;
+  std::string m_FilePath;
+  std::time_t m_OldTime;
+
+  bool AppliesTo()
+  {
+    mitk::CoreServicePointer<mitk::IMimeTypeProvider> provider(mitk::CoreServices::GetMimeTypeProvider());
+    for (const auto &mimeType : provider->GetMimeTypesForFile(m_FilePath))
+    {
+      if (mimeType.GetName() == "CountingTestMimeType")
+        return true;
+    }
+    return false;
+  }
+
+public:
+  void setUp() override
+  {
+    m_NumberOfChecks = 0;
+    m_MimeType = new CountingMimeType(&m_NumberOfChecks);
+    m_Registration = us::GetModuleContext()->RegisterService<mitk::CustomMimeType>(m_MimeType);
+
+    std::ofstream tmpStream;
+    m_FilePath = mitk::IOUtil::CreateTemporaryFile(tmpStream, "mimetypeprovidertest-XXXXXX.test");
+    tmpStream.close();
+
+    m_OldTime = std::time(nullptr) - 60;
+    WriteFile(m_FilePath, "content", m_OldTime);
+  }
+
+  void tearDown() override
+  {
+    m_Registration.Unregister();
+    delete m_MimeType;
+    std::remove(m_FilePath.c_str());
+  }
+
+  void GetMimeTypesForFile_UnchangedFile_IsCheckedOnce()
+  {
+    CPPUNIT_ASSERT_MESSAGE("Mime-type does not apply", this->AppliesTo());
+    CPPUNIT_ASSERT_MESSAGE("Mime-type does not apply", this->AppliesTo());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Unchanged file was checked again", 1, m_NumberOfChecks);
+  }
+
+  void GetMimeTypesForFile_ChangedSize_IsCheckedAgain()
+  {
+    this->AppliesTo();
+    WriteFile(m_FilePath, "changed content", m_OldTime);
+    this->AppliesTo();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("File with changed size was not checked again", 2, m_NumberOfChecks);
+  }
+
+  void GetMimeTypesForFile_ChangedModificationTime_IsCheckedAgain()
+  {
+    this->AppliesTo();
+    WriteFile(m_FilePath, "CONTENT", m_OldTime + 10);
+    this->AppliesTo();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("File with changed modification time was not checked again", 2, m_NumberOfChecks);
+  }
+
+  void GetMimeTypesForFile_RecentlyModifiedFile_IsAlwaysChecked()
+  {
+    // A file rewritten with the same size within the resolution of the modification time
+    // is indistinguishable from the original one, so recently modified files are not cached
+    WriteFile(m_FilePath, "CONTENT", std::time(nullptr));
+    this->AppliesTo();
+    this->AppliesTo();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Recently modified file was not checked again", 2, m_NumberOfChecks);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkMimeTypeProvider)
@@ -0,0 +1,92 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkParallelFor.h"
+#include "mitkTestFixture.h"
+#include "mitkTestingMacros.h"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief Tests that mitk::ParallelFor and mitk::ParallelForChunks visit every item exactly once.
+ */
+class mitkParallelForTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkParallelForTestSuite);
+  MITK_TEST(ParallelFor_VisitsEveryItemOnce);
+  MITK_TEST(ParallelFor_ThrowingTask_RethrowsException);
+  MITK_TEST(ParallelForChunks_CoversRangeWithoutGaps);
+  MITK_TEST(GetNumberOfParallelChunks_RespectsMinimumChunkSize);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void ParallelFor_VisitsEveryItemOnce()
+  {
+    std::vector<std::atomic<int>> visits(1000);
+    for (auto &visit : visits)
+      visit = 0;
+
+    mitk::ParallelFor(visits.size(), [&visits](std::size_t i) { ++visits[i]; });
+
+    for (const auto &visit : visits)
+      CPPUNIT_ASSERT_EQUAL_MESSAGE("Item was not visited exactly once", 1, visit.load());
+  }
+
+  void ParallelFor_ThrowingTask_RethrowsException()
+  {
+    CPPUNIT_ASSERT_THROW(mitk::ParallelFor(100,
+                                           [](std::size_t i) {
+                                             if (50 == i)
+                                               throw std::runtime_error("Test");
+                                           }),
+                         std::runtime_error);
+  }
+
+  void ParallelForChunks_CoversRangeWithoutGaps()
+  {
+    const std::size_t count = 1001;
+    const std::size_t numberOfChunks = mitk::GetNumberOfParallelChunks(count);
+    std::vector<std::size_t> begins(numberOfChunks);
+    std::vector<std::size_t> ends(numberOfChunks);
+
+    mitk::ParallelForChunks(count, [&](std::size_t begin, std::size_t end, std::size_t chunk) {
+      begins[chunk] = begin;
+      ends[chunk] = end;
+    });
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("First chunk does not start at zero", std::size_t(0), begins.front());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Last chunk does not end at count", count, ends.back());
+    for (std::size_t chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Chunk is empty", begins[chunk] < ends[chunk]);
+      if (chunk > 0)
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Chunks are not consecutive", ends[chunk - 1], begins[chunk]);
+    }
+  }
+
+  void GetNumberOfParallelChunks_RespectsMinimumChunkSize()
+  {
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Empty range has chunks", std::size_t(0), mitk::GetNumberOfParallelChunks(0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE(
+      "Range smaller than the minimum chunk size is split", std::size_t(1), mitk::GetNumberOfParallelChunks(63, 64));
+    CPPUNIT_ASSERT_MESSAGE("Chunk is smaller than the minimum chunk size",
+                           mitk::GetNumberOfParallelChunks(200, 64) <= 3);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkParallelFor)
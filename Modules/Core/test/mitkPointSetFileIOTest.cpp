@@ -103,14 +103,14 @@ public:
                         "Restored geometry must equal original one.");
   }
 
-  bool PointSetWrite(mitk::BaseGeometry *geometry = nullptr)
+  bool PointSetWrite(mitk::BaseGeometry *geometry = nullptr, const std::string &extension = ".mps")
   {
     try
     {
       m_SavedPointSet = nullptr;
 
       std::ofstream tmpStream;
-      m_FilePath = mitk::IOUtil::CreateTemporaryFile(tmpStream) + ".mps";
+      m_FilePath = mitk::IOUtil::CreateTemporaryFile(tmpStream) + extension;
       MITK_INFO << "PointSet test file at " << m_FilePath;
       mitk::IOUtil::Save(CreateTestPointSet(geometry), m_FilePath);
     }
@@ -187,6 +187,19 @@ int mitkPointSetFileIOTest(int, char *[])
 
     MITK_TEST_CONDITION(test.PointSetWrite(g), "Testing if the PointSetWriter writes Data _with_ geometry");
     test.PointSetLoadAndCompareTest(); // load - compare
+
+    // binary format
+    mitkPointSetFileIOTestClass binaryTest;
+    MITK_TEST_CONDITION(binaryTest.PointSetWrite(g, ".mpsb"),
+                        "Testing if the binary PointSet writer writes Data _with_ geometry");
+    binaryTest.PointSetLoadAndCompareTest(); // load - compare
+  }
+
+  // binary format with identity geometry
+  {
+    mitkPointSetFileIOTestClass test;
+    MITK_TEST_CONDITION(test.PointSetWrite(nullptr, ".mpsb"), "Testing if the binary PointSet writer writes Data");
+    test.PointSetLoadAndCompareTest(); // load - compare
   }
 
   MITK_TEST_END();
@@ -67,6 +67,25 @@ class MITKDICOMREADER_EXPORT DICOMDatasetAccess
     */
     virtual FindingsListType GetTagValueAsString(const DICOMTagPath& path) const = 0;
 
+    /** \brief Return the value of the tag parsed as a floating point number.
+    This is the numeric sort key used by DICOMSortByTag. The default implementation parses
+    the string returned by GetTagValueAsString() on every call; implementations
+    may cache the parsed value (see DICOMDatasetAccessingImageFrameInfo).
+    \param tag Tag which value should be retreived.
+    \param successful Indicates if the tag was present.
+    */
+    virtual double GetTagValueAsDouble(const DICOMTag& tag, bool& successful) const;
+
+    /** \brief Return (0020,0032) Image Position (Patient) as a point.
+    \param successful Indicates if the dataset contains a non-empty position value that could be converted to a point.
+    */
+    virtual Point3D GetImagePositionPatient(bool& successful) const;
+
+    /** \brief Return (0020,0037) Image Orientation (Patient) as row and column direction vectors.
+    \param successful Indicates if the orientation could be parsed.
+    */
+    virtual void GetImageOrientationPatient(Vector3D& right, Vector3D& up, bool& successful) const;
+
     virtual ~DICOMDatasetAccess() {};
 };
 
@@ -22,6 +22,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "MitkDICOMReaderExports.h"
 
+#include <map>
+
 namespace mitk
 {
   /**
@@ -31,17 +33,50 @@ namespace mitk
     This abstract base class extends the DICOMImageFrameInfo by the DICOMDatasetAccess interface.
     This allows to directly query for tag values of a frame/file specified by the info.
     DICOMGDCMImageFrameInfo is an example for a concrete implementation.
+
+    The numeric sort keys (GetTagValueAsDouble(), GetImagePositionPatient(),
+    GetImageOrientationPatient()) are parsed only once per frame and cached,
+    so sorters can compare frames without re-parsing tag strings. Sorting
+    typically calls these methods O(n log n) times on the same n frames.
+    Derived classes that change tag values after construction have to call
+    InvalidateSortKeys().
+
+    \note The cache is filled lazily and is not protected against concurrent first access.
   */
   class MITKDICOMREADER_EXPORT DICOMDatasetAccessingImageFrameInfo : public DICOMImageFrameInfo, public DICOMDatasetAccess
   {
     public:
       mitkClassMacro(DICOMDatasetAccessingImageFrameInfo, DICOMImageFrameInfo);
 
+      double GetTagValueAsDouble(const DICOMTag& tag, bool& successful) const override;
+      Point3D GetImagePositionPatient(bool& successful) const override;
+      void GetImageOrientationPatient(Vector3D& right, Vector3D& up, bool& successful) const override;
+
   protected:
       DICOMDatasetAccessingImageFrameInfo(const std::string& filename = "", unsigned int frameNo = 0);
       ~DICOMDatasetAccessingImageFrameInfo() override;
 
+      /** Discards all cached sort keys. Must be called whenever tag values of the frame change. */
+      void InvalidateSortKeys();
+
     private:
+      struct NumericValue
+      {
+        double value;
+        bool successful;
+      };
+
+      mutable std::map<DICOMTag, NumericValue> m_NumericTagValues;
+
+      mutable bool m_PositionParsed;
+      mutable bool m_HasPosition;
+      mutable Point3D m_Position;
+
+      mutable bool m_OrientationParsed;
+      mutable bool m_HasOrientation;
+      mutable Vector3D m_OrientationRight;
+      mutable Vector3D m_OrientationUp;
+
       DICOMDatasetAccessingImageFrameInfo(const DICOMDatasetAccessingImageFrameInfo::Pointer& frameinfo);
       Self& operator = (const Self& frameinfo);
   };
@@ -0,0 +1,58 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkDICOMDatasetAccess.h"
+
+#include "dcmtk/ofstd/ofstd.h"
+
+double
+mitk::DICOMDatasetAccess
+::GetTagValueAsDouble(const DICOMTag& tag, bool& successful) const
+{
+  const DICOMDatasetFinding finding = this->GetTagValueAsString(tag);
+  successful = finding.isValid;
+  //Doesn't care if findings are valid or not. If they are not valid,
+  //value is empty, which converts to 0.
+  return OFStandard::atof(finding.value.c_str());
+}
+
+mitk::Point3D
+mitk::DICOMDatasetAccess
+::GetImagePositionPatient(bool& successful) const
+{
+  static const DICOMTag tagImagePositionPatient = DICOMTag(0x0020,0x0032); // Image Position (Patient)
+
+  const std::string originString = this->GetTagValueAsString(tagImagePositionPatient).value;
+  successful = !originString.empty();
+
+  Point3D origin; origin.Fill(0.0);
+  if (successful)
+  {
+    origin = DICOMStringToPoint3D(originString, successful);
+  }
+  return origin;
+}
+
+void
+mitk::DICOMDatasetAccess
+::GetImageOrientationPatient(Vector3D& right, Vector3D& up, bool& successful) const
+{
+  static const DICOMTag tagImageOrientation = DICOMTag(0x0020, 0x0037); // Image Orientation
+
+  right.Fill(0.0);
+  up.Fill(0.0);
+  DICOMStringToOrientationVectors(this->GetTagValueAsString(tagImageOrientation).value, right, up, successful);
+}
@@ -19,7 +19,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 mitk::DICOMDatasetAccessingImageFrameInfo
 ::DICOMDatasetAccessingImageFrameInfo(const std::string& filename, unsigned int frameNo)
 :DICOMImageFrameInfo(filename, frameNo)
+,m_PositionParsed(false)
+,m_HasPosition(false)
+,m_OrientationParsed(false)
+,m_HasOrientation(false)
 {
+  m_Position.Fill(0.0);
+  m_OrientationRight.Fill(0.0);
+  m_OrientationUp.Fill(0.0);
 }
 
 mitk::DICOMDatasetAccessingImageFrameInfo
@@ -27,6 +34,60 @@ mitk::DICOMDatasetAccessingImageFrameInfo
 {
 }
 
+void
+mitk::DICOMDatasetAccessingImageFrameInfo
+::InvalidateSortKeys()
+{
+  m_NumericTagValues.clear();
+  m_PositionParsed = false;
+  m_OrientationParsed = false;
+}
+
+double
+mitk::DICOMDatasetAccessingImageFrameInfo
+::GetTagValueAsDouble(const DICOMTag& tag, bool& successful) const
+{
+  auto finding = m_NumericTagValues.find(tag);
+  if (finding == m_NumericTagValues.end())
+  {
+    NumericValue parsed;
+    parsed.value = DICOMDatasetAccess::GetTagValueAsDouble(tag, parsed.successful);
+    finding = m_NumericTagValues.insert(std::make_pair(tag, parsed)).first;
+  }
+
+  successful = finding->second.successful;
+  return finding->second.value;
+}
+
+mitk::Point3D
+mitk::DICOMDatasetAccessingImageFrameInfo
+::GetImagePositionPatient(bool& successful) const
+{
+  if (!m_PositionParsed)
+  {
+    m_Position = DICOMDatasetAccess::GetImagePositionPatient(m_HasPosition);
+    m_PositionParsed = true;
+  }
+
+  successful = m_HasPosition;
+  return m_Position;
+}
+
+void
+mitk::DICOMDatasetAccessingImageFrameInfo
+::GetImageOrientationPatient(Vector3D& right, Vector3D& up, bool& successful) const
+{
+  if (!m_OrientationParsed)
+  {
+    DICOMDatasetAccess::GetImageOrientationPatient(m_OrientationRight, m_OrientationUp, m_HasOrientation);
+    m_OrientationParsed = true;
+  }
+
+  right = m_OrientationRight;
+  up = m_OrientationUp;
+  successful = m_HasOrientation;
+}
+
 mitk::DICOMImageFrameList
 mitk::ConvertToDICOMImageFrameList(const DICOMDatasetAccessingImageFrameList& input)
 {
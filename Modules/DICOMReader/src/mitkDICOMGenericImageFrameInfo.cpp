@@ -77,6 +77,7 @@ mitk::DICOMGenericImageFrameInfo::SetTagValue(const DICOMTagPath& path, const st
   }
 
   m_Values[path] = value;
+  this->InvalidateSortKeys();
 }
 
 std::string
@@ -16,8 +16,6 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDICOMSortByTag.h"
 
-#include "dcmtk/ofstd/ofstd.h"
-
 mitk::DICOMSortByTag
 ::DICOMSortByTag(const DICOMTag& tag, DICOMSortCriterion::Pointer secondaryCriterion)
 :DICOMSortCriterion(secondaryCriterion)
@@ -121,24 +119,13 @@ mitk::DICOMSortByTag
   assert(left);
   assert(right);
 
-  const DICOMDatasetFinding leftFinding = left->GetTagValueAsString(tag);
-  const DICOMDatasetFinding rightFinding = right->GetTagValueAsString(tag);
+  // numeric values are parsed once per dataset (see DICOMDatasetAccess::GetTagValueAsDouble()),
+  // std::sort will ask for them O(n log n) times.
   //Doesn't care if findings are valid or not. If they are not valid,
-  //value is empty, thats enough.
-
-  double leftDouble( 0 );
-  double rightDouble( 0 );
-
-  try
-  {
-    leftDouble = OFStandard::atof( leftFinding.value.c_str() );
-    rightDouble = OFStandard::atof(rightFinding.value.c_str());
-  }
-  catch ( const std::exception& /*e*/ )
-  {
-    return this->StringCompare(left,right, tag); // fallback to string compare
-  }
-
+  //value is 0, thats enough.
+  bool ignoredValidity(false);
+  const double leftDouble = left->GetTagValueAsDouble(tag, ignoredValidity);
+  const double rightDouble = right->GetTagValueAsDouble(tag, ignoredValidity);
 
   if ( leftDouble != rightDouble ) // can we decide?
   {
@@ -157,24 +144,11 @@ mitk::DICOMSortByTag
   assert(from);
   assert(to);
 
-  const DICOMDatasetFinding fromFinding = from->GetTagValueAsString(m_Tag);
-  const DICOMDatasetFinding toFinding = to->GetTagValueAsString(m_Tag);
   //Doesn't care if findings are valid or not. If they are not valid,
-  //value is empty, thats enough.
-
-  double fromDouble(0);
-  double toDouble(0);
-
-  try
-  {
-    fromDouble = OFStandard::atof(fromFinding.value.c_str());
-    toDouble = OFStandard::atof(toFinding.value.c_str());
-  }
-  catch ( const std::exception& /*e*/ )
-  {
-    MITK_WARN << "NO NUMERIC DISTANCE between '" << fromFinding.value << "' and '" << toFinding.value << "'";
-    return 0;
-  }
+  //value is 0, thats enough.
+  bool ignoredValidity(false);
+  const double fromDouble = from->GetTagValueAsDouble(m_Tag, ignoredValidity);
+  const double toDouble = to->GetTagValueAsDouble(m_Tag, ignoredValidity);
 
   return toDouble - fromDouble;
   // TODO second-level compare?
@@ -365,11 +365,11 @@ mitk::EquiDistantBlocksSorter
        ++dsIter, ++fileIndex)
   {
     bool fileFitsIntoPattern(false);
-    std::string thisOriginString;
-    // Read tag value into point3D. PLEASE replace this by appropriate GDCM code if you figure out how to do that
-    thisOriginString = (*dsIter)->GetTagValueAsString(tagImagePositionPatient).value;
+    // position is parsed only once per dataset, even if we analyze the dataset again for later blocks
+    bool hasOrigin(false);
+    thisOrigin = (*dsIter)->GetImagePositionPatient(hasOrigin);
 
-    if (thisOriginString.empty())
+    if (!hasOrigin)
     {
       // don't let such files be in a common group. Everything without position information will be loaded as a single slice:
       // with standard DICOM files this can happen to: CR, DX, SC
@@ -397,7 +397,6 @@ mitk::EquiDistantBlocksSorter
     }
 
     bool ignoredConversionError(-42); // hard to get here, no graceful way to react
-    thisOrigin = DICOMStringToPoint3D( thisOriginString, ignoredConversionError );
 
     MITK_DEBUG << "  " << fileIndex << " " << (*dsIter)->GetFilenameIfAvailable()
                        << " at "
@@ -441,8 +440,7 @@ mitk::EquiDistantBlocksSorter
 
         Vector3D right; right.Fill(0.0);
         Vector3D up; right.Fill(0.0); // might be down as well, but it is just a name at this point
-        std::string orientationValue = (*dsIter)->GetTagValueAsString( tagImageOrientation ).value;
-        DICOMStringToOrientationVectors( orientationValue, right, up, ignoredConversionError );
+        (*dsIter)->GetImageOrientationPatient( right, up, ignoredConversionError );
 
         GantryTiltInformation tiltInfo( lastDifferentOrigin, thisOrigin, right, up, 1 );
 
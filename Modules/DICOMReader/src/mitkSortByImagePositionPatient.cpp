@@ -91,28 +91,22 @@ mitk::SortByImagePositionPatient
 ::InternalNumericDistance(const mitk::DICOMDatasetAccess* left, const mitk::DICOMDatasetAccess* right, bool& possible) const
 {
   // sort by distance to world origin, assuming (almost) equal orientation
-  static const DICOMTag tagImagePositionPatient = DICOMTag(0x0020,0x0032); // Image Position (Patient)
-  static const DICOMTag    tagImageOrientation = DICOMTag(0x0020, 0x0037); // Image Orientation
-
+  // position and orientation are parsed once per dataset, see DICOMDatasetAccess::GetImagePositionPatient()
   Vector3D leftRight; leftRight.Fill(0.0);
   Vector3D leftUp; leftUp.Fill(0.0);
   bool leftHasOrientation(false);
-  DICOMStringToOrientationVectors( left->GetTagValueAsString( tagImageOrientation ).value,
-                                   leftRight, leftUp, leftHasOrientation );
+  left->GetImageOrientationPatient(leftRight, leftUp, leftHasOrientation);
 
   Vector3D rightRight; rightRight.Fill(0.0);
   Vector3D rightUp; rightUp.Fill(0.0);
   bool rightHasOrientation(false);
-  DICOMStringToOrientationVectors(right->GetTagValueAsString(tagImageOrientation).value,
-                                   rightRight, rightUp, rightHasOrientation );
+  right->GetImageOrientationPatient(rightRight, rightUp, rightHasOrientation);
 
-  Point3D leftOrigin; leftOrigin.Fill(0.0f);
   bool leftHasOrigin(false);
-  leftOrigin = DICOMStringToPoint3D(left->GetTagValueAsString(tagImagePositionPatient).value, leftHasOrigin);
+  const Point3D leftOrigin = left->GetImagePositionPatient(leftHasOrigin);
 
-  Point3D rightOrigin; rightOrigin.Fill(0.0f);
   bool rightHasOrigin(false);
-  rightOrigin = DICOMStringToPoint3D(right->GetTagValueAsString(tagImagePositionPatient).value, rightHasOrigin);
+  const Point3D rightOrigin = right->GetImagePositionPatient(rightHasOrigin);
 
   //   we tolerate very small differences in image orientation, since we got to know about
   //   acquisitions where these values change across a single series (7th decimal digit)
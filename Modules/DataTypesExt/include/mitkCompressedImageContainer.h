@@ -59,6 +59,11 @@ namespace mitk
      */
     Image::Pointer GetImage();
 
+    /**
+     * \brief Returns the number of bytes of the compressed image data.
+     */
+    std::size_t GetCompressedSize() const;
+
   protected:
     CompressedImageContainer(); // purposely hidden
     ~CompressedImageContainer() override;
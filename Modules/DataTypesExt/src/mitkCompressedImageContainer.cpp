@@ -125,6 +125,17 @@ void mitk::CompressedImageContainer::SetImage(Image *image)
   }
 }
 
+std::size_t mitk::CompressedImageContainer::GetCompressedSize() const
+{
+  std::size_t compressedSize = 0;
+  for (auto iter = m_ByteBuffers.begin(); iter != m_ByteBuffers.end(); ++iter)
+  {
+    compressedSize += iter->second;
+  }
+
+  return compressedSize;
+}
+
 mitk::Image::Pointer mitk::CompressedImageContainer::GetImage()
 {
   if (m_ByteBuffers.empty())
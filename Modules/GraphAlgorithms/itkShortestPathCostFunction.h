@@ -64,12 +64,20 @@ namespace itk
     // \brief Set the ending index of a path
     void SetEndIndex(const IndexType &index);
 
+    // \brief Returns the time stamp of the last change of the costs. Subclasses call CostsModified() whenever
+    // the costs between pixels change, so a shortest path filter can reuse a search tree while it is unchanged.
+    const TimeStamp &GetCostsTimeStamp() const { return m_CostsTimeStamp; }
+
   protected:
     ShortestPathCostFunction(){};
     ~ShortestPathCostFunction() override{};
     void PrintSelf(std::ostream &os, Indent indent) const override;
+    // \brief Marks the costs as changed
+    void CostsModified() { m_CostsTimeStamp.Modified(); }
+
     ImageConstPointer m_Image;
     IndexType m_StartIndex, m_EndIndex;
+    TimeStamp m_CostsTimeStamp;
 
   private:
     ShortestPathCostFunction(const Self &); // purposely not implemented
@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkImageRegionConstIterator.h"
 
+#include <vector>
+
 namespace itk
 {
   /** \brief Cost function for LiveWire purposes.
@@ -96,14 +98,32 @@ namespace itk
       this->m_CostMap = costMap;
       this->m_UseCostMap = true;
       this->m_MaxMapCosts = -1;
+      this->m_PixelCostsValid = false;
+      this->CostsModified();
       this->Modified();
     }
 
-    void SetUseCostMap(bool useCostMap) { this->m_UseCostMap = useCostMap; }
+    void SetUseCostMap(bool useCostMap)
+    {
+      if (this->m_UseCostMap != useCostMap)
+      {
+        this->m_UseCostMap = useCostMap;
+        this->m_PixelCostsValid = false;
+        this->CostsModified();
+      }
+    }
     /**
      \brief Set the maximum of the dynamic cost map to save computation time.
     */
-    void SetCostMapMaximum(double max) { this->m_MaxMapCosts = max; }
+    void SetCostMapMaximum(double max)
+    {
+      if (this->m_MaxMapCosts != max)
+      {
+        this->m_MaxMapCosts = max;
+        this->m_PixelCostsValid = false;
+        this->CostsModified();
+      }
+    }
     enum Constants
     {
       MAPSCALEFACTOR = 10
@@ -155,6 +175,19 @@ namespace itk
 
     double m_MaxMapCosts;
 
+    /** \brief Costs of stepping onto each pixel of the image, before scaling by the step length.
+     The costs only depend on the target pixel, so they are computed once per image instead of
+     once per visited edge.*/
+    std::vector<double> m_PixelCosts;
+
+    bool m_PixelCostsValid;
+
+    /** \brief Computes the costs of stepping onto a pixel from the image features*/
+    double ComputePixelCost(const IndexType &index);
+
+    /** \brief Fills the pixel costs for the whole image*/
+    void UpdatePixelCosts();
+
   private:
     double SigmoidFunction(double I, double max, double min, double alpha, double beta);
   };
@@ -25,6 +25,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkCastImageFilter.h>
 #include <itkGradientImageFilter.h>
 #include <itkGradientMagnitudeImageFilter.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 #include <itkLaplacianImageFilter.h>
 #include <itkStatisticsImageFilter.h>
 #include <itkZeroCrossingImageFilter.h>
@@ -33,7 +34,7 @@ namespace itk
 {
   // Constructor
   template <class TInputImageType>
-  ShortestPathCostFunctionLiveWire<TInputImageType>::ShortestPathCostFunctionLiveWire(): m_MinCosts(0.0), m_UseRepulsivePoints(false), m_GradientMax(0.0), m_Initialized(false),  m_UseCostMap(false), m_MaxMapCosts(-1.0)
+  ShortestPathCostFunctionLiveWire<TInputImageType>::ShortestPathCostFunctionLiveWire(): m_MinCosts(0.0), m_UseRepulsivePoints(false), m_GradientMax(0.0), m_Initialized(false),  m_UseCostMap(false), m_MaxMapCosts(-1.0), m_PixelCostsValid(false)
   {
   }
 
@@ -42,12 +43,14 @@ namespace itk
   {
     this->m_MaskImage->SetPixel(index, 255);
     m_UseRepulsivePoints = true;
+    this->CostsModified();
   }
 
   template <class TInputImageType>
   void ShortestPathCostFunctionLiveWire<TInputImageType>::RemoveRepulsivePoint(const IndexType &index)
   {
     this->m_MaskImage->SetPixel(index, 0);
+    this->CostsModified();
   }
 
   template <class TInputImageType>
@@ -68,6 +71,8 @@ namespace itk
 
       this->Modified();
       this->m_Initialized = false;
+      this->m_PixelCostsValid = false;
+      this->CostsModified();
     }
   }
 
@@ -76,18 +81,12 @@ namespace itk
   {
     m_UseRepulsivePoints = false;
     this->m_MaskImage->FillBuffer(0);
+    this->CostsModified();
   }
 
   template <class TInputImageType>
   double ShortestPathCostFunctionLiveWire<TInputImageType>::GetCost(IndexType p1, IndexType p2)
   {
-    // local component costs
-    // weights
-    double w1;
-    double w2;
-    double w3;
-    double costs = 0.0;
-
     // if we are on the mask, return asap
     if (m_UseRepulsivePoints)
     {
@@ -95,6 +94,36 @@ namespace itk
         return 1000;
     }
 
+    double costs = m_PixelCosts[this->m_GradientMagnitudeImage->ComputeOffset(p2)];
+
+    // scale by euclidian distance
+    double costScale;
+    if (p1[0] == p2[0] || p1[1] == p2[1])
+    {
+      // horizontal or vertical neighbor
+      costScale = 1.0;
+    }
+    else
+    {
+      // diagonal neighbor
+      costScale = sqrt(2.0);
+    }
+
+    costs *= costScale;
+
+    return costs;
+  }
+
+  template <class TInputImageType>
+  double ShortestPathCostFunctionLiveWire<TInputImageType>::ComputePixelCost(const IndexType &p2)
+  {
+    // local component costs
+    // weights
+    double w1;
+    double w2;
+    double w3;
+    double costs = 0.0;
+
     double gradientX, gradientY;
     gradientX = gradientY = 0.0;
 
@@ -271,22 +300,23 @@ namespace itk
     }
     costs = w1 * laplacianCost + w2 * gradientCost + w3 * gradientDirectionCost;
 
-    // scale by euclidian distance
-    double costScale;
-    if (p1[0] == p2[0] || p1[1] == p2[1])
-    {
-      // horizontal or vertical neighbor
-      costScale = 1.0;
-    }
-    else
+    return costs;
+  }
+
+  template <class TInputImageType>
+  void ShortestPathCostFunctionLiveWire<TInputImageType>::UpdatePixelCosts()
+  {
+    // the buffer is traversed in memory order, so the position in m_PixelCosts is the offset of the pixel
+    const RegionType region = this->m_GradientMagnitudeImage->GetBufferedRegion();
+    m_PixelCosts.resize(region.GetNumberOfPixels());
+
+    itk::ImageRegionConstIteratorWithIndex<FloatImageType> it(this->m_GradientMagnitudeImage, region);
+    for (std::size_t i = 0; !it.IsAtEnd(); ++it, ++i)
     {
-      // diagonal neighbor
-      costScale = sqrt(2.0);
+      m_PixelCosts[i] = this->ComputePixelCost(it.GetIndex());
     }
 
-    costs *= costScale;
-
-    return costs;
+    m_PixelCostsValid = true;
   }
 
   template <class TInputImageType>
@@ -375,6 +405,11 @@ namespace itk
       m_Initialized = true;
     }
 
+    if (!m_PixelCostsValid)
+    {
+      this->UpdatePixelCosts();
+    }
+
     // check start/end point value
     startValue = this->m_Image->GetPixel(this->m_StartIndex);
     endValue = this->m_Image->GetPixel(this->m_EndIndex);
@@ -39,6 +39,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 // for GetVectorOrderImage
 // void AddEndIndex(const IndexType & EndIndex) //Optional. By calling this function you can add several endpoints! The
 // algorithm will look for several shortest Pathes. From Start to all Endpoints.
+// void SetReuseSearchTree(bool) // Optional (default=false), keep the search tree of the last update and continue it, if
+// only the end point has changed. Good for interactive tools that move the end point of a path with a fixed start.
 //
 /// GET FUNCTIONS
 // std::vector< itk::Index<3> > GetVectorPath(); // returns the shortest path as vector
@@ -72,6 +74,7 @@ namespace itk
     typedef typename TInputImageType::PixelType InputImagePixelType;
     typedef typename TInputImageType::SizeType InputImageSizeType;
     typedef typename TInputImageType::IndexType IndexType;
+    typedef typename TInputImageType::OffsetType OffsetType;
     typedef typename itk::ImageRegionIteratorWithIndex<InputImageType> InputImageIteratorType;
 
     typedef TOutputImageType OutputImageType;
@@ -133,6 +136,12 @@ namespace itk
     itkSetMacro(ActivateTimeOut, bool);
     itkGetMacro(ActivateTimeOut, bool);
 
+    // \brief (default=false), Reuse the search tree of the last update if start point, input and costs are unchanged.
+    // The nodes closed before are final, so a moved end point is either found directly or the search is continued.
+    // Not used for multiple end points or if the vector order is stored.
+    itkSetMacro(ReuseSearchTree, bool);
+    itkGetMacro(ReuseSearchTree, bool);
+
     // \brief returns shortest Path as vector
     std::vector<IndexType> GetVectorPath();
 
@@ -163,7 +172,10 @@ namespace itk
       m_endPoints; // if you fill this vector, the algo will not rest until all endPoints have been reached
     std::vector<IndexType> m_endPointsClosed;
 
-    ShortestPathNode *m_Nodes; // main list that contains all nodes
+    std::vector<ShortestPathNode> m_Nodes;     // main list that contains all nodes
+    std::vector<NodeNumType> m_Heap;           // binary min heap (by distAndEst) of discovered but not closed nodes
+    std::vector<NodeNumType> m_TouchedNodes;   // nodes that were discovered, only these have to be reset
+    std::vector<OffsetType> m_NeighborOffsets; // offsets of the neighbors, first the face neighbors
     NodeNumType m_Graph_NumberOfNodes;
     NodeNumType m_Graph_StartNode;
     NodeNumType m_Graph_EndNode;
@@ -186,6 +198,12 @@ namespace itk
 
     bool m_Initialized;
 
+    bool m_ReuseSearchTree;
+    bool m_SearchTreeValid;            // m_Nodes and m_Heap hold the search tree of the last update
+    NodeNumType m_SearchTreeStartNode; // start node of that search tree
+    bool m_SearchTreeFullNeighbors;    // neighborhood used to build that search tree
+    TimeStamp m_SearchTreeTime;        // time that search tree was last extended
+
     CostFunctionTypePointer m_CostFunction;
     IndexType m_StartIndex, m_EndIndex;
     std::vector<IndexType> m_VectorPath;
@@ -217,6 +235,21 @@ namespace itk
     // \brief Returns the neighbors of a node
     std::vector<ShortestPathNode *> GetNeighbors(NodeNumType nodeNum, bool FullNeighbors);
 
+    // \brief Fills m_NeighborOffsets with the face neighbors and, if FullNeighbors is set, all other neighbors
+    void InitNeighborOffsets(bool FullNeighbors);
+
+    // \brief Resets all discovered nodes and discovers the start node
+    void ResetGraph();
+
+    // \brief Checks if the search tree of the last update can be continued
+    bool CanReuseSearchTree();
+
+    // \brief Heap operations on m_Heap, the heapIndex of the nodes is kept up to date
+    void HeapPush(NodeNumType node);
+    NodeNumType HeapPop();
+    void HeapSiftUp(NodeNumType position);
+    void HeapSiftDown(NodeNumType position);
+
     // \brief Check if coords are in bounds of image
     bool CoordIsInBounds(IndexType);
 
@@ -29,8 +29,7 @@ namespace itk
   // Constructor  (initialize standard values)
   template <class TInputImageType, class TOutputImageType>
   ShortestPathImageFilter<TInputImageType, TOutputImageType>::ShortestPathImageFilter()
-    : m_Nodes(nullptr),
-      m_Graph_NumberOfNodes(0),
+    : m_Graph_NumberOfNodes(0),
       m_Graph_fullNeighbors(false),
       m_FullNeighborsMode(false),
       m_MakeOutputImage(true),
@@ -38,7 +37,11 @@ namespace itk
       m_CalcAllDistances(false),
       multipleEndPoints(false),
       m_ActivateTimeOut(false),
-      m_Initialized(false)
+      m_Initialized(false),
+      m_ReuseSearchTree(false),
+      m_SearchTreeValid(false),
+      m_SearchTreeStartNode(0),
+      m_SearchTreeFullNeighbors(false)
   {
     m_endPoints.clear();
     m_endPointsClosed.clear();
@@ -53,7 +56,6 @@ namespace itk
   template <class TInputImageType, class TOutputImageType>
   ShortestPathImageFilter<TInputImageType, TOutputImageType>::~ShortestPathImageFilter()
   {
-    delete[] m_Nodes;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -147,231 +149,61 @@ namespace itk
     unsigned int nodeNum, bool FullNeighbors)
   {
     // returns a vector of nodepointers.. these nodes are the neighbors
-    int dim = InputImageType::ImageDimension;
     IndexType Coord = NodeToCoord(nodeNum);
     IndexType NeighborCoord;
     std::vector<ShortestPathNode *> nodeList;
 
-    int neighborDistance = 1; // if i increase that, i might not hit the endnote
-
-    // maybe use itkNeighborhoodIterator here, might be faster
+    InitNeighborOffsets(FullNeighbors);
 
-    if (dim == 2)
+    for (unsigned int i = 0; i < m_NeighborOffsets.size(); ++i)
     {
-      // N4
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] - neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] + neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] + neighborDistance;
+      NeighborCoord = Coord + m_NeighborOffsets[i];
       if (CoordIsInBounds(NeighborCoord))
         nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] - neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      if (FullNeighbors)
-      {
-        // N8
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-      }
     }
-    if (dim == 3)
-    {
-      // N6
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] - neighborDistance;
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0] + neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1] + neighborDistance;
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+    return nodeList;
+  }
 
-      NeighborCoord[0] = Coord[0] - neighborDistance;
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2];
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::InitNeighborOffsets(bool FullNeighbors)
+  {
+    const unsigned int dim = InputImageType::ImageDimension;
+    m_NeighborOffsets.clear();
 
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2] + neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+    // N4 in 2D, N6 in 3D
+    OffsetType offset;
+    for (unsigned int i = 0; i < dim; ++i)
+    {
+      offset.Fill(0);
+      offset[i] = -1;
+      m_NeighborOffsets.push_back(offset);
+      offset[i] = 1;
+      m_NeighborOffsets.push_back(offset);
+    }
 
-      NeighborCoord[0] = Coord[0];
-      NeighborCoord[1] = Coord[1];
-      NeighborCoord[2] = Coord[2] - neighborDistance;
-      if (CoordIsInBounds(NeighborCoord))
-        nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+    if (FullNeighbors)
+    {
+      // N8 in 2D, N26 in 3D: all remaining offsets of the 3^dim neighborhood, except the center
+      unsigned int numberOfOffsets = 1;
+      for (unsigned int i = 0; i < dim; ++i)
+        numberOfOffsets *= 3;
 
-      if (FullNeighbors)
+      for (unsigned int n = 0; n < numberOfOffsets; ++n)
       {
-        // N26
-        // Middle Slice
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2];
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // BackSlice (Diagonal)
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // BackSlice (Non-Diag)
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] - neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // FrontSlice (Diagonal)
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        // FrontSlice(Non-Diag)
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] - neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] + neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0];
-        NeighborCoord[1] = Coord[1] + neighborDistance;
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
-
-        NeighborCoord[0] = Coord[0] - neighborDistance;
-        NeighborCoord[1] = Coord[1];
-        NeighborCoord[2] = Coord[2] + neighborDistance;
-        if (CoordIsInBounds(NeighborCoord))
-          nodeList.push_back(&m_Nodes[CoordToNode(NeighborCoord)]);
+        unsigned int numberOfNonZeros = 0;
+        unsigned int rest = n;
+        for (unsigned int i = 0; i < dim; ++i)
+        {
+          offset[i] = static_cast<int>(rest % 3) - 1;
+          rest /= 3;
+          if (offset[i] != 0)
+            ++numberOfNonZeros;
+        }
+
+        if (numberOfNonZeros > 1)
+          m_NeighborOffsets.push_back(offset);
       }
     }
-    return nodeList;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -385,7 +217,6 @@ namespace itk
     m_Graph_StartNode = CoordToNode(m_StartIndex);
     // MITK_INFO << "StartIndex = " << StartIndex;
     // MITK_INFO << "StartNode = " << m_Graph_StartNode;
-    m_Initialized = false;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -415,15 +246,17 @@ namespace itk
     multipleEndPoints = true;
   }
 
+
   template <class TInputImageType, class TOutputImageType>
   inline double ShortestPathImageFilter<TInputImageType, TOutputImageType>::getEstimatedCostsToTarget(
     const typename TInputImageType::IndexType &a)
   {
     // Returns the minimal possible costs for a path from "a" to targetnode.
-    itk::Vector<float, 3> v;
-    v[0] = m_EndIndex[0] - a[0];
-    v[1] = m_EndIndex[1] - a[1];
-    v[2] = m_EndIndex[2] - a[2];
+    itk::Vector<float, TInputImageType::ImageDimension> v;
+    for (unsigned int i = 0; i < TInputImageType::ImageDimension; ++i)
+    {
+      v[i] = m_EndIndex[i] - a[i];
+    }
 
     return m_CostFunction->GetMinCost() * v.GetNorm();
   }
@@ -431,20 +264,18 @@ namespace itk
   template <class TInputImageType, class TOutputImageType>
   void ShortestPathImageFilter<TInputImageType, TOutputImageType>::InitGraph()
   {
-    if (!m_Initialized)
-    {
-      // Clean up previous stuff
-      CleanUp();
-
-      // Calc Number of nodes
-      auto imageDimensions = TInputImageType::ImageDimension;
-      const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
-      m_Graph_NumberOfNodes = 1;
-      for (NodeNumType i = 0; i < imageDimensions; ++i)
-        m_Graph_NumberOfNodes = m_Graph_NumberOfNodes * size[i];
+    // Calc Number of nodes
+    auto imageDimensions = TInputImageType::ImageDimension;
+    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
+    NodeNumType numberOfNodes = 1;
+    for (NodeNumType i = 0; i < imageDimensions; ++i)
+      numberOfNodes = numberOfNodes * size[i];
 
-      // Initialize mainNodeList with that number
-      m_Nodes = new ShortestPathNode[m_Graph_NumberOfNodes];
+    if (!m_Initialized || numberOfNodes != m_Graph_NumberOfNodes)
+    {
+      // Initialize mainNodeList with that number. Afterwards only the discovered nodes are reset for a new search.
+      m_Graph_NumberOfNodes = numberOfNodes;
+      m_Nodes.resize(m_Graph_NumberOfNodes);
 
       // Initialize each node in nodelist
       for (NodeNumType i = 0; i < m_Graph_NumberOfNodes; i++)
@@ -453,18 +284,132 @@ namespace itk
         m_Nodes[i].distance = -1;
         m_Nodes[i].prevNode = -1;
         m_Nodes[i].mainListIndex = i;
+        m_Nodes[i].heapIndex = 0;
         m_Nodes[i].closed = false;
       }
 
+      m_TouchedNodes.clear();
+      m_Heap.clear();
+      m_SearchTreeValid = false;
       m_Initialized = true;
     }
 
-    // In the beginning, the Startnode needs a distance of 0
-    m_Nodes[m_Graph_StartNode].distance = 0;
-    m_Nodes[m_Graph_StartNode].distAndEst = 0;
+    InitNeighborOffsets(m_Graph_fullNeighbors);
 
     // initalize cost function
     m_CostFunction->Initialize();
+
+    if (CanReuseSearchTree())
+    {
+      // The closed nodes keep their distances. The discovered nodes are sorted by the estimate to the new target.
+      for (NodeNumType i = 0; i < m_Heap.size(); ++i)
+      {
+        ShortestPathNode &node = m_Nodes[m_Heap[i]];
+        node.distAndEst = node.distance + getEstimatedCostsToTarget(NodeToCoord(node.mainListIndex));
+      }
+      for (NodeNumType i = m_Heap.size() / 2; i > 0; --i)
+      {
+        HeapSiftDown(i - 1);
+      }
+    }
+    else
+    {
+      ResetGraph();
+    }
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  void ShortestPathImageFilter<TInputImageType, TOutputImageType>::ResetGraph()
+  {
+    for (NodeNumType i = 0; i < m_TouchedNodes.size(); ++i)
+    {
+      ShortestPathNode &node = m_Nodes[m_TouchedNodes[i]];
+      node.distAndEst = -1;
+      node.distance = -1;
+      node.prevNode = -1;
+      node.closed = false;
+    }
+    m_TouchedNodes.clear();
+    m_Heap.clear();
+    m_VectorOrder.clear();
+
+    // In the beginning, the Startnode needs a distance of 0 and is the only discovered node
+    m_Nodes[m_Graph_StartNode].distance = 0;
+    m_Nodes[m_Graph_StartNode].distAndEst = 0;
+    m_TouchedNodes.push_back(m_Graph_StartNode);
+    HeapPush(m_Graph_StartNode);
+
+    m_SearchTreeValid = true;
+    m_SearchTreeStartNode = m_Graph_StartNode;
+    m_SearchTreeFullNeighbors = m_Graph_fullNeighbors;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  bool ShortestPathImageFilter<TInputImageType, TOutputImageType>::CanReuseSearchTree()
+  {
+    // Only the costs may not change, object modifications like a new requested region of the cost function do not
+    // matter. The input image is checked as well, in case the cost function does not report a new image.
+    return m_ReuseSearchTree && m_SearchTreeValid && !multipleEndPoints && !m_StoreVectorOrder &&
+           m_SearchTreeStartNode == m_Graph_StartNode && m_SearchTreeFullNeighbors == m_Graph_fullNeighbors &&
+           this->GetInput()->GetMTime() < m_SearchTreeTime.GetMTime() &&
+           m_CostFunction->GetCostsTimeStamp() < m_SearchTreeTime;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline void ShortestPathImageFilter<TInputImageType, TOutputImageType>::HeapPush(NodeNumType node)
+  {
+    m_Heap.push_back(node);
+    HeapSiftUp(m_Heap.size() - 1);
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline NodeNumType ShortestPathImageFilter<TInputImageType, TOutputImageType>::HeapPop()
+  {
+    NodeNumType top = m_Heap.front();
+    m_Heap.front() = m_Heap.back();
+    m_Heap.pop_back();
+    if (!m_Heap.empty())
+      HeapSiftDown(0);
+    return top;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline void ShortestPathImageFilter<TInputImageType, TOutputImageType>::HeapSiftUp(NodeNumType position)
+  {
+    NodeNumType node = m_Heap[position];
+    DistanceType key = m_Nodes[node].distAndEst;
+    while (position > 0)
+    {
+      NodeNumType parent = (position - 1) / 2;
+      if (m_Nodes[m_Heap[parent]].distAndEst <= key)
+        break;
+      m_Heap[position] = m_Heap[parent];
+      m_Nodes[m_Heap[position]].heapIndex = position;
+      position = parent;
+    }
+    m_Heap[position] = node;
+    m_Nodes[node].heapIndex = position;
+  }
+
+  template <class TInputImageType, class TOutputImageType>
+  inline void ShortestPathImageFilter<TInputImageType, TOutputImageType>::HeapSiftDown(NodeNumType position)
+  {
+    NodeNumType node = m_Heap[position];
+    DistanceType key = m_Nodes[node].distAndEst;
+    NodeNumType heapSize = m_Heap.size();
+    while (2 * position + 1 < heapSize)
+    {
+      NodeNumType child = 2 * position + 1;
+      if (child + 1 < heapSize && m_Nodes[m_Heap[child + 1]].distAndEst < m_Nodes[m_Heap[child]].distAndEst)
+        ++child;
+      if (key <= m_Nodes[m_Heap[child]].distAndEst)
+        break;
+      m_Heap[position] = m_Heap[child];
+      m_Nodes[m_Heap[position]].heapIndex = position;
+      position = child;
+    }
+    m_Heap[position] = node;
+    m_Nodes[node].heapIndex = position;
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -481,43 +426,36 @@ namespace itk
     DistanceType curNodeDistance = 0;
     NodeNumType numberOfNodesChecked = 0;
 
-    // Create Multimap (tree structure for fast searching)
-    std::multimap<double, ShortestPathNode *> myMap;
-    std::pair<std::multimap<double, ShortestPathNode *>::iterator, std::multimap<double, ShortestPathNode *>::iterator>
-      ret;
-    std::multimap<double, ShortestPathNode *>::iterator it;
+    // A reused search tree may already contain the shortest path to the end node
+    if (!multipleEndPoints && !m_CalcAllDistances && m_Nodes[m_Graph_EndNode].closed)
+    {
+      m_SearchTreeTime.Modified();
+      return;
+    }
 
-    // At first, only startNote is discovered.
-    myMap.insert(
-      std::pair<double, ShortestPathNode *>(m_Nodes[m_Graph_StartNode].distAndEst, &m_Nodes[m_Graph_StartNode]));
+    // Node numbers of the neighbors relative to the current node, see m_NeighborOffsets
+    const InputImageSizeType &size = this->GetInput()->GetRequestedRegion().GetSize();
+    std::vector<long> neighborNodeOffsets(m_NeighborOffsets.size(), 0);
+    for (unsigned int i = 0; i < m_NeighborOffsets.size(); ++i)
+    {
+      long stride = 1;
+      for (unsigned int j = 0; j < TInputImageType::ImageDimension; ++j)
+      {
+        neighborNodeOffsets[i] += m_NeighborOffsets[i][j] * stride;
+        stride *= size[j];
+      }
+    }
 
     // While there are discovered Nodes, pick the one with lowest distance,
     // update its neighbors and eventually delete it from the discovered Nodes list.
-    while (!myMap.empty())
+    while (!m_Heap.empty())
     {
       numberOfNodesChecked++;
-      /*if ( (numberOfNodesChecked % (m_Graph_NumberOfNodes/100)) == 0)
-      {
-        MITK_INFO << "Checked " << ( numberOfNodesChecked / (m_Graph_NumberOfNodes/100) ) << "% List: " << myMap.size()
-      << "\n";
-      }*/
-
-      // Get element with lowest score
-      mainNodeListIndex = myMap.begin()->second->mainListIndex;
-      curNodeDistance = myMap.begin()->second->distance;
-      myMap.begin()->second->closed = true; // close it
-
-      // Debug:
-      // MITK_INFO << "INFO: size " << myMap.size();
-      /*
-      for (it = myMap.begin(); it != myMap.end(); ++it)
-      {
-      MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-      }
-      */
 
       // Kicks out element with lowest score
-      myMap.erase(myMap.begin());
+      mainNodeListIndex = HeapPop();
+      curNodeDistance = m_Nodes[mainNodeListIndex].distance;
+      m_Nodes[mainNodeListIndex].closed = true; // close it
 
       // if wanted, store vector order
       if (m_StoreVectorOrder)
@@ -526,137 +464,46 @@ namespace itk
       }
 
       // Check neighbors
-      std::vector<ShortestPathNode *> neighborNodes = GetNeighbors(mainNodeListIndex, m_Graph_fullNeighbors);
-      for (NodeNumType i = 0; i < neighborNodes.size(); i++)
+      IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
+      for (unsigned int i = 0; i < m_NeighborOffsets.size(); i++)
       {
-        if (neighborNodes[i]->closed)
-          continue; // this nodes is already closed, go to next neighbor
+        IndexType coordNeighborNode = coordCurNode + m_NeighborOffsets[i];
 
-        IndexType coordCurNode = NodeToCoord(mainNodeListIndex);
-        IndexType coordNeighborNode = NodeToCoord(neighborNodes[i]->mainListIndex);
+        bool inBounds = true;
+        for (unsigned int j = 0; j < TInputImageType::ImageDimension; ++j)
+        {
+          if (coordNeighborNode[j] < 0 || static_cast<unsigned long>(coordNeighborNode[j]) >= size[j])
+            inBounds = false;
+        }
+        if (!inBounds)
+          continue;
+
+        ShortestPathNode &neighborNode = m_Nodes[mainNodeListIndex + neighborNodeOffsets[i]];
+
+        if (neighborNode.closed)
+          continue; // this nodes is already closed, go to next neighbor
 
         // calculate the new Distance to the current neighbor
         double newDistance = curNodeDistance + (m_CostFunction->GetCost(coordCurNode, coordNeighborNode));
 
         // if it is shorter than any yet known path to this neighbor, than the current path is better. Save that!
-        if ((newDistance < neighborNodes[i]->distance) || (neighborNodes[i]->distance == -1))
+        if ((newDistance < neighborNode.distance) || (neighborNode.distance == -1))
         {
-          // if that neighbornode is not in discoverednodeList yet, Push it there and update
-          if (neighborNodes[i]->distance == -1)
+          bool discovered = neighborNode.distance != -1;
+
+          neighborNode.distance = newDistance;
+          neighborNode.distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
+          neighborNode.prevNode = mainNodeListIndex;
+
+          // if that neighbornode is not in the discovered nodes yet, push it there, otherwise move it up in the heap
+          if (!discovered)
           {
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-            /*
-            MITK_INFO << "Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            MITK_INFO << "INFO: size " << myMap.size();
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }
-            */
+            m_TouchedNodes.push_back(neighborNode.mainListIndex);
+            HeapPush(neighborNode.mainListIndex);
           }
-          // or if is already in discoverednodelist, update
           else
           {
-            /*
-            it = myMap.find(neighborNodes[i]->distAndEst);
-            if (it == myMap.end() )
-            {
-            MITK_INFO << "Nothing!";
-            // look further
-            for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            if ((*it).second->mainListIndex == lookForId)
-            {
-            MITK_INFO << "But it is there!!!";
-            MITK_INFO << "Searched for: " << lookFor << "   but had: " << (*it).second->distAndEst;
-            }
-
-            }
-            }
-            */
-
-            // 1st : find and delete old element
-            bool found = false;
-            ret = myMap.equal_range(neighborNodes[i]->distAndEst);
-
-            if ((ret.first == ret.second))
-            {
-              /*+++++++++++++ no exact match +++++++++++++*/
-              // MITK_INFO << "No exact match!"; // if this happens, you are screwed
-              /*
-              MITK_INFO << "Was looking for: " << lookFor << "  ID: " << lookForId;
-              if (ret.first != myMap.end() )
-              {
-              it = ret.first;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              ++it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              --it;
-              --it;
-              MITK_INFO << "Found: " << it->first << "  ID: " << it->second->mainListIndex;
-              }
-
-              // look if that ID is found in the map
-              for (it = myMap.begin(); it != myMap.end(); ++it)
-              {
-              if ((*it).second->mainListIndex == lookForId)
-              {
-              MITK_INFO << "But it is there!!!";
-              MITK_INFO << "Searched dist: " << lookFor << "  found dist: " << (*it).second->distAndEst;
-              }
-
-              }
-              */
-            }
-            else
-            {
-              for (it = ret.first; it != ret.second; ++it)
-              {
-                if (it->second->mainListIndex == neighborNodes[i]->mainListIndex)
-                {
-                  found = true;
-                  myMap.erase(it);
-                  /*
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  MITK_INFO << "Erase: " << it->first << "|" << it->second->mainListIndex;
-
-                  MITK_INFO << "INFO: size " << myMap.size();
-                  for (it = myMap.begin(); it != myMap.end(); ++it)
-                  {
-                  MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-                  }
-                  */
-                  break;
-                }
-              }
-            }
-
-            if (!found)
-            {
-              // MITK_INFO << "Could not find it! :(";
-              continue;
-            }
-
-            // 2nd: update and insert new element
-            neighborNodes[i]->distance = newDistance;
-            neighborNodes[i]->distAndEst = newDistance + getEstimatedCostsToTarget(coordNeighborNode);
-            neighborNodes[i]->prevNode = mainNodeListIndex;
-            // myMap.insert( std::pair<double,ShortestPathNode*> (neighborNodes[i]->distAndEst, neighborNodes[i]));
-            myMap.insert(std::pair<double, ShortestPathNode *>(m_Nodes[neighborNodes[i]->mainListIndex].distAndEst,
-                                                               &m_Nodes[neighborNodes[i]->mainListIndex]));
-
-            // MITK_INFO << "Re-Inserted: " << m_Nodes[neighborNodes[i]->mainListIndex].distAndEst << "|" <<
-            // m_Nodes[neighborNodes[i]->mainListIndex].mainListIndex;
-            // MITK_INFO << "INFO: size " << myMap.size();
-            /*for (it = myMap.begin(); it != myMap.end(); ++it)
-            {
-            MITK_INFO << "(1) " << it->first << "|" << it->second->distAndEst << "|"<<it->second->mainListIndex;
-            }*/
+            HeapSiftUp(neighborNode.heapIndex);
           }
         }
       }
@@ -703,9 +550,12 @@ namespace itk
       {
         /*if (m_StoreVectorOrder)
           MITK_INFO << "Number of Nodes checked: " << m_VectorOrder.size() ;*/
+        m_SearchTreeTime.Modified();
         return;
       }
     }
+
+    m_SearchTreeTime.Modified();
   }
 
   template <class TInputImageType, class TOutputImageType>
@@ -863,8 +713,11 @@ namespace itk
     m_VectorPath.clear();
     // TODO: if multiple Path, clear all multiple Paths
 
-    if (m_Nodes)
-      delete[] m_Nodes;
+    std::vector<ShortestPathNode>().swap(m_Nodes);
+    std::vector<NodeNumType>().swap(m_Heap);
+    std::vector<NodeNumType>().swap(m_TouchedNodes);
+    m_SearchTreeValid = false;
+    m_Initialized = false;
   }
 
   template <class TInputImageType, class TOutputImageType>
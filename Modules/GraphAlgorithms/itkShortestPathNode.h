@@ -31,6 +31,7 @@ namespace itk
     DistanceType distAndEst;   // Distance+Estimated Distnace to target
     NodeNumType prevNode;      // previous node. Important to find the Shortest Path
     NodeNumType mainListIndex; // Indexnumber of this node in m_Nodes
+    NodeNumType heapIndex;     // position in the heap of discovered nodes, only valid until the node is closed
     bool closed;               // determines if this node is closes, so its optimal path to startNode is known
   };
 
@@ -4,6 +4,8 @@ set(MODULE_TESTS
   mitkPointSetDifferenceStatisticsCalculatorTest.cpp
   mitkImageStatisticsTextureAnalysisTest.cpp
   mitkImageStatisticsContainerManagerTest.cpp
+  mitkImageStatisticsCacheTest.cpp
+  mitkIncrementalImageStatisticsCalculatorTest.cpp
 )
 
 set(MODULE_CUSTOM_TESTS
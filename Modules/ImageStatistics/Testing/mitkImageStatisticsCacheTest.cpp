@@ -0,0 +1,181 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImageStatisticsCache.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkImage.h>
+#include <mitkPlanarCircle.h>
+#include <mitkProportionalTimeGeometry.h>
+
+class mitkImageStatisticsCacheTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkImageStatisticsCacheTestSuite);
+  MITK_TEST(TestHitAndMiss);
+  MITK_TEST(TestModifiedInputs);
+  MITK_TEST(TestRemove);
+  MITK_TEST(TestMemoryLimit);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  mitk::Image::Pointer m_Image;
+  mitk::Image::Pointer m_Mask;
+  mitk::PlanarFigure::Pointer m_PlanarFigure;
+
+  static mitk::ImageStatisticsContainer::Pointer CreateStatistics(unsigned int numberOfBins)
+  {
+    typedef mitk::ImageStatisticsContainer::HistogramType HistogramType;
+
+    HistogramType::Pointer histogram = HistogramType::New();
+    HistogramType::SizeType size(1);
+    HistogramType::MeasurementVectorType lowerBound(1);
+    HistogramType::MeasurementVectorType upperBound(1);
+    size[0] = numberOfBins;
+    lowerBound[0] = 0;
+    upperBound[0] = 100;
+    histogram->SetMeasurementVectorSize(1);
+    histogram->Initialize(size, lowerBound, upperBound);
+
+    mitk::ImageStatisticsContainer::ImageStatisticsObject statisticsObject;
+    statisticsObject.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), 1.0);
+    statisticsObject.m_Histogram = histogram.GetPointer();
+
+    auto timeGeometry = mitk::ProportionalTimeGeometry::New();
+    timeGeometry->Initialize(1);
+
+    mitk::ImageStatisticsContainer::Pointer statistics = mitk::ImageStatisticsContainer::New();
+    statistics->SetTimeGeometry(timeGeometry);
+    statistics->SetStatisticsForTimeStep(0, statisticsObject);
+    return statistics;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Image = mitk::Image::New();
+    m_Mask = mitk::Image::New();
+    m_PlanarFigure = mitk::PlanarCircle::New().GetPointer();
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Mask = nullptr;
+    m_PlanarFigure = nullptr;
+  }
+
+  void TestHitAndMiss()
+  {
+    mitk::ImageStatisticsCache cache;
+    auto statistics = CreateStatistics(100);
+
+    mitk::ImageStatisticsCache::Key key(m_Image, m_Mask);
+    CPPUNIT_ASSERT_MESSAGE("Empty cache returned statistics", cache.Get(key).IsNull());
+
+    cache.Insert(key, statistics);
+    auto cachedStatistics = cache.Get(mitk::ImageStatisticsCache::Key(m_Image, m_Mask));
+    CPPUNIT_ASSERT_MESSAGE("Inserted statistics not found", cachedStatistics.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Cache returned the inserted instance", cachedStatistics != statistics);
+
+    // modifying the returned statistics does not change the cached result
+    cachedStatistics->Reset();
+    CPPUNIT_ASSERT_MESSAGE("Modified statistics returned",
+                           cache.Get(mitk::ImageStatisticsCache::Key(m_Image, m_Mask))
+                             ->GetStatisticsForTimeStep(0)
+                             .HasStatistic(mitk::ImageStatisticsConstants::MEAN()));
+
+    // other settings, mask or no mask miss
+    mitk::ImageStatisticsCache::Key otherBins(m_Image, m_Mask);
+    otherBins.m_NBins = 50;
+    CPPUNIT_ASSERT_MESSAGE("Statistics with other bins returned", cache.Get(otherBins).IsNull());
+
+    mitk::ImageStatisticsCache::Key ignoreZeros(m_Image, m_Mask);
+    ignoreZeros.m_IgnorePixelValue = true;
+    CPPUNIT_ASSERT_MESSAGE("Statistics without ignored pixels returned", cache.Get(ignoreZeros).IsNull());
+
+    CPPUNIT_ASSERT_MESSAGE("Statistics of other mask returned",
+                           cache.Get(mitk::ImageStatisticsCache::Key(m_Image, m_PlanarFigure)).IsNull());
+    CPPUNIT_ASSERT_MESSAGE("Masked statistics returned for unmasked image",
+                           cache.Get(mitk::ImageStatisticsCache::Key(m_Image)).IsNull());
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.GetNumberOfEntries());
+  }
+
+  void TestModifiedInputs()
+  {
+    mitk::ImageStatisticsCache cache;
+    cache.Insert(mitk::ImageStatisticsCache::Key(m_Image, m_Mask), CreateStatistics(100));
+    cache.Insert(mitk::ImageStatisticsCache::Key(m_Image, m_PlanarFigure), CreateStatistics(100));
+
+    m_PlanarFigure->Modified();
+    CPPUNIT_ASSERT_MESSAGE("Statistics of modified planar figure returned",
+                           cache.Get(mitk::ImageStatisticsCache::Key(m_Image, m_PlanarFigure)).IsNull());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.GetNumberOfEntries());
+    CPPUNIT_ASSERT_MESSAGE("Statistics of unmodified mask removed",
+                           cache.Get(mitk::ImageStatisticsCache::Key(m_Image, m_Mask)).IsNotNull());
+
+    // all results of an image are outdated once it is modified
+    m_Image->Modified();
+    CPPUNIT_ASSERT_MESSAGE("Statistics of modified image returned",
+                           cache.Get(mitk::ImageStatisticsCache::Key(m_Image, m_Mask)).IsNull());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.GetNumberOfEntries());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.GetMemorySize());
+  }
+
+  void TestRemove()
+  {
+    mitk::ImageStatisticsCache cache;
+    cache.Insert(mitk::ImageStatisticsCache::Key(m_Image, m_Mask), CreateStatistics(100));
+    cache.Insert(mitk::ImageStatisticsCache::Key(m_Image, m_PlanarFigure), CreateStatistics(100));
+    cache.Insert(mitk::ImageStatisticsCache::Key(m_Mask), CreateStatistics(100));
+
+    cache.Remove(m_Mask);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(1), cache.GetNumberOfEntries());
+    CPPUNIT_ASSERT(cache.Get(mitk::ImageStatisticsCache::Key(m_Image, m_PlanarFigure)).IsNotNull());
+
+    cache.Clear();
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), cache.GetNumberOfEntries());
+  }
+
+  void TestMemoryLimit()
+  {
+    mitk::ImageStatisticsCache cache;
+    auto statistics = CreateStatistics(1000);
+    const std::size_t memorySize = mitk::ImageStatisticsCache::EstimateMemorySize(statistics);
+    cache.SetMaximumMemorySize(2 * memorySize);
+
+    mitk::ImageStatisticsCache::Key first(m_Image);
+    mitk::ImageStatisticsCache::Key second(m_Image);
+    second.m_NBins = 200;
+    mitk::ImageStatisticsCache::Key third(m_Image);
+    third.m_NBins = 300;
+
+    cache.Insert(first, statistics);
+    cache.Insert(second, CreateStatistics(1000));
+    cache.Get(first);
+    cache.Insert(third, CreateStatistics(1000));
+
+    // the least recently used result is removed
+    CPPUNIT_ASSERT_EQUAL(std::size_t(2), cache.GetNumberOfEntries());
+    CPPUNIT_ASSERT(cache.GetMemorySize() <= cache.GetMaximumMemorySize());
+    CPPUNIT_ASSERT(cache.Get(first).IsNotNull());
+    CPPUNIT_ASSERT(cache.Get(second).IsNull());
+    CPPUNIT_ASSERT(cache.Get(third).IsNotNull());
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkImageStatisticsCache)
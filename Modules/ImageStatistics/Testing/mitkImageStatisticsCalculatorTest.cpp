@@ -23,8 +23,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkPlanarFigureMaskGenerator.h>
 #include <mitkImageMaskGenerator.h>
+#include <mitkMultiLabelMaskGenerator.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkImageReadAccessor.h>
 #include <mitkImageStatisticsConstants.h>
 
+#include <algorithm>
+#include <vector>
+
 /**
  * \brief Test class for mitkImageStatisticsCalculator
  *
@@ -48,6 +54,7 @@ class mitkImageStatisticsCalculatorTestSuite : public mitk::TestFixture
   MITK_TEST(TestCase10);
   MITK_TEST(TestCase11);
   MITK_TEST(TestCase12);
+  MITK_TEST(TestMovedPlanarFigure);
   MITK_TEST(TestPic3DCroppedNoMask);
   MITK_TEST(TestPic3DCroppedBinMask);
   MITK_TEST(TestPic3DCroppedMultilabelMask);
@@ -58,6 +65,8 @@ class mitkImageStatisticsCalculatorTestSuite : public mitk::TestFixture
   MITK_TEST(TestUS4DCroppedPlanarFigureTimeStep1);
   MITK_TEST(TestUS4DCroppedAllTimesteps);
   MITK_TEST(TestUS4DCropped3DMask);
+  MITK_TEST(TestMultiLabelMaskGenerator);
+  MITK_TEST(TestUS4DCroppedTimeStepsInParallel);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -76,6 +85,7 @@ public:
   void TestCase10();
   void TestCase11();
   void TestCase12();
+  void TestMovedPlanarFigure();
   
   void TestPic3DCroppedNoMask();
   void TestPic3DCroppedBinMask();
@@ -88,6 +98,10 @@ public:
   void TestUS4DCroppedPlanarFigureTimeStep1();
   void TestUS4DCroppedAllTimesteps();
   void TestUS4DCropped3DMask();
+
+  void TestMultiLabelMaskGenerator();
+
+  void TestUS4DCroppedTimeStepsInParallel();
 private:
 	mitk::Image::ConstPointer m_TestImage;
 
@@ -507,6 +521,83 @@ void mitkImageStatisticsCalculatorTestSuite::TestCase12()
 	this->VerifyStatistics(statisticsObjectTimestep0, 212.666666666666667, 59.8683741404609923, 254.36499786376954);
 }
 
+void mitkImageStatisticsCalculatorTestSuite::TestMovedPlanarFigure()
+{
+	/*****************************
+	 * whole pixel (gray), then the figure is moved to a whole pixel (white)
+	 * -> mean of 255 expected, the mask of the first position must have been reset
+	 ******************************/
+	MITK_INFO << std::endl << "Test moved planar figure:-----------------------------------------------------------------------------------";
+
+	std::string filename = this->GetTestDataFilePath("ImageStatisticsTestData/testimage.nrrd");
+	m_TestImage = mitk::IOUtil::Load<mitk::Image>(filename);
+	m_Geometry = m_TestImage->GetSlicedGeometry()->GetPlaneGeometry(0);
+
+	mitk::Point2D pnt1; pnt1[0] = 11.5; pnt1[1] = 10.5;
+	mitk::Point2D pnt2; pnt2[0] = 11.5; pnt2[1] = 11.5;
+	mitk::Point2D pnt3; pnt3[0] = 12.5; pnt3[1] = 11.5;
+	mitk::Point2D pnt4; pnt4[0] = 12.5; pnt4[1] = 10.5;
+	std::vector<mitk::Point2D> points{ pnt1,pnt2,pnt3,pnt4 };
+	auto figure = GeneratePlanarPolygon(m_Geometry, points);
+
+	mitk::PlanarFigureMaskGenerator::Pointer planFigMaskGen = mitk::PlanarFigureMaskGenerator::New();
+	planFigMaskGen->SetInputImage(m_TestImage);
+	planFigMaskGen->SetPlanarFigure(figure.GetPointer());
+
+	mitk::ImageStatisticsContainer::Pointer statisticsContainer;
+	CPPUNIT_ASSERT_NO_THROW(statisticsContainer = ComputeStatistics(m_TestImage, planFigMaskGen.GetPointer()));
+	this->VerifyStatistics(statisticsContainer->GetStatisticsForTimeStep(0), 128.0, 0.0, 128.0);
+
+	mitk::Image::Pointer firstMask = planFigMaskGen->GetMask();
+	const std::size_t firstMaskSize = firstMask->GetPixelType().GetSize() * firstMask->GetDimension(0) * firstMask->GetDimension(1);
+	std::vector<char> firstMaskPixels(firstMaskSize);
+	{
+		mitk::ImageReadAccessor firstMaskAccessor(firstMask);
+		const auto *firstMaskData = static_cast<const char *>(firstMaskAccessor.GetData());
+		std::copy(firstMaskData, firstMaskData + firstMaskSize, firstMaskPixels.begin());
+	}
+
+	pnt1[0] = 10.5; pnt1[1] = 3.5;
+	pnt2[0] = 9.5; pnt2[1] = 3.5;
+	pnt3[0] = 9.5; pnt3[1] = 4.5;
+	pnt4[0] = 10.5; pnt4[1] = 4.5;
+	figure->SetControlPoint(0, pnt1);
+	figure->SetControlPoint(1, pnt2);
+	figure->SetControlPoint(2, pnt3);
+	figure->SetControlPoint(3, pnt4);
+	figure->Modified();
+
+	CPPUNIT_ASSERT_NO_THROW(statisticsContainer = ComputeStatistics(m_TestImage, planFigMaskGen.GetPointer()));
+	this->VerifyStatistics(statisticsContainer->GetStatisticsForTimeStep(0), 255.0, 0.0, 255.0);
+
+	// the mask returned for the first position must not be changed by the calculation of the second one
+	CPPUNIT_ASSERT_MESSAGE("The mask of the first position was reused", firstMask != planFigMaskGen->GetMask());
+	{
+		mitk::ImageReadAccessor firstMaskAccessor(firstMask);
+		const auto *firstMaskData = static_cast<const char *>(firstMaskAccessor.GetData());
+		CPPUNIT_ASSERT_MESSAGE("The mask of the first position was overwritten",
+			std::equal(firstMaskPixels.begin(), firstMaskPixels.end(), firstMaskData));
+	}
+
+	// once the mask of the first position is released, the next calculation reuses it
+	const mitk::Image *firstMaskAddress = firstMask.GetPointer();
+	firstMask = nullptr;
+
+	pnt1[0] = 11.5; pnt1[1] = 10.5;
+	pnt2[0] = 11.5; pnt2[1] = 11.5;
+	pnt3[0] = 12.5; pnt3[1] = 11.5;
+	pnt4[0] = 12.5; pnt4[1] = 10.5;
+	figure->SetControlPoint(0, pnt1);
+	figure->SetControlPoint(1, pnt2);
+	figure->SetControlPoint(2, pnt3);
+	figure->SetControlPoint(3, pnt4);
+	figure->Modified();
+
+	CPPUNIT_ASSERT_NO_THROW(statisticsContainer = ComputeStatistics(m_TestImage, planFigMaskGen.GetPointer()));
+	this->VerifyStatistics(statisticsContainer->GetStatisticsForTimeStep(0), 128.0, 0.0, 128.0);
+	CPPUNIT_ASSERT_MESSAGE("The released mask was not reused", firstMaskAddress == planFigMaskGen->GetMask().GetPointer());
+}
+
 // T26098 histogram statistics need to be tested (median, uniformity, UPP, entropy)
 void mitkImageStatisticsCalculatorTestSuite::TestPic3DCroppedNoMask()
 {
@@ -1030,6 +1121,128 @@ void mitkImageStatisticsCalculatorTestSuite::TestUS4DCropped3DMask()
 		expected_maxIndex);
 }
 
+void mitkImageStatisticsCalculatorTestSuite::TestMultiLabelMaskGenerator()
+{
+	MITK_INFO << std::endl << "Test multilabel mask generator:-----------------------------------------------------------------------------------";
+
+	// the gray value of every voxel is its x index
+	mitk::Image::Pointer image = mitk::Image::New();
+	unsigned int dimensions[3] = { 10, 10, 10 };
+	image->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+	{
+		mitk::ImagePixelWriteAccessor<int, 3> accessor(image);
+		for (long z = 0; z < 10; ++z)
+			for (long y = 0; y < 10; ++y)
+				for (long x = 0; x < 10; ++x)
+				{
+					itk::Index<3> index = { { x, y, z } };
+					accessor.SetPixelByIndex(index, static_cast<int>(x));
+				}
+	}
+
+	// label 1 covers x 0..2, label 2 covers x 3..5 and label 3 covers x 6..9 in the lower half of y
+	mitk::LabelSetImage::Pointer labelSetImage = mitk::LabelSetImage::New();
+	labelSetImage->Initialize(image);
+	{
+		mitk::ImagePixelWriteAccessor<mitk::LabelSetImage::PixelType, 3> accessor(labelSetImage);
+		for (long z = 0; z < 10; ++z)
+			for (long y = 0; y < 10; ++y)
+				for (long x = 0; x < 10; ++x)
+				{
+					itk::Index<3> index = { { x, y, z } };
+					mitk::LabelSetImage::PixelType label = x < 3 ? 1 : x < 6 ? 2 : y < 5 ? 3 : 0;
+					accessor.SetPixelByIndex(index, label);
+				}
+	}
+
+	mitk::MultiLabelMaskGenerator::Pointer multiLabelMaskGen = mitk::MultiLabelMaskGenerator::New();
+	multiLabelMaskGen->SetLabelSetImage(labelSetImage);
+
+	mitk::ImageStatisticsCalculator::Pointer imgStatCalc = mitk::ImageStatisticsCalculator::New();
+	imgStatCalc->SetInputImage(image);
+	imgStatCalc->SetMask(multiLabelMaskGen.GetPointer());
+
+	const mitk::ImageStatisticsContainer::VoxelCountType expected_N[3] = { 300, 300, 200 };
+	const mitk::ImageStatisticsContainer::RealType expected_mean[3] = { 1.0, 4.0, 7.5 };
+	const mitk::ImageStatisticsContainer::RealType expected_variance[3] = { 2.0 / 3.0, 2.0 / 3.0, 1.25 };
+
+	for (unsigned short label = 1; label <= 3; ++label)
+	{
+		mitk::ImageStatisticsContainer::Pointer statisticsContainer;
+		CPPUNIT_ASSERT_NO_THROW(statisticsContainer = imgStatCalc->GetStatistics(label));
+		auto statisticsObject = statisticsContainer->GetStatisticsForTimeStep(0);
+
+		auto numberOfVoxels = statisticsObject.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS());
+		auto mean = statisticsObject.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::MEAN());
+		auto variance = statisticsObject.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(mitk::ImageStatisticsConstants::VARIANCE());
+
+		CPPUNIT_ASSERT_MESSAGE("Calculated number of voxels does not fit expected value", numberOfVoxels == expected_N[label - 1]);
+		CPPUNIT_ASSERT_MESSAGE("Calculated mean does not fit expected value", std::abs(mean - expected_mean[label - 1]) < mitk::eps);
+		CPPUNIT_ASSERT_MESSAGE("Calculated variance does not fit expected value", std::abs(variance - expected_variance[label - 1]) < mitk::eps);
+	}
+}
+
+void mitkImageStatisticsCalculatorTestSuite::TestUS4DCroppedTimeStepsInParallel()
+{
+	MITK_INFO << std::endl << "Test US4D cropped all timesteps in parallel:-----------------------------------------------------------------------------------";
+
+	std::string US4DCroppedFile = this->GetTestDataFilePath("ImageStatisticsTestData/US4D_cropped.nrrd");
+	m_US4DCroppedImage = mitk::IOUtil::Load<mitk::Image>(US4DCroppedFile);
+	CPPUNIT_ASSERT_MESSAGE("Failed loading US4D_cropped", m_US4DCroppedImage.IsNotNull());
+
+	std::string US4DCropped3DBinMaskFile = this->GetTestDataFilePath("ImageStatisticsTestData/US4D_cropped3DBinMask.nrrd");
+	m_US4DCropped3DBinMask = mitk::IOUtil::Load<mitk::Image>(US4DCropped3DBinMaskFile);
+	CPPUNIT_ASSERT_MESSAGE("Failed loading US4D 3D binary mask", m_US4DCropped3DBinMask.IsNotNull());
+
+	mitk::ImageMaskGenerator::Pointer imgMask = mitk::ImageMaskGenerator::New();
+	imgMask->SetInputImage(m_US4DCroppedImage);
+	imgMask->SetImageMask(m_US4DCropped3DBinMask);
+
+	// the parallel computation of all timesteps has to give the same results as the computation per timestep
+	for (mitk::MaskGenerator::Pointer maskGen : { mitk::MaskGenerator::Pointer(), mitk::MaskGenerator::Pointer(imgMask.GetPointer()) })
+	{
+		mitk::ImageStatisticsCalculator::Pointer sequentialCalc = mitk::ImageStatisticsCalculator::New();
+		sequentialCalc->SetInputImage(m_US4DCroppedImage);
+		sequentialCalc->SetMask(maskGen);
+		mitk::ImageStatisticsContainer::Pointer expectedContainer;
+		CPPUNIT_ASSERT_NO_THROW(expectedContainer = sequentialCalc->GetStatistics());
+
+		mitk::ImageStatisticsCalculator::Pointer parallelCalc = mitk::ImageStatisticsCalculator::New();
+		parallelCalc->SetInputImage(m_US4DCroppedImage);
+		parallelCalc->SetMask(maskGen);
+		parallelCalc->SetComputeTimeStepsInParallel(true);
+		mitk::ImageStatisticsContainer::Pointer statisticsContainer;
+		CPPUNIT_ASSERT_NO_THROW(statisticsContainer = parallelCalc->GetStatistics());
+
+		for (unsigned int timeStep = 0; timeStep < m_US4DCroppedImage->GetTimeSteps(); ++timeStep)
+		{
+			CPPUNIT_ASSERT_MESSAGE("Error computing statistics for multiple timestep", statisticsContainer->TimeStepExists(timeStep));
+			auto expected = expectedContainer->GetStatisticsForTimeStep(timeStep);
+			auto statisticsObject = statisticsContainer->GetStatisticsForTimeStep(timeStep);
+
+			CPPUNIT_ASSERT_EQUAL(expected.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS()),
+				statisticsObject.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(mitk::ImageStatisticsConstants::NUMBEROFVOXELS()));
+			CPPUNIT_ASSERT(expected.GetValueConverted<mitk::ImageStatisticsContainer::IndexType>(mitk::ImageStatisticsConstants::MINIMUMPOSITION()) ==
+				statisticsObject.GetValueConverted<mitk::ImageStatisticsContainer::IndexType>(mitk::ImageStatisticsConstants::MINIMUMPOSITION()));
+			CPPUNIT_ASSERT(expected.GetValueConverted<mitk::ImageStatisticsContainer::IndexType>(mitk::ImageStatisticsConstants::MAXIMUMPOSITION()) ==
+				statisticsObject.GetValueConverted<mitk::ImageStatisticsContainer::IndexType>(mitk::ImageStatisticsConstants::MAXIMUMPOSITION()));
+
+			for (const auto &name : { mitk::ImageStatisticsConstants::MEAN(),
+				mitk::ImageStatisticsConstants::MINIMUM(),
+				mitk::ImageStatisticsConstants::MAXIMUM(),
+				mitk::ImageStatisticsConstants::VARIANCE(),
+				mitk::ImageStatisticsConstants::MEDIAN(),
+				mitk::ImageStatisticsConstants::ENTROPY() })
+			{
+				CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(name,
+					expected.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(name),
+					statisticsObject.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(name),
+					mitk::eps);
+			}
+		}
+	}
+}
+
 mitk::PlanarPolygon::Pointer mitkImageStatisticsCalculatorTestSuite::GeneratePlanarPolygon(mitk::PlaneGeometry::Pointer geometry, std::vector <mitk::Point2D> points)
 {
 	mitk::PlanarPolygon::Pointer figure = mitk::PlanarPolygon::New();
@@ -453,7 +453,8 @@ struct mitkImageStatisticsHotspotTestClass
 
     Uses ImageStatisticsCalculator to find a hotspot in a defined ROI within the given image.
   */
-  static mitk::ImageStatisticsContainer::ImageStatisticsObject CalculateStatistics(mitk::Image* image, const Parameters& testParameters,  unsigned int label)
+  static mitk::ImageStatisticsContainer::ImageStatisticsObject CalculateStatistics(mitk::Image* image, const Parameters& testParameters,  unsigned int label,
+                                                                                   mitk::HotspotMaskGenerator::SearchMethod searchMethod)
   {
     const unsigned int Dimension = 3;
     typedef itk::Image<unsigned short, Dimension> MaskImageType;
@@ -522,6 +523,7 @@ struct mitkImageStatisticsHotspotTestClass
       hotspotMaskGen->SetLabel(testParameters.m_Label[label]);
       hotspotMaskGen->SetMask(imgMaskGen.GetPointer());
       hotspotMaskGen->SetHotspotRadiusInMM(testParameters.m_HotspotRadiusInMM);
+      hotspotMaskGen->SetSearchMethod(searchMethod);
       if(testParameters.m_EntireHotspotInImage == 1)
       {
         MITK_INFO << "Hotspot must be completly inside image";
@@ -541,6 +543,7 @@ struct mitkImageStatisticsHotspotTestClass
       mitk::HotspotMaskGenerator::Pointer hotspotMaskGen = mitk::HotspotMaskGenerator::New();
       hotspotMaskGen->SetInputImage(image);
       hotspotMaskGen->SetHotspotRadiusInMM(testParameters.m_HotspotRadiusInMM);
+      hotspotMaskGen->SetSearchMethod(searchMethod);
       if(testParameters.m_EntireHotspotInImage == 1)
       {
         MITK_INFO << "Hotspot must be completly inside image";
@@ -630,10 +633,14 @@ int mitkImageStatisticsHotspotTest(int argc, char* argv[])
 
       for(unsigned int label = 0; label < parameters.m_NumberOfLabels; ++label)
       {
-        mitk::ImageStatisticsContainer::ImageStatisticsObject statistics = mitkImageStatisticsHotspotTestClass::CalculateStatistics(image, parameters, label);
+        // both search methods have to find the same hotspot
+        for (auto searchMethod : { mitk::HotspotMaskGenerator::ConvolutionSearch, mitk::HotspotMaskGenerator::IntegralImageSearch })
+        {
+          mitk::ImageStatisticsContainer::ImageStatisticsObject statistics = mitkImageStatisticsHotspotTestClass::CalculateStatistics(image, parameters, label, searchMethod);
 
-        mitkImageStatisticsHotspotTestClass::ValidateStatistics(statistics, parameters, label);
-        std::cout << std::endl;
+          mitkImageStatisticsHotspotTestClass::ValidateStatistics(statistics, parameters, label);
+          std::cout << std::endl;
+        }
       }
 
 
@@ -0,0 +1,243 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkIncrementalImageStatisticsCalculator.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <mitkImageMaskGenerator.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkImageStatisticsCalculator.h>
+#include <mitkImageStatisticsConstants.h>
+
+class mitkIncrementalImageStatisticsCalculatorTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkIncrementalImageStatisticsCalculatorTestSuite);
+  MITK_TEST(TestCompute);
+  MITK_TEST(TestUpdateWithinRange);
+  MITK_TEST(TestUpdateChangingRange);
+  MITK_TEST(TestEmptyMask);
+  MITK_TEST(TestNonPositiveLabel);
+  MITK_TEST(TestInvalidInputs);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::IncrementalImageStatisticsCalculator::RegionType RegionType;
+
+  mitk::Image::Pointer m_Image;
+  mitk::Image::Pointer m_Mask;
+
+  void SetMask(const RegionType &region, unsigned char value)
+  {
+    mitk::ImagePixelWriteAccessor<unsigned char, 3> accessor(m_Mask);
+    const RegionType::IndexType lower = region.GetIndex();
+    const RegionType::IndexType upper = region.GetUpperIndex();
+    for (long z = lower[2]; z <= upper[2]; ++z)
+      for (long y = lower[1]; y <= upper[1]; ++y)
+        for (long x = lower[0]; x <= upper[0]; ++x)
+          accessor.SetPixelByIndex({{x, y, z}}, value);
+  }
+
+  static RegionType CreateRegion(long x, long y, long z, unsigned long sizeX, unsigned long sizeY, unsigned long sizeZ)
+  {
+    RegionType region;
+    region.SetIndex({{x, y, z}});
+    region.SetSize({{sizeX, sizeY, sizeZ}});
+    return region;
+  }
+
+  // compares with the statistics of ImageStatisticsCalculator for the current mask
+  void VerifyStatistics(const mitk::ImageStatisticsContainer::ImageStatisticsObject &statistics, double binSize = 0)
+  {
+    mitk::ImageMaskGenerator::Pointer maskGenerator = mitk::ImageMaskGenerator::New();
+    maskGenerator->SetImageMask(m_Mask);
+
+    mitk::ImageStatisticsCalculator::Pointer calculator = mitk::ImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(maskGenerator.GetPointer());
+    if (binSize > 0)
+      calculator->SetBinSizeForHistogramStatistics(binSize);
+    const auto expected = calculator->GetStatistics()->GetStatisticsForTimeStep(0);
+
+    CPPUNIT_ASSERT_EQUAL(
+      expected.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(
+        mitk::ImageStatisticsConstants::NUMBEROFVOXELS()),
+      statistics.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(
+        mitk::ImageStatisticsConstants::NUMBEROFVOXELS()));
+
+    for (const auto &name : {mitk::ImageStatisticsConstants::MEAN(),
+                             mitk::ImageStatisticsConstants::MINIMUM(),
+                             mitk::ImageStatisticsConstants::MAXIMUM(),
+                             mitk::ImageStatisticsConstants::VARIANCE(),
+                             mitk::ImageStatisticsConstants::SKEWNESS(),
+                             mitk::ImageStatisticsConstants::KURTOSIS(),
+                             mitk::ImageStatisticsConstants::RMS(),
+                             mitk::ImageStatisticsConstants::MPP(),
+                             mitk::ImageStatisticsConstants::MEDIAN(),
+                             mitk::ImageStatisticsConstants::ENTROPY(),
+                             mitk::ImageStatisticsConstants::UNIFORMITY()})
+    {
+      CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(name,
+                                           expected.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(name),
+                                           statistics.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(name),
+                                           1e-6);
+    }
+
+    for (unsigned int bin = 0; bin < expected.m_Histogram->Size(); ++bin)
+      CPPUNIT_ASSERT_EQUAL(expected.m_Histogram->GetFrequency(bin), statistics.m_Histogram->GetFrequency(bin));
+  }
+
+public:
+  void setUp() override
+  {
+    // the gray value of every voxel is x + 10 * y
+    unsigned int dimensions[3] = {10, 10, 10};
+    m_Image = mitk::Image::New();
+    m_Image->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+    {
+      mitk::ImagePixelWriteAccessor<int, 3> accessor(m_Image);
+      for (long z = 0; z < 10; ++z)
+        for (long y = 0; y < 10; ++y)
+          for (long x = 0; x < 10; ++x)
+            accessor.SetPixelByIndex({{x, y, z}}, static_cast<int>(x + 10 * y));
+    }
+
+    m_Mask = mitk::Image::New();
+    m_Mask->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dimensions);
+    this->SetMask(CreateRegion(0, 0, 0, 10, 10, 10), 0);
+    this->SetMask(CreateRegion(2, 2, 2, 4, 4, 4), 1);
+  }
+
+  void tearDown() override
+  {
+    m_Image = nullptr;
+    m_Mask = nullptr;
+  }
+
+  void TestCompute()
+  {
+    mitk::IncrementalImageStatisticsCalculator::Pointer calculator = mitk::IncrementalImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(m_Mask);
+    calculator->Compute();
+
+    const auto statistics = calculator->GetStatistics();
+    CPPUNIT_ASSERT_EQUAL(mitk::ImageStatisticsContainer::VoxelCountType(64),
+                         statistics.GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(
+                           mitk::ImageStatisticsConstants::NUMBEROFVOXELS()));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL(38.5,
+                                 statistics.GetValueConverted<mitk::ImageStatisticsContainer::RealType>(
+                                   mitk::ImageStatisticsConstants::MEAN()),
+                                 mitk::eps);
+    this->VerifyStatistics(statistics);
+  }
+
+  void TestUpdateWithinRange()
+  {
+    mitk::IncrementalImageStatisticsCalculator::Pointer calculator = mitk::IncrementalImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(m_Mask);
+    calculator->Compute();
+
+    // paint into another slice, the values are within the range of the label
+    this->SetMask(CreateRegion(3, 3, 7, 2, 2, 1), 1);
+    calculator->UpdateMaskRegion(CreateRegion(0, 0, 7, 10, 10, 1));
+    this->VerifyStatistics(calculator->GetStatistics());
+
+    // erase a part of a slice that does not contain minimum or maximum
+    this->SetMask(CreateRegion(3, 3, 3, 2, 2, 1), 0);
+    calculator->UpdateMaskRegion(CreateRegion(0, 0, 3, 10, 10, 1));
+    this->VerifyStatistics(calculator->GetStatistics());
+
+    CPPUNIT_ASSERT_EQUAL(1ul, calculator->GetNumberOfComputations());
+  }
+
+  void TestUpdateChangingRange()
+  {
+    mitk::IncrementalImageStatisticsCalculator::Pointer calculator = mitk::IncrementalImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(m_Mask);
+    calculator->SetBinSizeForHistogramStatistics(2);
+    calculator->Compute();
+
+    // a new maximum changes the histogram bins
+    this->SetMask(CreateRegion(8, 8, 5, 1, 1, 1), 1);
+    calculator->UpdateMaskRegion(CreateRegion(0, 0, 5, 10, 10, 1));
+    this->VerifyStatistics(calculator->GetStatistics(), 2);
+    CPPUNIT_ASSERT_EQUAL(2ul, calculator->GetNumberOfComputations());
+
+    // the minimum is removed
+    this->SetMask(CreateRegion(2, 2, 2, 1, 1, 1), 0);
+    calculator->UpdateMaskRegion(CreateRegion(0, 0, 2, 10, 10, 1));
+    this->VerifyStatistics(calculator->GetStatistics(), 2);
+    CPPUNIT_ASSERT_EQUAL(3ul, calculator->GetNumberOfComputations());
+
+    // a modified image is computed again
+    m_Image->Modified();
+    calculator->UpdateMaskRegion(CreateRegion(0, 0, 2, 10, 10, 1));
+    CPPUNIT_ASSERT_EQUAL(4ul, calculator->GetNumberOfComputations());
+  }
+
+  void TestEmptyMask()
+  {
+    this->SetMask(CreateRegion(0, 0, 0, 10, 10, 10), 0);
+
+    mitk::IncrementalImageStatisticsCalculator::Pointer calculator = mitk::IncrementalImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(m_Mask);
+    calculator->Compute();
+    CPPUNIT_ASSERT_EQUAL(mitk::ImageStatisticsContainer::VoxelCountType(0),
+                         calculator->GetStatistics().GetValueConverted<mitk::ImageStatisticsContainer::VoxelCountType>(
+                           mitk::ImageStatisticsConstants::NUMBEROFVOXELS()));
+
+    // the first voxels of a new segmentation
+    this->SetMask(CreateRegion(4, 4, 4, 3, 1, 1), 1);
+    calculator->UpdateMaskRegion(CreateRegion(0, 0, 4, 10, 10, 1));
+    this->VerifyStatistics(calculator->GetStatistics());
+  }
+
+  void TestNonPositiveLabel()
+  {
+    // the gray value of all voxels of the label is 0
+    this->SetMask(CreateRegion(0, 0, 0, 10, 10, 10), 0);
+    this->SetMask(CreateRegion(0, 0, 0, 1, 1, 2), 1);
+
+    mitk::IncrementalImageStatisticsCalculator::Pointer calculator = mitk::IncrementalImageStatisticsCalculator::New();
+    calculator->SetInputImage(m_Image);
+    calculator->SetMask(m_Mask);
+    calculator->Compute();
+    CPPUNIT_ASSERT_EQUAL(0.,
+                         calculator->GetStatistics().GetValueConverted<mitk::ImageStatisticsContainer::RealType>(
+                           mitk::ImageStatisticsConstants::MPP()));
+  }
+
+  void TestInvalidInputs()
+  {
+    mitk::IncrementalImageStatisticsCalculator::Pointer calculator = mitk::IncrementalImageStatisticsCalculator::New();
+    CPPUNIT_ASSERT_THROW(calculator->Compute(), mitk::Exception);
+
+    calculator->SetInputImage(m_Image);
+    CPPUNIT_ASSERT_THROW(calculator->Compute(), mitk::Exception);
+
+    unsigned int dimensions[3] = {10, 10, 5};
+    mitk::Image::Pointer smallMask = mitk::Image::New();
+    smallMask->Initialize(mitk::MakeScalarPixelType<unsigned char>(), 3, dimensions);
+    calculator->SetMask(smallMask);
+    CPPUNIT_ASSERT_THROW(calculator->Compute(), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkIncrementalImageStatisticsCalculator)
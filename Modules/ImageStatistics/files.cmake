@@ -15,6 +15,8 @@ set(CPP_FILES
   mitkImageStatisticsPredicateHelper.cpp
   mitkImageStatisticsContainerNodeHelper.cpp
   mitkImageStatisticsContainerManager.cpp
+  mitkImageStatisticsCache.cpp
+  mitkIncrementalImageStatisticsCalculator.cpp
   mitkStatisticsToImageRelationRule.cpp
   mitkStatisticsToMaskRelationRule.cpp
   mitkImageStatisticsConstants.cpp
@@ -41,6 +43,8 @@ set(H_FILES
   mitkImageStatisticsPredicateHelper.h
   mitkImageStatisticsContainerNodeHelper.h
   mitkImageStatisticsContainerManager.h
+  mitkImageStatisticsCache.h
+  mitkIncrementalImageStatisticsCalculator.h
   mitkStatisticsToImageRelationRule.h
   mitkStatisticsToMaskRelationRule.h
   mitkImageStatisticsConstants.h
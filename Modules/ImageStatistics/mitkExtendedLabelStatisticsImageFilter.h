@@ -18,6 +18,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkLabelStatisticsImageFilter.h"
 
+#include <algorithm>
+#include <list>
+#include <map>
+#include <vector>
+
 namespace itk
 {
   /**
@@ -28,7 +33,9 @@ namespace itk
   * uses its results for the calculation of seven additional coefficients:
   * the Skewness, Kurtosis, Uniformity, UPP, MPP, Entropy and Median
   *
-  *
+  * All labels of the label image are computed in a single pass. Every thread keeps its
+  * statistics in a flat table indexed by the label value, the tables are merged once
+  * after the threads have finished.
   */
   template< class TInputImage, class TLabelImage >
   class ExtendedLabelStatisticsImageFilter : public LabelStatisticsImageFilter< TInputImage,  TLabelImage >
@@ -45,6 +52,7 @@ namespace itk
     typedef typename Superclass::MapIterator                        MapIterator;
     typedef typename Superclass::BoundingBoxType                    BoundingBoxType;
     typedef typename Superclass::RegionType                         RegionType;
+    typedef typename TInputImage::IndexType                         IndexType;
     typedef  itk::Statistics::Histogram<double> HistogramType;
 
     itkFactorylessNewMacro( Self );
@@ -69,10 +77,6 @@ namespace itk
         m_Sum = NumericTraits< RealType >::ZeroValue();
         m_SumOfPositivePixels = NumericTraits< RealType >::ZeroValue();
 
-        m_SumOfSquares = NumericTraits< RealType >::ZeroValue();
-        m_SumOfCubes = NumericTraits< RealType >::ZeroValue();
-        m_SumOfQuadruples = NumericTraits< RealType >::ZeroValue();
-
         // Set such that the first pixel encountered can be compared
         m_Minimum = NumericTraits< RealType >::max();
         m_Maximum = NumericTraits< RealType >::NonpositiveMin();
@@ -99,121 +103,11 @@ namespace itk
         m_Histogram = nullptr;
       }
 
-      // constructor with histogram enabled
-      LabelStatistics(int size, RealType lowerBound, RealType upperBound)
-      {
-        // initialized to the default values
-        m_Count = NumericTraits< IdentifierType >::ZeroValue();
-        m_PositivePixelCount = NumericTraits< IdentifierType >::ZeroValue();
-        m_Sum = NumericTraits< RealType >::ZeroValue();
-        m_SumOfPositivePixels = NumericTraits< RealType >::ZeroValue();
-
-        m_SumOfSquares = NumericTraits< RealType >::ZeroValue();
-        m_SumOfCubes = NumericTraits< RealType >::ZeroValue();
-        m_SumOfQuadruples = NumericTraits< RealType >::ZeroValue();
-
-        // Set such that the first pixel encountered can be compared
-        m_Minimum = NumericTraits< RealType >::max();
-        m_Maximum = NumericTraits< RealType >::NonpositiveMin();
-
-        // Default these to zero
-        m_Mean = NumericTraits< RealType >::ZeroValue();
-        m_Sigma = NumericTraits< RealType >::ZeroValue();
-        m_Variance = NumericTraits< RealType >::ZeroValue();
-        m_MPP = NumericTraits< RealType >::ZeroValue();
-        m_Median = NumericTraits< RealType >::ZeroValue();
-        m_Uniformity = NumericTraits< RealType >::ZeroValue();
-        m_UPP = NumericTraits< RealType >::ZeroValue();
-        m_Entropy = NumericTraits< RealType >::ZeroValue();
-        m_Skewness = NumericTraits< RealType >::ZeroValue();
-        m_Kurtosis = NumericTraits< RealType >::ZeroValue();
-
-
-        unsigned int imageDimension = itkGetStaticConstMacro(ImageDimension);
-        m_BoundingBox.resize(imageDimension * 2);
-        for ( unsigned int i = 0; i < imageDimension * 2; i += 2 )
-          {
-          m_BoundingBox[i] = NumericTraits< IndexValueType >::max();
-          m_BoundingBox[i + 1] = NumericTraits< IndexValueType >::NonpositiveMin();
-          }
-
-        // Histogram
-        m_Histogram = HistogramType::New();
-        typename HistogramType::SizeType hsize;
-        typename HistogramType::MeasurementVectorType lb;
-        typename HistogramType::MeasurementVectorType ub;
-        hsize.SetSize(1);
-        lb.SetSize(1);
-        ub.SetSize(1);
-        m_Histogram->SetMeasurementVectorSize(1);
-        hsize[0] = size;
-        lb[0] = lowerBound;
-        ub[0] = upperBound;
-        m_Histogram->Initialize(hsize, lb, ub);
-      }
-
-      // need copy constructor because of smart pointer to histogram
-      LabelStatistics(const LabelStatistics & l)
-      {
-        m_Count = l.m_Count;
-        m_Minimum = l.m_Minimum;
-        m_Maximum = l.m_Maximum;
-        m_Mean = l.m_Mean;
-        m_Sum = l.m_Sum;
-        m_SumOfSquares = l.m_SumOfSquares;
-        m_Sigma = l.m_Sigma;
-        m_Variance = l.m_Variance;
-        m_MPP = l.m_MPP;
-        m_Median = l.m_Median;
-        m_Uniformity = l.m_Uniformity;
-        m_UPP = l.m_UPP;
-        m_Entropy = l.m_Entropy;
-        m_Skewness = l.m_Skewness;
-        m_Kurtosis = l.m_Kurtosis;
-        m_BoundingBox = l.m_BoundingBox;
-        m_Histogram = l.m_Histogram;
-        m_SumOfPositivePixels = l.m_SumOfPositivePixels;
-        m_PositivePixelCount = l.m_PositivePixelCount;
-        m_SumOfCubes = l.m_SumOfCubes;
-        m_SumOfQuadruples = l.m_SumOfQuadruples;
-      }
-
-      // added for completeness
-      LabelStatistics &operator= (const LabelStatistics& l)
-      {
-        if(this != &l)
-          {
-          m_Count = l.m_Count;
-          m_Minimum = l.m_Minimum;
-          m_Maximum = l.m_Maximum;
-          m_Mean = l.m_Mean;
-          m_Sum = l.m_Sum;
-          m_SumOfSquares = l.m_SumOfSquares;
-          m_Sigma = l.m_Sigma;
-          m_Variance = l.m_Variance;
-          m_MPP = l.m_MPP;
-          m_Median = l.m_Median;
-          m_Uniformity = l.m_Uniformity;
-          m_UPP = l.m_UPP;
-          m_Entropy = l.m_Entropy;
-          m_Skewness = l.m_Skewness;
-          m_Kurtosis = l.m_Kurtosis;
-          m_BoundingBox = l.m_BoundingBox;
-          m_Histogram = l.m_Histogram;
-          m_SumOfPositivePixels = l.m_SumOfPositivePixels;
-          m_PositivePixelCount = l.m_PositivePixelCount;
-          m_SumOfCubes = l.m_SumOfCubes;
-          m_SumOfQuadruples = l.m_SumOfQuadruples;
-          }
-        return *this;
-      }
-
       IdentifierType  m_Count;
       RealType        m_Minimum;
       RealType        m_Maximum;
       RealType        m_Mean;
       RealType        m_Sum;
-      RealType        m_SumOfSquares;
       RealType        m_Sigma;
       RealType        m_Variance;
       RealType        m_MPP;
@@ -225,16 +119,12 @@ namespace itk
       RealType        m_Kurtosis;
       IdentifierType  m_PositivePixelCount;
       RealType        m_SumOfPositivePixels;
-      RealType        m_SumOfCubes;
-      RealType        m_SumOfQuadruples;
       typename Superclass::BoundingBoxType m_BoundingBox;
       typename HistogramType::Pointer m_Histogram;
     };
 
-    /** Type of the map used to store data per label */
-    typedef itksys::hash_map< LabelPixelType, LabelStatistics >                          MapType;
-    typedef typename itksys::hash_map< LabelPixelType, LabelStatistics >::const_iterator StatisticsMapConstIterator;
-    typedef typename itksys::hash_map< LabelPixelType, LabelStatistics >::iterator       StatisticsMapIterator;
+    /** Type of the container used to store the statistics, sorted by label value */
+    typedef std::vector<LabelStatistics>                                                 StatisticsContainerType;
     typedef IdentifierType                                                               MapSizeType;
 
     /** Type of the container used to store valid label values */
@@ -281,8 +171,15 @@ namespace itk
 
     bool             GetMaskingNonEmpty() const;
 
+    /** Return all labels found in the label image, in ascending order. */
     std::list<int> GetRelevantLabels() const;
 
+    /** Return all labels found in the label image, in ascending order. */
+    const ValidLabelValuesContainerType & GetValidLabelValues() const
+    {
+      return m_ValidLabelValues;
+    }
+
 
     /** specify global Histogram parameters. If the histogram parameters are set with this function, the same min and max value are used for all histograms.  */
     void SetHistogramParameters(const int numBins, RealType lowerBound,
@@ -318,12 +215,147 @@ namespace itk
      * a call to Update(). */
     bool HasLabel(LabelPixelType label) const
     {
-      return m_LabelStatistics.find(label) != m_LabelStatistics.end();
+      return this->FindLabelStatistics(label) != nullptr;
     }
 
   private:
-    std::vector< MapType >        m_LabelStatisticsPerThread;
-    MapType                       m_LabelStatistics;
+    typedef typename HistogramType::AbsoluteFrequencyType FrequencyType;
+
+    /** Running statistics of one label in one thread. Mean and central moments are updated with
+     * Welford's method, so no power sums have to be kept and the merge of the threads is exact
+     * up to rounding. The histogram is a plain array of counts, the bin of a value is computed
+     * from the bin width and only corrected against the bin borders of m_Histogram. */
+    struct LabelAccumulator
+    {
+      explicit LabelAccumulator(LabelPixelType label)
+        : m_Label(label),
+          m_Count(0),
+          m_Sum(0.0),
+          m_Mean(0.0),
+          m_M2(0.0),
+          m_M3(0.0),
+          m_M4(0.0),
+          m_Minimum(NumericTraits< RealType >::max()),
+          m_Maximum(NumericTraits< RealType >::NonpositiveMin()),
+          m_PositivePixelCount(0),
+          m_SumOfPositivePixels(0.0),
+          m_HistogramLowerBound(0.0),
+          m_HistogramUpperBound(0.0),
+          m_BinWidth(0.0)
+      {
+        m_LowerIndex.Fill(NumericTraits< IndexValueType >::max());
+        m_UpperIndex.Fill(NumericTraits< IndexValueType >::NonpositiveMin());
+      }
+
+      void AddValue(RealType value)
+      {
+        const RealType n1 = static_cast< RealType >( m_Count++ );
+        const RealType n = n1 + 1.0;
+        const RealType delta = value - m_Mean;
+        const RealType deltaN = delta / n;
+        const RealType deltaN2 = deltaN * deltaN;
+        const RealType term1 = delta * deltaN * n1;
+
+        m_Mean += deltaN;
+        m_M4 += term1 * deltaN2 * ( n * n - 3.0 * n + 3.0 ) + 6.0 * deltaN2 * m_M2 - 4.0 * deltaN * m_M3;
+        m_M3 += term1 * deltaN * ( n - 2.0 ) - 3.0 * deltaN * m_M2;
+        m_M2 += term1;
+        m_Sum += value;
+
+        if ( value < m_Minimum )
+          {
+          m_Minimum = value;
+          }
+        if ( value > m_Maximum )
+          {
+          m_Maximum = value;
+          }
+        if ( value > 0 )
+          {
+          ++m_PositivePixelCount;
+          m_SumOfPositivePixels += value;
+          }
+
+        // values outside of the histogram range are not counted, like in itk::Statistics::Histogram
+        if ( !m_Frequencies.empty() && value >= m_HistogramLowerBound && value <= m_HistogramUpperBound )
+          {
+          const std::size_t lastBin = m_Frequencies.size() - 1;
+          std::size_t bin = lastBin;
+          if ( m_BinWidth > 0 )
+            {
+            bin = std::min( lastBin, static_cast< std::size_t >( ( value - m_HistogramLowerBound ) / m_BinWidth ) );
+            }
+          while ( bin > 0 && value < m_BinMinimums[bin] )
+            {
+            --bin;
+            }
+          while ( bin < lastBin && value >= m_BinMinimums[bin + 1] )
+            {
+            ++bin;
+            }
+          ++m_Frequencies[bin];
+          }
+      }
+
+      /** Extends the bounding box by a run of pixels along the first dimension. */
+      void AddRun(const IndexType & lineIndex, IndexValueType first, IndexValueType last)
+      {
+        m_LowerIndex[0] = std::min( m_LowerIndex[0], first );
+        m_UpperIndex[0] = std::max( m_UpperIndex[0], last );
+        for ( unsigned int i = 1; i < itkGetStaticConstMacro(ImageDimension); ++i )
+          {
+          m_LowerIndex[i] = std::min( m_LowerIndex[i], lineIndex[i] );
+          m_UpperIndex[i] = std::max( m_UpperIndex[i], lineIndex[i] );
+          }
+      }
+
+      LabelPixelType                  m_Label;
+      IdentifierType                  m_Count;
+      RealType                        m_Sum;
+      RealType                        m_Mean;
+      RealType                        m_M2;
+      RealType                        m_M3;
+      RealType                        m_M4;
+      RealType                        m_Minimum;
+      RealType                        m_Maximum;
+      IdentifierType                  m_PositivePixelCount;
+      RealType                        m_SumOfPositivePixels;
+      IndexType                       m_LowerIndex;
+      IndexType                       m_UpperIndex;
+      typename HistogramType::Pointer m_Histogram;
+      RealType                        m_HistogramLowerBound;
+      RealType                        m_HistogramUpperBound;
+      RealType                        m_BinWidth;
+      std::vector< RealType >         m_BinMinimums;
+      std::vector< FrequencyType >    m_Frequencies;
+    };
+
+    /** Flat table of the accumulators of one thread. Small non-negative label values index
+     * m_DenseSlots directly, all other label values are kept in m_SparseSlots. */
+    struct LabelTable
+    {
+      std::vector< int >                m_DenseSlots;
+      std::map< LabelPixelType, int >   m_SparseSlots;
+      std::vector< LabelAccumulator >   m_Accumulators;
+    };
+
+    /** Returns true and the table index of label if label is a small non-negative integer. */
+    static bool GetDenseLabelIndex(LabelPixelType label, std::size_t & index);
+
+    /** Returns the slot of label in table or -1 if the label has not been added yet. */
+    static int FindSlot(const LabelTable & table, LabelPixelType label);
+    static void AddSlot(LabelTable & table, LabelPixelType label, int slot);
+
+    /** Returns the slot of label in table, adds an accumulator with the histogram parameters of label if necessary. */
+    int GetOrCreateSlot(LabelTable & table, LabelPixelType label) const;
+
+    /** Adds the values accumulated in source to target. */
+    static void MergeAccumulator(LabelAccumulator & target, const LabelAccumulator & source);
+
+    const LabelStatistics * FindLabelStatistics(LabelPixelType label) const;
+
+    std::vector< LabelTable >     m_LabelTablePerThread;
+    StatisticsContainerType       m_LabelStatistics;
     ValidLabelValuesContainerType m_ValidLabelValues;
 
     bool m_GlobalHistogramParametersSet;
@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageRegionConstIterator.h"
+#include "itkImageScanlineConstIterator.h"
+#include "itkProgressReporter.h"
 #include <mbilog.h>
 #include <mitkLogMacros.h>
 #include "mitkNumericConstants.h"
@@ -68,18 +70,13 @@ namespace itk
     ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
     ::GetUniformity(LabelPixelType label) const
   {
-    StatisticsMapConstIterator      mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
-    {
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
+      {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::Zero;
-    }
-    else
-    {
-      return ( *mapIt ).second.m_Uniformity;
-    }
+      }
+    return labelStats->m_Uniformity;
   }
 
 
@@ -88,18 +85,13 @@ namespace itk
     ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
     ::GetMedian(LabelPixelType label) const
   {
-    StatisticsMapConstIterator      mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
-    {
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
+      {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::Zero;
-    }
-    else
-    {
-      return ( *mapIt ).second.m_Median;
-    }
+      }
+    return labelStats->m_Median;
   }
 
   template< class TInputImage, class TLabelImage >
@@ -107,18 +99,13 @@ namespace itk
     ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
     ::GetEntropy(LabelPixelType label) const
   {
-    StatisticsMapConstIterator      mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
-    {
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
+      {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::Zero;
-    }
-    else
-    {
-      return ( *mapIt ).second.m_Entropy;
-    }
+      }
+    return labelStats->m_Entropy;
   }
 
   template< class TInputImage, class TLabelImage >
@@ -126,18 +113,13 @@ namespace itk
     ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
     ::GetUPP(LabelPixelType label) const
   {
-    StatisticsMapConstIterator      mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
-    {
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
+      {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::Zero;
-    }
-    else
-    {
-      return ( *mapIt ).second.m_UPP;
-    }
+      }
+    return labelStats->m_UPP;
   }
 
   template< class TInputImage, class TLabelImage >
@@ -145,18 +127,13 @@ namespace itk
     ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
     ::GetMPP(LabelPixelType label) const
   {
-    StatisticsMapConstIterator      mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
-    {
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
+      {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::Zero;
-    }
-    else
-    {
-      return ( *mapIt ).second.m_MPP;
-    }
+      }
+    return labelStats->m_MPP;
   }
 
   template< class TInputImage, class TLabelImage >
@@ -164,18 +141,13 @@ namespace itk
     ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
     ::GetKurtosis(LabelPixelType label) const
   {
-    StatisticsMapConstIterator      mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
-    {
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
+      {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::Zero;
-    }
-    else
-    {
-      return ( *mapIt ).second.m_Kurtosis;
-    }
+      }
+    return labelStats->m_Kurtosis;
   }
 
 
@@ -184,18 +156,13 @@ namespace itk
     ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
     ::GetSkewness(LabelPixelType label) const
   {
-    StatisticsMapConstIterator      mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
-    {
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
+      {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::Zero;
-    }
-    else
-    {
-      return ( *mapIt ).second.m_Skewness;
-    }
+      }
+    return labelStats->m_Skewness;
   }
 
 
@@ -205,18 +172,13 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetMinimum(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::max();
       }
-    else
-      {
-      return ( *mapIt ).second.m_Minimum;
-      }
+    return labelStats->m_Minimum;
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -224,18 +186,13 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetMaximum(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::NonpositiveMin();
       }
-    else
-      {
-      return ( *mapIt ).second.m_Maximum;
-      }
+    return labelStats->m_Maximum;
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -243,18 +200,13 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetMean(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::ZeroValue();
       }
-    else
-      {
-      return ( *mapIt ).second.m_Mean;
-      }
+    return labelStats->m_Mean;
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -262,18 +214,13 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetSum(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::ZeroValue();
       }
-    else
-      {
-      return ( *mapIt ).second.m_Sum;
-      }
+    return labelStats->m_Sum;
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -281,18 +228,13 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetSigma(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::ZeroValue();
       }
-    else
-      {
-      return ( *mapIt ).second.m_Sigma;
-      }
+    return labelStats->m_Sigma;
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -300,18 +242,13 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetVariance(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return NumericTraits< PixelType >::ZeroValue();
       }
-    else
-      {
-      return ( *mapIt ).second.m_Variance;
-      }
+    return labelStats->m_Variance;
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -319,19 +256,14 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetBoundingBox(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       typename Superclass::BoundingBoxType emptyBox;
       // label does not exist, return a default value
       return emptyBox;
       }
-    else
-      {
-      return ( *mapIt ).second.m_BoundingBox;
-      }
+    return labelStats->m_BoundingBox;
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -339,11 +271,7 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetRegion(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-
-    if ( mapIt == m_LabelStatistics.end() )
+    if ( !this->HasLabel(label) )
       {
       typename Superclass::RegionType emptyRegion;
       // label does not exist, return a default value
@@ -375,18 +303,13 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetCount(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return 0;
       }
-    else
-      {
-      return ( *mapIt ).second.m_Count;
-      }
+    return labelStats->m_Count;
   }
 
 
@@ -395,41 +318,33 @@ namespace itk
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
   ::GetHistogram(LabelPixelType label) const
   {
-    StatisticsMapConstIterator mapIt;
-
-    mapIt = m_LabelStatistics.find(label);
-    if ( mapIt == m_LabelStatistics.end() )
+    const LabelStatistics *labelStats = this->FindLabelStatistics(label);
+    if ( labelStats == nullptr )
       {
       // label does not exist, return a default value
       return ITK_NULLPTR;
       }
-    else
-      {
-      // this will be zero if histograms have not been enabled
-      return ( *mapIt ).second.m_Histogram;
-      }
+    // this will be zero if histograms have not been enabled
+    return labelStats->m_Histogram;
   }
 
 
 
+
   template< typename TInputImage, typename TLabelImage >
-  void
+  const typename ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >::LabelStatistics *
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
-  ::BeforeThreadedGenerateData()
+  ::FindLabelStatistics(LabelPixelType label) const
   {
-    ThreadIdType numberOfThreads = this->GetNumberOfThreads();
-
-    // Resize the thread temporaries
-    m_LabelStatisticsPerThread.resize(numberOfThreads);
+    // m_ValidLabelValues is sorted and parallel to m_LabelStatistics
+    typename ValidLabelValuesContainerType::const_iterator labelIt =
+      std::lower_bound(m_ValidLabelValues.begin(), m_ValidLabelValues.end(), label);
 
-    // Initialize the temporaries
-    for ( ThreadIdType i = 0; i < numberOfThreads; ++i )
+    if ( labelIt == m_ValidLabelValues.end() || *labelIt != label )
       {
-      m_LabelStatisticsPerThread[i].clear();
+      return nullptr;
       }
-
-    // Initialize the final map
-    m_LabelStatistics.clear();
+    return &m_LabelStatistics[labelIt - m_ValidLabelValues.begin()];
   }
 
   template< typename TInputImage, typename TLabelImage >
@@ -438,163 +353,270 @@ namespace itk
     ::GetRelevantLabels() const
   {
     std::list< int> relevantLabels;
-    for (int i = 0; i < 4096; ++i )
+    for ( LabelPixelType label : m_ValidLabelValues )
     {
-      if ( this->HasLabel( i ) )
-      {
-        relevantLabels.push_back( i );
-      }
+      relevantLabels.push_back( static_cast< int >( label ) );
     }
     return relevantLabels;
   }
 
+  template< typename TInputImage, typename TLabelImage >
+  bool
+  ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
+  ::GetDenseLabelIndex(LabelPixelType label, std::size_t & index)
+  {
+    // label values below this limit are looked up directly, this covers all labels of a LabelSetImage
+    const double denseLabelTableSize = 65536.0;
+
+    const double value = static_cast< double >( label );
+    if ( !( value >= 0.0 && value < denseLabelTableSize ) )
+      {
+      return false;
+      }
+    index = static_cast< std::size_t >( value );
+    return static_cast< double >( index ) == value;
+  }
+
+  template< typename TInputImage, typename TLabelImage >
+  int
+  ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
+  ::FindSlot(const LabelTable & table, LabelPixelType label)
+  {
+    std::size_t index;
+    if ( GetDenseLabelIndex(label, index) )
+      {
+      return index < table.m_DenseSlots.size() ? table.m_DenseSlots[index] : -1;
+      }
+
+    typename std::map< LabelPixelType, int >::const_iterator slotIt = table.m_SparseSlots.find(label);
+    return slotIt != table.m_SparseSlots.end() ? slotIt->second : -1;
+  }
+
   template< typename TInputImage, typename TLabelImage >
   void
   ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
-  ::ThreadedGenerateData(const typename TInputImage::RegionType & outputRegionForThread,
-                         ThreadIdType threadId)
+  ::AddSlot(LabelTable & table, LabelPixelType label, int slot)
   {
+    std::size_t index;
+    if ( GetDenseLabelIndex(label, index) )
+      {
+      if ( index >= table.m_DenseSlots.size() )
+        {
+        table.m_DenseSlots.resize(index + 1, -1);
+        }
+      table.m_DenseSlots[index] = slot;
+      }
+    else
+      {
+      table.m_SparseSlots[label] = slot;
+      }
+  }
 
-    typename HistogramType::IndexType histogramIndex(1);
-    typename HistogramType::MeasurementVectorType histogramMeasurement(1);
+  template< typename TInputImage, typename TLabelImage >
+  int
+  ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
+  ::GetOrCreateSlot(LabelTable & table, LabelPixelType label) const
+  {
+    int slot = FindSlot(table, label);
+    if ( slot >= 0 )
+      {
+      return slot;
+      }
+
+    bool useHistogram = false;
+    unsigned int numberOfBins = 0;
+    RealType lowerBound = 0.0;
+    RealType upperBound = 0.0;
+
+    // if global histogram parameters are set and preferred then use them
+    if ( m_PreferGlobalHistogramParameters && m_GlobalHistogramParametersSet )
+      {
+      useHistogram = true;
+      numberOfBins = m_NumBins[0];
+      lowerBound = m_LowerBound;
+      upperBound = m_UpperBound;
+      }
+    // if we have label histogram parameters then use them. If we encounter a label that has no parameters then use global settings if available
+    else if ( !m_PreferGlobalHistogramParameters && m_LabelHistogramParametersSet )
+      {
+      typename std::map<LabelPixelType, PixelType>::const_iterator lbIt = m_LabelMin.find(label);
+      typename std::map<LabelPixelType, PixelType>::const_iterator ubIt = m_LabelMax.find(label);
+      typename std::map<LabelPixelType, unsigned int>::const_iterator nbIt = m_LabelNBins.find(label);
+
+      // label histogram parameters are available, use them!
+      if ( lbIt != m_LabelMin.end() && ubIt != m_LabelMax.end() && nbIt != m_LabelNBins.end() )
+        {
+        useHistogram = true;
+        numberOfBins = nbIt->second;
+        lowerBound = lbIt->second;
+        upperBound = ubIt->second;
+        }
+      // if any of the parameters is lacking for the current label but global histogram params are available, use the global parameters
+      else if ( m_GlobalHistogramParametersSet )
+        {
+        useHistogram = true;
+        numberOfBins = m_NumBins[0];
+        lowerBound = m_LowerBound;
+        upperBound = m_UpperBound;
+        }
+      }
+
+    LabelAccumulator accumulator(label);
+    if ( useHistogram && numberOfBins > 0 )
+      {
+      typename HistogramType::SizeType size(1);
+      typename HistogramType::MeasurementVectorType lb(1);
+      typename HistogramType::MeasurementVectorType ub(1);
+      size[0] = numberOfBins;
+      lb[0] = lowerBound;
+      ub[0] = upperBound;
+
+      accumulator.m_Histogram = HistogramType::New();
+      accumulator.m_Histogram->SetMeasurementVectorSize(1);
+      accumulator.m_Histogram->Initialize(size, lb, ub);
+
+      // keep the bin borders of the histogram, so values are counted in the same bins as by
+      // itk::Statistics::Histogram::GetIndex()
+      accumulator.m_HistogramLowerBound = accumulator.m_Histogram->GetBinMin(0, 0);
+      accumulator.m_HistogramUpperBound = accumulator.m_Histogram->GetBinMax(0, numberOfBins - 1);
+      accumulator.m_BinWidth = ( upperBound - lowerBound ) / static_cast< RealType >( numberOfBins );
+      accumulator.m_BinMinimums.resize(numberOfBins);
+      for ( unsigned int bin = 0; bin < numberOfBins; ++bin )
+        {
+        accumulator.m_BinMinimums[bin] = accumulator.m_Histogram->GetBinMin(0, bin);
+        }
+      accumulator.m_Frequencies.assign(numberOfBins, 0);
+      }
+
+    slot = static_cast< int >( table.m_Accumulators.size() );
+    table.m_Accumulators.push_back(accumulator);
+    AddSlot(table, label, slot);
+    return slot;
+  }
+
+  template< typename TInputImage, typename TLabelImage >
+  void
+  ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
+  ::MergeAccumulator(LabelAccumulator & target, const LabelAccumulator & source)
+  {
+    // pairwise update of the central moments, see Chan et al. and Pebay, "Formulas for robust,
+    // one-pass parallel computation of covariances and arbitrary-order statistical moments"
+    const RealType na = static_cast< RealType >( target.m_Count );
+    const RealType nb = static_cast< RealType >( source.m_Count );
+    const RealType n = na + nb;
+    const RealType delta = source.m_Mean - target.m_Mean;
+    const RealType delta2 = delta * delta;
+    const RealType nanb = na * nb;
+
+    const RealType m2 = target.m_M2 + source.m_M2 + delta2 * nanb / n;
+    const RealType m3 = target.m_M3 + source.m_M3 + delta2 * delta * nanb * ( na - nb ) / ( n * n )
+                        + 3.0 * delta * ( na * source.m_M2 - nb * target.m_M2 ) / n;
+    const RealType m4 = target.m_M4 + source.m_M4
+                        + delta2 * delta2 * nanb * ( na * na - nanb + nb * nb ) / ( n * n * n )
+                        + 6.0 * delta2 * ( na * na * source.m_M2 + nb * nb * target.m_M2 ) / ( n * n )
+                        + 4.0 * delta * ( na * source.m_M3 - nb * target.m_M3 ) / n;
+
+    target.m_Mean += delta * nb / n;
+    target.m_M2 = m2;
+    target.m_M3 = m3;
+    target.m_M4 = m4;
+    target.m_Count += source.m_Count;
+    target.m_Sum += source.m_Sum;
+    target.m_Minimum = std::min(target.m_Minimum, source.m_Minimum);
+    target.m_Maximum = std::max(target.m_Maximum, source.m_Maximum);
+    target.m_PositivePixelCount += source.m_PositivePixelCount;
+    target.m_SumOfPositivePixels += source.m_SumOfPositivePixels;
+
+    for ( unsigned int i = 0; i < itkGetStaticConstMacro(ImageDimension); ++i )
+      {
+      target.m_LowerIndex[i] = std::min(target.m_LowerIndex[i], source.m_LowerIndex[i]);
+      target.m_UpperIndex[i] = std::max(target.m_UpperIndex[i], source.m_UpperIndex[i]);
+      }
+
+    // all threads use the same histogram parameters for a label
+    for ( std::size_t bin = 0; bin < target.m_Frequencies.size(); ++bin )
+      {
+      target.m_Frequencies[bin] += source.m_Frequencies[bin];
+      }
+  }
 
+  template< typename TInputImage, typename TLabelImage >
+  void
+  ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
+  ::BeforeThreadedGenerateData()
+  {
+    ThreadIdType numberOfThreads = this->GetNumberOfThreads();
+
+    // Resize and initialize the thread temporaries
+    m_LabelTablePerThread.clear();
+    m_LabelTablePerThread.resize(numberOfThreads);
+
+    // Initialize the final tables
+    m_LabelStatistics.clear();
+    m_ValidLabelValues.clear();
+  }
+
+  template< typename TInputImage, typename TLabelImage >
+  void
+  ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >
+  ::ThreadedGenerateData(const typename TInputImage::RegionType & outputRegionForThread,
+                         ThreadIdType threadId)
+  {
     const SizeValueType size0 = outputRegionForThread.GetSize(0);
     if( size0 == 0)
       {
       return;
       }
 
-    ImageLinearConstIteratorWithIndex< TInputImage > it (this->GetInput(),
-                                                         outputRegionForThread);
+    ImageScanlineConstIterator< TInputImage > it (this->GetInput(),
+                                                  outputRegionForThread);
 
     ImageScanlineConstIterator< TLabelImage > labelIt (this->GetLabelInput(),
                                                        outputRegionForThread);
 
-    StatisticsMapIterator mapIt;
+    LabelTable & table = m_LabelTablePerThread[threadId];
 
     // support progress methods/callbacks
     const size_t numberOfLinesToProcess = outputRegionForThread.GetNumberOfPixels() / size0;
     ProgressReporter progress( this, threadId, numberOfLinesToProcess );
 
-    typedef typename MapType::value_type MapValueType;
-
     // do the work
     while ( !it.IsAtEnd() )
       {
-      while ( !it.IsAtEndOfLine() )
-        {
-        const RealType & value = static_cast< RealType >( it.Get() );
-
-        const LabelPixelType & label = labelIt.Get();
-
-        // is the label already in this thread?
-        mapIt = m_LabelStatisticsPerThread[threadId].find(label);
-        if ( mapIt == m_LabelStatisticsPerThread[threadId].end() )
-          {
-          // if global histogram parameters are set and preferred then use them
-          if ( m_PreferGlobalHistogramParameters && m_GlobalHistogramParametersSet )
-            {
-            mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                               LabelStatistics(m_NumBins[0], m_LowerBound,
-                                                                                               m_UpperBound) ) ).first;
-            }
-          // if we have label histogram parameters then use them. If we encounter a label that has no parameters then use global settings if available
-          else if(!m_PreferGlobalHistogramParameters && m_LabelHistogramParametersSet)
-          {
-            typename std::map<LabelPixelType, PixelType>::iterator lbIt, ubIt;
-            typename std::map<LabelPixelType, unsigned int>::iterator nbIt;
-
-            lbIt = m_LabelMin.find(label);
-            ubIt = m_LabelMax.find(label);
-            nbIt = m_LabelNBins.find(label);
-
-            // if any of the parameters is lacking for the current label but global histogram params are available, use the global parameters
-            if ((lbIt == m_LabelMin.end() || ubIt == m_LabelMax.end() || nbIt == m_LabelNBins.end()) && m_GlobalHistogramParametersSet)
-            {
-              mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                                 LabelStatistics(m_NumBins[0], m_LowerBound,
-                                                                                                 m_UpperBound) ) ).first;
-            }
-            // if any of the parameters is lacking for the current label and global histogram params are not available, dont use histograms for this label
-            else if ((lbIt == m_LabelMin.end() || ubIt == m_LabelMax.end() || nbIt == m_LabelNBins.end()) && !m_GlobalHistogramParametersSet)
-            {
-              mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                                 LabelStatistics() ) ).first;
-            }
-            // label histogram parameters are available, use them!
-            else
-            {
-              PixelType lowerBound, upperBound;
-              unsigned int nBins;
-              lowerBound = (*lbIt).second;
-              upperBound = (*ubIt).second;
-              nBins = (*nbIt).second;
-              mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                                 LabelStatistics(nBins, lowerBound, upperBound) ) ).first;
-            }
-          }
-          // neither global nor label specific histogram parameters are set -> don't use histograms
-          else
-            {
-            mapIt = m_LabelStatisticsPerThread[threadId].insert( MapValueType( label,
-                                                                               LabelStatistics() ) ).first;
-            }
-          }
+      const IndexType lineIndex = it.GetIndex();
+      IndexValueType x = lineIndex[0];
 
-        typename MapType::mapped_type &labelStats = ( *mapIt ).second;
+      // labels mostly come in runs, the slot is only looked up when the label changes
+      int slot = -1;
+      LabelPixelType currentLabel = NumericTraits< LabelPixelType >::ZeroValue();
+      IndexValueType runStart = x;
 
-        // update the values for this label and this thread
-        if ( value < labelStats.m_Minimum )
-          {
-          labelStats.m_Minimum = value;
-          }
-        if ( value > labelStats.m_Maximum )
-          {
-          labelStats.m_Maximum = value;
-          }
-
-        // bounding box is min,max pairs
-        for ( unsigned int i = 0; i < ( 2 * TInputImage::ImageDimension ); i += 2 )
+      while ( !it.IsAtEndOfLine() )
+        {
+        const LabelPixelType label = labelIt.Get();
+        if ( slot < 0 || label != currentLabel )
           {
-          const typename TInputImage::IndexType & index = it.GetIndex();
-          if ( labelStats.m_BoundingBox[i] > index[i / 2] )
+          if ( slot >= 0 )
             {
-            labelStats.m_BoundingBox[i] = index[i / 2];
-            }
-          if ( labelStats.m_BoundingBox[i + 1] < index[i / 2] )
-            {
-            labelStats.m_BoundingBox[i + 1] = index[i / 2];
+            table.m_Accumulators[slot].AddRun(lineIndex, runStart, x - 1);
             }
+          slot = this->GetOrCreateSlot(table, label);
+          currentLabel = label;
+          runStart = x;
           }
 
-        labelStats.m_Sum += value;
-        labelStats.m_SumOfSquares += ( value * value );
-        labelStats.m_Count++;
-        labelStats.m_SumOfCubes += std::pow(value, 3.);
-        labelStats.m_SumOfQuadruples += std::pow(value, 4.);
-
-        if (value > 0)
-        {
-          labelStats.m_PositivePixelCount++;
-          labelStats.m_SumOfPositivePixels += value;
-        }
-
-        // if enabled, update the histogram for this label
-        if ( labelStats.m_Histogram.IsNotNull() )
-        {
-          histogramMeasurement[0] = value;
-          labelStats.m_Histogram->GetIndex(histogramMeasurement, histogramIndex);
-          labelStats.m_Histogram->IncreaseFrequencyOfIndex(histogramIndex, 1);
-        }
+        table.m_Accumulators[slot].AddValue( static_cast< RealType >( it.Get() ) );
 
         ++labelIt;
         ++it;
+        ++x;
         }
+      table.m_Accumulators[slot].AddRun(lineIndex, runStart, x - 1);
+
       labelIt.NextLine();
       it.NextLine();
       progress.CompletedPixel();
       }
-
   }
 
 
@@ -602,156 +624,89 @@ namespace itk
   void ExtendedLabelStatisticsImageFilter< TInputImage, TLabelImage >::
     AfterThreadedGenerateData()
   {
-    StatisticsMapIterator      mapIt;
-    StatisticsMapConstIterator threadIt;
-    ThreadIdType               i;
-    ThreadIdType     numberOfThreads = this->GetNumberOfThreads();
-
-    // Run through the map for each thread and accumulate the count,
-    // sum, and sumofsquares
-    for ( i = 0; i < numberOfThreads; i++ )
-      {
-      // iterate over the map for this thread
-      for ( threadIt = m_LabelStatisticsPerThread[i].begin();
-            threadIt != m_LabelStatisticsPerThread[i].end();
-            ++threadIt )
+    // merge the tables of all threads into the first one that found a label
+    LabelTable mergedTable;
+    for ( LabelTable & table : m_LabelTablePerThread )
+      {
+      for ( const LabelAccumulator & accumulator : table.m_Accumulators )
         {
-        // does this label exist in the cumulative structure yet?
-        mapIt = m_LabelStatistics.find( ( *threadIt ).first );
-        if ( mapIt == m_LabelStatistics.end() )
+        const int slot = FindSlot(mergedTable, accumulator.m_Label);
+        if ( slot < 0 )
           {
-          // create a new entry
-          typedef typename MapType::value_type MapValueType;
-          if ( m_GlobalHistogramParametersSet || m_LabelHistogramParametersSet )
-            {
-//            mapIt = m_LabelStatistics.insert( MapValueType( ( *threadIt ).first,
-//                                                            LabelStatistics(m_NumBins[0], m_LowerBound,
-//                                                                            m_UpperBound) ) ).first;
-            mapIt = m_LabelStatistics.insert( MapValueType( *threadIt ) ).first;
-            continue;
-            }
-          else
-            {
-            mapIt = m_LabelStatistics.insert( MapValueType( ( *threadIt ).first,
-                                                            LabelStatistics() ) ).first;
-            }
+          AddSlot(mergedTable, accumulator.m_Label, static_cast< int >( mergedTable.m_Accumulators.size() ));
+          mergedTable.m_Accumulators.push_back(accumulator);
           }
-
-
-        typename MapType::mapped_type &labelStats = ( *mapIt ).second;
-
-        // accumulate the information from this thread
-        labelStats.m_Count += ( *threadIt ).second.m_Count;
-        labelStats.m_Sum += ( *threadIt ).second.m_Sum;
-        labelStats.m_SumOfSquares += ( *threadIt ).second.m_SumOfSquares;
-        labelStats.m_SumOfPositivePixels += ( *threadIt ).second.m_SumOfPositivePixels;
-        labelStats.m_PositivePixelCount +=  ( *threadIt ).second.m_PositivePixelCount;
-        labelStats.m_SumOfCubes +=  ( *threadIt ).second.m_SumOfCubes;
-        labelStats.m_SumOfQuadruples +=  ( *threadIt ).second.m_SumOfQuadruples;
-
-        if ( labelStats.m_Minimum > ( *threadIt ).second.m_Minimum )
+        else
           {
-          labelStats.m_Minimum = ( *threadIt ).second.m_Minimum;
-          }
-        if ( labelStats.m_Maximum < ( *threadIt ).second.m_Maximum )
-          {
-          labelStats.m_Maximum = ( *threadIt ).second.m_Maximum;
+          MergeAccumulator(mergedTable.m_Accumulators[slot], accumulator);
           }
+        }
+      }
+    m_LabelTablePerThread.clear();
 
-        //bounding box is min,max pairs
-        int dimension = labelStats.m_BoundingBox.size() / 2;
-        for ( int ii = 0; ii < ( dimension * 2 ); ii += 2 )
-          {
-          if ( labelStats.m_BoundingBox[ii] > ( *threadIt ).second.m_BoundingBox[ii] )
-            {
-            labelStats.m_BoundingBox[ii] = ( *threadIt ).second.m_BoundingBox[ii];
-            }
-          if ( labelStats.m_BoundingBox[ii + 1] < ( *threadIt ).second.m_BoundingBox[ii + 1] )
-            {
-            labelStats.m_BoundingBox[ii + 1] = ( *threadIt ).second.m_BoundingBox[ii + 1];
-            }
-          }
+    std::vector< LabelAccumulator > & accumulators = mergedTable.m_Accumulators;
+    std::sort(accumulators.begin(), accumulators.end(),
+              [](const LabelAccumulator & a, const LabelAccumulator & b) { return a.m_Label < b.m_Label; });
 
-        // if enabled, update the histogram for this label
-        if ( m_GlobalHistogramParametersSet || m_LabelHistogramParametersSet )
-          {
-          typename HistogramType::IndexType index;
-          index.SetSize(1);
-          for ( unsigned int bin = 0; bin < labelStats.m_Histogram->Size(); bin++ )
-            {
-            index[0] = bin;
-            labelStats.m_Histogram->IncreaseFrequency( bin, ( *threadIt ).second.m_Histogram->GetFrequency(bin) );
-            }
-          }
-        } // end of thread map iterator loop
-      }   // end of thread loop
+    m_ValidLabelValues.resize(0);
+    m_ValidLabelValues.reserve(accumulators.size());
+    m_LabelStatistics.resize(0);
+    m_LabelStatistics.reserve(accumulators.size());
 
     // compute the remainder of the statistics
-    for ( mapIt = m_LabelStatistics.begin();
-          mapIt != m_LabelStatistics.end();
-          ++mapIt )
+    for ( const LabelAccumulator & accumulator : accumulators )
       {
-      typename MapType::mapped_type &labelStats = ( *mapIt ).second;
+      LabelStatistics ls;
+      const RealType count = static_cast< RealType >( accumulator.m_Count );
+
+      ls.m_Count = accumulator.m_Count;
+      ls.m_Sum = accumulator.m_Sum;
+      ls.m_Minimum = accumulator.m_Minimum;
+      ls.m_Maximum = accumulator.m_Maximum;
+      ls.m_PositivePixelCount = accumulator.m_PositivePixelCount;
+      ls.m_SumOfPositivePixels = accumulator.m_SumOfPositivePixels;
 
       // mean
-      labelStats.m_Mean = labelStats.m_Sum
-                                 / static_cast< RealType >( labelStats.m_Count );
+      ls.m_Mean = ls.m_Sum / count;
 
       // MPP
-      labelStats.m_MPP = labelStats.m_SumOfPositivePixels
-                          / static_cast< RealType >( labelStats.m_PositivePixelCount );
-
-      // variance
-      if ( labelStats.m_Count > 0 )
-        {
-        // unbiased estimate of variance
-        LabelStatistics & ls = mapIt->second;
-        const RealType    sumSquared  = ls.m_Sum * ls.m_Sum;
-        const RealType    count       = static_cast< RealType >( ls.m_Count );
+      ls.m_MPP = ls.m_SumOfPositivePixels / static_cast< RealType >( ls.m_PositivePixelCount );
 
-        ls.m_Variance = ( ls.m_SumOfSquares - sumSquared / count ) / ( count );
+      // variance, skewness and kurtosis from the central moments, the -3 of the excess kurtosis is dropped
+      ls.m_Variance = accumulator.m_M2 / count;
+      ls.m_Skewness = std::sqrt(count) * accumulator.m_M3 / std::pow(accumulator.m_M2, 1.5);
+      ls.m_Kurtosis = count * accumulator.m_M4 / ( accumulator.m_M2 * accumulator.m_M2 );
 
-        RealType secondMoment = ls.m_SumOfSquares / count;
-        RealType thirdMoment = ls.m_SumOfCubes / count;
-        RealType fourthMoment = ls.m_SumOfQuadruples / count;
+      // sigma
+      ls.m_Sigma = std::sqrt( ls.m_Variance );
 
-        ls.m_Skewness = (thirdMoment - 3. * secondMoment * ls.m_Mean + 2. * std::pow(ls.m_Mean, 3.)) / std::pow(secondMoment - std::pow(ls.m_Mean, 2.), 1.5); // see http://www.boost.org/doc/libs/1_51_0/doc/html/boost/accumulators/impl/skewness_impl.html
-        ls.m_Kurtosis = (fourthMoment - 4. * thirdMoment * ls.m_Mean + 6. * secondMoment * std::pow(ls.m_Mean, 2.) - 3. * std::pow(ls.m_Mean, 4.)) / std::pow(secondMoment - std::pow(ls.m_Mean, 2.), 2.); // see http://www.boost.org/doc/libs/1_51_0/doc/html/boost/accumulators/impl/kurtosis_impl.html, dropped -3
-        }
-      else
+      // bounding box is min,max pairs
+      for ( unsigned int i = 0; i < itkGetStaticConstMacro(ImageDimension); ++i )
         {
-        labelStats.m_Variance = NumericTraits< RealType >::ZeroValue();
-        labelStats.m_Skewness = NumericTraits< RealType >::ZeroValue();
-        labelStats.m_Kurtosis = NumericTraits< RealType >::ZeroValue();
+        ls.m_BoundingBox[2 * i] = accumulator.m_LowerIndex[i];
+        ls.m_BoundingBox[2 * i + 1] = accumulator.m_UpperIndex[i];
         }
 
-      // sigma
-      labelStats.m_Sigma = std::sqrt( labelStats.m_Variance );
-
       // histogram statistics
-      if (labelStats.m_Histogram.IsNotNull())
-      {
+      if ( accumulator.m_Histogram.IsNotNull() )
+        {
+        ls.m_Histogram = accumulator.m_Histogram;
+        for ( std::size_t bin = 0; bin < accumulator.m_Frequencies.size(); ++bin )
+          {
+          ls.m_Histogram->SetFrequency(bin, accumulator.m_Frequencies[bin]);
+          }
+
         mitk::HistogramStatisticsCalculator histStatCalc;
-        histStatCalc.SetHistogram(labelStats.m_Histogram);
+        histStatCalc.SetHistogram(ls.m_Histogram);
         histStatCalc.CalculateStatistics();
-        labelStats.m_Median = histStatCalc.GetMedian();
-        labelStats.m_Entropy = histStatCalc.GetEntropy();
-        labelStats.m_Uniformity = histStatCalc.GetUniformity();
-        labelStats.m_UPP = histStatCalc.GetUPP();
-      }
-
-      }
-
-      {
-      //Now update the cached vector of valid labels.
-      m_ValidLabelValues.resize(0);
-      m_ValidLabelValues.reserve(m_LabelStatistics.size());
-      for ( mapIt = m_LabelStatistics.begin();
-        mapIt != m_LabelStatistics.end();
-        ++mapIt )
-        {
-        m_ValidLabelValues.push_back(mapIt->first);
+        ls.m_Median = histStatCalc.GetMedian();
+        ls.m_Entropy = histStatCalc.GetEntropy();
+        ls.m_Uniformity = histStatCalc.GetUniformity();
+        ls.m_UPP = histStatCalc.GetUPP();
         }
+
+      m_ValidLabelValues.push_back(accumulator.m_Label);
+      m_LabelStatistics.push_back(ls);
       }
   }
 
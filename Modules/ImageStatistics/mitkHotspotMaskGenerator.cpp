@@ -6,14 +6,69 @@
 #include "mitkImageAccessByItk.h"
 #include <itkImageDuplicator.h>
 #include <itkFFTConvolutionImageFilter.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+#include <itkMath.h>
 #include <mitkITKImageImport.h>
+#include <mitkParallelFor.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    /** Returns the slices [begin, end) of region along its last dimension. */
+    template <unsigned int VImageDimension>
+    itk::ImageRegion<VImageDimension> GetSlices(itk::ImageRegion<VImageDimension> region, std::size_t begin, std::size_t end)
+    {
+        region.SetIndex(VImageDimension - 1, region.GetIndex(VImageDimension - 1) + static_cast<itk::IndexValueType>(begin));
+        region.SetSize(VImageDimension - 1, end - begin);
+        return region;
+    }
+
+    /** Candidate center of the hotspot, identified by its offset in the image buffer. */
+    struct HotspotCandidate
+    {
+        double Score;
+        itk::OffsetValueType Offset;
+    };
+
+    /** Orders candidates by descending score, equal scores by raster order like the search in the convolution image. */
+    bool IsHigherCandidate(const HotspotCandidate& first, const HotspotCandidate& second)
+    {
+        return first.Score > second.Score || (first.Score == second.Score && first.Offset < second.Offset);
+    }
+
+    bool IsLowerCandidate(const HotspotCandidate& first, const HotspotCandidate& second)
+    {
+        return first.Score < second.Score || (first.Score == second.Score && first.Offset < second.Offset);
+    }
+
+    /** Keeps the best maximumSize candidates according to isBetter in a heap whose top is the worst of them. */
+    template <typename TCompare>
+    void AddCandidate(std::vector<HotspotCandidate>& heap, const HotspotCandidate& candidate, std::size_t maximumSize, TCompare isBetter)
+    {
+        if (heap.size() < maximumSize)
+        {
+            heap.push_back(candidate);
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        }
+        else if (isBetter(candidate, heap.front()))
+        {
+            std::pop_heap(heap.begin(), heap.end(), isBetter);
+            heap.back() = candidate;
+            std::push_heap(heap.begin(), heap.end(), isBetter);
+        }
+    }
+}
 
 namespace mitk
 {
     HotspotMaskGenerator::HotspotMaskGenerator():
         m_HotspotRadiusinMM(6.2035049089940),   // radius of a 1cm3 sphere in mm
         m_HotspotMustBeCompletelyInsideImage(true),
-        m_Label(1)
+        m_Label(1),
+        m_SearchMethod(ConvolutionSearch)
     {
         m_TimeStep = 0;
         m_InternalMask = mitk::Image::New();
@@ -157,6 +212,20 @@ namespace mitk
         }
     }
 
+    void HotspotMaskGenerator::SetSearchMethod(SearchMethod method)
+    {
+        if (method != m_SearchMethod)
+        {
+            m_SearchMethod = method;
+            this->Modified();
+        }
+    }
+
+    HotspotMaskGenerator::SearchMethod HotspotMaskGenerator::GetSearchMethod() const
+    {
+        return m_SearchMethod;
+    }
+
     vnl_vector<int> HotspotMaskGenerator::GetConvolutionImageMinIndex()
     {
         this->GetMask(); // make sure we are up to date
@@ -182,30 +251,12 @@ namespace mitk
       typedef itk::ImageRegionConstIteratorWithIndex<MaskImageType> MaskImageIteratorType;
       typedef itk::ImageRegionConstIteratorWithIndex<ImageType> InputImageIndexIteratorType;
 
-      typename ImageType::SpacingType spacing = inputImage->GetSpacing();
-
       ImageExtrema minMax;
       minMax.Defined = false;
       minMax.MaxIndex.set_size(VImageDimension);
       minMax.MaxIndex.set_size(VImageDimension);
 
-      typename ImageType::RegionType allowedExtremaRegion = inputImage->GetLargestPossibleRegion();
-
-      bool keepDistanceToImageBorders( neccessaryDistanceToImageBorderInMM > 0 );
-      if (keepDistanceToImageBorders)
-      {
-        itk::IndexValueType distanceInPixels[VImageDimension];
-        for(unsigned short dimension = 0; dimension < VImageDimension; ++dimension)
-        {
-          // To confirm that the whole hotspot is inside the image we have to keep a specific distance to the image-borders, which is as long as
-          // the radius. To get the amount of indices we divide the radius by spacing and add 0.5 because voxels are center based:
-          // For example with a radius of 2.2 and a spacing of 1 two indices are enough because 2.2 / 1 + 0.5 = 2.7 => 2.
-          // But with a radius of 2.7 we need 3 indices because 2.7 / 1 + 0.5 = 3.2 => 3
-          distanceInPixels[dimension] = int( neccessaryDistanceToImageBorderInMM / spacing[dimension] + 0.5);
-        }
-
-        allowedExtremaRegion.ShrinkByRadius(distanceInPixels);
-      }
+      typename ImageType::RegionType allowedExtremaRegion = this->CalculateAllowedExtremaRegion(inputImage, neccessaryDistanceToImageBorderInMM);
 
       InputImageIndexIteratorType imageIndexIt(inputImage, allowedExtremaRegion);
 
@@ -297,6 +348,387 @@ namespace mitk
       return minMax;
     }
 
+    template <typename TPixel, unsigned int VImageDimension>
+    typename itk::Image<TPixel, VImageDimension>::RegionType
+      HotspotMaskGenerator::CalculateAllowedExtremaRegion( const itk::Image<TPixel, VImageDimension>* inputImage,
+                                                            double neccessaryDistanceToImageBorderInMM )
+    {
+      typedef itk::Image< TPixel, VImageDimension > ImageType;
+
+      typename ImageType::SpacingType spacing = inputImage->GetSpacing();
+      typename ImageType::RegionType allowedExtremaRegion = inputImage->GetLargestPossibleRegion();
+
+      bool keepDistanceToImageBorders( neccessaryDistanceToImageBorderInMM > 0 );
+      if (keepDistanceToImageBorders)
+      {
+        itk::IndexValueType distanceInPixels[VImageDimension];
+        for(unsigned short dimension = 0; dimension < VImageDimension; ++dimension)
+        {
+          // To confirm that the whole hotspot is inside the image we have to keep a specific distance to the image-borders, which is as long as
+          // the radius. To get the amount of indices we divide the radius by spacing and add 0.5 because voxels are center based:
+          // For example with a radius of 2.2 and a spacing of 1 two indices are enough because 2.2 / 1 + 0.5 = 2.7 => 2.
+          // But with a radius of 2.7 we need 3 indices because 2.7 / 1 + 0.5 = 3.2 => 3
+          distanceInPixels[dimension] = int( neccessaryDistanceToImageBorderInMM / spacing[dimension] + 0.5);
+        }
+
+        allowedExtremaRegion.ShrinkByRadius(distanceInPixels);
+      }
+
+      return allowedExtremaRegion;
+    }
+
+    template <typename TPixel, unsigned int VImageDimension>
+    HotspotMaskGenerator::ImageExtrema
+      HotspotMaskGenerator::CalculateExtremaIntegralImage( const itk::Image<TPixel, VImageDimension>* inputImage,
+                                                            const itk::Image<unsigned short, VImageDimension>* maskImage,
+                                                            double neccessaryDistanceToImageBorderInMM,
+                                                            unsigned int label )
+    {
+      typedef itk::Image< TPixel, VImageDimension > ImageType;
+      typedef itk::Image< unsigned short, VImageDimension > MaskImageType;
+      typedef typename ImageType::RegionType RegionType;
+      typedef typename ImageType::IndexType IndexType;
+      typedef typename ImageType::SizeType SizeType;
+
+      // number of candidates whose neighborhood is evaluated with the exact spherical kernel, for maximum and minimum each
+      const std::size_t numberOfRefinedCandidates = 64;
+
+      ImageExtrema minMax;
+      minMax.Defined = false;
+      minMax.MaxIndex.set_size(VImageDimension);
+      minMax.MinIndex.set_size(VImageDimension);
+      minMax.MaxIndex.fill(0);
+      minMax.MinIndex.fill(0);
+
+      const RegionType imageRegion = inputImage->GetLargestPossibleRegion();
+      const RegionType allowedExtremaRegion = this->CalculateAllowedExtremaRegion(inputImage, neccessaryDistanceToImageBorderInMM);
+      if (0 == allowedExtremaRegion.GetNumberOfPixels())
+      {
+        return minMax;
+      }
+
+      // bounding box of all candidates, i.e. pixels of the label within the allowed region
+      const std::size_t numberOfSlices = allowedExtremaRegion.GetSize(VImageDimension - 1);
+      std::vector<IndexType> lowerBounds(numberOfSlices);
+      std::vector<IndexType> upperBounds(numberOfSlices);
+      std::vector<char> sliceContainsLabel(numberOfSlices, 0);
+      ParallelForChunks(numberOfSlices, [&](std::size_t begin, std::size_t end, std::size_t)
+      {
+        for (std::size_t slice = begin; slice < end; ++slice)
+        {
+          itk::ImageRegionConstIteratorWithIndex<MaskImageType> maskIt(maskImage, GetSlices(allowedExtremaRegion, slice, slice + 1));
+          for (maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt)
+          {
+            if (maskIt.Get() != label)
+            {
+              continue;
+            }
+
+            const IndexType index = maskIt.GetIndex();
+            if (!sliceContainsLabel[slice])
+            {
+              lowerBounds[slice] = upperBounds[slice] = index;
+              sliceContainsLabel[slice] = 1;
+            }
+
+            for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+            {
+              lowerBounds[slice][dimension] = std::min(lowerBounds[slice][dimension], index[dimension]);
+              upperBounds[slice][dimension] = std::max(upperBounds[slice][dimension], index[dimension]);
+            }
+          }
+        }
+      });
+
+      IndexType lowerBound;
+      IndexType upperBound;
+      for (std::size_t slice = 0; slice < numberOfSlices; ++slice)
+      {
+        if (!sliceContainsLabel[slice])
+        {
+          continue;
+        }
+
+        if (!minMax.Defined)
+        {
+          lowerBound = lowerBounds[slice];
+          upperBound = upperBounds[slice];
+          minMax.Defined = true;
+        }
+
+        for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+        {
+          lowerBound[dimension] = std::min(lowerBound[dimension], lowerBounds[slice][dimension]);
+          upperBound[dimension] = std::max(upperBound[dimension], upperBounds[slice][dimension]);
+        }
+      }
+
+      if (!minMax.Defined)
+      {
+        return minMax;
+      }
+
+      RegionType candidateRegion;
+      candidateRegion.SetIndex(lowerBound);
+      for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+      {
+        candidateRegion.SetSize(dimension, upperBound[dimension] - lowerBound[dimension] + 1);
+      }
+
+      // The candidates are ranked by the mean of a cube which has the volume of the sphere (a square with the area of the circle in 2D).
+      const double cubeSideLengthPerRadius = VImageDimension == 2 ? std::sqrt(itk::Math::pi) : std::cbrt(4.0 / 3.0 * itk::Math::pi);
+      SizeType halfCubeSize;
+      for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+      {
+        const double cubeSizeInPixels = cubeSideLengthPerRadius * m_HotspotRadiusinMM / inputImage->GetSpacing()[dimension];
+        halfCubeSize[dimension] = static_cast<itk::SizeValueType>(std::max(0.0, std::floor(0.5 * (cubeSizeInPixels - 1.0) + 0.5)));
+      }
+
+      // The integral image covers all cubes around the candidates. Its first row, column (and slice) are 0, so that
+      // integralImage[i] is the sum of all pixels with indices lower than i in every dimension.
+      RegionType integralRegion = candidateRegion;
+      integralRegion.PadByRadius(halfCubeSize);
+      integralRegion.Crop(imageRegion);
+
+      itk::OffsetValueType integralStrides[VImageDimension];
+      itk::OffsetValueType integralSize = 1;
+      for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+      {
+        integralStrides[dimension] = integralSize;
+        integralSize *= integralRegion.GetSize(dimension) + 1;
+      }
+
+      std::vector<double> integralImage(integralSize, 0.0);
+      const IndexType integralOrigin = integralRegion.GetIndex();
+
+      const std::size_t numberOfIntegralSlices = integralRegion.GetSize(VImageDimension - 1);
+      ParallelForChunks(numberOfIntegralSlices, [&](std::size_t begin, std::size_t end, std::size_t)
+      {
+        itk::ImageRegionConstIteratorWithIndex<ImageType> imageIt(inputImage, GetSlices(integralRegion, begin, end));
+        for (imageIt.GoToBegin(); !imageIt.IsAtEnd(); ++imageIt)
+        {
+          const IndexType index = imageIt.GetIndex();
+          itk::OffsetValueType offset = 0;
+          for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+          {
+            offset += (index[dimension] - integralOrigin[dimension] + 1) * integralStrides[dimension];
+          }
+          integralImage[offset] = static_cast<double>(imageIt.Get());
+        }
+      });
+
+      // cumulative sums along every dimension, the lines along a dimension are independent of each other
+      for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+      {
+        const itk::OffsetValueType stride = integralStrides[dimension];
+        const itk::OffsetValueType lineLength = integralRegion.GetSize(dimension) + 1;
+        ParallelForChunks(integralSize / lineLength, [&](std::size_t begin, std::size_t end, std::size_t)
+        {
+          for (std::size_t line = begin; line < end; ++line)
+          {
+            const itk::OffsetValueType lineOffset = (line % stride) + (line / stride) * stride * lineLength;
+            for (itk::OffsetValueType position = 1; position < lineLength; ++position)
+            {
+              integralImage[lineOffset + position * stride] += integralImage[lineOffset + (position - 1) * stride];
+            }
+          }
+        });
+      }
+
+      // rank all candidates by the mean of their cube and keep the highest and lowest ones
+      const std::size_t numberOfCandidateSlices = candidateRegion.GetSize(VImageDimension - 1);
+      std::vector<std::vector<HotspotCandidate>> highestCandidates(numberOfCandidateSlices);
+      std::vector<std::vector<HotspotCandidate>> lowestCandidates(numberOfCandidateSlices);
+      ParallelForChunks(numberOfCandidateSlices, [&](std::size_t begin, std::size_t end, std::size_t)
+      {
+        for (std::size_t slice = begin; slice < end; ++slice)
+        {
+          itk::ImageRegionConstIteratorWithIndex<MaskImageType> maskIt(maskImage, GetSlices(candidateRegion, slice, slice + 1));
+          for (maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt)
+          {
+            if (maskIt.Get() != label)
+            {
+              continue;
+            }
+
+            const IndexType index = maskIt.GetIndex();
+            itk::OffsetValueType lower[VImageDimension];
+            itk::OffsetValueType upper[VImageDimension];
+            double numberOfPixels = 1.0;
+            double numberOfCubePixels = 1.0;
+            for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+            {
+              const itk::OffsetValueType position = index[dimension] - integralOrigin[dimension];
+              const itk::OffsetValueType halfSize = halfCubeSize[dimension];
+              lower[dimension] = std::max<itk::OffsetValueType>(position - halfSize, 0);
+              upper[dimension] = std::min<itk::OffsetValueType>(position + halfSize + 1, integralRegion.GetSize(dimension));
+              numberOfPixels *= upper[dimension] - lower[dimension];
+              numberOfCubePixels *= 2 * halfSize + 1;
+            }
+
+            // inclusion-exclusion over the corners of the cube
+            double sum = 0.0;
+            for (unsigned int corner = 0; corner < (1u << VImageDimension); ++corner)
+            {
+              itk::OffsetValueType offset = 0;
+              unsigned int numberOfLowerCoordinates = 0;
+              for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+              {
+                if (corner & (1u << dimension))
+                {
+                  offset += upper[dimension] * integralStrides[dimension];
+                }
+                else
+                {
+                  offset += lower[dimension] * integralStrides[dimension];
+                  ++numberOfLowerCoordinates;
+                }
+              }
+              sum += numberOfLowerCoordinates % 2 ? -integralImage[offset] : integralImage[offset];
+            }
+
+            // pixels outside of the image are 0 if the hotspot must be inside of the image, otherwise they repeat the border
+            HotspotCandidate candidate;
+            candidate.Score = sum / (m_HotspotMustBeCompletelyInsideImage ? numberOfCubePixels : numberOfPixels);
+            candidate.Offset = inputImage->ComputeOffset(index);
+            AddCandidate(highestCandidates[slice], candidate, numberOfRefinedCandidates, IsHigherCandidate);
+            AddCandidate(lowestCandidates[slice], candidate, numberOfRefinedCandidates, IsLowerCandidate);
+          }
+        }
+      });
+
+      std::vector<HotspotCandidate> highest;
+      std::vector<HotspotCandidate> lowest;
+      for (std::size_t slice = 0; slice < numberOfCandidateSlices; ++slice)
+      {
+        for (const auto& candidate : highestCandidates[slice])
+        {
+          AddCandidate(highest, candidate, numberOfRefinedCandidates, IsHigherCandidate);
+        }
+        for (const auto& candidate : lowestCandidates[slice])
+        {
+          AddCandidate(lowest, candidate, numberOfRefinedCandidates, IsLowerCandidate);
+        }
+      }
+
+      // the exact spherical kernel of the convolution search
+      double mmPerPixel[VImageDimension];
+      for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+      {
+        mmPerPixel[dimension] = inputImage->GetSpacing()[dimension];
+      }
+
+      typedef itk::Image< float, VImageDimension > KernelImageType;
+      typename KernelImageType::Pointer kernel = this->GenerateHotspotSearchConvolutionKernel<VImageDimension>(mmPerPixel, m_HotspotRadiusinMM);
+
+      std::vector<typename ImageType::OffsetType> kernelOffsets;
+      std::vector<double> kernelWeights;
+      double kernelWeight = 0.0;
+      itk::ImageRegionConstIteratorWithIndex<KernelImageType> kernelIt(kernel, kernel->GetLargestPossibleRegion());
+      for (kernelIt.GoToBegin(); !kernelIt.IsAtEnd(); ++kernelIt)
+      {
+        if (kernelIt.Get() > 0)
+        {
+          typename ImageType::OffsetType kernelOffset;
+          for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+          {
+            kernelOffset[dimension] = kernelIt.GetIndex()[dimension] - (kernel->GetLargestPossibleRegion().GetSize(dimension) - 1) / 2;
+          }
+          kernelOffsets.push_back(kernelOffset);
+          kernelWeights.push_back(kernelIt.Get());
+          kernelWeight += kernelIt.Get();
+        }
+      }
+
+      // The cube only approximates the sphere, so the exact mean is evaluated for the candidates next to the best ones.
+      std::vector<itk::OffsetValueType> maxNeighbors;
+      std::vector<itk::OffsetValueType> minNeighbors;
+      RegionType neighborhood;
+      neighborhood.SetSize(SizeType::Filled(3));
+      for (int extremum = 0; extremum < 2; ++extremum)
+      {
+        const std::vector<HotspotCandidate>& candidates = extremum == 0 ? highest : lowest;
+        std::vector<itk::OffsetValueType>& neighbors = extremum == 0 ? maxNeighbors : minNeighbors;
+        for (const auto& candidate : candidates)
+        {
+          neighborhood.SetIndex(inputImage->ComputeIndex(candidate.Offset) - ImageType::OffsetType::Filled(1));
+          RegionType validNeighborhood = neighborhood;
+          validNeighborhood.Crop(candidateRegion);
+          itk::ImageRegionConstIteratorWithIndex<MaskImageType> maskIt(maskImage, validNeighborhood);
+          for (maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt)
+          {
+            if (maskIt.Get() == label)
+            {
+              neighbors.push_back(inputImage->ComputeOffset(maskIt.GetIndex()));
+            }
+          }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+      }
+
+      std::vector<itk::OffsetValueType> refinedOffsets;
+      std::set_union(maxNeighbors.begin(), maxNeighbors.end(), minNeighbors.begin(), minNeighbors.end(), std::back_inserter(refinedOffsets));
+      std::vector<double> refinedMeans(refinedOffsets.size());
+      ParallelForChunks(refinedOffsets.size(), [&](std::size_t begin, std::size_t end, std::size_t)
+      {
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          const IndexType center = inputImage->ComputeIndex(refinedOffsets[i]);
+          double sum = 0.0;
+          for (std::size_t k = 0; k < kernelOffsets.size(); ++k)
+          {
+            IndexType index = center + kernelOffsets[k];
+            if (!imageRegion.IsInside(index))
+            {
+              if (m_HotspotMustBeCompletelyInsideImage)
+              {
+                continue;
+              }
+
+              for (unsigned int dimension = 0; dimension < VImageDimension; ++dimension)
+              {
+                index[dimension] = std::max(imageRegion.GetIndex(dimension),
+                  std::min<itk::IndexValueType>(index[dimension], imageRegion.GetUpperIndex()[dimension]));
+              }
+            }
+            sum += kernelWeights[k] * inputImage->GetPixel(index);
+          }
+          refinedMeans[i] = sum / kernelWeight;
+        }
+      });
+
+      HotspotCandidate maxCandidate = { 0.0, -1 };
+      HotspotCandidate minCandidate = { 0.0, -1 };
+      for (std::size_t i = 0; i < refinedOffsets.size(); ++i)
+      {
+        const HotspotCandidate candidate = { refinedMeans[i], refinedOffsets[i] };
+        if (std::binary_search(maxNeighbors.begin(), maxNeighbors.end(), candidate.Offset) &&
+            (maxCandidate.Offset < 0 || IsHigherCandidate(candidate, maxCandidate)))
+        {
+          maxCandidate = candidate;
+        }
+        if (std::binary_search(minNeighbors.begin(), minNeighbors.end(), candidate.Offset) &&
+            (minCandidate.Offset < 0 || IsLowerCandidate(candidate, minCandidate)))
+        {
+          minCandidate = candidate;
+        }
+      }
+
+      const IndexType maxIndex = inputImage->ComputeIndex(maxCandidate.Offset);
+      const IndexType minIndex = inputImage->ComputeIndex(minCandidate.Offset);
+      for (unsigned int i = 0; i < VImageDimension; ++i)
+      {
+        minMax.MaxIndex[i] = maxIndex[i];
+        minMax.MinIndex[i] = minIndex[i];
+      }
+
+      minMax.Max = maxCandidate.Score;
+      minMax.Min = minCandidate.Score;
+
+      return minMax;
+    }
+
     template <unsigned int VImageDimension>
     itk::Size<VImageDimension>
       HotspotMaskGenerator::CalculateConvolutionKernelSize( double spacing[VImageDimension],
@@ -494,14 +926,6 @@ namespace mitk
         typedef itk::Image< TPixel, VImageDimension > ConvolutionImageType;
         typedef itk::Image< unsigned short, VImageDimension > MaskImageType;
 
-        typename ConvolutionImageType::Pointer convolutionImage = this->GenerateConvolutionImage(inputImage);
-
-        if (convolutionImage.IsNull())
-        {
-          MITK_ERROR << "Empty convolution image in CalculateHotspotStatistics(). We should never reach this state (logic error).";
-          throw std::logic_error("Empty convolution image in CalculateHotspotStatistics()");
-        }
-
         // if mask image is not defined, create an image of the same size as inputImage and fill it with 1's
         // there is maybe a better way to do this!?
         if (maskImage == nullptr)
@@ -522,9 +946,26 @@ namespace mitk
             label = 1;
         }
 
-        // find maximum in convolution image, given the current mask
+        // find maximum of the mean within the sphere, given the current mask
         double requiredDistanceToBorder = m_HotspotMustBeCompletelyInsideImage ? m_HotspotRadiusinMM : -1.0;
-        ImageExtrema convolutionImageInformation = CalculateExtremaWorld(convolutionImage.GetPointer(), maskImage, requiredDistanceToBorder, label);
+        ImageExtrema convolutionImageInformation;
+
+        if (m_SearchMethod == IntegralImageSearch)
+        {
+          convolutionImageInformation = CalculateExtremaIntegralImage(inputImage, maskImage.GetPointer(), requiredDistanceToBorder, label);
+        }
+        else
+        {
+          typename ConvolutionImageType::Pointer convolutionImage = this->GenerateConvolutionImage(inputImage);
+
+          if (convolutionImage.IsNull())
+          {
+            MITK_ERROR << "Empty convolution image in CalculateHotspotStatistics(). We should never reach this state (logic error).";
+            throw std::logic_error("Empty convolution image in CalculateHotspotStatistics()");
+          }
+
+          convolutionImageInformation = CalculateExtremaWorld(convolutionImage.GetPointer(), maskImage, requiredDistanceToBorder, label);
+        }
 
         bool isHotspotDefined = convolutionImageInformation.Defined;
 
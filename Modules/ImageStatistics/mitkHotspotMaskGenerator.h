@@ -21,6 +21,12 @@ namespace mitk
      * The maximum value of the convolved image then corresponds to the hotspot.
      * If a maskGenerator is set, only the pixels of the convolved image where the corresponding mask is == @a label
      * are searched for the maximum value.
+     *
+     * For large images the convolution of the whole image needs a lot of memory. SetSearchMethod(IntegralImageSearch)
+     * selects a search that only works on the bounding box of the mask: An integral image of the bounding box gives the
+     * mean of a cube with the volume of the sphere around every candidate in constant time. The spherical kernel is then
+     * evaluated exactly around the best candidates. The result equals the one of the convolution unless the cube
+     * ranks the real hotspot behind all of these candidates.
      */
     class MITKIMAGESTATISTICS_EXPORT HotspotMaskGenerator: public MaskGenerator
     {
@@ -37,6 +43,13 @@ namespace mitk
         /** Runtime information support. */
         itkTypeMacro(HotspotMaskGenerator, MaskGenerator)
 
+        /** \brief Algorithms to find the hotspot, see SetSearchMethod(). */
+        enum SearchMethod
+        {
+            ConvolutionSearch,
+            IntegralImageSearch
+        };
+
         /**
         @brief Set the input image. Required for this class
          */
@@ -66,6 +79,14 @@ namespace mitk
          */
         void SetLabel(unsigned short label);
 
+        /**
+        @brief Select how the hotspot is searched. ConvolutionSearch (default) convolves the whole image with the spherical kernel,
+        IntegralImageSearch ranks the candidates with an integral image of the bounding box of the mask and refines the best of them.
+         */
+        void SetSearchMethod(SearchMethod method);
+
+        SearchMethod GetSearchMethod() const;
+
         /**
         @brief Computes and returns the hotspot mask. The hotspot mask has the same size as the input image. The hopspot has value 1, the remaining pixels are set to 0
          */
@@ -148,6 +169,19 @@ namespace mitk
                                                         double neccessaryDistanceToImageBorderInMM,
                                                         unsigned int label);
 
+        /** \brief Finds the extrema of the mean within the sphere using an integral image of the bounding box of the mask. */
+        template <typename TPixel, unsigned int VImageDimension>
+        ImageExtrema CalculateExtremaIntegralImage( const itk::Image<TPixel, VImageDimension>* inputImage,
+                                                    const itk::Image<unsigned short, VImageDimension>* maskImage,
+                                                    double neccessaryDistanceToImageBorderInMM,
+                                                    unsigned int label);
+
+        /** \brief Returns the region of possible hotspot centers, which keeps the given distance to the image borders. */
+        template <typename TPixel, unsigned int VImageDimension>
+        typename itk::Image<TPixel, VImageDimension>::RegionType
+          CalculateAllowedExtremaRegion( const itk::Image<TPixel, VImageDimension>* inputImage,
+                                         double neccessaryDistanceToImageBorderInMM);
+
         bool IsUpdateRequired() const;
 
         HotspotMaskGenerator(const HotspotMaskGenerator &);
@@ -160,6 +194,7 @@ namespace mitk
         double m_HotspotRadiusinMM;
         bool m_HotspotMustBeCompletelyInsideImage;
         unsigned short m_Label;
+        SearchMethod m_SearchMethod;
         vnl_vector<int> m_ConvolutionImageMinIndex, m_ConvolutionImageMaxIndex;
         unsigned long m_InternalMaskUpdateTime;
     };
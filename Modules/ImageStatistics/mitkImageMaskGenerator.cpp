@@ -24,6 +24,11 @@ void ImageMaskGenerator::SetTimeStep(unsigned int timeStep)
     }
 }
 
+bool ImageMaskGenerator::IsTimeInvariant() const
+{
+    return m_internalMaskImage.IsNotNull() && m_internalMaskImage->GetTimeSteps() == 1;
+}
+
 void ImageMaskGenerator::UpdateInternalMask()
 {
     unsigned int timeStepForExtraction;
@@ -28,6 +28,9 @@ public:
 
     void SetTimeStep(unsigned int timeStep) override;
 
+    /** The mask is time invariant if the mask image has only one time step. */
+    bool IsTimeInvariant() const override;
+
     void SetImageMask(mitk::Image::Pointer maskImage);
 
 protected:
@@ -0,0 +1,242 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkImageStatisticsCache.h"
+
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+  std::string GetDataID(const mitk::BaseData *data)
+  {
+    if (nullptr == data)
+      return std::string();
+
+    auto uid = data->GetUID();
+    if (!uid.empty())
+      return uid;
+
+    // data without UID is identified by its address, the modification time tells apart reused addresses
+    std::ostringstream stream;
+    stream << static_cast<const void *>(data);
+    return stream.str();
+  }
+
+  auto SourcesTuple(const mitk::ImageStatisticsCache::Key &key)
+    -> decltype(std::tie(key.m_ImageID, key.m_MaskID, key.m_Label, key.m_NBins, key.m_UseBinSize, key.m_BinSize,
+                         key.m_IgnorePixelValue, key.m_IgnoredPixelValue))
+  {
+    return std::tie(key.m_ImageID, key.m_MaskID, key.m_Label, key.m_NBins, key.m_UseBinSize, key.m_BinSize,
+                    key.m_IgnorePixelValue, key.m_IgnoredPixelValue);
+  }
+}
+
+mitk::ImageStatisticsCache::Key::Key(const BaseData *image, const BaseData *mask)
+  : m_ImageID(GetDataID(image)),
+    m_ImageMTime(nullptr != image ? image->GetMTime() : 0),
+    m_MaskID(GetDataID(mask)),
+    m_MaskMTime(nullptr != mask ? mask->GetMTime() : 0),
+    m_Label(1),
+    m_NBins(100),
+    m_UseBinSize(false),
+    m_BinSize(10.0),
+    m_IgnorePixelValue(false),
+    m_IgnoredPixelValue(0.0)
+{
+}
+
+bool mitk::ImageStatisticsCache::Key::operator<(const Key &other) const
+{
+  if (SourcesTuple(*this) != SourcesTuple(other))
+    return SourcesTuple(*this) < SourcesTuple(other);
+
+  return std::tie(m_ImageMTime, m_MaskMTime) < std::tie(other.m_ImageMTime, other.m_MaskMTime);
+}
+
+mitk::ImageStatisticsCache::ImageStatisticsCache()
+  : m_MaximumMemorySize(64 * 1024 * 1024), m_MemorySize(0), m_UseCounter(0)
+{
+}
+
+mitk::ImageStatisticsCache *mitk::ImageStatisticsCache::GetInstance()
+{
+  static ImageStatisticsCache instance;
+  return &instance;
+}
+
+mitk::ImageStatisticsContainer::Pointer mitk::ImageStatisticsCache::Get(const Key &key)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  this->RemoveOutdated(key);
+
+  auto entryIt = m_Entries.find(key);
+  if (entryIt == m_Entries.end())
+    return nullptr;
+
+  entryIt->second.m_LastUse = ++m_UseCounter;
+  return entryIt->second.m_Statistics->Clone();
+}
+
+void mitk::ImageStatisticsCache::Insert(const Key &key, ImageStatisticsContainer *statistics)
+{
+  if (nullptr == statistics)
+  {
+    mitkThrow() << "Statistics are nullptr";
+  }
+
+  const std::size_t memorySize = EstimateMemorySize(statistics);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  this->RemoveOutdated(key);
+
+  auto entryIt = m_Entries.find(key);
+  if (entryIt != m_Entries.end())
+  {
+    m_MemorySize -= entryIt->second.m_MemorySize;
+    m_Entries.erase(entryIt);
+  }
+
+  Entry entry;
+  entry.m_Statistics = statistics->Clone();
+  entry.m_MemorySize = memorySize;
+  entry.m_LastUse = ++m_UseCounter;
+  m_Entries.emplace(key, entry);
+  m_MemorySize += memorySize;
+
+  this->Shrink();
+}
+
+void mitk::ImageStatisticsCache::Remove(const BaseData *data)
+{
+  const std::string id = GetDataID(data);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+
+  for (auto entryIt = m_Entries.begin(); entryIt != m_Entries.end();)
+  {
+    if (entryIt->first.m_ImageID == id || entryIt->first.m_MaskID == id)
+    {
+      m_MemorySize -= entryIt->second.m_MemorySize;
+      entryIt = m_Entries.erase(entryIt);
+    }
+    else
+    {
+      ++entryIt;
+    }
+  }
+}
+
+void mitk::ImageStatisticsCache::Clear()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Entries.clear();
+  m_MemorySize = 0;
+}
+
+void mitk::ImageStatisticsCache::SetMaximumMemorySize(std::size_t size)
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_MaximumMemorySize = size;
+  this->Shrink();
+}
+
+std::size_t mitk::ImageStatisticsCache::GetMaximumMemorySize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MaximumMemorySize;
+}
+
+std::size_t mitk::ImageStatisticsCache::GetMemorySize() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_MemorySize;
+}
+
+std::size_t mitk::ImageStatisticsCache::GetNumberOfEntries() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Entries.size();
+}
+
+std::size_t mitk::ImageStatisticsCache::EstimateMemorySize(const ImageStatisticsContainer *statistics)
+{
+  // rough size of a named statistic in the map of a statistics object
+  const std::size_t statisticSize = 128;
+  // frequency and bin borders of a histogram bin
+  const std::size_t binSize =
+    sizeof(ImageStatisticsContainer::HistogramType::AbsoluteFrequencyType) + 2 * sizeof(double);
+
+  std::size_t memorySize = sizeof(ImageStatisticsContainer);
+
+  if (nullptr == statistics)
+    return memorySize;
+
+  for (unsigned int timeStep = 0; timeStep < statistics->GetNumberOfTimeSteps(); ++timeStep)
+  {
+    if (!statistics->TimeStepExists(timeStep))
+      continue;
+
+    const auto &statisticsObject = statistics->GetStatisticsForTimeStep(timeStep);
+    memorySize += statisticsObject.GetExistingStatisticNames().size() * statisticSize;
+
+    if (statisticsObject.m_Histogram.IsNotNull())
+      memorySize += sizeof(ImageStatisticsContainer::HistogramType) + statisticsObject.m_Histogram->Size() * binSize;
+  }
+
+  return memorySize;
+}
+
+void mitk::ImageStatisticsCache::RemoveOutdated(const Key &key)
+{
+  for (auto entryIt = m_Entries.begin(); entryIt != m_Entries.end();)
+  {
+    const Key &entryKey = entryIt->first;
+
+    // a newer version of the image or the mask has been requested, the results of the old version cannot be hit any more
+    const bool imageIsOutdated = entryKey.m_ImageID == key.m_ImageID && entryKey.m_ImageMTime < key.m_ImageMTime;
+    const bool maskIsOutdated =
+      !key.m_MaskID.empty() && entryKey.m_MaskID == key.m_MaskID && entryKey.m_MaskMTime < key.m_MaskMTime;
+
+    if (imageIsOutdated || maskIsOutdated)
+    {
+      m_MemorySize -= entryIt->second.m_MemorySize;
+      entryIt = m_Entries.erase(entryIt);
+    }
+    else
+    {
+      ++entryIt;
+    }
+  }
+}
+
+void mitk::ImageStatisticsCache::Shrink()
+{
+  while (m_MemorySize > m_MaximumMemorySize && !m_Entries.empty())
+  {
+    auto leastRecentlyUsed = m_Entries.begin();
+    for (auto entryIt = m_Entries.begin(); entryIt != m_Entries.end(); ++entryIt)
+    {
+      if (entryIt->second.m_LastUse < leastRecentlyUsed->second.m_LastUse)
+        leastRecentlyUsed = entryIt;
+    }
+
+    m_MemorySize -= leastRecentlyUsed->second.m_MemorySize;
+    m_Entries.erase(leastRecentlyUsed);
+  }
+}
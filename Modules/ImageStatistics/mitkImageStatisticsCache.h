@@ -0,0 +1,118 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+#ifndef mitkImageStatisticsCache_h
+#define mitkImageStatisticsCache_h
+
+#include "MitkImageStatisticsExports.h"
+
+#include <mitkBaseData.h>
+#include <mitkImageStatisticsContainer.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace mitk
+{
+  /**
+  \brief Keeps computed ImageStatisticsContainers, so statistics of unchanged inputs are not computed again.
+
+  A result is identified by the UID and modification time of image and mask together with the settings of
+  the computation. A modified image or mask therefore never hits an old result, and the outdated results of
+  it are removed as soon as the new version is looked up or inserted. If the estimated memory of all results
+  exceeds the maximum memory size, the least recently used results are removed.
+
+  The cache keeps its own copies of the results: Insert() stores a clone and Get() returns a clone, so callers
+  may modify the returned statistics or add them to a DataStorage without changing the cached result.
+
+  The cache is thread safe. Use GetInstance() to share results between views and calculation jobs.
+  */
+  class MITKIMAGESTATISTICS_EXPORT ImageStatisticsCache
+  {
+  public:
+    /** \brief Identifies a statistics result by its inputs and the settings of the computation. */
+    struct MITKIMAGESTATISTICS_EXPORT Key
+    {
+      /** Reads identity and modification time of image and the optional mask (image or planar figure). */
+      explicit Key(const BaseData *image, const BaseData *mask = nullptr);
+
+      bool operator<(const Key &other) const;
+
+      std::string m_ImageID;
+      unsigned long m_ImageMTime;
+      std::string m_MaskID;
+      unsigned long m_MaskMTime;
+      ImageStatisticsContainer::LabelIndex m_Label;
+      unsigned int m_NBins;
+      bool m_UseBinSize;
+      double m_BinSize;
+      bool m_IgnorePixelValue;
+      double m_IgnoredPixelValue;
+    };
+
+    ImageStatisticsCache();
+
+    /** \brief Returns the shared cache instance. */
+    static ImageStatisticsCache *GetInstance();
+
+    /** \brief Returns a clone of the cached statistics for key or nullptr. */
+    ImageStatisticsContainer::Pointer Get(const Key &key);
+
+    /** \brief Adds a clone of statistics for key, replaces a previous result for the same key. */
+    void Insert(const Key &key, ImageStatisticsContainer *statistics);
+
+    /** \brief Removes all results that were computed on data, as image or as mask.
+
+    Call it once data is removed from the DataStorage, its results can never be hit again.
+    */
+    void Remove(const BaseData *data);
+
+    void Clear();
+
+    /** \brief Sets the memory in bytes the results may use, the default is 64 MB. */
+    void SetMaximumMemorySize(std::size_t size);
+    std::size_t GetMaximumMemorySize() const;
+
+    std::size_t GetMemorySize() const;
+    std::size_t GetNumberOfEntries() const;
+
+    /** \brief Estimates the memory used by the statistics and histograms of all time steps of statistics. */
+    static std::size_t EstimateMemorySize(const ImageStatisticsContainer *statistics);
+
+  private:
+    struct Entry
+    {
+      ImageStatisticsContainer::Pointer m_Statistics;
+      std::size_t m_MemorySize;
+      unsigned long m_LastUse;
+    };
+
+    typedef std::map<Key, Entry> EntryMapType;
+
+    /** Removes results of older versions of the image or mask of key. Expects the mutex to be locked. */
+    void RemoveOutdated(const Key &key);
+
+    /** Removes least recently used results until the memory limit is kept. Expects the mutex to be locked. */
+    void Shrink();
+
+    mutable std::mutex m_Mutex;
+    EntryMapType m_Entries;
+    std::size_t m_MaximumMemorySize;
+    std::size_t m_MemorySize;
+    unsigned long m_UseCounter;
+  };
+}
+#endif
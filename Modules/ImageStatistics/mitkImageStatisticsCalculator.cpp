@@ -26,6 +26,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkMaskUtilities.h>
 #include <mitkMinMaxImageFilterWithIndex.h>
 #include <mitkMinMaxLabelmageFilterWithIndex.h>
+#include <mitkParallelFor.h>
 #include <mitkitkMaskImageFilter.h>
 
 namespace mitk
@@ -94,6 +95,17 @@ namespace mitk
 
   double ImageStatisticsCalculator::GetBinSizeForHistogramStatistics() const { return m_binSizeForHistogramStatistics; }
 
+  void ImageStatisticsCalculator::SetComputeTimeStepsInParallel(bool computeTimeStepsInParallel)
+  {
+    if (computeTimeStepsInParallel != m_ComputeTimeStepsInParallel)
+    {
+      m_ComputeTimeStepsInParallel = computeTimeStepsInParallel;
+      this->Modified();
+    }
+  }
+
+  bool ImageStatisticsCalculator::GetComputeTimeStepsInParallel() const { return m_ComputeTimeStepsInParallel; }
+
   mitk::ImageStatisticsContainer* ImageStatisticsCalculator::GetStatistics(LabelIndex label)
   {
     if (m_Image.IsNull())
@@ -109,52 +121,69 @@ namespace mitk
     if (IsUpdateRequired(label))
     {
       auto timeGeometry = m_Image->GetTimeGeometry();
-      // always compute statistics on all timesteps
-      for (unsigned int timeStep = 0; timeStep < m_Image->GetTimeSteps(); timeStep++)
+      if (m_ComputeTimeStepsInParallel && this->CanComputeTimeStepsInParallel())
       {
+        // the mask is the same for all timesteps, so it is generated once and the timesteps are computed in parallel
+        m_InternalMask = nullptr;
         if (m_MaskGenerator.IsNotNull())
         {
-          m_MaskGenerator->SetTimeStep(timeStep);
-          //See T25625: otherwise, the mask is not computed again after setting a different time step
+          m_MaskGenerator->SetTimeStep(0);
           m_MaskGenerator->Modified();
           m_InternalMask = m_MaskGenerator->GetMask();
-          if (m_MaskGenerator->GetReferenceImage().IsNotNull())
+        }
+        m_InternalImageForStatistics = m_Image;
+
+        AccessFixedDimensionByItk_n(m_Image, InternalCalculateStatisticsOfAllTimeSteps, 4, (timeGeometry));
+      }
+      else
+      {
+        // always compute statistics on all timesteps
+        for (unsigned int timeStep = 0; timeStep < m_Image->GetTimeSteps(); timeStep++)
+        {
+          if (m_MaskGenerator.IsNotNull())
           {
-            m_InternalImageForStatistics = m_MaskGenerator->GetReferenceImage();
+            m_MaskGenerator->SetTimeStep(timeStep);
+            //See T25625: otherwise, the mask is not computed again after setting a different time step
+            m_MaskGenerator->Modified();
+            m_InternalMask = m_MaskGenerator->GetMask();
+            if (m_MaskGenerator->GetReferenceImage().IsNotNull())
+            {
+              m_InternalImageForStatistics = m_MaskGenerator->GetReferenceImage();
+            }
+            else
+            {
+              m_InternalImageForStatistics = m_Image;
+            }
           }
           else
           {
             m_InternalImageForStatistics = m_Image;
           }
-        }
-        else
-        {
-          m_InternalImageForStatistics = m_Image;
-        }
 
-        if (m_SecondaryMaskGenerator.IsNotNull())
-        {
-          m_SecondaryMaskGenerator->SetTimeStep(timeStep);
-          m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
-        }
+          if (m_SecondaryMaskGenerator.IsNotNull())
+          {
+            m_SecondaryMaskGenerator->SetTimeStep(timeStep);
+            m_SecondaryMask = m_SecondaryMaskGenerator->GetMask();
+          }
 
-        ImageTimeSelector::Pointer imgTimeSel = ImageTimeSelector::New();
-        imgTimeSel->SetInput(m_InternalImageForStatistics);
-        imgTimeSel->SetTimeNr(timeStep);
-        imgTimeSel->UpdateLargestPossibleRegion();
-        imgTimeSel->Update();
-        m_ImageTimeSlice = imgTimeSel->GetOutput();
+          ImageTimeSelector::Pointer imgTimeSel = ImageTimeSelector::New();
+          imgTimeSel->SetInput(m_InternalImageForStatistics);
+          imgTimeSel->SetTimeNr(timeStep);
+          imgTimeSel->UpdateLargestPossibleRegion();
+          imgTimeSel->Update();
+          m_ImageTimeSlice = imgTimeSel->GetOutput();
 
-        // Calculate statistics with/without mask
-        if (m_MaskGenerator.IsNull() && m_SecondaryMaskGenerator.IsNull())
-        {
-          // 1) calculate statistics unmasked:
-          AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsUnmasked, timeGeometry, timeStep)
-        }
-        else
-        {
-          // 2) calculate statistics masked
-          AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsMasked, timeGeometry, timeStep)
+          // Calculate statistics with/without mask
+          if (m_MaskGenerator.IsNull() && m_SecondaryMaskGenerator.IsNull())
+          {
+            // 1) calculate statistics unmasked:
+            AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsUnmasked, timeGeometry, timeStep)
+          }
+          else
+          {
+            // 2) calculate statistics masked
+            AccessByItk_2(m_ImageTimeSlice, InternalCalculateStatisticsMasked, timeGeometry, timeStep)
+          }
         }
       }
     }
@@ -174,26 +203,20 @@ namespace mitk
   template <typename TPixel, unsigned int VImageDimension>
   void ImageStatisticsCalculator::InternalCalculateStatisticsUnmasked(
     typename itk::Image<TPixel, VImageDimension> *image, const TimeGeometry *timeGeometry, TimeStepType timeStep)
+  {
+    LabelIndex labelNoMask = 1;
+    auto statObj = this->CalculateStatisticsUnmasked<TPixel, VImageDimension>(image, 0);
+    this->GetStatisticsContainer(labelNoMask, timeGeometry)->SetStatisticsForTimeStep(timeStep, statObj);
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  ImageStatisticsContainer::ImageStatisticsObject ImageStatisticsCalculator::CalculateStatisticsUnmasked(
+    typename itk::Image<TPixel, VImageDimension> *image, unsigned int numberOfThreads) const
   {
     typedef typename itk::Image<TPixel, VImageDimension> ImageType;
     typedef typename itk::ExtendedStatisticsImageFilter<ImageType> ImageStatisticsFilterType;
     typedef typename itk::MinMaxImageFilterWithIndex<ImageType> MinMaxFilterType;
 
-    // reset statistics container if exists
-    ImageStatisticsContainer::Pointer statisticContainerForImage;
-    LabelIndex labelNoMask = 1;
-    auto it = m_StatisticContainers.find(labelNoMask);
-    if (it != m_StatisticContainers.end())
-    {
-      statisticContainerForImage = it->second;
-    }
-    else
-    {
-      statisticContainerForImage = ImageStatisticsContainer::New();
-      statisticContainerForImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
-      m_StatisticContainers.emplace(labelNoMask, statisticContainerForImage);
-    }
-
     auto statObj = ImageStatisticsContainer::ImageStatisticsObject();
 
     typename ImageStatisticsFilterType::Pointer statisticsFilter = ImageStatisticsFilterType::New();
@@ -209,6 +232,11 @@ namespace mitk
 
     typename MinMaxFilterType::Pointer minMaxFilter = MinMaxFilterType::New();
     minMaxFilter->SetInput(image);
+    if (numberOfThreads > 0)
+    {
+      statisticsFilter->SetNumberOfThreads(numberOfThreads);
+      minMaxFilter->SetNumberOfThreads(numberOfThreads);
+    }
     minMaxFilter->UpdateLargestPossibleRegion();
     typename ImageType::PixelType minval = minMaxFilter->GetMin();
     typename ImageType::PixelType maxval = minMaxFilter->GetMax();
@@ -281,11 +309,11 @@ namespace mitk
     statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), statisticsFilter->GetUniformity());
     statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), statisticsFilter->GetUPP());
     statObj.m_Histogram = statisticsFilter->GetHistogram().GetPointer();
-    statisticContainerForImage->SetStatisticsForTimeStep(timeStep, statObj);
+    return statObj;
   }
 
   template <typename TPixel, unsigned int VImageDimension>
-  double ImageStatisticsCalculator::GetVoxelVolume(typename itk::Image<TPixel, VImageDimension> *image) const
+  double ImageStatisticsCalculator::GetVoxelVolume(const itk::Image<TPixel, VImageDimension> *image) const
   {
     auto spacing = image->GetSpacing();
     double voxelVolume = 1.;
@@ -301,13 +329,7 @@ namespace mitk
                                                                     const TimeGeometry *timeGeometry,
                                                                     unsigned int timeStep)
   {
-    typedef itk::Image<TPixel, VImageDimension> ImageType;
     typedef itk::Image<MaskPixelType, VImageDimension> MaskType;
-    typedef typename MaskType::PixelType LabelPixelType;
-    typedef itk::ExtendedLabelStatisticsImageFilter<ImageType, MaskType> ImageStatisticsFilterType;
-    typedef MaskUtilities<TPixel, VImageDimension> MaskUtilType;
-    typedef typename itk::MinMaxLabelImageFilterWithIndex<ImageType, MaskType> MinMaxLabelFilterType;
-    typedef typename ImageType::PixelType InputImgPixelType;
 
     // workaround: if m_SecondaryMaskGenerator ist not null but m_MaskGenerator is! (this is the case if we request a
     // 'ignore zuero valued pixels' mask in the gui but do not define a primary mask)
@@ -368,9 +390,41 @@ namespace mitk
       maskImage = maskFilter->GetOutput();
     }
 
+    StatisticsObjectMapType statistics =
+      this->CalculateStatisticsMasked<TPixel, VImageDimension>(image, maskImage.GetPointer(), 0);
+    for (const auto &labelStatistics : statistics)
+    {
+      this->GetStatisticsContainer(labelStatistics.first, timeGeometry)
+        ->SetStatisticsForTimeStep(timeStep, labelStatistics.second);
+    }
+
+    // swap maskGenerators back
+    if (swapMasks)
+    {
+      m_SecondaryMask = m_InternalMask;
+      m_InternalMask = nullptr;
+    }
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  ImageStatisticsCalculator::StatisticsObjectMapType ImageStatisticsCalculator::CalculateStatisticsMasked(
+    typename itk::Image<TPixel, VImageDimension> *image,
+    typename itk::Image<MaskPixelType, VImageDimension> *maskImage,
+    unsigned int numberOfThreads) const
+  {
+    typedef itk::Image<TPixel, VImageDimension> ImageType;
+    typedef itk::Image<MaskPixelType, VImageDimension> MaskType;
+    typedef typename MaskType::PixelType LabelPixelType;
+    typedef itk::ExtendedLabelStatisticsImageFilter<ImageType, MaskType> ImageStatisticsFilterType;
+    typedef MaskUtilities<TPixel, VImageDimension> MaskUtilType;
+    typedef typename itk::MinMaxLabelImageFilterWithIndex<ImageType, MaskType> MinMaxLabelFilterType;
+    typedef typename ImageType::PixelType InputImgPixelType;
+
+    StatisticsObjectMapType statistics;
+
     typename MaskUtilType::Pointer maskUtil = MaskUtilType::New();
     maskUtil->SetImage(image);
-    maskUtil->SetMask(maskImage.GetPointer());
+    maskUtil->SetMask(maskImage);
 
     // if mask is smaller than image, extract the image region where the mask is
     typename ImageType::Pointer adaptedImage = ImageType::New();
@@ -381,6 +435,10 @@ namespace mitk
     typename MinMaxLabelFilterType::Pointer minMaxFilter = MinMaxLabelFilterType::New();
     minMaxFilter->SetInput(adaptedImage);
     minMaxFilter->SetLabelInput(maskImage);
+    if (numberOfThreads > 0)
+    {
+      minMaxFilter->SetNumberOfThreads(numberOfThreads);
+    }
     minMaxFilter->UpdateLargestPossibleRegion();
 
     // set histogram parameters for each label individually (min/max may be different for each label)
@@ -419,6 +477,10 @@ namespace mitk
     imageStatisticsFilter->SetInput(adaptedImage);
     imageStatisticsFilter->SetLabelInput(maskImage);
     imageStatisticsFilter->SetHistogramParametersForLabels(nBins, minVals, maxVals);
+    if (numberOfThreads > 0)
+    {
+      imageStatisticsFilter->SetNumberOfThreads(numberOfThreads);
+    }
     imageStatisticsFilter->Update();
 
     std::list<int> labels = imageStatisticsFilter->GetRelevantLabels();
@@ -426,22 +488,6 @@ namespace mitk
 
     while (it != labels.end())
     {
-      ImageStatisticsContainer::Pointer statisticContainerForLabelImage;
-      auto labelIt = m_StatisticContainers.find(*it);
-      // reset if statisticContainer already exist
-      if (labelIt != m_StatisticContainers.end())
-      {
-        statisticContainerForLabelImage = labelIt->second;
-      }
-      // create new statisticContainer
-      else
-      {
-        statisticContainerForLabelImage = ImageStatisticsContainer::New();
-        statisticContainerForLabelImage->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
-        // link label (*it) to statisticContainer
-        m_StatisticContainers.emplace(*it, statisticContainerForLabelImage);
-      }
-
       ImageStatisticsContainer::ImageStatisticsObject statObj;
 
       // find min, max, minindex and maxindex
@@ -498,16 +544,129 @@ namespace mitk
       statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), imageStatisticsFilter->GetUPP(*it));
       statObj.m_Histogram = imageStatisticsFilter->GetHistogram(*it).GetPointer();
 
-      statisticContainerForLabelImage->SetStatisticsForTimeStep(timeStep, statObj);
+      statistics.emplace(*it, statObj);
       ++it;
     }
 
-    // swap maskGenerators back
-    if (swapMasks)
+    return statistics;
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  void ImageStatisticsCalculator::InternalCalculateStatisticsOfAllTimeSteps(
+    const itk::Image<TPixel, VImageDimension> *image, const TimeGeometry *timeGeometry)
+  {
+    const unsigned int VVolumeDimension = VImageDimension - 1;
+    typedef itk::Image<TPixel, VVolumeDimension> VolumeType;
+    typedef itk::Image<MaskPixelType, VVolumeDimension> MaskType;
+
+    typename MaskType::Pointer maskImage;
+    if (m_InternalMask.IsNotNull())
     {
-      m_SecondaryMask = m_InternalMask;
-      m_InternalMask = nullptr;
+      try
+      {
+        maskImage = ImageToItkImage<MaskPixelType, VVolumeDimension>(m_InternalMask);
+      }
+      catch (const itk::ExceptionObject &)
+      {
+        CastToItkImage(m_InternalMask, maskImage);
+      }
+    }
+
+    // every timestep is computed on a volume that references its part of the buffer of image. The volumes and the
+    // mask views have no source, so the pipelines of different threads do not share any object
+    const auto &bufferedRegion = image->GetBufferedRegion();
+    typename VolumeType::RegionType volumeRegion;
+    typename VolumeType::PointType volumeOrigin;
+    typename VolumeType::SpacingType volumeSpacing;
+    typename VolumeType::DirectionType volumeDirection;
+    for (unsigned int i = 0; i < VVolumeDimension; ++i)
+    {
+      volumeRegion.SetIndex(i, bufferedRegion.GetIndex(i));
+      volumeRegion.SetSize(i, bufferedRegion.GetSize(i));
+      volumeOrigin[i] = image->GetOrigin()[i];
+      volumeSpacing[i] = image->GetSpacing()[i];
+      for (unsigned int j = 0; j < VVolumeDimension; ++j)
+      {
+        volumeDirection[i][j] = image->GetDirection()[i][j];
+      }
     }
+    const std::size_t numberOfVolumePixels = volumeRegion.GetNumberOfPixels();
+    const std::size_t numberOfTimeSteps = bufferedRegion.GetSize(VVolumeDimension);
+
+    std::vector<StatisticsObjectMapType> results(numberOfTimeSteps);
+
+    ParallelFor(numberOfTimeSteps, [&](std::size_t timeStep) {
+      typename VolumeType::Pointer volume = VolumeType::New();
+      volume->SetRegions(volumeRegion);
+      volume->SetOrigin(volumeOrigin);
+      volume->SetSpacing(volumeSpacing);
+      volume->SetDirection(volumeDirection);
+      volume->GetPixelContainer()->SetImportPointer(
+        const_cast<TPixel *>(image->GetBufferPointer()) + timeStep * numberOfVolumePixels,
+        numberOfVolumePixels,
+        false);
+
+      if (maskImage.IsNull())
+      {
+        LabelIndex labelNoMask = 1;
+        results[timeStep].emplace(labelNoMask,
+                                  this->CalculateStatisticsUnmasked<TPixel, VVolumeDimension>(volume, 1));
+      }
+      else
+      {
+        typename MaskType::Pointer maskView = MaskType::New();
+        maskView->SetRegions(maskImage->GetBufferedRegion());
+        maskView->SetOrigin(maskImage->GetOrigin());
+        maskView->SetSpacing(maskImage->GetSpacing());
+        maskView->SetDirection(maskImage->GetDirection());
+        maskView->GetPixelContainer()->SetImportPointer(
+          maskImage->GetBufferPointer(), maskImage->GetBufferedRegion().GetNumberOfPixels(), false);
+
+        results[timeStep] = this->CalculateStatisticsMasked<TPixel, VVolumeDimension>(volume, maskView, 1);
+      }
+    });
+
+    for (std::size_t timeStep = 0; timeStep < numberOfTimeSteps; ++timeStep)
+    {
+      for (const auto &labelStatistics : results[timeStep])
+      {
+        this->GetStatisticsContainer(labelStatistics.first, timeGeometry)
+          ->SetStatisticsForTimeStep(timeStep, labelStatistics.second);
+      }
+    }
+  }
+
+  bool ImageStatisticsCalculator::CanComputeTimeStepsInParallel() const
+  {
+    if (m_Image->GetDimension() != 4 || m_Image->GetTimeSteps() < 2 || m_SecondaryMaskGenerator.IsNotNull())
+    {
+      return false;
+    }
+
+    if (m_MaskGenerator.IsNull())
+    {
+      return true;
+    }
+
+    // the mask has to be the same for all timesteps and has to refer to the input image
+    auto referenceImage = m_MaskGenerator->GetReferenceImage();
+    return m_MaskGenerator->IsTimeInvariant() && (referenceImage.IsNull() || referenceImage == m_Image);
+  }
+
+  ImageStatisticsContainer* ImageStatisticsCalculator::GetStatisticsContainer(LabelIndex label,
+                                                                              const TimeGeometry *timeGeometry)
+  {
+    // reset statistics container if exists
+    auto it = m_StatisticContainers.find(label);
+    if (it != m_StatisticContainers.end())
+    {
+      return it->second;
+    }
+
+    ImageStatisticsContainer::Pointer statisticContainer = ImageStatisticsContainer::New();
+    statisticContainer->SetTimeGeometry(const_cast<mitk::TimeGeometry*>(timeGeometry));
+    m_StatisticContainers.emplace(label, statisticContainer);
+    return statisticContainer;
   }
 
   bool ImageStatisticsCalculator::IsUpdateRequired(LabelIndex label) const
@@ -76,6 +76,13 @@ namespace mitk
         That solely depends on which parameter has been set last.*/
         double GetBinSizeForHistogramStatistics() const;
 
+        /**Documentation
+        @brief Set whether the time steps of a 3D+t image are computed in parallel, each time step being one work item on the
+        4D buffer. This is only possible if no secondary mask is set and the mask (if any) is the same for all time steps
+        (see MaskGenerator::IsTimeInvariant()), otherwise the time steps are computed one after another. Default is false.*/
+        void SetComputeTimeStepsInParallel(bool computeTimeStepsInParallel);
+        bool GetComputeTimeStepsInParallel() const;
+
         /**Documentation
         @brief Returns the statistics for label @a label. If these requested statistics are not computed yet the computation is done as well.
         For performance reasons, statistics for all labels in the image are computed at once.
@@ -87,10 +94,13 @@ namespace mitk
             m_nBinsForHistogramStatistics = 100;
             m_binSizeForHistogramStatistics = 10;
             m_UseBinSizeOverNBins = false;
+            m_ComputeTimeStepsInParallel = false;
         };
 
 
     private:
+        typedef std::map<LabelIndex, ImageStatisticsContainer::ImageStatisticsObject> StatisticsObjectMapType;
+
         //Calculates statistics for each timestep for image
         template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatisticsUnmasked(
                 typename itk::Image< TPixel, VImageDimension >* image, const TimeGeometry* timeGeometry, TimeStepType timeStep);
@@ -99,8 +109,27 @@ namespace mitk
                 typename itk::Image< TPixel, VImageDimension >* image, const TimeGeometry* timeGeometry,
                 unsigned int timeStep);
 
+        //Calculates statistics for all timesteps of a 3D+t image at once, all timesteps share m_InternalMask (may be nullptr)
+        template < typename TPixel, unsigned int VImageDimension > void InternalCalculateStatisticsOfAllTimeSteps(
+                const itk::Image< TPixel, VImageDimension >* image, const TimeGeometry* timeGeometry);
+
+        //Computes the statistics of one volume, numberOfThreads==0 keeps the default number of threads of the filters
         template < typename TPixel, unsigned int VImageDimension >
-        double GetVoxelVolume(typename itk::Image<TPixel, VImageDimension>* image) const;
+        ImageStatisticsContainer::ImageStatisticsObject CalculateStatisticsUnmasked(
+                typename itk::Image< TPixel, VImageDimension >* image, unsigned int numberOfThreads) const;
+
+        template < typename TPixel, unsigned int VImageDimension > StatisticsObjectMapType CalculateStatisticsMasked(
+                typename itk::Image< TPixel, VImageDimension >* image,
+                typename itk::Image< MaskPixelType, VImageDimension >* maskImage, unsigned int numberOfThreads) const;
+
+        template < typename TPixel, unsigned int VImageDimension >
+        double GetVoxelVolume(const itk::Image<TPixel, VImageDimension>* image) const;
+
+        //Returns whether GetStatistics can use InternalCalculateStatisticsOfAllTimeSteps
+        bool CanComputeTimeStepsInParallel() const;
+
+        //Returns the container for label, a new one is created with timeGeometry if it does not exist
+        ImageStatisticsContainer* GetStatisticsContainer(LabelIndex label, const TimeGeometry* timeGeometry);
 
         bool IsUpdateRequired(LabelIndex label) const;
 
@@ -117,6 +146,7 @@ namespace mitk
         unsigned int m_nBinsForHistogramStatistics;
         double m_binSizeForHistogramStatistics;
         bool m_UseBinSizeOverNBins;
+        bool m_ComputeTimeStepsInParallel;
 
         std::map<LabelIndex,ImageStatisticsContainer::Pointer> m_StatisticContainers;
     };
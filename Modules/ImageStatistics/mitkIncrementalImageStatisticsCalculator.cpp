@@ -0,0 +1,536 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkIncrementalImageStatisticsCalculator.h"
+#include <mitkHistogramStatisticsCalculator.h>
+#include <mitkImageAccessByItk.h>
+#include <mitkImageStatisticsConstants.h>
+#include <mitkImageToItk.h>
+
+#include <itkImageRegionConstIterator.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace mitk
+{
+  IncrementalImageStatisticsCalculator::IncrementalImageStatisticsCalculator()
+    : m_Label(1),
+      m_nBinsForHistogramStatistics(100),
+      m_binSizeForHistogramStatistics(10),
+      m_UseBinSizeOverNBins(false),
+      m_VoxelVolume(1.),
+      m_NumberOfComputations(0)
+  {
+    this->ResetAccumulators();
+  }
+
+  IncrementalImageStatisticsCalculator::~IncrementalImageStatisticsCalculator() {}
+
+  void IncrementalImageStatisticsCalculator::SetInputImage(const mitk::Image *image)
+  {
+    if (image != m_Image)
+    {
+      m_Image = image;
+      this->Modified();
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::SetMask(const mitk::Image *mask)
+  {
+    if (mask != m_Mask)
+    {
+      m_Mask = mask;
+      this->Modified();
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::SetLabel(LabelIndex label)
+  {
+    if (label != m_Label)
+    {
+      m_Label = label;
+      this->Modified();
+    }
+  }
+
+  IncrementalImageStatisticsCalculator::LabelIndex IncrementalImageStatisticsCalculator::GetLabel() const
+  {
+    return m_Label;
+  }
+
+  void IncrementalImageStatisticsCalculator::SetNBinsForHistogramStatistics(unsigned int nBins)
+  {
+    if (nBins != m_nBinsForHistogramStatistics || m_UseBinSizeOverNBins)
+    {
+      m_nBinsForHistogramStatistics = nBins;
+      m_UseBinSizeOverNBins = false;
+      this->Modified();
+    }
+  }
+
+  unsigned int IncrementalImageStatisticsCalculator::GetNBinsForHistogramStatistics() const
+  {
+    return m_nBinsForHistogramStatistics;
+  }
+
+  void IncrementalImageStatisticsCalculator::SetBinSizeForHistogramStatistics(double binSize)
+  {
+    if (binSize != m_binSizeForHistogramStatistics || !m_UseBinSizeOverNBins)
+    {
+      m_binSizeForHistogramStatistics = binSize;
+      m_UseBinSizeOverNBins = true;
+      this->Modified();
+    }
+  }
+
+  double IncrementalImageStatisticsCalculator::GetBinSizeForHistogramStatistics() const
+  {
+    return m_binSizeForHistogramStatistics;
+  }
+
+  void IncrementalImageStatisticsCalculator::Compute()
+  {
+    this->CheckInputs();
+
+    const mitk::Image *image = m_Image;
+    AccessFixedDimensionByItk(image, InternalCompute, 3);
+
+    m_ComputeTime.Modified();
+    ++m_NumberOfComputations;
+  }
+
+  void IncrementalImageStatisticsCalculator::UpdateMaskRegion(const RegionType &region)
+  {
+    this->CheckInputs();
+
+    // changed inputs or settings invalidate everything that was accumulated
+    if (m_LabelBits.empty() || this->GetMTime() > m_ComputeTime.GetMTime() ||
+        m_Image->GetMTime() > m_ComputeTime.GetMTime())
+    {
+      this->Compute();
+      return;
+    }
+
+    const mitk::Image *image = m_Image;
+    AccessFixedDimensionByItk_1(image, InternalUpdateMaskRegion, 3, region);
+  }
+
+  ImageStatisticsContainer::ImageStatisticsObject IncrementalImageStatisticsCalculator::GetStatistics() const
+  {
+    ImageStatisticsContainer::ImageStatisticsObject statObj;
+
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::NUMBEROFVOXELS(),
+                         static_cast<ImageStatisticsContainer::VoxelCountType>(m_Count));
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::VOLUME(), static_cast<double>(m_Count) * m_VoxelVolume);
+
+    if (0 == m_Count)
+    {
+      return statObj;
+    }
+
+    // central moments from the sums of powers, see ExtendedLabelStatisticsImageFilter for the definitions
+    const double count = static_cast<double>(m_Count);
+    const double shiftedMean = m_Sums[0] / count;
+    const double shiftedMean2 = shiftedMean * shiftedMean;
+    const double m2 = std::max(0., m_Sums[1] - count * shiftedMean2);
+    const double m3 = m_Sums[2] - 3. * shiftedMean * m_Sums[1] + 2. * count * shiftedMean2 * shiftedMean;
+    const double m4 = m_Sums[3] - 4. * shiftedMean * m_Sums[2] + 6. * shiftedMean2 * m_Sums[1] -
+                      3. * count * shiftedMean2 * shiftedMean2;
+
+    const double mean = m_Shift + shiftedMean;
+    const double variance = m2 / count;
+    const double rms = std::sqrt(mean * mean + variance);
+
+    vnl_vector<int> minIndex(3), maxIndex(3);
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      minIndex[i] = m_MinimumIndex[i];
+      maxIndex[i] = m_MaximumIndex[i];
+    }
+
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUMPOSITION(), minIndex);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUMPOSITION(), maxIndex);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MEAN(), mean);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MINIMUM(), m_Minimum);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MAXIMUM(), m_Maximum);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::STANDARDDEVIATION(), std::sqrt(variance));
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::VARIANCE(), variance);
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::SKEWNESS(), std::sqrt(count) * m3 / std::pow(m2, 1.5));
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::KURTOSIS(), count * m4 / (m2 * m2));
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::RMS(), rms);
+    // like the default of ExtendedStatisticsImageFilter, labels without positive voxels have a MPP of 0
+    statObj.AddStatistic(mitk::ImageStatisticsConstants::MPP(),
+                         0 == m_PositivePixelCount ? 0.
+                                                   : m_SumOfPositivePixels / static_cast<double>(m_PositivePixelCount));
+
+    if (m_Histogram.IsNotNull())
+    {
+      // hand out a copy, the histogram of the calculator changes with the next update
+      const auto numberOfBins = m_Histogram->GetSize(0);
+      HistogramType::SizeType size(1);
+      HistogramType::MeasurementVectorType lowerBound(1);
+      HistogramType::MeasurementVectorType upperBound(1);
+      size[0] = numberOfBins;
+      lowerBound[0] = m_Minimum;
+      upperBound[0] = m_Maximum;
+
+      HistogramType::Pointer histogram = HistogramType::New();
+      histogram->SetMeasurementVectorSize(1);
+      histogram->Initialize(size, lowerBound, upperBound);
+      for (HistogramType::InstanceIdentifier bin = 0; bin < numberOfBins; ++bin)
+      {
+        histogram->SetFrequency(bin, m_Histogram->GetFrequency(bin));
+      }
+
+      mitk::HistogramStatisticsCalculator histStatCalc;
+      histStatCalc.SetHistogram(histogram);
+      histStatCalc.CalculateStatistics();
+
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::ENTROPY(), histStatCalc.GetEntropy());
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::MEDIAN(), histStatCalc.GetMedian());
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::UNIFORMITY(), histStatCalc.GetUniformity());
+      statObj.AddStatistic(mitk::ImageStatisticsConstants::UPP(), histStatCalc.GetUPP());
+      statObj.m_Histogram = histogram.GetPointer();
+    }
+
+    return statObj;
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  void IncrementalImageStatisticsCalculator::InternalCompute(const itk::Image<TPixel, VImageDimension> *image)
+  {
+    const RegionType largestRegion = image->GetLargestPossibleRegion();
+
+    m_VoxelVolume = 1.;
+    for (unsigned int i = 0; i < VImageDimension; i++)
+    {
+      m_VoxelVolume *= image->GetSpacing()[i];
+    }
+
+    m_LabelBits.assign((largestRegion.GetNumberOfPixels() + 63) / 64, 0);
+    m_BoundingBox = RegionType();
+
+    this->ReadMask(image, largestRegion, false);
+    this->Accumulate(image, m_BoundingBox);
+  }
+
+  template <typename TPixel, unsigned int VImageDimension>
+  void IncrementalImageStatisticsCalculator::InternalUpdateMaskRegion(const itk::Image<TPixel, VImageDimension> *image,
+                                                                      const RegionType &region)
+  {
+    RegionType croppedRegion = region;
+    if (!croppedRegion.Crop(image->GetLargestPossibleRegion()))
+    {
+      return;
+    }
+
+    if (!this->ReadMask(image, croppedRegion, true))
+    {
+      // the mask state is up to date, only the voxels of the label have to be visited again
+      this->Accumulate(image, m_BoundingBox);
+      ++m_NumberOfComputations;
+    }
+  }
+
+  template <typename TPixel>
+  bool IncrementalImageStatisticsCalculator::ReadMask(const itk::Image<TPixel, 3> *image,
+                                                      const RegionType &region,
+                                                      bool updateStatistics)
+  {
+    // segmentations are unsigned char, label set images unsigned short
+    switch (m_Mask->GetPixelType().GetComponentType())
+    {
+      case itk::ImageIOBase::UCHAR:
+        return this->ReadMaskRegion(
+          image, ImageToItkImage<unsigned char, 3>(m_Mask.GetPointer()).GetPointer(), region, updateStatistics);
+      case itk::ImageIOBase::USHORT:
+        return this->ReadMaskRegion(
+          image, ImageToItkImage<unsigned short, 3>(m_Mask.GetPointer()).GetPointer(), region, updateStatistics);
+      default:
+        mitkThrow() << "Mask pixel type " << m_Mask->GetPixelType().GetComponentTypeAsString()
+                    << " is not supported, use unsigned char or unsigned short";
+    }
+  }
+
+  template <typename TPixel, typename TMaskPixel>
+  bool IncrementalImageStatisticsCalculator::ReadMaskRegion(const itk::Image<TPixel, 3> *image,
+                                                            const itk::Image<TMaskPixel, 3> *mask,
+                                                            const RegionType &region,
+                                                            bool updateStatistics)
+  {
+    bool statisticsAreValid = updateStatistics;
+
+    itk::ImageRegionConstIteratorWithIndex<itk::Image<TMaskPixel, 3>> maskIt(mask, region);
+    itk::ImageRegionConstIterator<itk::Image<TPixel, 3>> imageIt(image, region);
+
+    for (maskIt.GoToBegin(), imageIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt, ++imageIt)
+    {
+      const bool inLabel = static_cast<LabelIndex>(maskIt.Get()) == m_Label;
+      const std::size_t offset = static_cast<std::size_t>(image->ComputeOffset(maskIt.GetIndex()));
+
+      if (inLabel == this->IsInLabel(offset))
+      {
+        continue;
+      }
+
+      this->SetInLabel(offset, inLabel);
+
+      if (inLabel)
+      {
+        this->GrowBoundingBox(maskIt.GetIndex());
+      }
+
+      // after the first change that needs a new accumulation only the mask state is updated
+      if (statisticsAreValid)
+      {
+        const double value = static_cast<double>(imageIt.Get());
+        statisticsAreValid = inLabel ? this->AddValue(value) : this->RemoveValue(value, maskIt.GetIndex());
+      }
+    }
+
+    return statisticsAreValid;
+  }
+
+  template <typename TPixel>
+  void IncrementalImageStatisticsCalculator::Accumulate(const itk::Image<TPixel, 3> *image, const RegionType &region)
+  {
+    this->ResetAccumulators();
+    m_BoundingBox = RegionType();
+
+    if (0 == region.GetNumberOfPixels())
+    {
+      return;
+    }
+
+    RegionType::IndexType lower = region.GetIndex();
+    RegionType::IndexType upper = region.GetIndex();
+    itk::ImageRegionConstIteratorWithIndex<itk::Image<TPixel, 3>> it(image, region);
+    for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+    {
+      const RegionType::IndexType index = it.GetIndex();
+      if (!this->IsInLabel(static_cast<std::size_t>(image->ComputeOffset(index))))
+      {
+        continue;
+      }
+
+      const double value = static_cast<double>(it.Get());
+      if (0 == m_Count)
+      {
+        m_Shift = value;
+        lower = index;
+        upper = index;
+      }
+
+      this->AddToSums(value, 1.);
+
+      if (value < m_Minimum)
+      {
+        m_Minimum = value;
+        m_MinimumIndex = index;
+      }
+      if (value > m_Maximum)
+      {
+        m_Maximum = value;
+        m_MaximumIndex = index;
+      }
+
+      for (unsigned int i = 0; i < 3; i++)
+      {
+        lower[i] = std::min(lower[i], index[i]);
+        upper[i] = std::max(upper[i], index[i]);
+      }
+    }
+
+    // the bounding box shrinks to the voxels that are left
+    if (0 == m_Count)
+    {
+      return;
+    }
+    m_BoundingBox.SetIndex(lower);
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      m_BoundingBox.SetSize(i, upper[i] - lower[i] + 1);
+    }
+
+    // the histogram parameters depend on minimum and maximum, so the bins are filled in a second pass
+    unsigned int nBinsForHistogram;
+    if (m_UseBinSizeOverNBins)
+    {
+      nBinsForHistogram = std::max(static_cast<double>(std::ceil(m_Maximum - m_Minimum)) /
+                                     m_binSizeForHistogramStatistics,
+                                   10.); // do not allow less than 10 bins
+    }
+    else
+    {
+      nBinsForHistogram = m_nBinsForHistogramStatistics;
+    }
+
+    HistogramType::SizeType size(1);
+    HistogramType::MeasurementVectorType lowerBound(1);
+    HistogramType::MeasurementVectorType upperBound(1);
+    size[0] = nBinsForHistogram;
+    lowerBound[0] = m_Minimum;
+    upperBound[0] = m_Maximum;
+
+    m_Histogram = HistogramType::New();
+    m_Histogram->SetMeasurementVectorSize(1);
+    m_Histogram->Initialize(size, lowerBound, upperBound);
+
+    itk::ImageRegionConstIteratorWithIndex<itk::Image<TPixel, 3>> histogramIt(image, m_BoundingBox);
+    for (histogramIt.GoToBegin(); !histogramIt.IsAtEnd(); ++histogramIt)
+    {
+      if (this->IsInLabel(static_cast<std::size_t>(image->ComputeOffset(histogramIt.GetIndex()))))
+      {
+        this->AddToHistogram(static_cast<double>(histogramIt.Get()), 1);
+      }
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::CheckInputs() const
+  {
+    if (m_Image.IsNull())
+    {
+      mitkThrow() << "no image";
+    }
+
+    if (m_Mask.IsNull())
+    {
+      mitkThrow() << "no mask";
+    }
+
+    if (m_Image->GetDimension() != 3 || m_Mask->GetDimension() != 3)
+    {
+      mitkThrow() << "Image and mask have to be 3D images!";
+    }
+
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      if (m_Image->GetDimension(i) != m_Mask->GetDimension(i))
+      {
+        mitkThrow() << "Image and mask have different sizes!";
+      }
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::ResetAccumulators()
+  {
+    m_Count = 0;
+    m_Shift = 0.;
+    std::fill(m_Sums, m_Sums + 4, 0.);
+    m_PositivePixelCount = 0;
+    m_SumOfPositivePixels = 0.;
+    m_Minimum = std::numeric_limits<double>::max();
+    m_Maximum = std::numeric_limits<double>::lowest();
+    m_MinimumIndex.Fill(0);
+    m_MaximumIndex.Fill(0);
+    m_Histogram = nullptr;
+  }
+
+  void IncrementalImageStatisticsCalculator::AddToSums(double value, double weight)
+  {
+    const double delta = value - m_Shift;
+    const double delta2 = delta * delta;
+
+    m_Sums[0] += weight * delta;
+    m_Sums[1] += weight * delta2;
+    m_Sums[2] += weight * delta2 * delta;
+    m_Sums[3] += weight * delta2 * delta2;
+
+    const bool add = weight > 0;
+    m_Count = add ? m_Count + 1 : m_Count - 1;
+
+    if (value > 0)
+    {
+      m_PositivePixelCount = add ? m_PositivePixelCount + 1 : m_PositivePixelCount - 1;
+      m_SumOfPositivePixels += weight * value;
+    }
+  }
+
+  void IncrementalImageStatisticsCalculator::AddToHistogram(double value, int frequencyChange)
+  {
+    HistogramType::MeasurementVectorType measurement(1);
+    HistogramType::IndexType index(1);
+    measurement[0] = value;
+
+    if (m_Histogram->GetIndex(measurement, index))
+    {
+      const HistogramType::InstanceIdentifier bin = m_Histogram->GetInstanceIdentifier(index);
+      m_Histogram->SetFrequency(bin, m_Histogram->GetFrequency(bin) + frequencyChange);
+    }
+  }
+
+  bool IncrementalImageStatisticsCalculator::AddValue(double value)
+  {
+    // a new minimum or maximum changes the histogram bins
+    if (0 == m_Count || value < m_Minimum || value > m_Maximum)
+    {
+      return false;
+    }
+
+    this->AddToSums(value, 1.);
+    this->AddToHistogram(value, 1);
+    return true;
+  }
+
+  bool IncrementalImageStatisticsCalculator::RemoveValue(double value, const RegionType::IndexType &index)
+  {
+    // other voxels may have the same value, but their position is not known
+    if (index == m_MinimumIndex || index == m_MaximumIndex)
+    {
+      return false;
+    }
+
+    this->AddToSums(value, -1.);
+    this->AddToHistogram(value, -1);
+    return true;
+  }
+
+  void IncrementalImageStatisticsCalculator::GrowBoundingBox(const RegionType::IndexType &index)
+  {
+    if (0 == m_BoundingBox.GetNumberOfPixels())
+    {
+      m_BoundingBox.SetIndex(index);
+      m_BoundingBox.GetModifiableSize().Fill(1);
+      return;
+    }
+
+    RegionType::IndexType lower = m_BoundingBox.GetIndex();
+    RegionType::IndexType upper = m_BoundingBox.GetUpperIndex();
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      lower[i] = std::min(lower[i], index[i]);
+      upper[i] = std::max(upper[i], index[i]);
+    }
+    m_BoundingBox.SetIndex(lower);
+    m_BoundingBox.SetUpperIndex(upper);
+  }
+
+  void IncrementalImageStatisticsCalculator::SetInLabel(std::size_t offset, bool inLabel)
+  {
+    const std::uint64_t bit = std::uint64_t(1) << (offset & 63);
+    if (inLabel)
+    {
+      m_LabelBits[offset >> 6] |= bit;
+    }
+    else
+    {
+      m_LabelBits[offset >> 6] &= ~bit;
+    }
+  }
+} // namespace mitk
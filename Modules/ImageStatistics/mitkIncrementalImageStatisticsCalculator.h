@@ -0,0 +1,182 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef MITKINCREMENTALIMAGESTATISTICSCALCULATOR
+#define MITKINCREMENTALIMAGESTATISTICSCALCULATOR
+
+#include <MitkImageStatisticsExports.h>
+#include <mitkImage.h>
+#include <mitkImageStatisticsContainer.h>
+
+#include <itkImageRegion.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mitk
+{
+  /**
+  \brief Keeps the statistics of one label of a mask up to date while the mask is edited.
+
+  Compute() collects the voxels of the image whose mask value equals the label and accumulates
+  count, sums of powers, min/max and the histogram of them. After the mask was changed within a
+  region (e.g. the slice written back by a segmentation tool), UpdateMaskRegion() compares the
+  region with the mask state of the last call, subtracts the voxels that left the label and adds
+  the voxels that entered it. Only the region is visited, so the statistics can be updated while
+  segmenting large images.
+
+  The calculator does not observe the mask. Whoever edits the mask has to pass the changed region,
+  e.g. the region of the ImageRegionModifiedEvent the segmentation tools invoke when they write back a slice
+  (QmitkImageStatisticsCalculationJob::AddChangedMaskRegion()).
+
+  The histogram spans the range between minimum and maximum of the label, like the histograms of
+  ImageStatisticsCalculator. If an edit changes the minimum or maximum, the bins are no longer valid
+  and the statistics are computed again from the voxels of the label within their bounding box.
+
+  Image and mask have to be 3D images of the same size, the mask is of pixel type unsigned char or
+  unsigned short. For images with several time steps pass the volume of a time step (see ImageTimeSelector).
+  If the image or the settings were modified since the last computation, UpdateMaskRegion() computes
+  all statistics again.
+  */
+  class MITKIMAGESTATISTICS_EXPORT IncrementalImageStatisticsCalculator : public itk::Object
+  {
+  public:
+    /** Standard Self typedef */
+    typedef IncrementalImageStatisticsCalculator Self;
+    typedef itk::Object Superclass;
+    typedef itk::SmartPointer<Self> Pointer;
+    typedef itk::SmartPointer<const Self> ConstPointer;
+
+    /** Method for creation through the object factory. */
+    itkNewMacro(Self)
+
+    /** Runtime information support. */
+    itkTypeMacro(IncrementalImageStatisticsCalculator, itk::Object)
+
+    typedef itk::ImageRegion<3> RegionType;
+    typedef ImageStatisticsContainer::HistogramType HistogramType;
+    using LabelIndex = ImageStatisticsContainer::LabelIndex;
+
+    /**Documentation
+    @brief Set the 3D image for which the statistics are to be computed.*/
+    void SetInputImage(const mitk::Image *image);
+
+    /**Documentation
+    @brief Set the 3D mask that is edited. It has to have the same size as the input image.*/
+    void SetMask(const mitk::Image *mask);
+
+    /**Documentation
+    @brief Set the mask value of the voxels for which the statistics are computed. The default is 1.*/
+    void SetLabel(LabelIndex label);
+    LabelIndex GetLabel() const;
+
+    /**Documentation
+    @brief Set number of bins to be used for histogram statistics. If Bin size is set after number of bins, bin size will be used instead!*/
+    void SetNBinsForHistogramStatistics(unsigned int nBins);
+    unsigned int GetNBinsForHistogramStatistics() const;
+
+    /**Documentation
+    @brief Set bin size to be used for histogram statistics. If nbins is set after bin size, nbins will be used instead!*/
+    void SetBinSizeForHistogramStatistics(double binSize);
+    double GetBinSizeForHistogramStatistics() const;
+
+    /**Documentation
+    @brief Computes the statistics of all voxels of the label and remembers the mask state.*/
+    void Compute();
+
+    /**Documentation
+    @brief Updates the statistics after the mask was changed within @a region (index region of the mask).
+    Changes of the mask outside of the region since the last call are not noticed.*/
+    void UpdateMaskRegion(const RegionType &region);
+
+    /**Documentation
+    @brief Returns the current statistics of the label with the same statistics as ImageStatisticsCalculator.
+    If the label has no voxels, only the number of voxels and the volume are set.*/
+    ImageStatisticsContainer::ImageStatisticsObject GetStatistics() const;
+
+    /**Documentation
+    @brief Returns how often all statistics of the label were computed, either by Compute() or as fallback of
+    UpdateMaskRegion().*/
+    itkGetConstMacro(NumberOfComputations, unsigned long)
+
+  protected:
+    IncrementalImageStatisticsCalculator();
+    ~IncrementalImageStatisticsCalculator() override;
+
+  private:
+    template <typename TPixel, unsigned int VImageDimension>
+    void InternalCompute(const itk::Image<TPixel, VImageDimension> *image);
+
+    template <typename TPixel, unsigned int VImageDimension>
+    void InternalUpdateMaskRegion(const itk::Image<TPixel, VImageDimension> *image, const RegionType &region);
+
+    /** Reads the mask in region and updates the mask state. The changed voxels are added to or removed from the
+    statistics if updateStatistics is true. Returns false if the statistics have to be accumulated again. */
+    template <typename TPixel>
+    bool ReadMask(const itk::Image<TPixel, 3> *image, const RegionType &region, bool updateStatistics);
+
+    template <typename TPixel, typename TMaskPixel>
+    bool ReadMaskRegion(const itk::Image<TPixel, 3> *image,
+                        const itk::Image<TMaskPixel, 3> *mask,
+                        const RegionType &region,
+                        bool updateStatistics);
+
+    /** Accumulates the voxels of the label in region, which has to contain all of them. */
+    template <typename TPixel>
+    void Accumulate(const itk::Image<TPixel, 3> *image, const RegionType &region);
+
+    void CheckInputs() const;
+    void ResetAccumulators();
+    void AddToSums(double value, double weight);
+    void AddToHistogram(double value, int frequencyChange);
+    bool AddValue(double value);
+    bool RemoveValue(double value, const RegionType::IndexType &index);
+    void GrowBoundingBox(const RegionType::IndexType &index);
+
+    bool IsInLabel(std::size_t offset) const { return 0 != ((m_LabelBits[offset >> 6] >> (offset & 63)) & 1); }
+    void SetInLabel(std::size_t offset, bool inLabel);
+
+    mitk::Image::ConstPointer m_Image;
+    mitk::Image::ConstPointer m_Mask;
+    LabelIndex m_Label;
+
+    unsigned int m_nBinsForHistogramStatistics;
+    double m_binSizeForHistogramStatistics;
+    bool m_UseBinSizeOverNBins;
+
+    // mask state of the last update, one bit per voxel
+    std::vector<std::uint64_t> m_LabelBits;
+    // contains all voxels of the label, may be larger after voxels were removed
+    RegionType m_BoundingBox;
+
+    // sums of powers of (value - m_Shift), the shift keeps the sums small and avoids cancellation
+    unsigned long m_Count;
+    double m_Shift;
+    double m_Sums[4];
+    unsigned long m_PositivePixelCount;
+    double m_SumOfPositivePixels;
+    double m_Minimum;
+    double m_Maximum;
+    RegionType::IndexType m_MinimumIndex;
+    RegionType::IndexType m_MaximumIndex;
+    HistogramType::Pointer m_Histogram;
+    double m_VoxelVolume;
+
+    itk::TimeStamp m_ComputeTime;
+    unsigned long m_NumberOfComputations;
+  };
+}
+#endif // MITKINCREMENTALIMAGESTATISTICSCALCULATOR
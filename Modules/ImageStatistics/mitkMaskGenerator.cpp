@@ -36,6 +36,11 @@ void MaskGenerator::SetTimeStep(unsigned int timeStep)
     }
 }
 
+bool MaskGenerator::IsTimeInvariant() const
+{
+    return false;
+}
+
 void MaskGenerator::SetInputImage(mitk::Image::ConstPointer inputImg)
 {
     if (inputImg != m_inputImage)
@@ -50,6 +50,13 @@ public:
 
     virtual void SetTimeStep(unsigned int timeStep);
 
+    /**
+     * @brief IsTimeInvariant returns true if the generated mask is the same for all time steps, so it can be generated
+     * once and shared by all time steps of the input image (see ImageStatisticsCalculator::SetComputeTimeStepsInParallel()).
+     * The default implementation returns false.
+     */
+    virtual bool IsTimeInvariant() const;
+
 protected:
     MaskGenerator();
 
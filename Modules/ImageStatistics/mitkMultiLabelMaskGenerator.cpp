@@ -1 +1,98 @@
 #include <mitkMultiLabelMaskGenerator.h>
+#include <mitkImageTimeSelector.h>
+
+namespace mitk
+{
+
+void MultiLabelMaskGenerator::SetLabelSetImage(const mitk::LabelSetImage* labelSetImage)
+{
+    if (labelSetImage != m_LabelSetImage)
+    {
+        m_LabelSetImage = labelSetImage;
+        this->Modified();
+    }
+}
+
+void MultiLabelMaskGenerator::SetLayer(unsigned int layer)
+{
+    if (layer != m_Layer)
+    {
+        m_Layer = layer;
+        this->Modified();
+    }
+}
+
+unsigned int MultiLabelMaskGenerator::GetLayer() const
+{
+    return m_Layer;
+}
+
+void MultiLabelMaskGenerator::SetTimeStep(unsigned int timeStep)
+{
+    if (timeStep != m_TimeStep)
+    {
+        m_TimeStep = timeStep;
+        this->Modified();
+    }
+}
+
+mitk::Image::Pointer MultiLabelMaskGenerator::GetMask()
+{
+    if (m_LabelSetImage.IsNull())
+    {
+        mitkThrow() << "LabelSetImage not set!";
+    }
+
+    if (m_Layer >= m_LabelSetImage->GetNumberOfLayers())
+    {
+        mitkThrow() << "Invalid layer: " << m_Layer << ". The LabelSetImage has " << m_LabelSetImage->GetNumberOfLayers() << " layers!";
+    }
+
+    if (IsUpdateRequired())
+    {
+        // the active layer is the LabelSetImage itself, other layers may be stored encoded and are decoded into a copy
+        mitk::Image::ConstPointer layerImage;
+        if (m_Layer == m_LabelSetImage->GetActiveLayer())
+        {
+            layerImage = m_LabelSetImage.GetPointer();
+        }
+        else
+        {
+            layerImage = m_LabelSetImage->CreateLayerImage(m_Layer).GetPointer();
+        }
+
+        unsigned int timeStepForExtraction = m_TimeStep;
+        if (m_TimeStep >= layerImage->GetTimeSteps())
+        {
+            MITK_WARN << "Warning: time step > number of time steps in LabelSetImage, using last time step";
+            timeStepForExtraction = layerImage->GetTimeSteps() - 1;
+        }
+
+        ImageTimeSelector::Pointer imageTimeSelector = ImageTimeSelector::New();
+        imageTimeSelector->SetInput(layerImage);
+        imageTimeSelector->SetTimeNr(timeStepForExtraction);
+        imageTimeSelector->UpdateLargestPossibleRegion();
+
+        m_InternalMask = imageTimeSelector->GetOutput();
+        m_InternalMaskUpdateTime = m_InternalMask->GetMTime();
+    }
+
+    return m_InternalMask;
+}
+
+bool MultiLabelMaskGenerator::IsUpdateRequired() const
+{
+    if (this->GetMTime() > m_InternalMaskUpdateTime) // layer, time step or image have been set
+    {
+        return true;
+    }
+
+    if (m_LabelSetImage->GetMTime() > m_InternalMaskUpdateTime) // the labels have been edited
+    {
+        return true;
+    }
+
+    return false;
+}
+
+}
@@ -10,32 +10,62 @@
 namespace mitk
 {
 /**
- * @brief The MultiLabelMaskGenerator class NOT IMPLEMENTED YET!
+ * @brief The MultiLabelMaskGenerator class uses one layer of a LabelSetImage as mask.
+ *
+ * The mask keeps the label values of the layer, so the ImageStatisticsCalculator computes the statistics
+ * of all labels of the layer in a single pass over the image. Use GetStatistics(label) of the calculator
+ * to retrieve the statistics of a label.
  */
 class MITKIMAGESTATISTICS_EXPORT MultiLabelMaskGenerator: public MaskGenerator
 {
 public:
-   /* void setLabelSetImage(mitk::LabelSetImage::Pointer labelSetImage);
+    /** Standard Self typedef */
+    typedef MultiLabelMaskGenerator             Self;
+    typedef MaskGenerator                       Superclass;
+    typedef itk::SmartPointer< Self >           Pointer;
+    typedef itk::SmartPointer< const Self >     ConstPointer;
 
-    void addLabel(LabelSetImage::PixelType, std::vector<mitk::Image::Pointer>::size_type layer=0);
-    void removeLabel(LabelSetImage::PixelType, std::vector<mitk::Image::Pointer>::size_type layer=0);
+    /** Method for creation through the object factory. */
+    itkNewMacro(Self)
 
-    void addLabels(std::pair<std::vector<mitk::Image::Pointer>::size_type, std::vector<unsigned int>> labelsToAdd);
-    void removeLabels(std::pair<std::vector<mitk::Image::Pointer>::size_type, std::vector<unsigned int>> labelsToAdd);
+    /** Runtime information support. */
+    itkTypeMacro(MultiLabelMaskGenerator, MaskGenerator)
 
-    void addLabels(std::vector<LabelSetImage::PixelType> labels, std::vector<mitk::Image::Pointer>::size_type layer=0);
-    void removeLabels(std::vector<LabelSetImage::PixelType> labels, std::vector<mitk::Image::Pointer>::size_type layer=0);
+    /**
+     * @brief Sets the LabelSetImage whose labels are used as mask.
+     */
+    void SetLabelSetImage(const mitk::LabelSetImage* labelSetImage);
 
-    void removeLayer(std::vector<mitk::Image::Pointer>::size_type layer);
+    /**
+     * @brief Sets the layer of the LabelSetImage that is used as mask, the default is layer 0.
+     */
+    void SetLayer(unsigned int layer);
 
-    mitk::Image::Pointer GetMask();
+    unsigned int GetLayer() const;
+
+    /**
+     * @brief Returns the label image of the layer at the current time step
+     */
+    mitk::Image::Pointer GetMask() override;
+
+    void SetTimeStep(unsigned int timeStep) override;
 
 protected:
+    MultiLabelMaskGenerator():
+        m_Layer(0),
+        m_InternalMaskUpdateTime(0)
+    {
+        m_InternalMask = mitk::Image::New();
+    }
+
+    ~MultiLabelMaskGenerator() override{}
 
 private:
-    mitk::LabelSetImage::Pointer m_LabelSetImage;
-    std::vector<std::vector<LabelSetImage::PixelType>> m_selectedLabels;*/
+    bool IsUpdateRequired() const;
 
+    mitk::LabelSetImage::ConstPointer m_LabelSetImage;
+    unsigned int m_Layer;
+    unsigned long m_InternalMaskUpdateTime;
 };
 
 }
@@ -8,20 +8,71 @@
 #include <mitkIOUtil.h>
 
 #include <itkCastImageFilter.h>
-#include <itkVTKImageExport.h>
-#include <itkVTKImageImport.h>
-#include <itkImageDuplicator.h>
 #include <itkExceptionObject.h>
+#include <itkImageRegionIterator.h>
 #include <itkLineIterator.h>
 
-#include <vtkPoints.h>
-#include <vtkImageStencil.h>
-#include <vtkImageImport.h>
-#include <vtkImageExport.h>
-#include <vtkLassoStencilSource.h>
-#include <vtkSmartPointer.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
 
+namespace
+{
+  /** Edge of a polygon in index coordinates, YMin and YMax are the range of its end points. */
+  struct PolygonEdge
+  {
+    double X0, Y0, X1, Y1;
+    double YMin, YMax;
+    bool IsHole;
+  };
+
+  void AddPolygonEdges(const std::vector<mitk::Point2D> &polygon, bool isHole, std::vector<PolygonEdge> &edges)
+  {
+    for (std::size_t i = 0; i < polygon.size(); ++i)
+    {
+      // the last point is connected to the first one
+      const mitk::Point2D &start = polygon[i];
+      const mitk::Point2D &end = polygon[(i + 1) % polygon.size()];
+      if (start == end)
+      {
+        continue;
+      }
+
+      PolygonEdge edge;
+      edge.X0 = start[0];
+      edge.Y0 = start[1];
+      edge.X1 = end[0];
+      edge.Y1 = end[1];
+      edge.YMin = std::min(edge.Y0, edge.Y1);
+      edge.YMax = std::max(edge.Y0, edge.Y1);
+      edge.IsHole = isHole;
+      edges.push_back(edge);
+    }
+  }
+
+  /** Returns the smallest region that contains region and index, region may be empty. */
+  itk::ImageRegion<2> ExpandRegion(const itk::ImageRegion<2> &region, const itk::Index<2> &index)
+  {
+    itk::ImageRegion<2> result;
+    result.SetIndex(index);
+    result.SetSize({ { 1, 1 } });
+    if (0 == region.GetNumberOfPixels())
+    {
+      return result;
+    }
 
+    itk::Index<2> lower = region.GetIndex();
+    itk::Index<2> upper = region.GetUpperIndex();
+    for (unsigned int dimension = 0; dimension < 2; ++dimension)
+    {
+      lower[dimension] = std::min(lower[dimension], index[dimension]);
+      upper[dimension] = std::max(upper[dimension], index[dimension]);
+    }
+    result.SetIndex(lower);
+    result.SetUpperIndex(upper);
+    return result;
+  }
+}
 
 namespace mitk
 {
@@ -67,21 +118,9 @@ template < typename TPixel, unsigned int VImageDimension >
 void PlanarFigureMaskGenerator::InternalCalculateMaskFromPlanarFigure(
   const itk::Image< TPixel, VImageDimension > *image, unsigned int axis )
 {
-  typedef itk::Image< unsigned short, 2 > MaskImage2DType;
-
-  typename MaskImage2DType::Pointer maskImage = MaskImage2DType::New();
-  maskImage->SetOrigin(image->GetOrigin());
-  maskImage->SetSpacing(image->GetSpacing());
-  maskImage->SetLargestPossibleRegion(image->GetLargestPossibleRegion());
-  maskImage->SetBufferedRegion(image->GetBufferedRegion());
-  maskImage->SetDirection(image->GetDirection());
-  maskImage->SetNumberOfComponentsPerPixel(image->GetNumberOfComponentsPerPixel());
-  maskImage->Allocate();
-  maskImage->FillBuffer(1);
+  this->InitializeInternalMask(image);
 
-  // all PolylinePoints of the PlanarFigure are stored in a vtkPoints object.
-  // These points are used by the vtkLassoStencilSource to create
-  // a vtkImageStencil.
+  // all PolylinePoints of the PlanarFigure are converted to index coordinates of the image slice
   const mitk::PlaneGeometry *planarFigurePlaneGeometry = m_PlanarFigure->GetPlaneGeometry();
   const typename PlanarFigure::PolyLineType planarFigurePolyline = m_PlanarFigure->GetPolyLine( 0 );
   const mitk::BaseGeometry *imageGeometry3D = m_inputImage->GetGeometry( 0 );
@@ -114,9 +153,9 @@ void PlanarFigureMaskGenerator::InternalCalculateMaskFromPlanarFigure(
     break;
   }
 
-  // store the polyline contour as vtkPoints object
+  // store the polyline contour as polygon in index coordinates
   bool outOfBounds = false;
-  vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+  PolygonType polygon;
   typename PlanarFigure::PolyLineType::const_iterator it;
   for ( it = planarFigurePolyline.begin();
     it != planarFigurePolyline.end();
@@ -132,7 +171,6 @@ void PlanarFigureMaskGenerator::InternalCalculateMaskFromPlanarFigure(
     planarFigurePlaneGeometry->Map( *it, point3D );
 
     // Polygons (partially) outside of the image bounds can not be processed
-    // further due to a bug in vtkPolyDataToImageStencil
     if ( !imageGeometry3D->IsInside( point3D ) )
     {
       outOfBounds = true;
@@ -140,38 +178,47 @@ void PlanarFigureMaskGenerator::InternalCalculateMaskFromPlanarFigure(
 
     imageGeometry3D->WorldToIndex( point3D, point3D );
 
-    points->InsertNextPoint( point3D[i0], point3D[i1], 0 );
+    Point2D point2D;
+    point2D[0] = point3D[i0];
+    point2D[1] = point3D[i1];
+    polygon.push_back( point2D );
   }
 
-  vtkSmartPointer<vtkPoints> holePoints = nullptr;
-
-  if (!planarFigureHolePolyline.empty())
+  PolygonType hole;
+  for (it = planarFigureHolePolyline.begin(); it != planarFigureHolePolyline.end(); ++it)
   {
-    holePoints = vtkSmartPointer<vtkPoints>::New();
-
     Point3D point3D;
-    PlanarFigure::PolyLineType::const_iterator end = planarFigureHolePolyline.end();
 
-    for (it = planarFigureHolePolyline.begin(); it != end; ++it)
-    {
-      // Fabian: same as above
-      planarFigurePlaneGeometry->Map(*it, point3D);
-      imageGeometry3D->WorldToIndex(point3D, point3D);
-      holePoints->InsertNextPoint(point3D[i0], point3D[i1], 0);
-    }
+    // Fabian: same as above
+    planarFigurePlaneGeometry->Map(*it, point3D);
+    imageGeometry3D->WorldToIndex(point3D, point3D);
+
+    Point2D point2D;
+    point2D[0] = point3D[i0];
+    point2D[1] = point3D[i1];
+    hole.push_back(point2D);
   }
 
   // mark a malformed 2D planar figure ( i.e. area = 0 ) as out of bounds
-  // this can happen when all control points of a rectangle lie on the same line = two of the three extents are zero
-  double bounds[6] = {0, 0, 0, 0, 0, 0};
-  points->GetBounds( bounds );
+  // this can happen when all control points of a rectangle lie on the same line = one of the two extents is zero
+  double bounds[4] = {0, 0, 0, 0};
+  if ( !polygon.empty() )
+  {
+    bounds[0] = bounds[1] = polygon.front()[0];
+    bounds[2] = bounds[3] = polygon.front()[1];
+  }
+  for ( const auto &point : polygon )
+  {
+    bounds[0] = std::min( bounds[0], point[0] );
+    bounds[1] = std::max( bounds[1], point[0] );
+    bounds[2] = std::min( bounds[2], point[1] );
+    bounds[3] = std::max( bounds[3], point[1] );
+  }
   bool extent_x = (fabs(bounds[0] - bounds[1])) < mitk::eps;
   bool extent_y = (fabs(bounds[2] - bounds[3])) < mitk::eps;
-  bool extent_z = (fabs(bounds[4] - bounds[5])) < mitk::eps;
 
   // throw an exception if a closed planar figure is deformed, i.e. has only one non-zero extent
-  if ( m_PlanarFigure->IsClosed() &&
-    ((extent_x && extent_y) || (extent_x && extent_z)  || (extent_y && extent_z)))
+  if ( m_PlanarFigure->IsClosed() && (extent_x || extent_y) )
   {
     mitkThrow() << "Figure has a zero area and cannot be used for masking.";
   }
@@ -181,69 +228,7 @@ void PlanarFigureMaskGenerator::InternalCalculateMaskFromPlanarFigure(
     throw std::runtime_error( "Figure at least partially outside of image bounds!" );
   }
 
-  // create a vtkLassoStencilSource and set the points of the Polygon
-  vtkSmartPointer<vtkLassoStencilSource> lassoStencil = vtkSmartPointer<vtkLassoStencilSource>::New();
-  lassoStencil->SetShapeToPolygon();
-  lassoStencil->SetPoints( points );
-
-  vtkSmartPointer<vtkLassoStencilSource> holeLassoStencil = nullptr;
-
-  if (holePoints.GetPointer() != nullptr)
-  {
-    holeLassoStencil = vtkSmartPointer<vtkLassoStencilSource>::New();
-    holeLassoStencil->SetShapeToPolygon();
-    holeLassoStencil->SetPoints(holePoints);
-  }
-
-  // Export from ITK to VTK (to use a VTK filter)
-  typedef itk::VTKImageImport< MaskImage2DType > ImageImportType;
-  typedef itk::VTKImageExport< MaskImage2DType > ImageExportType;
-
-  typename ImageExportType::Pointer itkExporter = ImageExportType::New();
-  itkExporter->SetInput( maskImage );
-//  itkExporter->SetInput( castFilter->GetOutput() );
-
-  vtkSmartPointer<vtkImageImport> vtkImporter = vtkSmartPointer<vtkImageImport>::New();
-  this->ConnectPipelines( itkExporter, vtkImporter );
-
-  // Apply the generated image stencil to the input image
-  vtkSmartPointer<vtkImageStencil> imageStencilFilter = vtkSmartPointer<vtkImageStencil>::New();
-  imageStencilFilter->SetInputConnection( vtkImporter->GetOutputPort() );
-  imageStencilFilter->SetStencilConnection(lassoStencil->GetOutputPort());
-  imageStencilFilter->ReverseStencilOff();
-  imageStencilFilter->SetBackgroundValue( 0 );
-  imageStencilFilter->Update();
-
-  vtkSmartPointer<vtkImageStencil> holeStencilFilter = nullptr;
-
-  if (holeLassoStencil.GetPointer() != nullptr)
-  {
-    holeStencilFilter = vtkSmartPointer<vtkImageStencil>::New();
-    holeStencilFilter->SetInputConnection(imageStencilFilter->GetOutputPort());
-    holeStencilFilter->SetStencilConnection(holeLassoStencil->GetOutputPort());
-    holeStencilFilter->ReverseStencilOn();
-    holeStencilFilter->SetBackgroundValue(0);
-    holeStencilFilter->Update();
-  }
-
-  // Export from VTK back to ITK
-  vtkSmartPointer<vtkImageExport> vtkExporter = vtkSmartPointer<vtkImageExport>::New();
-  vtkExporter->SetInputConnection( holeStencilFilter.GetPointer() == nullptr
-    ? imageStencilFilter->GetOutputPort()
-    : holeStencilFilter->GetOutputPort());
-  vtkExporter->Update();
-
-  typename ImageImportType::Pointer itkImporter = ImageImportType::New();
-  this->ConnectPipelines( vtkExporter, itkImporter );
-  itkImporter->Update();
-
-  typedef itk::ImageDuplicator< ImageImportType::OutputImageType > DuplicatorType;
-  DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage( itkImporter->GetOutput() );
-  duplicator->Update();
-
-  // Store mask
-  m_InternalITKImageMask2D = duplicator->GetOutput();
+  this->RasterizePolygon( polygon, hole );
 }
 
 template < typename TPixel, unsigned int VImageDimension >
@@ -255,15 +240,8 @@ void PlanarFigureMaskGenerator::InternalCalculateMaskFromOpenPlanarFigure(
   typedef MaskImage2DType::IndexType            IndexType2D;
   typedef std::vector< IndexType2D >            IndexVecType;
 
-  typename MaskImage2DType::Pointer maskImage = MaskImage2DType::New();
-  maskImage->SetOrigin(image->GetOrigin());
-  maskImage->SetSpacing(image->GetSpacing());
-  maskImage->SetLargestPossibleRegion(image->GetLargestPossibleRegion());
-  maskImage->SetBufferedRegion(image->GetBufferedRegion());
-  maskImage->SetDirection(image->GetDirection());
-  maskImage->SetNumberOfComponentsPerPixel(image->GetNumberOfComponentsPerPixel());
-  maskImage->Allocate();
-  maskImage->FillBuffer(0);
+  this->InitializeInternalMask(image);
+  MaskImage2DType *maskImage = m_InternalITKImageMask2D;
 
   // all PolylinePoints of the PlanarFigure are stored in a vtkPoints object.
   const mitk::PlaneGeometry *planarFigurePlaneGeometry = m_PlanarFigure->GetPlaneGeometry();
@@ -319,6 +297,9 @@ void PlanarFigureMaskGenerator::InternalCalculateMaskFromOpenPlanarFigure(
       index2D[1] = point3D[i1];
 
       pointIndices.push_back( index2D );
+
+      // remember the touched pixels, so that they can be reset for the next figure
+      m_InternalMaskBoundingRegion = ExpandRegion( m_InternalMaskBoundingRegion, index2D );
     }
 
     if ( outOfBounds )
@@ -339,9 +320,168 @@ void PlanarFigureMaskGenerator::InternalCalculateMaskFromOpenPlanarFigure(
       }
     }
   }
+}
 
-  // Store mask
-  m_InternalITKImageMask2D = maskImage;
+void PlanarFigureMaskGenerator::InitializeInternalMask(const itk::ImageBase<2> *image)
+{
+  typedef itk::Image< unsigned short, 2 > MaskImage2DType;
+
+  // the mask of the last calculation may still be in use, so the two masks are used in turns
+  std::swap( m_InternalMask, m_SpareMask );
+  std::swap( m_InternalITKImageMask2D, m_SpareITKImageMask2D );
+  std::swap( m_InternalMaskBoundingRegion, m_SpareMaskBoundingRegion );
+
+  // the itk mask shares its memory with m_InternalMask, which must not be changed while a mask returned
+  // by an earlier calculation is still referenced outside of this generator
+  if ( m_InternalITKImageMask2D.IsNotNull() && m_InternalMask.IsNotNull() && m_InternalMask->IsInitialized() &&
+       1 == m_InternalMask->GetReferenceCount() &&
+       m_InternalITKImageMask2D->GetLargestPossibleRegion() == image->GetLargestPossibleRegion() &&
+       m_InternalITKImageMask2D->GetBufferedRegion() == image->GetBufferedRegion() &&
+       m_InternalITKImageMask2D->GetOrigin() == image->GetOrigin() &&
+       m_InternalITKImageMask2D->GetSpacing() == image->GetSpacing() &&
+       m_InternalITKImageMask2D->GetDirection() == image->GetDirection() )
+  {
+    // the scratch mask still holds the last figure, only its pixels have to be reset
+    MaskImage2DType::RegionType lastFigureRegion = m_InternalMaskBoundingRegion;
+    if ( lastFigureRegion.Crop( m_InternalITKImageMask2D->GetBufferedRegion() ) )
+    {
+      itk::ImageRegionIterator< MaskImage2DType > maskIt( m_InternalITKImageMask2D, lastFigureRegion );
+      for ( maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt )
+      {
+        maskIt.Set( 0 );
+      }
+    }
+  }
+  else
+  {
+    MaskImage2DType::Pointer maskImage = MaskImage2DType::New();
+    maskImage->SetOrigin(image->GetOrigin());
+    maskImage->SetSpacing(image->GetSpacing());
+    maskImage->SetLargestPossibleRegion(image->GetLargestPossibleRegion());
+    maskImage->SetBufferedRegion(image->GetBufferedRegion());
+    maskImage->SetDirection(image->GetDirection());
+    maskImage->SetNumberOfComponentsPerPixel(image->GetNumberOfComponentsPerPixel());
+    maskImage->Allocate();
+    maskImage->FillBuffer(0);
+
+    m_InternalITKImageMask2D = maskImage;
+    m_InternalMask = mitk::GrabItkImageMemory(maskImage);
+  }
+
+  m_InternalMaskBoundingRegion = MaskImage2DType::RegionType();
+}
+
+void PlanarFigureMaskGenerator::RasterizePolygon(const PolygonType &polygon, const PolygonType &hole)
+{
+  typedef itk::Image< unsigned short, 2 > MaskImage2DType;
+
+  // edge table of outline and hole, the hole is cut out by the even-odd rule
+  std::vector<PolygonEdge> edges;
+  AddPolygonEdges( polygon, false, edges );
+  AddPolygonEdges( hole, true, edges );
+  if ( edges.empty() )
+  {
+    return;
+  }
+
+  std::sort( edges.begin(), edges.end(), [](const PolygonEdge &first, const PolygonEdge &second) {
+    return first.YMin < second.YMin;
+  });
+
+  // pixel centers closer to an outline than the tolerance are on the outline
+  const double tolerance = mitk::eps;
+  const MaskImage2DType::RegionType region = m_InternalITKImageMask2D->GetBufferedRegion();
+  const itk::IndexValueType xBegin = region.GetIndex(0);
+  const itk::IndexValueType xLast = region.GetUpperIndex()[0];
+  const itk::IndexValueType yLast = region.GetUpperIndex()[1];
+  const itk::OffsetValueType lineLength = region.GetSize(0);
+  unsigned short *buffer = m_InternalITKImageMask2D->GetBufferPointer();
+
+  double yMax = edges.front().YMax;
+  for ( const auto &edge : edges )
+  {
+    yMax = std::max( yMax, edge.YMax );
+  }
+
+  const auto yBegin = std::max<itk::IndexValueType>( region.GetIndex(1), std::ceil( edges.front().YMin - tolerance ) );
+  const auto yEnd = std::min<itk::IndexValueType>( yLast, std::floor( yMax + tolerance ) );
+
+  // sets the pixels of line between the pixel centers xFrom and xTo
+  itk::IndexValueType xMin = xLast + 1;
+  itk::IndexValueType xMax = xBegin - 1;
+  auto fillSpan = [&](unsigned short *line, double xFrom, double xTo, unsigned short value) {
+    const auto first = std::max<itk::IndexValueType>( xBegin, std::ceil( xFrom - tolerance ) );
+    const auto last = std::min<itk::IndexValueType>( xLast, std::floor( xTo + tolerance ) );
+    if ( first <= last )
+    {
+      std::fill( line + (first - xBegin), line + (last - xBegin + 1), value );
+      xMin = std::min( xMin, first );
+      xMax = std::max( xMax, last );
+    }
+  };
+
+  std::vector<const PolygonEdge *> activeEdges;
+  std::vector<double> crossings;
+  std::size_t nextEdge = 0;
+  for ( itk::IndexValueType y = yBegin; y <= yEnd; ++y )
+  {
+    // update the active edges, which touch the line within the tolerance
+    while ( nextEdge < edges.size() && edges[nextEdge].YMin - tolerance <= y )
+    {
+      activeEdges.push_back( &edges[nextEdge++] );
+    }
+    activeEdges.erase( std::remove_if( activeEdges.begin(), activeEdges.end(), [y, tolerance](const PolygonEdge *edge) {
+      return edge->YMax + tolerance < y;
+    }), activeEdges.end() );
+
+    unsigned short *line = buffer + (y - region.GetIndex(1)) * lineLength;
+
+    // interior: every edge crossing the line toggles between outside and inside
+    crossings.clear();
+    for ( const auto *edge : activeEdges )
+    {
+      if ( (edge->Y0 <= y) != (edge->Y1 <= y) )
+      {
+        crossings.push_back( edge->X0 + (y - edge->Y0) * (edge->X1 - edge->X0) / (edge->Y1 - edge->Y0) );
+      }
+    }
+    std::sort( crossings.begin(), crossings.end() );
+    for ( std::size_t i = 0; i + 1 < crossings.size(); i += 2 )
+    {
+      fillSpan( line, crossings[i], crossings[i + 1], 1 );
+    }
+
+    // outlines: pixel centers on the outline belong to the figure, the ones on the outline of the hole do not
+    for ( bool isHole : { false, true } )
+    {
+      for ( const auto *edge : activeEdges )
+      {
+        if ( edge->IsHole != isHole )
+        {
+          continue;
+        }
+
+        double xFrom = edge->X0;
+        double xTo = edge->X1;
+        if ( edge->YMax - edge->YMin > tolerance )
+        {
+          // part of the edge within the tolerance band around the line
+          const double t0 = std::max( 0.0, std::min( 1.0, (y - tolerance - edge->Y0) / (edge->Y1 - edge->Y0) ) );
+          const double t1 = std::max( 0.0, std::min( 1.0, (y + tolerance - edge->Y0) / (edge->Y1 - edge->Y0) ) );
+          xFrom = edge->X0 + t0 * (edge->X1 - edge->X0);
+          xTo = edge->X0 + t1 * (edge->X1 - edge->X0);
+        }
+        fillSpan( line, std::min( xFrom, xTo ), std::max( xFrom, xTo ), isHole ? 0 : 1 );
+      }
+    }
+  }
+
+  if ( xMin <= xMax )
+  {
+    MaskImage2DType::IndexType lower = { { xMin, yBegin } };
+    MaskImage2DType::IndexType upper = { { xMax, yEnd } };
+    m_InternalMaskBoundingRegion = ExpandRegion( ExpandRegion( m_InternalMaskBoundingRegion, lower ), upper );
+  }
 }
 
 bool PlanarFigureMaskGenerator::GetPrincipalAxis(
@@ -400,7 +540,6 @@ void PlanarFigureMaskGenerator::CalculateMask()
         m_InternalTimeSliceImage = m_inputImage;
     }
 
-    m_InternalITKImageMask2D = nullptr;
     const PlaneGeometry *planarFigurePlaneGeometry = m_PlanarFigure->GetPlaneGeometry();
     const auto *planarFigureGeometry = dynamic_cast< const PlaneGeometry * >( planarFigurePlaneGeometry );
     //const BaseGeometry *imageGeometry = m_inputImage->GetGeometry();
@@ -439,10 +578,9 @@ void PlanarFigureMaskGenerator::CalculateMask()
                                   2, axis)
     }
 
-    //convert itk mask to mitk::Image::Pointer and return it
-    mitk::Image::Pointer planarFigureMaskImage;
-    planarFigureMaskImage = mitk::GrabItkImageMemory(m_InternalITKImageMask2D);
-    //mitk::IOUtil::Save(planarFigureMaskImage, "/home/fabian/planarFigureMaskImage.nrrd");
+    // the itk mask shares its memory with m_InternalMask
+    m_InternalMask->Modified();
+    //mitk::IOUtil::Save(m_InternalMask, "/home/fabian/planarFigureMaskImage.nrrd");
 
     //Convert2Dto3DImageFilter::Pointer sliceTo3DImageConverter = Convert2Dto3DImageFilter::New();
     //sliceTo3DImageConverter->SetInput(planarFigureMaskImage);
@@ -451,7 +589,6 @@ void PlanarFigureMaskGenerator::CalculateMask()
 
     m_ReferenceImage = inputImageSlice;
     //mitk::IOUtil::Save(m_ReferenceImage, "/home/fabian/referenceImage.nrrd");
-    m_InternalMask = planarFigureMaskImage;
 }
 
 void PlanarFigureMaskGenerator::SetTimeStep(unsigned int timeStep)
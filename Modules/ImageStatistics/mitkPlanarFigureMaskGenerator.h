@@ -3,20 +3,24 @@
 
 #include <MitkImageStatisticsExports.h>
 #include <itkImage.h>
-#include <itkVTKImageExport.h>
-#include <itkVTKImageImport.h>
 #include <mitkImage.h>
 #include <mitkMaskGenerator.h>
 #include <mitkPlanarFigure.h>
-#include <vtkImageExport.h>
-#include <vtkImageImport.h>
-#include <vtkSmartPointer.h>
+
+#include <vector>
 
 namespace mitk
 {
   /**
    * \class PlanarFigureMaskGenerator
    * \brief Derived from MaskGenerator. This class is used to convert a mitk::PlanarFigure into a binary image mask
+   *
+   * Closed figures are rasterized line by line: A pixel belongs to the mask if its center lies inside of the polygon
+   * or on its outline. A second poly line of the figure is treated as hole, its outline does not belong to the mask.
+   * Only the bounding box of the figure is written, and the masks of earlier calculations are reused as long as the geometry of the
+   * image slice does not change, so moving a figure over a large image only rasterizes the pixels of the old and the new figure.
+   * Two masks are used in turns: A calculation reuses the mask of the calculation before the last one if it is not referenced
+   * outside of the generator any more, otherwise it allocates a new mask. So a returned mask is never changed while it is in use.
    */
   class MITKIMAGESTATISTICS_EXPORT PlanarFigureMaskGenerator : public MaskGenerator
   {
@@ -35,7 +39,7 @@ namespace mitk
 
       /**
        * @brief GetMask Computes and returns the mask
-       * @return mitk::Image::Pointer of the generated mask
+       * @return mitk::Image::Pointer of the generated mask, later calculations do not change it as long as it is referenced
        */
       mitk::Image::Pointer GetMask() override;
 
@@ -76,52 +80,25 @@ namespace mitk
 
     bool GetPrincipalAxis(const BaseGeometry *geometry, Vector3D vector, unsigned int &axis);
 
-    /** Connection from ITK to VTK */
-    template <typename ITK_Exporter, typename VTK_Importer>
-    void ConnectPipelines(ITK_Exporter exporter, vtkSmartPointer<VTK_Importer> importer)
-    {
-      importer->SetUpdateInformationCallback(exporter->GetUpdateInformationCallback());
-
-      importer->SetPipelineModifiedCallback(exporter->GetPipelineModifiedCallback());
-      importer->SetWholeExtentCallback(exporter->GetWholeExtentCallback());
-      importer->SetSpacingCallback(exporter->GetSpacingCallback());
-      importer->SetOriginCallback(exporter->GetOriginCallback());
-      importer->SetScalarTypeCallback(exporter->GetScalarTypeCallback());
-
-      importer->SetNumberOfComponentsCallback(exporter->GetNumberOfComponentsCallback());
-
-      importer->SetPropagateUpdateExtentCallback(exporter->GetPropagateUpdateExtentCallback());
-      importer->SetUpdateDataCallback(exporter->GetUpdateDataCallback());
-      importer->SetDataExtentCallback(exporter->GetDataExtentCallback());
-      importer->SetBufferPointerCallback(exporter->GetBufferPointerCallback());
-      importer->SetCallbackUserData(exporter->GetCallbackUserData());
-    }
-
-    /** Connection from VTK to ITK */
-    template <typename VTK_Exporter, typename ITK_Importer>
-    void ConnectPipelines(vtkSmartPointer<VTK_Exporter> exporter, ITK_Importer importer)
-    {
-      importer->SetUpdateInformationCallback(exporter->GetUpdateInformationCallback());
+    typedef std::vector<Point2D> PolygonType;
 
-      importer->SetPipelineModifiedCallback(exporter->GetPipelineModifiedCallback());
-      importer->SetWholeExtentCallback(exporter->GetWholeExtentCallback());
-      importer->SetSpacingCallback(exporter->GetSpacingCallback());
-      importer->SetOriginCallback(exporter->GetOriginCallback());
-      importer->SetScalarTypeCallback(exporter->GetScalarTypeCallback());
+    /** Swaps the masks of the last two calculations and reuses the one of the calculation before the last one if it is not referenced
+    any more and matches the geometry of image. Only the pixels of its figure are reset, otherwise a new mask filled with 0 is allocated. */
+    void InitializeInternalMask(const itk::ImageBase<2> *image);
 
-      importer->SetNumberOfComponentsCallback(exporter->GetNumberOfComponentsCallback());
-
-      importer->SetPropagateUpdateExtentCallback(exporter->GetPropagateUpdateExtentCallback());
-      importer->SetUpdateDataCallback(exporter->GetUpdateDataCallback());
-      importer->SetDataExtentCallback(exporter->GetDataExtentCallback());
-      importer->SetBufferPointerCallback(exporter->GetBufferPointerCallback());
-      importer->SetCallbackUserData(exporter->GetCallbackUserData());
-    }
+    /** Sets the pixels whose center is inside of polygon or on its outline to 1, except for the pixels inside of hole or
+    on its outline. Both polygons are given in index coordinates of the mask. */
+    void RasterizePolygon(const PolygonType &polygon, const PolygonType &hole);
 
     bool IsUpdateRequired() const;
 
     mitk::PlanarFigure::Pointer m_PlanarFigure;
     itk::Image<unsigned short, 2>::Pointer m_InternalITKImageMask2D;
+    itk::ImageRegion<2> m_InternalMaskBoundingRegion;
+    // mask of the calculation before the last one, shares its memory with m_SpareITKImageMask2D
+    mitk::Image::Pointer m_SpareMask;
+    itk::Image<unsigned short, 2>::Pointer m_SpareITKImageMask2D;
+    itk::ImageRegion<2> m_SpareMaskBoundingRegion;
     mitk::Image::ConstPointer m_InternalTimeSliceImage;
     mitk::Image::ConstPointer m_ReferenceImage;
     unsigned int m_PlanarFigureAxis;
@@ -29,6 +29,7 @@ QmitkImageStatisticsCalculationJob::QmitkImageStatisticsCalculationJob()
   , m_IgnoreZeros(false)
   , m_HistogramNBins(100)
   , m_CalculationSuccessful(false)
+  , m_IncrementalStatisticsOutdated(true)
 {
 }
 
@@ -43,6 +44,22 @@ void QmitkImageStatisticsCalculationJob::Initialize(const mitk::Image *image,
   this->m_StatisticsImage = image;
   this->m_BinaryMask = binaryImage;
   this->m_PlanarFigureMask = planarFig;
+
+  // the incremental statistics belong to the previous inputs
+  this->InvalidateChangedMaskRegions();
+}
+
+void QmitkImageStatisticsCalculationJob::AddChangedMaskRegion(const itk::ImageRegion<3> &region)
+{
+  std::lock_guard<std::mutex> lock(m_ChangedMaskRegionsMutex);
+  m_ChangedMaskRegions.push_back(region);
+}
+
+void QmitkImageStatisticsCalculationJob::InvalidateChangedMaskRegions()
+{
+  std::lock_guard<std::mutex> lock(m_ChangedMaskRegionsMutex);
+  m_ChangedMaskRegions.clear();
+  m_IncrementalStatisticsOutdated = true;
 }
 
 mitk::ImageStatisticsContainer* QmitkImageStatisticsCalculationJob::GetStatisticsData() const
@@ -106,8 +123,39 @@ bool QmitkImageStatisticsCalculationJob::GetStatisticsUpdateSuccessFlag() const
 
 void QmitkImageStatisticsCalculationJob::run()
 {
+  // the planar figure mask replaces the binary mask, see below
+  const mitk::BaseData *mask = this->m_PlanarFigureMask.IsNotNull()
+    ? static_cast<const mitk::BaseData *>(this->m_PlanarFigureMask.GetPointer())
+    : static_cast<const mitk::BaseData *>(this->m_BinaryMask.GetPointer());
+
+  mitk::ImageStatisticsCache::Key cacheKey(this->m_StatisticsImage, mask);
+  cacheKey.m_NBins = this->m_HistogramNBins;
+  cacheKey.m_IgnorePixelValue = this->m_IgnoreZeros;
+  cacheKey.m_IgnoredPixelValue = 0;
+
+  // while a segmentation is edited only the changed regions are visited
+  if (this->UpdateStatisticsIncrementally(cacheKey))
+  {
+    return;
+  }
+
+  if (this->m_StatisticsImage.IsNotNull())
+  {
+    // switching back to a mask whose statistics are known does not compute them again
+    mitk::ImageStatisticsContainer::Pointer cachedStatistics = mitk::ImageStatisticsCache::GetInstance()->Get(cacheKey);
+    if (cachedStatistics.IsNotNull())
+    {
+      m_StatisticsContainer = cachedStatistics;
+      this->m_CalculationSuccessful = true;
+      this->UpdateHistogramVector();
+      return;
+    }
+  }
+
   bool statisticCalculationSuccessful = true;
   mitk::ImageStatisticsCalculator::Pointer calculator = mitk::ImageStatisticsCalculator::New();
+  // time-intensity curves of 3D+t images need the statistics of all time steps
+  calculator->SetComputeTimeStepsInParallel(true);
 
   if(this->m_StatisticsImage.IsNotNull())
   {
@@ -204,22 +252,93 @@ void QmitkImageStatisticsCalculationJob::run()
   if(statisticCalculationSuccessful)
   {
     m_StatisticsContainer = calculator->GetStatistics();
-    this->m_HistogramVector.clear();
+    mitk::ImageStatisticsCache::GetInstance()->Insert(cacheKey, m_StatisticsContainer);
+    this->UpdateHistogramVector();
+  }
+}
+
+bool QmitkImageStatisticsCalculationJob::UpdateStatisticsIncrementally(const mitk::ImageStatisticsCache::Key &cacheKey)
+{
+  std::vector<itk::ImageRegion<3>> changedRegions;
+  bool incrementalStatisticsOutdated;
+  {
+    std::lock_guard<std::mutex> lock(m_ChangedMaskRegionsMutex);
+    changedRegions.swap(m_ChangedMaskRegions);
+    incrementalStatisticsOutdated = m_IncrementalStatisticsOutdated;
+    m_IncrementalStatisticsOutdated = false;
+  }
+
+  if (incrementalStatisticsOutdated)
+  {
+    m_IncrementalCalculator = nullptr;
+  }
+
+  // the incremental statistics support 3D binary masks without further masks
+  const bool isSupported = !changedRegions.empty() && this->m_StatisticsImage.IsNotNull() &&
+                           this->m_BinaryMask.IsNotNull() && this->m_PlanarFigureMask.IsNull() && !this->m_IgnoreZeros &&
+                           this->m_StatisticsImage->GetDimension() == 3 && this->m_BinaryMask->GetDimension() == 3;
+
+  if (!isSupported)
+  {
+    // the changed regions are dropped, the statistics have to be accumulated again with the next changed region
+    m_IncrementalCalculator = nullptr;
+    return false;
+  }
 
-    for (unsigned int i = 0; i < m_StatisticsImage->GetTimeSteps(); i++)
+  try
+  {
+    if (m_IncrementalCalculator.IsNull())
     {
-      HistogramType::ConstPointer tempHistogram;
-      try {
-        if(calculator->GetStatistics()->TimeStepExists(i))
-        {
-          tempHistogram = calculator->GetStatistics()->GetStatisticsForTimeStep(i).m_Histogram;
-          this->m_HistogramVector.push_back(tempHistogram);
-        }
-      } catch (mitk::Exception&) {
-        MITK_WARN << ":-(";
+      // the first change of the mask computes all statistics, the following ones only visit the changed regions
+      m_IncrementalCalculator = mitk::IncrementalImageStatisticsCalculator::New();
+      m_IncrementalCalculator->SetInputImage(m_StatisticsImage);
+      m_IncrementalCalculator->SetMask(m_BinaryMask);
+      m_IncrementalCalculator->SetNBinsForHistogramStatistics(m_HistogramNBins);
+      m_IncrementalCalculator->Compute();
+    }
+    else
+    {
+      // changed bins compute all statistics again
+      m_IncrementalCalculator->SetNBinsForHistogramStatistics(m_HistogramNBins);
+      for (const auto &region : changedRegions)
+      {
+        m_IncrementalCalculator->UpdateMaskRegion(region);
       }
-
     }
+  }
+  catch (const mitk::Exception &e)
+  {
+    MITK_WARN << "Incremental statistics update failed, computing all statistics: " << e.what();
+    m_IncrementalCalculator = nullptr;
+    return false;
+  }
+
+  mitk::ImageStatisticsContainer::Pointer statistics = mitk::ImageStatisticsContainer::New();
+  statistics->SetTimeGeometry(m_StatisticsImage->GetTimeGeometry()->Clone());
+  statistics->SetStatisticsForTimeStep(0, m_IncrementalCalculator->GetStatistics());
+
+  m_StatisticsContainer = statistics;
+  mitk::ImageStatisticsCache::GetInstance()->Insert(cacheKey, m_StatisticsContainer);
+  this->m_CalculationSuccessful = true;
+  this->UpdateHistogramVector();
+  return true;
+}
 
+void QmitkImageStatisticsCalculationJob::UpdateHistogramVector()
+{
+  this->m_HistogramVector.clear();
+
+  for (unsigned int i = 0; i < m_StatisticsImage->GetTimeSteps(); i++)
+  {
+    HistogramType::ConstPointer tempHistogram;
+    try {
+      if(m_StatisticsContainer->TimeStepExists(i))
+      {
+        tempHistogram = m_StatisticsContainer->GetStatisticsForTimeStep(i).m_Histogram;
+        this->m_HistogramVector.push_back(tempHistogram);
+      }
+    } catch (mitk::Exception&) {
+      MITK_WARN << ":-(";
+    }
   }
 }
@@ -23,9 +23,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 //mitk headers
 #include "mitkImage.h"
 #include "mitkPlanarFigure.h"
+#include "mitkImageStatisticsCache.h"
 #include "mitkImageStatisticsContainer.h"
+#include "mitkIncrementalImageStatisticsCalculator.h"
 #include <MitkImageStatisticsUIExports.h>
 
+#include <mutex>
+#include <vector>
+
 // itk headers
 #ifndef __itkHistogram_h
 #include <itkHistogram.h>
@@ -79,6 +84,15 @@ public:
   /brief Returns the histogram of the currently selected time step. */
   const HistogramType* GetTimeStepHistogram(unsigned int t = 0) const;
 
+  /*!
+  /brief Marks a region of the binary mask as changed, e.g. the slice a segmentation tool wrote back.
+  As long as a 3D mask is only changed within such regions, the next run updates the statistics of the
+  last run within the regions instead of computing all of them again (see mitk::IncrementalImageStatisticsCalculator). */
+  void AddChangedMaskRegion(const itk::ImageRegion<3> &region);
+  /*!
+  /brief Marks the binary mask as changed outside of the changed regions, the next run computes all statistics again. */
+  void InvalidateChangedMaskRegions();
+
   /*!
   /brief Returns a flag the indicates if the statistics are updated successfully */
   bool GetStatisticsUpdateSuccessFlag() const;
@@ -89,6 +103,14 @@ public:
   std::string GetLastErrorMessage() const;
 
 private:
+  /*!
+  /brief Fills the histogram vector from the statistics container. */
+  void UpdateHistogramVector();
+  /*!
+  /brief Updates the statistics within the changed mask regions. Returns false if they have to be computed by
+  mitk::ImageStatisticsCalculator. */
+  bool UpdateStatisticsIncrementally(const mitk::ImageStatisticsCache::Key &cacheKey);
+
   mitk::Image::ConstPointer m_StatisticsImage;                         ///< member variable holds the input image for which the statistics need to be calculated.
   mitk::Image::ConstPointer m_BinaryMask;                              ///< member variable holds the binary mask image for segmentation image statistics calculation.
   mitk::PlanarFigure::ConstPointer m_PlanarFigureMask;                 ///< member variable holds the planar figure for segmentation image statistics calculation.
@@ -98,5 +120,9 @@ private:
   bool m_CalculationSuccessful;                                   ///< flag set if statistics calculation was successful
   std::vector<HistogramType::ConstPointer> m_HistogramVector;          ///< member holds the histograms of all time steps.
   std::string m_message;
+  mitk::IncrementalImageStatisticsCalculator::Pointer m_IncrementalCalculator; ///< member variable keeps the statistics up to date while the binary mask is edited.
+  std::vector<itk::ImageRegion<3>> m_ChangedMaskRegions;               ///< member variable holds the regions of the binary mask changed since the last run.
+  bool m_IncrementalStatisticsOutdated;                               ///< flag set if the binary mask changed outside of the changed regions
+  std::mutex m_ChangedMaskRegionsMutex;
 };
 #endif // QMITKIMAGESTATISTICSCALCULATIONTHREAD_H_INCLUDED
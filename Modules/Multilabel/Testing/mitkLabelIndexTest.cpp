@@ -0,0 +1,114 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkLabelIndex.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+class mitkLabelIndexTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelIndexTestSuite);
+  MITK_TEST(TestAddRun);
+  MITK_TEST(TestChangeVoxel);
+  MITK_TEST(TestRemapLabels);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::LabelIndex::IndexType IndexType;
+
+  static IndexType MakeIndex(long x, long y, long z)
+  {
+    IndexType index = {{x, y, z}};
+    return index;
+  }
+
+public:
+  void TestAddRun()
+  {
+    mitk::LabelIndex labelIndex;
+    labelIndex.AddRun(0, MakeIndex(0, 0, 0), 10);
+    labelIndex.AddRun(3, MakeIndex(2, 1, 4), 4);
+    labelIndex.AddRun(3, MakeIndex(0, 3, 2), 2);
+
+    CPPUNIT_ASSERT_MESSAGE("Exterior voxels were indexed", labelIndex.GetEntry(0) == nullptr);
+
+    const mitk::LabelIndex::Entry *entry = labelIndex.GetEntry(3);
+    CPPUNIT_ASSERT_MESSAGE("Label was not indexed", entry != nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of voxels", entry->numberOfVoxels == 6);
+    CPPUNIT_ASSERT_MESSAGE("Wrong bounding box",
+                           entry->boundingBoxMin == MakeIndex(0, 1, 2) && entry->boundingBoxMax == MakeIndex(5, 3, 4));
+    CPPUNIT_ASSERT_MESSAGE("Bounding box is not tight", entry->boundingBoxIsTight);
+
+    // x: 2+3+4+5+0+1, y: 4*1+2*3, z: 4*4+2*2
+    mitk::Point3D centroid = entry->GetCentroid();
+    CPPUNIT_ASSERT_MESSAGE("Wrong centroid",
+                           mitk::Equal(centroid[0], 15.0 / 6) && mitk::Equal(centroid[1], 10.0 / 6) &&
+                             mitk::Equal(centroid[2], 20.0 / 6));
+  }
+
+  void TestChangeVoxel()
+  {
+    mitk::LabelIndex labelIndex;
+    labelIndex.AddRun(1, MakeIndex(0, 0, 0), 3);
+
+    // removing an inner voxel keeps the bounding box tight
+    labelIndex.ChangeVoxel(1, 2, MakeIndex(1, 0, 0));
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of voxels after change",
+                           labelIndex.GetEntry(1)->numberOfVoxels == 2 && labelIndex.GetEntry(2)->numberOfVoxels == 1);
+    CPPUNIT_ASSERT_MESSAGE("Bounding box is not tight after removing an inner voxel",
+                           labelIndex.GetEntry(1)->boundingBoxIsTight);
+
+    // removing a border voxel might shrink the box
+    labelIndex.ChangeVoxel(1, 0, MakeIndex(2, 0, 0));
+    CPPUNIT_ASSERT_MESSAGE("Bounding box is tight after removing a border voxel",
+                           !labelIndex.GetEntry(1)->boundingBoxIsTight);
+
+    labelIndex.SetTightBoundingBox(1, MakeIndex(0, 0, 0), MakeIndex(0, 0, 0));
+    CPPUNIT_ASSERT_MESSAGE("Bounding box was not replaced",
+                           labelIndex.GetEntry(1)->boundingBoxIsTight &&
+                             labelIndex.GetEntry(1)->GetBoundingBox().GetNumberOfPixels() == 1);
+
+    // removing the last voxel removes the entry
+    labelIndex.ChangeVoxel(1, 0, MakeIndex(0, 0, 0));
+    CPPUNIT_ASSERT_MESSAGE("Entry of label without voxels was not removed", labelIndex.GetEntry(1) == nullptr);
+    CPPUNIT_ASSERT_MESSAGE("Wrong label values",
+                           labelIndex.GetLabelValues() == std::vector<mitk::LabelIndex::PixelType>(1, 2));
+  }
+
+  void TestRemapLabels()
+  {
+    mitk::LabelIndex labelIndex;
+    labelIndex.AddRun(1, MakeIndex(0, 0, 0), 2);
+    labelIndex.AddRun(2, MakeIndex(5, 5, 5), 1);
+    labelIndex.AddRun(3, MakeIndex(9, 9, 9), 1);
+
+    std::vector<mitk::LabelIndex::PixelType> lookupTable(4);
+    lookupTable[1] = 2;
+    lookupTable[2] = 2;
+    lookupTable[3] = 0;
+    labelIndex.RemapLabels(lookupTable);
+
+    CPPUNIT_ASSERT_MESSAGE("Remapped labels were not removed",
+                           labelIndex.GetEntry(1) == nullptr && labelIndex.GetEntry(3) == nullptr);
+
+    const mitk::LabelIndex::Entry *entry = labelIndex.GetEntry(2);
+    CPPUNIT_ASSERT_MESSAGE("Entries were not merged", entry != nullptr && entry->numberOfVoxels == 3);
+    CPPUNIT_ASSERT_MESSAGE("Bounding boxes were not merged",
+                           entry->boundingBoxMin == MakeIndex(0, 0, 0) && entry->boundingBoxMax == MakeIndex(5, 5, 5));
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelIndex)
@@ -15,6 +15,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 ===================================================================*/
 
 #include <mitkIOUtil.h>
+#include <mitkImagePixelReadAccessor.h>
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkImageWriteAccessor.h>
 #include <mitkImageStatisticsHolder.h>
 #include <mitkLabelSetImage.h>
 #include <mitkTestFixture.h>
@@ -35,9 +38,14 @@ class mitkLabelSetImageTestSuite : public mitk::TestFixture
   MITK_TEST(TestExistsLabel);
   MITK_TEST(TestExistsLabelSet);
   MITK_TEST(TestSetActiveLayer);
+  MITK_TEST(TestLayerImageData);
   MITK_TEST(TestRemoveLayer);
   MITK_TEST(TestRemoveLabels);
   MITK_TEST(TestMergeLabel);
+  MITK_TEST(TestRemapLabels);
+  MITK_TEST(TestLabelIndex);
+  MITK_TEST(TestLabelIndexShrinksBoundingBox);
+  MITK_TEST(TestCenterOfMassOfDisconnectedLabel);
   // TODO check it these functionalities can be moved into a process object
   //  MITK_TEST(TestMergeLabels);
   //  MITK_TEST(TestConcatenate);
@@ -336,6 +344,87 @@ public:
                            mitk::Equal(*newlayer, *m_LabelSetImage->GetActiveLabelSet(), 0.00001, true));
   }
 
+  void TestLayerImageData()
+  {
+    typedef mitk::Label::PixelType PixelType;
+    itk::Index<3> index0 = {{10, 20, 30}};
+    itk::Index<3> index1 = {{11, 21, 31}};
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex(index0, 3);
+    }
+
+    m_LabelSetImage->AddLayer();
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      CPPUNIT_ASSERT_MESSAGE("New layer is not empty", accessor.GetPixelByIndex(index0) == 0);
+      accessor.SetPixelByIndex(index1, 4);
+    }
+
+    // the inactive first layer can be decoded slice-wise
+    mitk::Image::Pointer sliceImage = m_LabelSetImage->CreateLayerSliceImage(0, 2, 30);
+    CPPUNIT_ASSERT_MESSAGE("Slice of inactive layer could not be created", sliceImage.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Slice image has wrong dimensions",
+                           sliceImage->GetDimension(0) == 256 && sliceImage->GetDimension(1) == 256 &&
+                             sliceImage->GetDimension(2) == 1);
+
+    mitk::Point3D worldPoint;
+    mitk::Point3D indexPoint;
+    mitk::FillVector3D(indexPoint, index0[0], index0[1], index0[2]);
+    m_LabelSetImage->GetGeometry()->IndexToWorld(indexPoint, worldPoint);
+    itk::Index<3> sliceIndex;
+    sliceImage->GetGeometry()->WorldToIndex(worldPoint, sliceIndex);
+    CPPUNIT_ASSERT_MESSAGE("Slice image has wrong geometry",
+                           sliceIndex[0] == 10 && sliceIndex[1] == 20 && sliceIndex[2] == 0);
+
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(sliceImage);
+      CPPUNIT_ASSERT_MESSAGE("Slice of inactive layer has wrong content", accessor.GetPixelByIndex(sliceIndex) == 3);
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Slice of active layer should not be created",
+                           m_LabelSetImage->CreateLayerSliceImage(1, 2, 30).IsNull());
+
+    // the inactive first layer can be decoded completely
+    {
+      mitk::Image::Pointer layerImage = m_LabelSetImage->CreateLayerImage(0);
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(layerImage);
+      CPPUNIT_ASSERT_MESSAGE("Inactive layer has wrong content",
+                             accessor.GetPixelByIndex(index0) == 3 && accessor.GetPixelByIndex(index1) == 0);
+    }
+
+    // reading the layer keeps it encoded
+    {
+      const mitk::LabelSetImage *constImage = m_LabelSetImage;
+      mitk::Image::ConstPointer layerImage = constImage->GetLayerImage(0);
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(layerImage);
+      CPPUNIT_ASSERT_MESSAGE("Read image of inactive layer has wrong content", accessor.GetPixelByIndex(index0) == 3);
+      CPPUNIT_ASSERT_MESSAGE("Reading the inactive layer decoded it", m_LabelSetImage->IsLayerRunLengthEncoded(0));
+    }
+
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage->GetLayerImage(0));
+      CPPUNIT_ASSERT_MESSAGE("Dense image of inactive layer has wrong content", accessor.GetPixelByIndex(index0) == 3);
+    }
+
+    // switching the layers restores their content
+    m_LabelSetImage->SetActiveLayer(0);
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      CPPUNIT_ASSERT_MESSAGE("First layer was not restored",
+                             accessor.GetPixelByIndex(index0) == 3 && accessor.GetPixelByIndex(index1) == 0);
+    }
+
+    m_LabelSetImage->SetActiveLayer(1);
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      CPPUNIT_ASSERT_MESSAGE("Second layer was not restored",
+                             accessor.GetPixelByIndex(index0) == 0 && accessor.GetPixelByIndex(index1) == 4);
+    }
+  }
+
   void TestRemoveLayer()
   {
     // Cache active layer
@@ -443,6 +532,180 @@ public:
     // Check if merge label has 507 + 823 = 1330 pixels
     CPPUNIT_ASSERT_MESSAGE("Label with value 7 was not remove from the image", m_LabelSetImage->GetStatistics()->GetCountOfMaxValuedVoxels() == 1330);
   }
+
+  void TestRemapLabels()
+  {
+    typedef mitk::Label::PixelType PixelType;
+    itk::Index<3> index1 = {{10, 20, 30}};
+    itk::Index<3> index2 = {{11, 21, 31}};
+    itk::Index<3> index3 = {{12, 22, 32}};
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex(index1, 1);
+      accessor.SetPixelByIndex(index2, 2);
+      accessor.SetPixelByIndex(index3, 3);
+    }
+
+    // remap the active layer
+    std::map<PixelType, PixelType> labelMapping;
+    labelMapping[1] = 3;
+    labelMapping[2] = 0;
+    m_LabelSetImage->RemapLabels(labelMapping, 0);
+
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      CPPUNIT_ASSERT_MESSAGE("Active layer was not remapped correctly",
+                             accessor.GetPixelByIndex(index1) == 3 && accessor.GetPixelByIndex(index2) == 0 &&
+                               accessor.GetPixelByIndex(index3) == 3);
+    }
+
+    // remap the run-length encoded first layer while the second one is active
+    m_LabelSetImage->AddLayer();
+    std::vector<PixelType> labelsToErase(1, 3);
+    m_LabelSetImage->EraseLabels(labelsToErase, 0);
+    m_LabelSetImage->SetActiveLayer(0);
+
+    {
+      mitk::ImagePixelReadAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      CPPUNIT_ASSERT_MESSAGE("Inactive layer was not remapped correctly",
+                             accessor.GetPixelByIndex(index1) == 0 && accessor.GetPixelByIndex(index3) == 0);
+    }
+  }
+
+  void TestLabelIndex()
+  {
+    typedef mitk::Label::PixelType PixelType;
+    itk::Index<3> index1 = {{10, 20, 30}};
+    itk::Index<3> index2 = {{14, 20, 34}};
+    itk::Index<3> index3 = {{12, 22, 32}};
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex(index1, 1);
+      accessor.SetPixelByIndex(index2, 1);
+      accessor.SetPixelByIndex(index3, 2);
+    }
+    m_LabelSetImage->Modified();
+
+    itk::ImageRegion<3> boundingBox;
+    mitk::Point3D centroid;
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of label voxels", m_LabelSetImage->GetNumberOfLabelVoxels(1) == 2);
+    CPPUNIT_ASSERT_MESSAGE("Wrong bounding box",
+                           m_LabelSetImage->GetLabelBoundingBox(1, boundingBox) && boundingBox.GetIndex() == index1 &&
+                             boundingBox.GetUpperIndex() == index2);
+    CPPUNIT_ASSERT_MESSAGE("Wrong centroid",
+                           m_LabelSetImage->GetLabelCentroid(1, centroid) && mitk::Equal(centroid[0], 12.0) &&
+                             mitk::Equal(centroid[1], 20.0) && mitk::Equal(centroid[2], 32.0));
+    CPPUNIT_ASSERT_MESSAGE("Empty label has a bounding box", !m_LabelSetImage->GetLabelBoundingBox(3, boundingBox));
+
+    // merging updates the index without rescanning the image
+    m_LabelSetImage->MergeLabel(2, 1);
+    CPPUNIT_ASSERT_MESSAGE("Merged label was not removed from the index",
+                           m_LabelSetImage->GetNumberOfLabelVoxels(1) == 0);
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of voxels of merged label", m_LabelSetImage->GetNumberOfLabelVoxels(2) == 3);
+
+    // erasing a voxel at the border of the box shrinks it
+    std::map<PixelType, PixelType> labelMapping;
+    labelMapping[2] = 4;
+    m_LabelSetImage->RemapLabels(labelMapping);
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex(index2, 0);
+    }
+    m_LabelSetImage->Modified();
+    CPPUNIT_ASSERT_MESSAGE("Wrong bounding box after erasing a voxel",
+                           m_LabelSetImage->GetLabelBoundingBox(4, boundingBox) && boundingBox.GetIndex() == index1 &&
+                             boundingBox.GetUpperIndex() == index3);
+
+    // inactive, run-length encoded layers are indexed as well
+    m_LabelSetImage->AddLayer();
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of voxels in inactive layer",
+                           m_LabelSetImage->GetNumberOfLabelVoxels(4, 0) == 2 &&
+                             m_LabelSetImage->GetNumberOfLabelVoxels(4, 1) == 0);
+  }
+
+  void TestLabelIndexShrinksBoundingBox()
+  {
+    typedef mitk::Label::PixelType PixelType;
+    itk::Index<3> index1 = {{10, 20, 30}};
+    itk::Index<3> index2 = {{14, 24, 30}};
+    itk::Index<3> index3 = {{12, 22, 30}};
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex(index1, 1);
+      accessor.SetPixelByIndex(index2, 1);
+      accessor.SetPixelByIndex(index3, 1);
+    }
+    m_LabelSetImage->Modified();
+
+    itk::ImageRegion<3> boundingBox;
+    CPPUNIT_ASSERT_MESSAGE("Wrong bounding box",
+                           m_LabelSetImage->GetLabelBoundingBox(1, boundingBox) && boundingBox.GetIndex() == index1 &&
+                             boundingBox.GetUpperIndex() == index2);
+
+    // erase the voxel at the upper corner of the box by a slice edit, which updates the index incrementally
+    mitk::Image::Pointer originalSlice = mitk::Image::New();
+    unsigned int sliceDimensions[2] = {256, 256};
+    originalSlice->Initialize(mitk::MakeScalarPixelType<PixelType>(), 2, sliceDimensions);
+    mitk::Point3D sliceOrigin;
+    mitk::FillVector3D(sliceOrigin, 0.0, 0.0, 30.0);
+    originalSlice->SetOrigin(sliceOrigin);
+    {
+      mitk::ImageWriteAccessor accessor(originalSlice);
+      auto *buffer = static_cast<PixelType *>(accessor.GetData());
+      std::fill(buffer, buffer + sliceDimensions[0] * sliceDimensions[1], 0);
+      buffer[index1[1] * sliceDimensions[0] + index1[0]] = 1;
+      buffer[index2[1] * sliceDimensions[0] + index2[0]] = 1;
+      buffer[index3[1] * sliceDimensions[0] + index3[0]] = 1;
+    }
+
+    mitk::Image::Pointer modifiedSlice = originalSlice->Clone();
+    {
+      mitk::ImageWriteAccessor accessor(modifiedSlice);
+      static_cast<PixelType *>(accessor.GetData())[index2[1] * sliceDimensions[0] + index2[0]] = 0;
+    }
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex(index2, 0);
+    }
+    m_LabelSetImage->UpdateLabelIndex(originalSlice, modifiedSlice, 0);
+
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of label voxels after the slice edit",
+                           m_LabelSetImage->GetNumberOfLabelVoxels(1) == 2);
+    CPPUNIT_ASSERT_MESSAGE("Bounding box was not shrunk after the slice edit",
+                           m_LabelSetImage->GetLabelBoundingBox(1, boundingBox) && boundingBox.GetIndex() == index1 &&
+                             boundingBox.GetUpperIndex() == index3);
+  }
+
+  void TestCenterOfMassOfDisconnectedLabel()
+  {
+    typedef mitk::Label::PixelType PixelType;
+    itk::Index<3> index1 = {{10, 20, 30}};
+    itk::Index<3> index2 = {{20, 20, 30}};
+    itk::Index<3> index3 = {{21, 20, 30}};
+
+    mitk::Label::Pointer label = mitk::Label::New();
+    label->SetName("Label1");
+    label->SetValue(1);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label);
+
+    {
+      mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+      accessor.SetPixelByIndex(index1, 1);
+      accessor.SetPixelByIndex(index2, 1);
+      accessor.SetPixelByIndex(index3, 1);
+    }
+    m_LabelSetImage->Modified();
+
+    // the centroid (17, 20, 30) is not part of the label, the nearest label voxel is used instead
+    m_LabelSetImage->UpdateCenterOfMass(1);
+    mitk::Point3D centerOfMass = m_LabelSetImage->GetLabel(1)->GetCenterOfMassIndex();
+    CPPUNIT_ASSERT_MESSAGE("Center of mass is not a voxel of the label",
+                           mitk::Equal(centerOfMass[0], 20.0) && mitk::Equal(centerOfMass[1], 20.0) &&
+                             mitk::Equal(centerOfMass[2], 30.0));
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImage)
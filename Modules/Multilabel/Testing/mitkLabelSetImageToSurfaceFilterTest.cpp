@@ -0,0 +1,154 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkImagePixelWriteAccessor.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkLabelSetImage.h>
+#include <mitkLabelSetImageToSurfaceFilter.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <vtkPolyData.h>
+
+class mitkLabelSetImageToSurfaceFilterTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkLabelSetImageToSurfaceFilterTestSuite);
+  MITK_TEST(TestGenerateAllLabels);
+  MITK_TEST(TestGenerateAllLabelsOfPlainImage);
+  MITK_TEST(TestDecimation);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::Label::PixelType PixelType;
+
+  mitk::LabelSetImage::Pointer m_LabelSetImage;
+
+  void FillCube(PixelType value, long first, long last)
+  {
+    mitk::ImagePixelWriteAccessor<PixelType, 3> accessor(m_LabelSetImage);
+    for (long z = first; z <= last; ++z)
+      for (long y = first; y <= last; ++y)
+        for (long x = first; x <= last; ++x)
+        {
+          itk::Index<3> index = {{x, y, z}};
+          accessor.SetPixelByIndex(index, value);
+        }
+  }
+
+  void AddLabel(PixelType value)
+  {
+    mitk::Label::Pointer label = mitk::Label::New();
+    label->SetValue(value);
+    m_LabelSetImage->GetActiveLabelSet()->AddLabel(label);
+  }
+
+  static bool HasBounds(mitk::Surface *surface, double lower, double upper)
+  {
+    double bounds[6];
+    surface->GetVtkPolyData()->GetBounds(bounds);
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      if (!mitk::Equal(bounds[2 * i], lower, 0.01) || !mitk::Equal(bounds[2 * i + 1], upper, 0.01))
+        return false;
+    }
+    return true;
+  }
+
+public:
+  void setUp() override
+  {
+    m_LabelSetImage = mitk::LabelSetImage::New();
+    mitk::Image::Pointer regularImage = mitk::Image::New();
+    unsigned int dimensions[3] = {32, 32, 32};
+    regularImage->Initialize(mitk::MakeScalarPixelType<int>(), 3, dimensions);
+    m_LabelSetImage->Initialize(regularImage);
+
+    this->AddLabel(1);
+    this->AddLabel(2);
+    this->AddLabel(3);
+
+    // two touching cubes, label 3 has no voxels
+    this->FillCube(1, 4, 11);
+    this->FillCube(2, 12, 19);
+    m_LabelSetImage->Modified();
+  }
+
+  void tearDown() override { m_LabelSetImage = nullptr; }
+
+  void TestGenerateAllLabels()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_LabelSetImage);
+    filter->GenerateAllLabelsOn();
+    filter->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of outputs", filter->GetNumberOfIndexedOutputs() == 2);
+    CPPUNIT_ASSERT_MESSAGE("Wrong labels of outputs",
+                           filter->GetLabelOfOutput(0) == 1 && filter->GetLabelOfOutput(1) == 2);
+
+    // the surface runs between the voxel centers of the label and its neighbours
+    CPPUNIT_ASSERT_MESSAGE("Wrong surface of label 1", HasBounds(filter->GetOutput(0), 3.5, 11.5));
+    CPPUNIT_ASSERT_MESSAGE("Wrong surface of label 2", HasBounds(filter->GetOutput(1), 11.5, 19.5));
+  }
+
+  void TestGenerateAllLabelsOfPlainImage()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer labelSetFilter = mitk::LabelSetImageToSurfaceFilter::New();
+    labelSetFilter->SetInput(m_LabelSetImage);
+    labelSetFilter->GenerateAllLabelsOn();
+    labelSetFilter->Update();
+
+    // without a label index the bounding boxes are determined by a scan of the image
+    mitk::Image::Pointer plainImage = mitk::Image::New();
+    plainImage->Initialize(m_LabelSetImage);
+    mitk::ImageReadAccessor accessor(m_LabelSetImage);
+    plainImage->SetImportVolume(accessor.GetData());
+
+    mitk::LabelSetImageToSurfaceFilter::Pointer plainFilter = mitk::LabelSetImageToSurfaceFilter::New();
+    plainFilter->SetInput(plainImage);
+    plainFilter->GenerateAllLabelsOn();
+    plainFilter->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("Wrong number of outputs", plainFilter->GetNumberOfIndexedOutputs() == 2);
+    for (unsigned int i = 0; i < 2; ++i)
+    {
+      CPPUNIT_ASSERT_MESSAGE("Surfaces differ",
+                             plainFilter->GetOutput(i)->GetVtkPolyData()->GetNumberOfPoints() ==
+                               labelSetFilter->GetOutput(i)->GetVtkPolyData()->GetNumberOfPoints());
+    }
+  }
+
+  void TestDecimation()
+  {
+    mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
+    filter->SetInput(m_LabelSetImage);
+    filter->GenerateAllLabelsOn();
+    filter->Update();
+    const vtkIdType numberOfPolys = filter->GetOutput(0)->GetVtkPolyData()->GetNumberOfPolys();
+
+    mitk::LabelSetImageToSurfaceFilter::Pointer decimatingFilter = mitk::LabelSetImageToSurfaceFilter::New();
+    decimatingFilter->SetInput(m_LabelSetImage);
+    decimatingFilter->GenerateAllLabelsOn();
+    decimatingFilter->SetUseSmoothing(1);
+    decimatingFilter->SetTargetReduction(0.5);
+    decimatingFilter->Update();
+
+    CPPUNIT_ASSERT_MESSAGE("Surface was not decimated",
+                           decimatingFilter->GetOutput(0)->GetVtkPolyData()->GetNumberOfPolys() < numberOfPolys);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkLabelSetImageToSurfaceFilter)
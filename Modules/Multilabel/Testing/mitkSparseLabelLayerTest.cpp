@@ -0,0 +1,141 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkException.h>
+#include <mitkSparseLabelLayer.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+class mitkSparseLabelLayerTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkSparseLabelLayerTestSuite);
+  MITK_TEST(TestEmptyLayer);
+  MITK_TEST(TestEncodeDecode);
+  MITK_TEST(TestDecodeSlice);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef mitk::SparseLabelLayer::PixelType PixelType;
+
+  unsigned int m_Dimensions[4];
+  std::vector<PixelType> m_Buffer;
+
+  std::size_t Index(unsigned int x, unsigned int y, unsigned int z, unsigned int t) const
+  {
+    return ((static_cast<std::size_t>(t) * m_Dimensions[2] + z) * m_Dimensions[1] + y) * m_Dimensions[0] + x;
+  }
+
+public:
+  void setUp() override
+  {
+    m_Dimensions[0] = 17;
+    m_Dimensions[1] = 11;
+    m_Dimensions[2] = 7;
+    m_Dimensions[3] = 2;
+
+    // a few label blocks of different values, some touching each other along x
+    m_Buffer.assign(static_cast<std::size_t>(m_Dimensions[0]) * m_Dimensions[1] * m_Dimensions[2] * m_Dimensions[3], 0);
+    for (unsigned int t = 0; t < m_Dimensions[3]; ++t)
+      for (unsigned int z = 1; z < 6; ++z)
+        for (unsigned int y = 2; y < 9; ++y)
+          for (unsigned int x = 3; x < 16; ++x)
+            m_Buffer[this->Index(x, y, z, t)] = x < 8 ? 1 + t : (x + y) % 3 == 0 ? 0 : 5;
+  }
+
+  void tearDown() override { m_Buffer.clear(); }
+
+  void TestEmptyLayer()
+  {
+    mitk::SparseLabelLayer layer;
+    layer.Initialize(4, m_Dimensions);
+
+    CPPUNIT_ASSERT_MESSAGE("New layer is not empty", layer.IsEmpty());
+    CPPUNIT_ASSERT_MESSAGE("New layer allocates memory", layer.GetMemorySize() == 0);
+
+    std::vector<PixelType> zeros(m_Buffer.size(), 0);
+    layer.Encode(zeros.data());
+    CPPUNIT_ASSERT_MESSAGE("Layer without labeled voxels is not empty", layer.IsEmpty());
+    CPPUNIT_ASSERT_MESSAGE("Layer without labeled voxels allocates memory", layer.GetMemorySize() == 0);
+
+    std::vector<PixelType> decoded(m_Buffer.size(), 7);
+    layer.Decode(decoded.data());
+    CPPUNIT_ASSERT_MESSAGE("Empty layer is not decoded to exterior voxels", decoded == zeros);
+  }
+
+  void TestEncodeDecode()
+  {
+    mitk::SparseLabelLayer layer;
+    layer.Initialize(4, m_Dimensions);
+    layer.Encode(m_Buffer.data());
+
+    CPPUNIT_ASSERT_MESSAGE("Encoded layer is empty", !layer.IsEmpty());
+    CPPUNIT_ASSERT_MESSAGE("Encoded layer is not smaller than the dense buffer",
+                           layer.GetMemorySize() < m_Buffer.size() * sizeof(PixelType));
+
+    std::vector<PixelType> decoded(m_Buffer.size(), 7);
+    layer.Decode(decoded.data());
+    CPPUNIT_ASSERT_MESSAGE("Decoded layer differs from the encoded buffer", decoded == m_Buffer);
+
+    mitk::SparseLabelLayer copy = layer;
+    layer.Clear();
+    CPPUNIT_ASSERT_MESSAGE("Cleared layer is not empty", layer.IsEmpty());
+
+    copy.Decode(decoded.data());
+    CPPUNIT_ASSERT_MESSAGE("Copied layer differs from the encoded buffer", decoded == m_Buffer);
+  }
+
+  void TestDecodeSlice()
+  {
+    mitk::SparseLabelLayer layer;
+    layer.Initialize(4, m_Dimensions);
+    layer.Encode(m_Buffer.data());
+
+    for (unsigned int t = 0; t < m_Dimensions[3]; ++t)
+    {
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        const unsigned int axis0 = 0 == dim ? 1 : 0;
+        const unsigned int axis1 = 2 == dim ? 1 : 2;
+        std::vector<PixelType> slice(static_cast<std::size_t>(m_Dimensions[axis0]) * m_Dimensions[axis1]);
+
+        for (unsigned int sliceIndex = 0; sliceIndex < m_Dimensions[dim]; ++sliceIndex)
+        {
+          layer.DecodeSlice(dim, sliceIndex, t, slice.data());
+
+          for (unsigned int j = 0; j < m_Dimensions[axis1]; ++j)
+          {
+            for (unsigned int i = 0; i < m_Dimensions[axis0]; ++i)
+            {
+              unsigned int index[3];
+              index[dim] = sliceIndex;
+              index[axis0] = i;
+              index[axis1] = j;
+
+              CPPUNIT_ASSERT_EQUAL_MESSAGE("Decoded slice differs from the encoded buffer",
+                                           m_Buffer[this->Index(index[0], index[1], index[2], t)],
+                                           slice[static_cast<std::size_t>(j) * m_Dimensions[axis0] + i]);
+            }
+          }
+        }
+      }
+    }
+
+    std::vector<PixelType> slice(static_cast<std::size_t>(m_Dimensions[0]) * m_Dimensions[1]);
+    CPPUNIT_ASSERT_THROW(layer.DecodeSlice(2, m_Dimensions[2], 0, slice.data()), mitk::Exception);
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkSparseLabelLayer)
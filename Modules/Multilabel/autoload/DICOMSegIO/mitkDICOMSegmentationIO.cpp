@@ -28,12 +28,18 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
 #include <mitkLocaleSwitch.h>
+#include <mitkParallelFor.h>
 #include <mitkPropertyNameHelper.h>
 
 
 // itk
 #include <itkThresholdImageFilter.h>
 
+// std
+#include <algorithm>
+#include <limits>
+#include <set>
+
 // dcmqi
 #include <dcmqi/ImageSEGConverter.h>
 
@@ -41,6 +47,28 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <usGetModuleContext.h>
 #include <usModuleContext.h>
 
+namespace
+{
+  /** Returns the DICOM segment number stored in the label properties or -1 if there is none. */
+  int GetSegmentNumber(const mitk::Label *label)
+  {
+    auto segmentNumberProp = dynamic_cast<const mitk::TemporoSpatialStringProperty *>(label->GetProperty(
+      mitk::DICOMTagPathToPropertyName(mitk::DICOMSegmentationConstants::SEGMENT_NUMBER_PATH()).c_str()));
+
+    if (segmentNumberProp == nullptr || segmentNumberProp->GetValue().empty())
+      return -1;
+
+    try
+    {
+      return std::stoi(segmentNumberProp->GetValue());
+    }
+    catch (const std::exception &)
+    {
+      return -1;
+    }
+  }
+}
+
 namespace mitk
 {
   DICOMSegmentationIO::DICOMSegmentationIO()
@@ -166,6 +194,8 @@ namespace mitk
     for (unsigned int layer = 0; layer < input->GetNumberOfLayers(); ++layer)
     {
       vector<itkInternalImageType::Pointer> segmentations;
+      std::vector<Label::PixelType> labelsToWrite;
+      bool singleSegmentationImage = false;
 
       try
       {
@@ -177,34 +207,60 @@ namespace mitk
         // Cast mitk layer image to itk
         ImageToItk<itkInputImageType>::Pointer imageToItkFilter = ImageToItk<itkInputImageType>::New();
         imageToItkFilter->SetInput(mitkLayerImage);
-        // Cast from original itk type to dcmqi input itk image type
-        typedef itk::CastImageFilter<itkInputImageType, itkInternalImageType> castItkImageFilterType;
-        castItkImageFilterType::Pointer castFilter = castItkImageFilterType::New();
-        castFilter->SetInput(imageToItkFilter->GetOutput());
-        castFilter->Update();
+        imageToItkFilter->Update();
+        itkInputImageType::Pointer itkLayerImage = imageToItkFilter->GetOutput();
 
-        itkInternalImageType::Pointer itkLabelImage = castFilter->GetOutput();
-        itkLabelImage->DisconnectPipeline();
-
-        // Iterate over all labels. For each label a segmentation image will be created
         const LabelSet *labelSet = input->GetLabelSet(layer);
-        auto labelIter = labelSet->IteratorConstBegin();
-        // Ignore background label
-        ++labelIter;
 
-        for (; labelIter != labelSet->IteratorConstEnd(); ++labelIter)
+        // Fast path: all labels of the layer in one segmentation image, empty labels are skipped
+        itkInternalImageType::Pointer segmentationImage;
+        singleSegmentationImage =
+          CreateSegmentationImageOfLayer(itkLayerImage, labelSet, segmentationImage, labelsToWrite);
+
+        if (singleSegmentationImage)
         {
-          // Thresold over the image with the given label value
-          itk::ThresholdImageFilter<itkInternalImageType>::Pointer thresholdFilter =
-            itk::ThresholdImageFilter<itkInternalImageType>::New();
-          thresholdFilter->SetInput(itkLabelImage);
-          thresholdFilter->ThresholdOutside(labelIter->first, labelIter->first);
-          thresholdFilter->SetOutsideValue(0);
-          thresholdFilter->Update();
-          itkInternalImageType::Pointer segmentImage = thresholdFilter->GetOutput();
-          segmentImage->DisconnectPipeline();
-
-          segmentations.push_back(segmentImage);
+          if (labelsToWrite.empty())
+          {
+            MITK_WARN << "Layer " << layer << " does not contain any labeled voxels. No DICOM Seg is written for it.";
+            continue;
+          }
+
+          segmentations.push_back(segmentationImage);
+        }
+        else
+        {
+          MITK_INFO << "Labels of layer " << layer
+                    << " have no unique segment numbers. Falling back to one segmentation image per label.";
+
+          // Cast from original itk type to dcmqi input itk image type
+          typedef itk::CastImageFilter<itkInputImageType, itkInternalImageType> castItkImageFilterType;
+          castItkImageFilterType::Pointer castFilter = castItkImageFilterType::New();
+          castFilter->SetInput(itkLayerImage);
+          castFilter->Update();
+
+          itkInternalImageType::Pointer itkLabelImage = castFilter->GetOutput();
+          itkLabelImage->DisconnectPipeline();
+
+          // Iterate over all labels. For each label a segmentation image will be created
+          auto labelIter = labelSet->IteratorConstBegin();
+          // Ignore background label
+          ++labelIter;
+
+          for (; labelIter != labelSet->IteratorConstEnd(); ++labelIter)
+          {
+            // Thresold over the image with the given label value
+            itk::ThresholdImageFilter<itkInternalImageType>::Pointer thresholdFilter =
+              itk::ThresholdImageFilter<itkInternalImageType>::New();
+            thresholdFilter->SetInput(itkLabelImage);
+            thresholdFilter->ThresholdOutside(labelIter->first, labelIter->first);
+            thresholdFilter->SetOutsideValue(0);
+            thresholdFilter->Update();
+            itkInternalImageType::Pointer segmentImage = thresholdFilter->GetOutput();
+            segmentImage->DisconnectPipeline();
+
+            segmentations.push_back(segmentImage);
+            labelsToWrite.push_back(labelIter->first);
+          }
         }
       }
       catch (const itk::ExceptionObject &e)
@@ -214,7 +270,7 @@ namespace mitk
       }
 
       // Create segmentation meta information
-      const std::string tmpMetaInfoFile = this->CreateMetaDataJsonFile(layer);
+      const std::string tmpMetaInfoFile = this->CreateMetaDataJsonFile(layer, labelsToWrite, singleSegmentationImage);
 
       MITK_INFO << "Writing image: " << path << std::endl;
       try
@@ -452,7 +508,80 @@ namespace mitk
     return result;
   }
 
-  const std::string mitk::DICOMSegmentationIO::CreateMetaDataJsonFile(int layer)
+  bool DICOMSegmentationIO::CreateSegmentationImageOfLayer(const itkInputImageType *layerImage,
+                                                           const LabelSet *labelSet,
+                                                           itkInternalImageType::Pointer &segmentationImage,
+                                                           std::vector<Label::PixelType> &labelsToWrite)
+  {
+    typedef itkInternalImageType::PixelType SegmentNumberType;
+
+    labelsToWrite.clear();
+
+    // Lookup table label value -> DICOM segment number; 0 means the voxel is not part of any segment
+    std::vector<SegmentNumberType> segmentNumberForLabel(static_cast<size_t>(Label::MAX_LABEL_VALUE) + 1, 0);
+    std::set<int> usedSegmentNumbers;
+
+    auto labelIter = labelSet->IteratorConstBegin();
+    // Ignore background label
+    ++labelIter;
+
+    for (; labelIter != labelSet->IteratorConstEnd(); ++labelIter)
+    {
+      const int segmentNumber = GetSegmentNumber(labelIter->second);
+
+      if (segmentNumber <= 0 || segmentNumber > std::numeric_limits<SegmentNumberType>::max() ||
+          !usedSegmentNumbers.insert(segmentNumber).second)
+        return false;
+
+      segmentNumberForLabel[labelIter->first] = static_cast<SegmentNumberType>(segmentNumber);
+    }
+
+    segmentationImage = itkInternalImageType::New();
+    segmentationImage->CopyInformation(layerImage);
+    segmentationImage->SetRegions(layerImage->GetBufferedRegion());
+    segmentationImage->Allocate();
+
+    const itkInputImageType::PixelType *inputBuffer = layerImage->GetBufferPointer();
+    SegmentNumberType *outputBuffer = segmentationImage->GetBufferPointer();
+    const size_t numberOfVoxels = layerImage->GetBufferedRegion().GetNumberOfPixels();
+
+    // Remap and count the voxels of all labels in one pass; every chunk of the buffer is processed in
+    // parallel and counts into its own histogram, which are merged afterwards.
+    std::vector<std::vector<size_t>> voxelsPerLabel(GetNumberOfParallelChunks(numberOfVoxels));
+
+    ParallelForChunks(numberOfVoxels, [&](size_t begin, size_t end, size_t chunk) {
+      std::vector<size_t> &counts = voxelsPerLabel[chunk];
+      counts.assign(segmentNumberForLabel.size(), 0);
+
+      for (size_t i = begin; i < end; ++i)
+      {
+        const itkInputImageType::PixelType value = inputBuffer[i];
+        outputBuffer[i] = segmentNumberForLabel[value];
+        ++counts[value];
+      }
+    });
+
+    labelIter = labelSet->IteratorConstBegin();
+    ++labelIter;
+
+    for (; labelIter != labelSet->IteratorConstEnd(); ++labelIter)
+    {
+      size_t numberOfLabelVoxels = 0;
+      for (const auto &counts : voxelsPerLabel)
+        numberOfLabelVoxels += counts[labelIter->first];
+
+      if (numberOfLabelVoxels > 0)
+        labelsToWrite.push_back(labelIter->first);
+      else
+        MITK_INFO << "Label " << labelIter->second->GetName() << " is empty and will not be written as segment.";
+    }
+
+    return true;
+  }
+
+  const std::string mitk::DICOMSegmentationIO::CreateMetaDataJsonFile(int layer,
+                                                                      const std::vector<Label::PixelType> &labelsToWrite,
+                                                                      bool singleSegmentationImage)
   {
     const mitk::LabelSetImage *image = dynamic_cast<const mitk::LabelSetImage *>(this->GetInput());
 
@@ -501,6 +630,9 @@ namespace mitk
 
     for (; labelIter != labelSet->IteratorConstEnd(); ++labelIter)
     {
+      if (std::find(labelsToWrite.begin(), labelsToWrite.end(), labelIter->first) == labelsToWrite.end())
+        continue;
+
       const Label *label = labelIter->second;
 
       if (label != nullptr)
@@ -594,6 +726,19 @@ namespace mitk
         }
       }
     }
+
+    if (singleSegmentationImage && handler.segmentsAttributesMappingList.size() > 1)
+    {
+      // All segments are stored in one (multi-label) segmentation image. dcmqi expects the attributes
+      // of all segments of one input image in one group.
+      std::map<unsigned, dcmqi::SegmentAttributes *> mergedSegments;
+      for (const auto &segments : handler.segmentsAttributesMappingList)
+        mergedSegments.insert(segments.begin(), segments.end());
+
+      handler.segmentsAttributesMappingList.clear();
+      handler.segmentsAttributesMappingList.push_back(mergedSegments);
+    }
+
     return handler.getJSONOutputAsString();
   }
 
@@ -57,7 +57,36 @@ namespace mitk
     DICOMSegmentationIO *IOClone() const override;
 
     // -------------- DICOMSegmentationIO specific functions -------------
-    const std::string CreateMetaDataJsonFile(int layer);
+
+    /**
+     * @brief Creates the dcmqi meta information for the given labels of a layer.
+     * @param layer the layer of the input LabelSetImage
+     * @param labelsToWrite pixel values of the labels that get a segment in the DICOM SEG object
+     * @param singleSegmentationImage if true, all segments are described as parts of one (multi-label)
+     *        segmentation image, otherwise one segmentation image per segment is expected by dcmqi
+     */
+    const std::string CreateMetaDataJsonFile(int layer,
+                                             const std::vector<Label::PixelType> &labelsToWrite,
+                                             bool singleSegmentationImage);
+
+    /**
+     * @brief Fast path for writing a layer: converts the layer in one (multi-threaded) pass into a single
+     * segmentation image, which contains the DICOM segment numbers instead of the label values.
+     *
+     * Since labels of one layer never overlap, dcmqi can generate the frames of all segments from this
+     * single image; only labels that actually contain voxels are written, so no empty segments and no
+     * per-label intermediate images are produced.
+     * @param layerImage the layer image as taken from the LabelSetImage
+     * @param labelSet the label set of the layer
+     * @param segmentationImage output, the image handed over to dcmqi
+     * @param labelsToWrite output, pixel values of all non-empty labels
+     * @return false if the labels cannot be mapped to unique segment numbers; the caller then has to use
+     *         the per-label path.
+     */
+    static bool CreateSegmentationImageOfLayer(const itkInputImageType *layerImage,
+                                               const LabelSet *labelSet,
+                                               itkInternalImageType::Pointer &segmentationImage,
+                                               std::vector<Label::PixelType> &labelsToWrite);
     void SetLabelProperties(Label *label, dcmqi::SegmentAttributes *segmentAttribute);
     void AddDICOMTagsToService();
   };
@@ -8,6 +8,8 @@ set(CPP_FILES
   mitkLabelSetImageToSurfaceFilter.cpp
   mitkLabelSetImageToSurfaceThreadedFilter.cpp
   mitkLabelSetImageVtkMapper2D.cpp
+  mitkSparseLabelLayer.cpp
+  mitkLabelIndex.cpp
   mitkMultilabelObjectFactory.cpp
   mitkLabelSetIOHelper.cpp
   mitkDICOMSegmentationPropertyHelper.cpp
@@ -0,0 +1,186 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkLabelIndex.h"
+
+#include <algorithm>
+
+mitk::LabelIndex::Entry::Entry() : numberOfVoxels(0), boundingBoxIsTight(true)
+{
+  std::fill(indexSum, indexSum + 3, 0.0);
+  boundingBoxMin.Fill(0);
+  boundingBoxMax.Fill(0);
+}
+
+mitk::LabelIndex::RegionType mitk::LabelIndex::Entry::GetBoundingBox() const
+{
+  RegionType::SizeType size;
+  for (unsigned int i = 0; i < 3; ++i)
+    size[i] = numberOfVoxels > 0 ? boundingBoxMax[i] - boundingBoxMin[i] + 1 : 0;
+
+  return RegionType(boundingBoxMin, size);
+}
+
+mitk::Point3D mitk::LabelIndex::Entry::GetCentroid() const
+{
+  mitk::Point3D centroid;
+  centroid.Fill(0.0);
+
+  if (numberOfVoxels > 0)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+      centroid[i] = indexSum[i] / numberOfVoxels;
+  }
+
+  return centroid;
+}
+
+void mitk::LabelIndex::Clear()
+{
+  m_Entries.clear();
+}
+
+void mitk::LabelIndex::AddRun(PixelType value, const IndexType &index, std::size_t length)
+{
+  if (0 == value || 0 == length)
+    return;
+
+  Entry &entry = m_Entries[value];
+
+  const auto lastX = index[0] + static_cast<IndexType::IndexValueType>(length) - 1;
+
+  if (0 == entry.numberOfVoxels)
+  {
+    entry.boundingBoxMin = index;
+    entry.boundingBoxMax = index;
+    entry.boundingBoxMax[0] = lastX;
+  }
+  else
+  {
+    entry.boundingBoxMin[0] = std::min(entry.boundingBoxMin[0], index[0]);
+    entry.boundingBoxMax[0] = std::max(entry.boundingBoxMax[0], lastX);
+    for (unsigned int i = 1; i < 3; ++i)
+    {
+      entry.boundingBoxMin[i] = std::min(entry.boundingBoxMin[i], index[i]);
+      entry.boundingBoxMax[i] = std::max(entry.boundingBoxMax[i], index[i]);
+    }
+  }
+
+  entry.numberOfVoxels += length;
+  entry.indexSum[0] += length * (index[0] + lastX) / 2.0;
+  entry.indexSum[1] += static_cast<double>(length) * index[1];
+  entry.indexSum[2] += static_cast<double>(length) * index[2];
+}
+
+void mitk::LabelIndex::ChangeVoxel(PixelType oldValue, PixelType newValue, const IndexType &index)
+{
+  if (oldValue == newValue)
+    return;
+
+  if (0 != oldValue)
+  {
+    auto iter = m_Entries.find(oldValue);
+    if (iter != m_Entries.end())
+    {
+      Entry &entry = iter->second;
+
+      if (entry.numberOfVoxels <= 1)
+      {
+        m_Entries.erase(iter);
+      }
+      else
+      {
+        entry.numberOfVoxels -= 1;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          entry.indexSum[i] -= index[i];
+
+          // the box might shrink, which can only be determined by looking at the image
+          if (index[i] == entry.boundingBoxMin[i] || index[i] == entry.boundingBoxMax[i])
+            entry.boundingBoxIsTight = false;
+        }
+      }
+    }
+  }
+
+  this->AddRun(newValue, index, 1);
+}
+
+void mitk::LabelIndex::RemapLabels(const std::vector<PixelType> &lookupTable)
+{
+  std::map<PixelType, Entry> remappedEntries;
+
+  for (const auto &entry : m_Entries)
+  {
+    const PixelType newValue = lookupTable[entry.first];
+    if (0 == newValue)
+      continue;
+
+    auto iter = remappedEntries.find(newValue);
+    if (iter == remappedEntries.end())
+    {
+      remappedEntries[newValue] = entry.second;
+    }
+    else
+    {
+      Merge(iter->second, entry.second);
+    }
+  }
+
+  m_Entries.swap(remappedEntries);
+}
+
+void mitk::LabelIndex::SetTightBoundingBox(PixelType value,
+                                           const IndexType &boundingBoxMin,
+                                           const IndexType &boundingBoxMax)
+{
+  auto iter = m_Entries.find(value);
+  if (iter == m_Entries.end())
+    return;
+
+  iter->second.boundingBoxMin = boundingBoxMin;
+  iter->second.boundingBoxMax = boundingBoxMax;
+  iter->second.boundingBoxIsTight = true;
+}
+
+const mitk::LabelIndex::Entry *mitk::LabelIndex::GetEntry(PixelType value) const
+{
+  auto iter = m_Entries.find(value);
+  return iter != m_Entries.end() ? &iter->second : nullptr;
+}
+
+std::vector<mitk::LabelIndex::PixelType> mitk::LabelIndex::GetLabelValues() const
+{
+  std::vector<PixelType> labelValues;
+  labelValues.reserve(m_Entries.size());
+
+  for (const auto &entry : m_Entries)
+    labelValues.push_back(entry.first);
+
+  return labelValues;
+}
+
+void mitk::LabelIndex::Merge(Entry &target, const Entry &source)
+{
+  target.numberOfVoxels += source.numberOfVoxels;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    target.indexSum[i] += source.indexSum[i];
+    target.boundingBoxMin[i] = std::min(target.boundingBoxMin[i], source.boundingBoxMin[i]);
+    target.boundingBoxMax[i] = std::max(target.boundingBoxMax[i], source.boundingBoxMax[i]);
+  }
+  target.boundingBoxIsTight = target.boundingBoxIsTight && source.boundingBoxIsTight;
+}
@@ -0,0 +1,111 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __mitkLabelIndex_H_
+#define __mitkLabelIndex_H_
+
+#include <mitkLabel.h>
+#include <mitkPoint.h>
+
+#include <MitkMultilabelExports.h>
+
+#include <itkImageRegion.h>
+
+#include <map>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Per-label voxel count, bounding box and centroid of one time step of a label image.
+   *
+   * The accumulators are updated incrementally for every added, removed or changed voxel,
+   * so that queries do not need to scan the image. Exterior voxels (value 0) are not indexed.
+   *
+   * Removing voxels cannot shrink a bounding box without looking at the image again. Bounding
+   * boxes of labels which lost voxels at their border are therefore only guaranteed to enclose
+   * the label and are marked as not tight (see Entry::boundingBoxIsTight).
+   *
+   * @ingroup Data
+   */
+  class MITKMULTILABEL_EXPORT LabelIndex
+  {
+  public:
+    typedef mitk::Label::PixelType PixelType;
+    typedef itk::Index<3> IndexType;
+    typedef itk::ImageRegion<3> RegionType;
+
+    struct MITKMULTILABEL_EXPORT Entry
+    {
+      Entry();
+
+      /** @brief Returns the bounding box as image region. */
+      RegionType GetBoundingBox() const;
+
+      /** @brief Returns the centroid in index coordinates. */
+      mitk::Point3D GetCentroid() const;
+
+      std::size_t numberOfVoxels;
+      double indexSum[3];
+      IndexType boundingBoxMin;
+      IndexType boundingBoxMax;
+      bool boundingBoxIsTight;
+    };
+
+    /**
+     * @brief Removes all entries.
+     */
+    void Clear();
+
+    /**
+     * @brief Adds length voxels of one label starting at index along the x axis.
+     */
+    void AddRun(PixelType value, const IndexType &index, std::size_t length);
+
+    /**
+     * @brief Accounts for a voxel whose value changed from oldValue to newValue.
+     */
+    void ChangeVoxel(PixelType oldValue, PixelType newValue, const IndexType &index);
+
+    /**
+     * @brief Replaces the label values by lookupTable[value], entries of labels mapped
+     *        to the same value are combined, labels mapped to the exterior are removed.
+     */
+    void RemapLabels(const std::vector<PixelType> &lookupTable);
+
+    /**
+     * @brief Replaces the bounding box of a label by an exactly determined one.
+     */
+    void SetTightBoundingBox(PixelType value, const IndexType &boundingBoxMin, const IndexType &boundingBoxMax);
+
+    /**
+     * @brief Returns the entry of a label or nullptr if the label has no voxels.
+     */
+    const Entry *GetEntry(PixelType value) const;
+
+    /**
+     * @brief Returns the values of all labels with at least one voxel.
+     */
+    std::vector<PixelType> GetLabelValues() const;
+
+  private:
+    static void Merge(Entry &target, const Entry &source);
+
+    std::map<PixelType, Entry> m_Entries;
+  };
+} // namespace mitk
+
+#endif // __mitkLabelIndex_H_
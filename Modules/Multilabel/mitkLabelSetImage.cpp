@@ -18,11 +18,14 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
+#include "mitkImageReadAccessor.h"
 #include "mitkImagePixelReadAccessor.h"
 #include "mitkImagePixelWriteAccessor.h"
 #include "mitkInteractionConst.h"
 #include "mitkLookupTableProperty.h"
 #include "mitkPadImageFilter.h"
+#include "mitkParallelFor.h"
+#include "mitkProportionalTimeGeometry.h"
 #include "mitkRenderingManager.h"
 #include "mitkDICOMSegmentationPropertyHelper.h"
 #include "mitkDICOMQIPropertyHelper.h"
@@ -32,38 +35,314 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <vtkTransformPolyDataFilter.h>
 
 #include <itkImageRegionIterator.h>
+#include <itkImageRegionIteratorWithIndex.h>
 #include <itkQuadEdgeMesh.h>
 #include <itkTriangleMeshToBinaryImageFilter.h>
 //#include <itkRelabelComponentImageFilter.h>
 
 #include <itkCommand.h>
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
 template <typename TPixel, unsigned int VDimensions>
 void SetToZero(itk::Image<TPixel, VDimensions> *source)
 {
   source->FillBuffer(0);
 }
 
-template <unsigned int VImageDimension = 3>
-void CreateLabelMaskProcessing(mitk::Image *layerImage, mitk::Image *mask, mitk::LabelSet::PixelType index)
+namespace
+{
+std::size_t GetNumberOfVoxels(const mitk::Image *image)
+{
+  std::size_t numberOfVoxels = 1;
+  for (unsigned int dim = 0; dim < image->GetDimension(); ++dim)
+    numberOfVoxels *= image->GetDimension(dim);
+  return numberOfVoxels;
+}
+
+void RemapLabels(mitk::Label::PixelType *buffer,
+                 std::size_t numberOfVoxels,
+                 const std::vector<mitk::Label::PixelType> &lookupTable)
+{
+  mitk::ParallelForChunks(numberOfVoxels, [buffer, &lookupTable](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t i = begin; i < end; ++i)
+      buffer[i] = lookupTable[buffer[i]];
+  });
+}
+
+void RemapLabels(mitk::Label::PixelType *buffer,
+                 const unsigned int *dimensions,
+                 const itk::ImageRegion<3> &region,
+                 const std::vector<mitk::Label::PixelType> &lookupTable)
 {
-  mitk::ImagePixelReadAccessor<mitk::LabelSet::PixelType, VImageDimension> readAccessor(layerImage);
-  mitk::ImagePixelWriteAccessor<mitk::LabelSet::PixelType, VImageDimension> writeAccessor(mask);
+  const itk::Index<3> &regionIndex = region.GetIndex();
+  const itk::Size<3> &regionSize = region.GetSize();
+
+  mitk::ParallelForChunks(regionSize[2], [&](std::size_t begin, std::size_t end, std::size_t) {
+    for (std::size_t z = regionIndex[2] + begin; z < regionIndex[2] + end; ++z)
+    {
+      for (std::size_t y = regionIndex[1]; y < regionIndex[1] + regionSize[1]; ++y)
+      {
+        mitk::Label::PixelType *row = buffer + (z * dimensions[1] + y) * dimensions[0];
+        for (std::size_t x = regionIndex[0]; x < regionIndex[0] + regionSize[0]; ++x)
+          row[x] = lookupTable[row[x]];
+      }
+    }
+  });
+}
 
-  std::size_t numberOfPixels = 1;
-  for (int dim = 0; dim < static_cast<int>(VImageDimension); ++dim)
-    numberOfPixels *= static_cast<std::size_t>(readAccessor.GetDimension(dim));
+void FillLabelIndex(const mitk::Label::PixelType *buffer, const unsigned int *dimensions, mitk::LabelIndex &labelIndex)
+{
+  labelIndex.Clear();
 
-  auto src = readAccessor.GetData();
-  auto dest = writeAccessor.GetData();
+  mitk::LabelIndex::IndexType index;
 
-  for (std::size_t i = 0; i < numberOfPixels; ++i)
+  for (unsigned int z = 0; z < dimensions[2]; ++z)
   {
-    if (index == *(src + i))
-      *(dest + i) = 1;
+    index[2] = z;
+    for (unsigned int y = 0; y < dimensions[1]; ++y)
+    {
+      index[1] = y;
+      const mitk::Label::PixelType *row = buffer + (static_cast<std::size_t>(z) * dimensions[1] + y) * dimensions[0];
+
+      unsigned int x = 0;
+      while (x < dimensions[0])
+      {
+        const mitk::Label::PixelType value = row[x];
+        const unsigned int start = x;
+        while (x < dimensions[0] && row[x] == value)
+          ++x;
+
+        index[0] = start;
+        labelIndex.AddRun(value, index, x - start);
+      }
+    }
   }
 }
 
+void FindBoundingBox(const mitk::Label::PixelType *buffer,
+                     const unsigned int *dimensions,
+                     mitk::Label::PixelType value,
+                     const itk::ImageRegion<3> &searchRegion,
+                     mitk::LabelIndex::IndexType &boundingBoxMin,
+                     mitk::LabelIndex::IndexType &boundingBoxMax)
+{
+  boundingBoxMin = searchRegion.GetUpperIndex();
+  boundingBoxMax = searchRegion.GetIndex();
+
+  const itk::Index<3> lower = searchRegion.GetIndex();
+  const itk::Index<3> upper = searchRegion.GetUpperIndex();
+
+  for (auto z = lower[2]; z <= upper[2]; ++z)
+  {
+    for (auto y = lower[1]; y <= upper[1]; ++y)
+    {
+      const mitk::Label::PixelType *row = buffer + (static_cast<std::size_t>(z) * dimensions[1] + y) * dimensions[0];
+      for (auto x = lower[0]; x <= upper[0]; ++x)
+      {
+        if (row[x] != value)
+          continue;
+
+        boundingBoxMin[0] = std::min(boundingBoxMin[0], x);
+        boundingBoxMin[1] = std::min(boundingBoxMin[1], y);
+        boundingBoxMin[2] = std::min(boundingBoxMin[2], z);
+        boundingBoxMax[0] = std::max(boundingBoxMax[0], x);
+        boundingBoxMax[1] = std::max(boundingBoxMax[1], y);
+        boundingBoxMax[2] = std::max(boundingBoxMax[2], z);
+      }
+    }
+  }
+}
+
+bool FindNearestLabelVoxel(const mitk::Label::PixelType *buffer,
+                           const unsigned int *dimensions,
+                           mitk::Label::PixelType value,
+                           const itk::ImageRegion<3> &searchRegion,
+                           const mitk::Point3D &point,
+                           mitk::LabelIndex::IndexType &nearestIndex)
+{
+  itk::ImageRegion<3> imageRegion;
+  imageRegion.SetSize(0, dimensions[0]);
+  imageRegion.SetSize(1, dimensions[1]);
+  imageRegion.SetSize(2, dimensions[2]);
+
+  itk::ImageRegion<3> region = searchRegion;
+  if (!region.Crop(imageRegion))
+    return false;
+
+  const itk::Index<3> lower = region.GetIndex();
+  const itk::Index<3> upper = region.GetUpperIndex();
+  double minDistance = std::numeric_limits<double>::max();
+
+  for (auto z = lower[2]; z <= upper[2]; ++z)
+  {
+    for (auto y = lower[1]; y <= upper[1]; ++y)
+    {
+      const double distanceYZ = (y - point[1]) * (y - point[1]) + (z - point[2]) * (z - point[2]);
+      if (distanceYZ >= minDistance)
+        continue;
+
+      const mitk::Label::PixelType *row = buffer + (static_cast<std::size_t>(z) * dimensions[1] + y) * dimensions[0];
+      for (auto x = lower[0]; x <= upper[0]; ++x)
+      {
+        if (row[x] != value)
+          continue;
+
+        const double distance = distanceYZ + (x - point[0]) * (x - point[0]);
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          nearestIndex[0] = x;
+          nearestIndex[1] = y;
+          nearestIndex[2] = z;
+        }
+      }
+    }
+  }
+
+  return minDistance < std::numeric_limits<double>::max();
+}
+
+bool AccountForSliceDifference(const mitk::Image *originalSlice,
+                               const mitk::Image *modifiedSlice,
+                               const mitk::BaseGeometry *imageGeometry,
+                               const itk::ImageRegion<3> &region,
+                               mitk::LabelIndex &labelIndex)
+{
+  const mitk::PixelType pixelType = mitk::MakeScalarPixelType<mitk::Label::PixelType>();
+
+  if (originalSlice->GetPixelType() != pixelType || modifiedSlice->GetPixelType() != pixelType ||
+      originalSlice->GetDimension(0) != modifiedSlice->GetDimension(0) ||
+      originalSlice->GetDimension(1) != modifiedSlice->GetDimension(1) || originalSlice->GetDimension(2) != 1 ||
+      modifiedSlice->GetDimension(2) != 1)
+    return false;
+
+  // map the first slice pixel and the steps along both slice axes into the image index space
+  const mitk::BaseGeometry *sliceGeometry = originalSlice->GetGeometry();
+
+  mitk::Point3D sliceIndices[3];
+  mitk::FillVector3D(sliceIndices[0], 0.0, 0.0, 0.0);
+  mitk::FillVector3D(sliceIndices[1], 1.0, 0.0, 0.0);
+  mitk::FillVector3D(sliceIndices[2], 0.0, 1.0, 0.0);
+
+  mitk::Point3D imageIndices[3];
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    mitk::Point3D world;
+    sliceGeometry->IndexToWorld(sliceIndices[i], world);
+    imageGeometry->WorldToIndex(world, imageIndices[i]);
+  }
+
+  itk::Index<3> origin;
+  itk::Offset<3> steps[2];
+  unsigned int stepAxes[2];
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    origin[i] = static_cast<itk::IndexValueType>(std::floor(imageIndices[0][i] + 0.5));
+    if (std::abs(imageIndices[0][i] - origin[i]) > 0.25)
+      return false;
+  }
+
+  // every slice axis has to be a unit step along a distinct image axis
+  for (unsigned int axis = 0; axis < 2; ++axis)
+  {
+    unsigned int numberOfUnitSteps = 0;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      const double step = imageIndices[axis + 1][i] - imageIndices[0][i];
+      steps[axis][i] = static_cast<itk::OffsetValueType>(std::floor(step + 0.5));
+
+      if (std::abs(step - steps[axis][i]) > 1e-3 || std::abs(steps[axis][i]) > 1)
+        return false;
+
+      if (0 != steps[axis][i])
+      {
+        stepAxes[axis] = i;
+        ++numberOfUnitSteps;
+      }
+    }
+
+    if (1 != numberOfUnitSteps)
+      return false;
+  }
+
+  if (stepAxes[0] == stepAxes[1])
+    return false;
+
+  mitk::ImageReadAccessor originalAccessor(originalSlice);
+  mitk::ImageReadAccessor modifiedAccessor(modifiedSlice);
+  const auto *originalBuffer = static_cast<const mitk::Label::PixelType *>(originalAccessor.GetData());
+  const auto *modifiedBuffer = static_cast<const mitk::Label::PixelType *>(modifiedAccessor.GetData());
+
+  const unsigned int sliceSize[2] = {originalSlice->GetDimension(0), originalSlice->GetDimension(1)};
+  const itk::Index<3> lower = region.GetIndex();
+  const itk::Index<3> upper = region.GetUpperIndex();
+
+  // only the slice pixels mapped into region are compared, the others are not written or not changed
+  const unsigned int normalAxis = 3 - stepAxes[0] - stepAxes[1];
+  if (origin[normalAxis] < lower[normalAxis] || origin[normalAxis] > upper[normalAxis])
+    return true;
+
+  itk::IndexValueType begin[2];
+  itk::IndexValueType end[2];
+  for (unsigned int axis = 0; axis < 2; ++axis)
+  {
+    // pixel p is mapped to origin + step * p with a step of 1 or -1
+    const unsigned int dim = stepAxes[axis];
+    const itk::IndexValueType toLower = (lower[dim] - origin[dim]) * steps[axis][dim];
+    const itk::IndexValueType toUpper = (upper[dim] - origin[dim]) * steps[axis][dim];
+    begin[axis] = std::max<itk::IndexValueType>(0, std::min(toLower, toUpper));
+    end[axis] = std::min<itk::IndexValueType>(sliceSize[axis], std::max(toLower, toUpper) + 1);
+  }
+
+  for (auto y = begin[1]; y < end[1]; ++y)
+  {
+    for (auto x = begin[0]; x < end[0]; ++x)
+    {
+      const std::size_t i = static_cast<std::size_t>(y) * sliceSize[0] + x;
+      if (originalBuffer[i] == modifiedBuffer[i])
+        continue;
+
+      itk::Index<3> index;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+        index[dim] = origin[dim] + steps[0][dim] * x + steps[1][dim] * y;
+
+      labelIndex.ChangeVoxel(originalBuffer[i], modifiedBuffer[i], index);
+    }
+  }
+
+  return true;
+}
+
+void CreateLabelMask(const mitk::Label::PixelType *labelBuffer,
+                     mitk::Label::PixelType *maskBuffer,
+                     const unsigned int *dimensions,
+                     const itk::ImageRegion<3> &boundingBox,
+                     mitk::Label::PixelType pixelValue)
+{
+  const itk::Index<3> lower = boundingBox.GetIndex();
+  const itk::Index<3> upper = boundingBox.GetUpperIndex();
+
+  for (auto z = lower[2]; z <= upper[2]; ++z)
+  {
+    for (auto y = lower[1]; y <= upper[1]; ++y)
+    {
+      const std::size_t rowOffset = (static_cast<std::size_t>(z) * dimensions[1] + y) * dimensions[0];
+      for (auto x = lower[0]; x <= upper[0]; ++x)
+      {
+        if (pixelValue == labelBuffer[rowOffset + x])
+          maskBuffer[rowOffset + x] = 1;
+      }
+    }
+  }
+}
+} // namespace
+
 mitk::LabelSetImage::LabelSetImage()
   : mitk::Image(), m_ActiveLayer(0), m_activeLayerInvalid(false), m_ExteriorLabel(nullptr)
 {
@@ -97,9 +376,12 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
     lsClone->AddObserver(itk::ModifiedEvent(), command);
     m_LabelSetContainer.push_back(lsClone);
 
-    // clone layer Image data
-    mitk::Image::Pointer liClone = other.GetLayerImage(i)->Clone();
+    // clone layer data, the data of the active layer is part of the cloned working image
+    mitk::Image::Pointer liClone;
+    if (other.m_LayerContainer[i].IsNotNull())
+      liClone = other.m_LayerContainer[i]->Clone();
     m_LayerContainer.push_back(liClone);
+    m_SparseLayerContainer.push_back(other.m_SparseLayerContainer[i]);
   }
 
   // Add some DICOM Tags as properties to segmentation image
@@ -108,7 +390,13 @@ mitk::LabelSetImage::LabelSetImage(const mitk::LabelSetImage &other)
 
 void mitk::LabelSetImage::OnLabelSetModified()
 {
+  // label properties do not affect the image data, the label index stays valid
+  const bool labelIndexUpToDate = this->IsLabelIndexUpToDate();
+
   Superclass::Modified();
+
+  if (labelIndexUpToDate)
+    m_LabelIndexTime.Modified();
 }
 
 void mitk::LabelSetImage::SetExteriorLabel(mitk::Label *label)
@@ -166,12 +454,143 @@ mitk::LabelSetImage::~LabelSetImage()
 
 mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer)
 {
+  if (layer == this->GetActiveLayer())
+    return this;
+
+  std::lock_guard<std::mutex> lock(m_LayerMutex);
+  if (m_LayerContainer[layer].IsNull())
+  {
+    // the decoded image replaces the run-length encoded data, as it might be modified by the caller
+    m_LayerContainer[layer] = this->InternalCreateLayerImage(layer);
+    m_SparseLayerContainer[layer].Clear();
+  }
+
   return m_LayerContainer[layer];
 }
 
-const mitk::Image *mitk::LabelSetImage::GetLayerImage(unsigned int layer) const
+mitk::Image::ConstPointer mitk::LabelSetImage::GetLayerImage(unsigned int layer) const
 {
-  return m_LayerContainer[layer];
+  if (layer == this->GetActiveLayer())
+    return this;
+
+  std::lock_guard<std::mutex> lock(m_LayerMutex);
+  if (m_LayerContainer[layer].IsNotNull())
+    return m_LayerContainer[layer].GetPointer();
+
+  // reading must not change the way the layer is stored, so encoded layers are decoded into a temporary image
+  return this->InternalCreateLayerImage(layer).GetPointer();
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::CreateLayerImage(unsigned int layer) const
+{
+  std::lock_guard<std::mutex> lock(m_LayerMutex);
+  return this->InternalCreateLayerImage(layer);
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::InternalCreateLayerImage(unsigned int layer) const
+{
+  if (layer != this->GetActiveLayer() && m_LayerContainer[layer].IsNotNull())
+    return m_LayerContainer[layer]->Clone();
+
+  mitk::Image::Pointer layerImage = this->CreateEmptyLayerImage();
+  ImageWriteAccessor writeAccessor(layerImage);
+
+  if (layer == this->GetActiveLayer())
+  {
+    ImageReadAccessor readAccessor(this);
+    memcpy(writeAccessor.GetData(), readAccessor.GetData(), ::GetNumberOfVoxels(this) * sizeof(PixelType));
+  }
+  else
+  {
+    m_SparseLayerContainer[layer].Decode(static_cast<PixelType *>(writeAccessor.GetData()));
+  }
+
+  return layerImage;
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::CreateLayerSliceImage(unsigned int layer,
+                                                                unsigned int sliceDimension,
+                                                                unsigned int sliceIndex,
+                                                                unsigned int timeStep,
+                                                                mitk::Image *sliceImage) const
+{
+  std::lock_guard<std::mutex> lock(m_LayerMutex);
+  if (layer == this->GetActiveLayer() || layer >= m_LayerContainer.size() || m_LayerContainer[layer].IsNotNull() ||
+      sliceDimension > 2)
+    return nullptr;
+
+  unsigned int dimensions[3] = {this->GetDimension(0), this->GetDimension(1), this->GetDimension(2)};
+  dimensions[sliceDimension] = 1;
+
+  // the buffer of a previous slice image of the same size is reused
+  mitk::Image::Pointer result = sliceImage;
+  if (result.IsNull() || result->GetDimension() != 3 || result->GetPixelType() != this->GetPixelType() ||
+      result->GetDimension(0) != dimensions[0] || result->GetDimension(1) != dimensions[1] ||
+      result->GetDimension(2) != dimensions[2])
+  {
+    result = mitk::Image::New();
+    result->Initialize(this->GetPixelType(), 3, dimensions);
+  }
+
+  // position the slice image like the corresponding region of the layer image
+  const mitk::SlicedGeometry3D *layerGeometry = this->GetSlicedGeometry(timeStep);
+
+  mitk::Point3D origin;
+  origin.Fill(0.0);
+  origin[sliceDimension] = sliceIndex;
+  layerGeometry->IndexToWorld(origin, origin);
+
+  mitk::PlaneGeometry::Pointer plane = layerGeometry->GetPlaneGeometry(0)->Clone();
+  mitk::Vector3D right = plane->GetAxisVector(0);
+  mitk::Vector3D down = plane->GetAxisVector(1);
+  mitk::Vector3D spacing = plane->GetSpacing();
+  plane->InitializeStandardPlane(dimensions[0], dimensions[1], right, down, &spacing);
+  plane->SetOrigin(origin);
+
+  mitk::SlicedGeometry3D *slicedGeometry = result->GetSlicedGeometry();
+  slicedGeometry->InitializeEvenlySpaced(plane, layerGeometry->GetSpacing()[2], dimensions[2]);
+
+  auto *timeGeometry = dynamic_cast<mitk::ProportionalTimeGeometry *>(result->GetTimeGeometry());
+  if (timeGeometry != nullptr)
+    timeGeometry->Initialize(slicedGeometry, 1);
+
+  {
+    ImageWriteAccessor accessor(result);
+    m_SparseLayerContainer[layer].DecodeSlice(
+      sliceDimension, sliceIndex, timeStep, static_cast<PixelType *>(accessor.GetData()));
+  }
+  result->Modified();
+
+  return result;
+}
+
+bool mitk::LabelSetImage::IsLayerRunLengthEncoded(unsigned int layer) const
+{
+  std::lock_guard<std::mutex> lock(m_LayerMutex);
+  return layer != this->GetActiveLayer() && layer < m_LayerContainer.size() && m_LayerContainer[layer].IsNull();
+}
+
+unsigned long mitk::LabelSetImage::GetLayerMTime(unsigned int layer) const
+{
+  if (layer == this->GetActiveLayer())
+    return this->GetMTime();
+
+  std::lock_guard<std::mutex> lock(m_LayerMutex);
+  if (m_LayerContainer[layer].IsNotNull())
+    return m_LayerContainer[layer]->GetMTime();
+
+  return m_SparseLayerContainer[layer].GetMTime();
+}
+
+mitk::Image::Pointer mitk::LabelSetImage::CreateEmptyLayerImage() const
+{
+  mitk::Image::Pointer newImage = mitk::Image::New();
+  newImage->Initialize(this->GetPixelType(),
+                       this->GetDimension(),
+                       this->GetDimensions(),
+                       this->GetImageDescriptor()->GetNumberOfChannels());
+  newImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
+  return newImage;
 }
 
 unsigned int mitk::LabelSetImage::GetActiveLayer() const
@@ -204,6 +623,7 @@ void mitk::LabelSetImage::RemoveLayer()
   // remove labelset and image data
   m_LabelSetContainer.erase(m_LabelSetContainer.begin() + layerToDelete);
   m_LayerContainer.erase(m_LayerContainer.begin() + layerToDelete);
+  m_SparseLayerContainer.erase(m_SparseLayerContainer.begin() + layerToDelete);
 
   if (layerToDelete == 0)
   {
@@ -215,23 +635,8 @@ void mitk::LabelSetImage::RemoveLayer()
 
 unsigned int mitk::LabelSetImage::AddLayer(mitk::LabelSet::Pointer lset)
 {
-  mitk::Image::Pointer newImage = mitk::Image::New();
-  newImage->Initialize(this->GetPixelType(),
-                       this->GetDimension(),
-                       this->GetDimensions(),
-                       this->GetImageDescriptor()->GetNumberOfChannels());
-  newImage->SetTimeGeometry(this->GetTimeGeometry()->Clone());
-
-  if (newImage->GetDimension() < 4)
-  {
-    AccessByItk(newImage, SetToZero);
-  }
-  else
-  {
-    AccessFixedDimensionByItk(newImage, SetToZero, 4);
-  }
-
-  unsigned int newLabelSetId = this->AddLayer(newImage, lset);
+  // an empty layer is an empty run-length encoded layer, no image memory is needed
+  unsigned int newLabelSetId = this->AddLayer(mitk::Image::Pointer(), lset);
 
   return newLabelSetId;
 }
@@ -257,8 +662,23 @@ unsigned int mitk::LabelSetImage::AddLayer(mitk::Image::Pointer layerImage, mitk
   // Add exterior Label to label set
   // mitk::Label::Pointer exteriorLabel = CreateExteriorLabel();
 
-  // push a new working image for the new layer
+  // push a new working image for the new layer, images matching the working image are run-length encoded
+  mitk::SparseLabelLayer sparseLayer;
+  sparseLayer.Initialize(this->GetDimension(), this->GetDimensions());
+
+  bool matchesWorkingImage = layerImage.IsNotNull() && layerImage->GetPixelType() == this->GetPixelType();
+  for (unsigned int dim = 0; dim < 4 && matchesWorkingImage; ++dim)
+    matchesWorkingImage = layerImage->GetDimension(dim) == this->GetDimension(dim);
+
+  if (matchesWorkingImage)
+  {
+    ImageReadAccessor accessor(layerImage);
+    sparseLayer.Encode(static_cast<const PixelType *>(accessor.GetData()));
+    layerImage = nullptr;
+  }
+
   m_LayerContainer.push_back(layerImage);
+  m_SparseLayerContainer.push_back(sparseLayer);
 
   // push a new labelset for the new layer
   m_LabelSetContainer.push_back(ls);
@@ -303,47 +723,23 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
 {
   try
   {
-    if (4 == this->GetDimension())
+    if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
     {
-      if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
-      {
-        BeforeChangeLayerEvent.Send();
+      BeforeChangeLayerEvent.Send();
 
-        if (m_activeLayerInvalid)
-        {
-          // We should not write the invalid layer back to the vector
-          m_activeLayerInvalid = false;
-        }
-        else
-        {
-          AccessFixedDimensionByItk_n(this, ImageToLayerContainerProcessing, 4, (GetActiveLayer()));
-        }
-        m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessFixedDimensionByItk_n(this, LayerContainerToImageProcessing, 4, (GetActiveLayer()));
-
-        AfterChangeLayerEvent.Send();
+      if (m_activeLayerInvalid)
+      {
+        // We should not write the invalid layer back to the vector
+        m_activeLayerInvalid = false;
       }
-    }
-    else
-    {
-      if ((layer != GetActiveLayer() || m_activeLayerInvalid) && (layer < this->GetNumberOfLayers()))
+      else
       {
-        BeforeChangeLayerEvent.Send();
-
-        if (m_activeLayerInvalid)
-        {
-          // We should not write the invalid layer back to the vector
-          m_activeLayerInvalid = false;
-        }
-        else
-        {
-          AccessByItk_1(this, ImageToLayerContainerProcessing, GetActiveLayer());
-        }
-        m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
-        AccessByItk_1(this, LayerContainerToImageProcessing, GetActiveLayer());
-
-        AfterChangeLayerEvent.Send();
+        this->ImageToLayerContainer(GetActiveLayer());
       }
+      m_ActiveLayer = layer; // only at this place m_ActiveLayer should be manipulated!!! Use Getter and Setter
+      this->LayerContainerToImage(GetActiveLayer());
+
+      AfterChangeLayerEvent.Send();
     }
   }
   catch (itk::ExceptionObject &e)
@@ -353,6 +749,37 @@ void mitk::LabelSetImage::SetActiveLayer(unsigned int layer)
   this->Modified();
 }
 
+void mitk::LabelSetImage::ImageToLayerContainer(unsigned int layer)
+{
+  ImageReadAccessor accessor(this);
+  m_SparseLayerContainer[layer].Encode(static_cast<const PixelType *>(accessor.GetData()));
+  m_LayerContainer[layer] = nullptr;
+}
+
+void mitk::LabelSetImage::LayerContainerToImage(unsigned int layer)
+{
+  if (m_LayerContainer[layer].IsNotNull())
+  {
+    if (4 == this->GetDimension())
+    {
+      AccessFixedDimensionByItk_n(this, LayerContainerToImageProcessing, 4, (layer));
+    }
+    else
+    {
+      AccessByItk_1(this, LayerContainerToImageProcessing, layer);
+    }
+    m_LayerContainer[layer] = nullptr;
+  }
+  else
+  {
+    ImageWriteAccessor accessor(this);
+    m_SparseLayerContainer[layer].Decode(static_cast<PixelType *>(accessor.GetData()));
+  }
+
+  // the data of the active layer is kept in the working image only
+  m_SparseLayerContainer[layer].Clear();
+}
+
 void mitk::LabelSetImage::Concatenate(mitk::LabelSetImage *other)
 {
   const unsigned int *otherDims = other->GetDimensions();
@@ -420,33 +847,101 @@ bool mitk::LabelSetImage::ExistLabelSet(unsigned int layer) const
 
 void mitk::LabelSetImage::MergeLabel(PixelType pixelValue, PixelType sourcePixelValue, unsigned int layer)
 {
-  try
-  {
-    AccessByItk_2(this, MergeLabelProcessing, pixelValue, sourcePixelValue);
-  }
-  catch (itk::ExceptionObject &e)
-  {
-    mitkThrow() << e.GetDescription();
-  }
-  GetLabelSet(layer)->SetActiveLabel(pixelValue);
-  Modified();
+  std::vector<PixelType> sourcePixelValues(1, sourcePixelValue);
+  this->MergeLabels(pixelValue, sourcePixelValues, layer);
 }
 
 void mitk::LabelSetImage::MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer)
 {
-  try
+  std::map<PixelType, PixelType> labelMapping;
+  for (auto sourcePixelValue : vectorOfSourcePixelValues)
+    labelMapping[sourcePixelValue] = pixelValue;
+
+  this->RemapLabels(labelMapping, layer);
+  GetLabelSet(layer)->SetActiveLabel(pixelValue);
+}
+
+void mitk::LabelSetImage::RemapLabels(const std::map<PixelType, PixelType> &labelMapping, unsigned int layer)
+{
+  if (layer >= this->GetNumberOfLayers())
+    mitkThrow() << "Cannot remap labels of non-existing layer " << layer << ".";
+
+  if (labelMapping.empty())
+    return;
+
+  std::vector<PixelType> lookupTable(static_cast<std::size_t>(std::numeric_limits<PixelType>::max()) + 1);
+  std::iota(lookupTable.begin(), lookupTable.end(), 0);
+
+  for (const auto &mapping : labelMapping)
+    lookupTable[mapping.first] = mapping.second;
+
+  bool labelIndexUpdated = false;
+  std::unique_lock<std::mutex> lock(m_LabelIndexMutex);
+
+  if (layer != this->GetActiveLayer() && m_LayerContainer[layer].IsNull())
   {
-    for (unsigned int idx = 0; idx < vectorOfSourcePixelValues.size(); idx++)
+    std::lock_guard<std::mutex> layerLock(m_LayerMutex);
+    m_SparseLayerContainer[layer].RemapLabels(lookupTable);
+  }
+  else if (layer == this->GetActiveLayer() && 0 == lookupTable[0] && this->IsLabelIndexUpToDate())
+  {
+    // only the bounding boxes of the changed labels have to be visited
+    const unsigned int dimensions[] = {this->GetDimension(0), this->GetDimension(1), this->GetDimension(2)};
+    const std::size_t numberOfVoxels = static_cast<std::size_t>(dimensions[0]) * dimensions[1] * dimensions[2];
+
+    ImageWriteAccessor accessor(this);
+    auto *buffer = static_cast<PixelType *>(accessor.GetData());
+
+    for (std::size_t timeStep = 0; timeStep < m_LabelIndices.size(); ++timeStep)
     {
-      AccessByItk_2(this, MergeLabelProcessing, pixelValue, vectorOfSourcePixelValues[idx]);
+      LabelIndex &labelIndex = m_LabelIndices[timeStep];
+      LabelIndex::Entry changedLabels;
+
+      for (const auto &mapping : labelMapping)
+      {
+        const LabelIndex::Entry *entry = labelIndex.GetEntry(mapping.first);
+        if (mapping.first == mapping.second || nullptr == entry)
+          continue;
+
+        if (0 == changedLabels.numberOfVoxels)
+        {
+          changedLabels.boundingBoxMin = entry->boundingBoxMin;
+          changedLabels.boundingBoxMax = entry->boundingBoxMax;
+        }
+
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          changedLabels.boundingBoxMin[i] = std::min(changedLabels.boundingBoxMin[i], entry->boundingBoxMin[i]);
+          changedLabels.boundingBoxMax[i] = std::max(changedLabels.boundingBoxMax[i], entry->boundingBoxMax[i]);
+        }
+        changedLabels.numberOfVoxels += entry->numberOfVoxels;
+      }
+
+      if (0 != changedLabels.numberOfVoxels)
+        ::RemapLabels(buffer + timeStep * numberOfVoxels, dimensions, changedLabels.GetBoundingBox(), lookupTable);
+
+      labelIndex.RemapLabels(lookupTable);
     }
+
+    labelIndexUpdated = true;
   }
-  catch (itk::ExceptionObject &e)
+  else
   {
-    mitkThrow() << e.GetDescription();
+    mitk::Image *layerImage = layer == this->GetActiveLayer() ? this : m_LayerContainer[layer].GetPointer();
+
+    if (layerImage->GetPixelType() != this->GetPixelType())
+      mitkThrow() << "Cannot remap labels of layer " << layer << " with a pixel type other than the label pixel type.";
+
+    ImageWriteAccessor accessor(layerImage);
+    ::RemapLabels(static_cast<PixelType *>(accessor.GetData()), ::GetNumberOfVoxels(layerImage), lookupTable);
   }
-  GetLabelSet(layer)->SetActiveLabel(pixelValue);
-  Modified();
+
+  lock.unlock();
+
+  this->Modified();
+
+  if (labelIndexUpdated)
+    m_LabelIndexTime.Modified();
 }
 
 void mitk::LabelSetImage::RemoveLabels(std::vector<PixelType> &VectorOfLabelPixelValues, unsigned int layer)
@@ -454,29 +949,23 @@ void mitk::LabelSetImage::RemoveLabels(std::vector<PixelType> &VectorOfLabelPixe
   for (unsigned int idx = 0; idx < VectorOfLabelPixelValues.size(); idx++)
   {
     GetLabelSet(layer)->RemoveLabel(VectorOfLabelPixelValues[idx]);
-    EraseLabel(VectorOfLabelPixelValues[idx], layer);
   }
+  this->EraseLabels(VectorOfLabelPixelValues, layer);
 }
 
 void mitk::LabelSetImage::EraseLabels(std::vector<PixelType> &VectorOfLabelPixelValues, unsigned int layer)
 {
-  for (unsigned int i = 0; i < VectorOfLabelPixelValues.size(); i++)
-  {
-    this->EraseLabel(VectorOfLabelPixelValues[i], layer);
-  }
+  std::map<PixelType, PixelType> labelMapping;
+  for (auto pixelValue : VectorOfLabelPixelValues)
+    labelMapping[pixelValue] = 0;
+
+  this->RemapLabels(labelMapping, layer);
 }
 
 void mitk::LabelSetImage::EraseLabel(PixelType pixelValue, unsigned int layer)
 {
-  try
-  {
-    AccessByItk_2(this, EraseLabelProcessing, pixelValue, layer);
-  }
-  catch (itk::ExceptionObject &e)
-  {
-    mitkThrow() << e.GetDescription();
-  }
-  Modified();
+  std::vector<PixelType> pixelValues(1, pixelValue);
+  this->EraseLabels(pixelValues, layer);
 }
 
 mitk::Label *mitk::LabelSetImage::GetActiveLabel(unsigned int layer)
@@ -521,14 +1010,220 @@ mitk::LabelSet *mitk::LabelSetImage::GetActiveLabelSet()
 
 void mitk::LabelSetImage::UpdateCenterOfMass(PixelType pixelValue, unsigned int layer)
 {
-  if (4 == this->GetDimension())
+  mitk::Label *label = this->GetLabel(pixelValue, layer);
+  if (nullptr == label)
+    return;
+
+  mitk::Point3D pos;
+  pos.Fill(0.0);
+
+  {
+    std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+
+    LabelIndex inactiveLayerIndex;
+    const LabelIndex::Entry *entry = this->GetLabelIndex(layer, 0, inactiveLayerIndex).GetEntry(pixelValue);
+
+    // the centroid of a non-convex or disconnected label may lie outside of it, the nearest label voxel is used
+    LabelIndex::IndexType nearestIndex;
+    bool found = false;
+
+    if (nullptr != entry)
+    {
+      const unsigned int dimensions[] = {this->GetDimension(0), this->GetDimension(1), this->GetDimension(2)};
+
+      if (layer == this->GetActiveLayer())
+      {
+        ImageReadAccessor accessor(this);
+        found = ::FindNearestLabelVoxel(static_cast<const PixelType *>(accessor.GetData()),
+                                        dimensions,
+                                        pixelValue,
+                                        entry->GetBoundingBox(),
+                                        entry->GetCentroid(),
+                                        nearestIndex);
+      }
+      else
+      {
+        std::lock_guard<std::mutex> layerLock(m_LayerMutex);
+
+        if (m_LayerContainer[layer].IsNull())
+        {
+          found = m_SparseLayerContainer[layer].FindNearestVoxel(
+            pixelValue, 0, entry->GetBoundingBox(), entry->GetCentroid(), nearestIndex);
+        }
+        else
+        {
+          ImageReadAccessor accessor(m_LayerContainer[layer].GetPointer());
+          found = ::FindNearestLabelVoxel(static_cast<const PixelType *>(accessor.GetData()),
+                                          dimensions,
+                                          pixelValue,
+                                          entry->GetBoundingBox(),
+                                          entry->GetCentroid(),
+                                          nearestIndex);
+        }
+      }
+    }
+
+    if (found)
+    {
+      for (unsigned int i = 0; i < 3; ++i)
+        pos[i] = nearestIndex[i];
+    }
+  }
+
+  label->SetCenterOfMassIndex(pos);
+  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
+  label->SetCenterOfMassCoordinates(pos);
+}
+
+std::size_t mitk::LabelSetImage::GetNumberOfLabelVoxels(PixelType pixelValue,
+                                                        unsigned int layer,
+                                                        unsigned int timeStep) const
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+
+  LabelIndex inactiveLayerIndex;
+  const LabelIndex::Entry *entry = this->GetLabelIndex(layer, timeStep, inactiveLayerIndex).GetEntry(pixelValue);
+
+  return nullptr != entry ? entry->numberOfVoxels : 0;
+}
+
+bool mitk::LabelSetImage::GetLabelBoundingBox(PixelType pixelValue,
+                                              itk::ImageRegion<3> &boundingBox,
+                                              unsigned int layer,
+                                              unsigned int timeStep) const
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+
+  LabelIndex inactiveLayerIndex;
+  const LabelIndex::Entry *entry = this->GetLabelIndex(layer, timeStep, inactiveLayerIndex).GetEntry(pixelValue);
+
+  if (nullptr == entry)
+    return false;
+
+  if (!entry->boundingBoxIsTight)
   {
-    AccessFixedDimensionByItk_2(this, CalculateCenterOfMassProcessing, 4, pixelValue, layer);
+    // only the index of the active layer is updated incrementally, shrink its box by scanning the enclosing box
+    const unsigned int dimensions[] = {this->GetDimension(0), this->GetDimension(1), this->GetDimension(2)};
+    const std::size_t numberOfVoxels = static_cast<std::size_t>(dimensions[0]) * dimensions[1] * dimensions[2];
+
+    ImageReadAccessor accessor(this);
+    LabelIndex::IndexType boundingBoxMin;
+    LabelIndex::IndexType boundingBoxMax;
+    ::FindBoundingBox(static_cast<const PixelType *>(accessor.GetData()) + timeStep * numberOfVoxels,
+                      dimensions,
+                      pixelValue,
+                      entry->GetBoundingBox(),
+                      boundingBoxMin,
+                      boundingBoxMax);
+
+    m_LabelIndices[timeStep].SetTightBoundingBox(pixelValue, boundingBoxMin, boundingBoxMax);
+  }
+
+  boundingBox = entry->GetBoundingBox();
+  return true;
+}
+
+bool mitk::LabelSetImage::GetLabelCentroid(PixelType pixelValue,
+                                           mitk::Point3D &centroid,
+                                           unsigned int layer,
+                                           unsigned int timeStep) const
+{
+  std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+
+  LabelIndex inactiveLayerIndex;
+  const LabelIndex::Entry *entry = this->GetLabelIndex(layer, timeStep, inactiveLayerIndex).GetEntry(pixelValue);
+
+  if (nullptr == entry)
+    return false;
+
+  centroid = entry->GetCentroid();
+  return true;
+}
+
+void mitk::LabelSetImage::UpdateLabelIndex(const mitk::Image *originalSlice,
+                                           const mitk::Image *modifiedSlice,
+                                           unsigned int timeStep,
+                                           const itk::ImageRegion<3> *changedRegion)
+{
+  bool labelIndexUpdated = false;
+
+  if (nullptr != originalSlice && nullptr != modifiedSlice)
+  {
+    std::lock_guard<std::mutex> lock(m_LabelIndexMutex);
+
+    if (this->IsLabelIndexUpToDate() && timeStep < m_LabelIndices.size())
+    {
+      itk::ImageRegion<3> region;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+        region.SetSize(dim, this->GetDimension(dim));
+
+      // a changed region outside of the image leaves the index as it is
+      labelIndexUpdated = (changedRegion != nullptr && !region.Crop(*changedRegion)) ||
+                          ::AccountForSliceDifference(
+                            originalSlice, modifiedSlice, this->GetGeometry(timeStep), region, m_LabelIndices[timeStep]);
+    }
+  }
+
+  this->Modified();
+
+  if (labelIndexUpdated)
+    m_LabelIndexTime.Modified();
+}
+
+bool mitk::LabelSetImage::IsLabelIndexUpToDate() const
+{
+  // the modification time of the geometry is not taken into account, it does not affect the index
+  return !m_LabelIndices.empty() && m_LabelIndexTime.GetMTime() > this->itk::Object::GetMTime();
+}
+
+const mitk::LabelIndex &mitk::LabelSetImage::GetLabelIndex(unsigned int layer,
+                                                           unsigned int timeStep,
+                                                           LabelIndex &inactiveLayerIndex) const
+{
+  if (layer >= this->GetNumberOfLayers())
+    mitkThrow() << "Layer " << layer << " does not exist.";
+
+  if (timeStep >= this->GetDimension(3))
+    mitkThrow() << "Time step " << timeStep << " does not exist.";
+
+  const unsigned int dimensions[] = {this->GetDimension(0), this->GetDimension(1), this->GetDimension(2)};
+  const std::size_t numberOfVoxels = static_cast<std::size_t>(dimensions[0]) * dimensions[1] * dimensions[2];
+
+  if (layer == this->GetActiveLayer())
+  {
+    if (!this->IsLabelIndexUpToDate())
+    {
+      m_LabelIndices.assign(this->GetDimension(3), LabelIndex());
+
+      ImageReadAccessor accessor(this);
+      const auto *buffer = static_cast<const PixelType *>(accessor.GetData());
+
+      for (std::size_t t = 0; t < m_LabelIndices.size(); ++t)
+        ::FillLabelIndex(buffer + t * numberOfVoxels, dimensions, m_LabelIndices[t]);
+
+      m_LabelIndexTime.Modified();
+    }
+
+    return m_LabelIndices[timeStep];
+  }
+
+  std::lock_guard<std::mutex> layerLock(m_LayerMutex);
+
+  if (m_LayerContainer[layer].IsNull())
+  {
+    m_SparseLayerContainer[layer].FillLabelIndex(timeStep, inactiveLayerIndex);
   }
   else
   {
-    AccessByItk_2(this, CalculateCenterOfMassProcessing, pixelValue, layer);
+    if (m_LayerContainer[layer]->GetPixelType() != this->GetPixelType())
+      mitkThrow() << "Cannot index layer " << layer << " with a pixel type other than the label pixel type.";
+
+    ImageReadAccessor accessor(m_LayerContainer[layer].GetPointer());
+    ::FillLabelIndex(
+      static_cast<const PixelType *>(accessor.GetData()) + timeStep * numberOfVoxels, dimensions, inactiveLayerIndex);
   }
+
+  return inactiveLayerIndex;
 }
 
 unsigned int mitk::LabelSetImage::GetNumberOfLabels(unsigned int layer) const
@@ -593,17 +1288,28 @@ mitk::Image::Pointer mitk::LabelSetImage::CreateLabelMask(PixelType index, bool
     if (!useActiveLayer)
       this->SetActiveLayer(layer);
 
-    if (4 == this->GetDimension())
-    {
-      ::CreateLabelMaskProcessing<4>(this, mask, index);
-    }
-    else if (3 == this->GetDimension())
-    {
-      ::CreateLabelMaskProcessing(this, mask, index);
-    }
-    else
-    {
+    if (this->GetDimension() < 3)
       mitkThrow();
+
+    // only the bounding box of the label has to be visited
+    std::vector<itk::ImageRegion<3>> boundingBoxes(this->GetDimension(3));
+    std::vector<bool> hasVoxels(boundingBoxes.size());
+    for (unsigned int timeStep = 0; timeStep < boundingBoxes.size(); ++timeStep)
+      hasVoxels[timeStep] = this->GetLabelBoundingBox(index, boundingBoxes[timeStep], this->GetActiveLayer(), timeStep);
+
+    const unsigned int dimensions[] = {this->GetDimension(0), this->GetDimension(1), this->GetDimension(2)};
+    const std::size_t numberOfVoxels = static_cast<std::size_t>(dimensions[0]) * dimensions[1] * dimensions[2];
+
+    ImageReadAccessor readAccessor(this);
+    ImageWriteAccessor writeAccessor(mask);
+    const auto *src = static_cast<const PixelType *>(readAccessor.GetData());
+    auto *dest = static_cast<PixelType *>(writeAccessor.GetData());
+
+    for (unsigned int timeStep = 0; timeStep < boundingBoxes.size(); ++timeStep)
+    {
+      if (hasVoxels[timeStep])
+        ::CreateLabelMask(
+          src + timeStep * numberOfVoxels, dest + timeStep * numberOfVoxels, dimensions, boundingBoxes[timeStep], index);
     }
   }
   catch (...)
@@ -717,7 +1423,7 @@ void mitk::LabelSetImage::MaskStampProcessing(ImageType *itkImage, mitk::Image *
   mitk::CastToItkImage(mask, itkMask);
 
   typedef itk::ImageRegionConstIterator<ImageType> SourceIteratorType;
-  typedef itk::ImageRegionIterator<ImageType> TargetIteratorType;
+  typedef itk::ImageRegionIteratorWithIndex<ImageType> TargetIteratorType;
 
   SourceIteratorType sourceIter(itkMask, itkMask->GetLargestPossibleRegion());
   sourceIter.GoToBegin();
@@ -725,7 +1431,13 @@ void mitk::LabelSetImage::MaskStampProcessing(ImageType *itkImage, mitk::Image *
   TargetIteratorType targetIter(itkImage, itkImage->GetLargestPossibleRegion());
   targetIter.GoToBegin();
 
-  int activeLabel = this->GetActiveLabel(GetActiveLayer())->GetValue();
+  auto activeLabel = static_cast<PixelType>(this->GetActiveLabel(GetActiveLayer())->GetValue());
+
+  // stamped voxels are accounted for in the label index instead of invalidating it
+  std::unique_lock<std::mutex> lock(m_LabelIndexMutex);
+  const bool labelIndexUpToDate = this->IsLabelIndexUpToDate();
+  LabelIndex::IndexType index;
+  index.Fill(0);
 
   while (!sourceIter.IsAtEnd())
   {
@@ -735,55 +1447,25 @@ void mitk::LabelSetImage::MaskStampProcessing(ImageType *itkImage, mitk::Image *
     if ((sourceValue != 0) &&
         (forceOverwrite || !this->GetLabel(targetValue)->GetLocked())) // skip exterior and locked labels
     {
+      if (labelIndexUpToDate)
+      {
+        for (unsigned int dim = 0; dim < ImageType::ImageDimension && dim < 3; ++dim)
+          index[dim] = targetIter.GetIndex()[dim];
+        m_LabelIndices[0].ChangeVoxel(targetValue, activeLabel, index);
+      }
+
       targetIter.Set(activeLabel);
     }
     ++sourceIter;
     ++targetIter;
   }
 
-  this->Modified();
-}
-
-template <typename ImageType>
-void mitk::LabelSetImage::CalculateCenterOfMassProcessing(ImageType *itkImage, PixelType pixelValue, unsigned int layer)
-{
-  // for now, we just retrieve the voxel in the middle
-  typedef itk::ImageRegionConstIterator<ImageType> IteratorType;
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
-
-  std::vector<typename ImageType::IndexType> indexVector;
-
-  while (!iter.IsAtEnd())
-  {
-    // TODO fix comparison warning more effective
-    if (iter.Get() == pixelValue)
-    {
-      indexVector.push_back(iter.GetIndex());
-    }
-    ++iter;
-  }
-
-  mitk::Point3D pos;
-  pos.Fill(0.0);
+  lock.unlock();
 
-  if (!indexVector.empty())
-  {
-    typename itk::ImageRegionConstIteratorWithIndex<ImageType>::IndexType centerIndex;
-    centerIndex = indexVector.at(indexVector.size() / 2);
-    if (centerIndex.GetIndexDimension() == 3)
-    {
-      pos[0] = centerIndex[0];
-      pos[1] = centerIndex[1];
-      pos[2] = centerIndex[2];
-    }
-    else
-      return;
-  }
+  this->Modified();
 
-  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassIndex(pos);
-  this->GetSlicedGeometry()->IndexToWorld(pos, pos); // TODO: TimeGeometry?
-  GetLabelSet(layer)->GetLabel(pixelValue)->SetCenterOfMassCoordinates(pos);
+  if (labelIndexUpToDate)
+    m_LabelIndexTime.Modified();
 }
 
 template <typename ImageType>
@@ -847,70 +1529,6 @@ void mitk::LabelSetImage::LayerContainerToImageProcessing(itk::Image<TPixel, VIm
   }
 }
 
-template <typename TPixel, unsigned int VImageDimension>
-void mitk::LabelSetImage::ImageToLayerContainerProcessing(itk::Image<TPixel, VImageDimension> *source,
-                                                          unsigned int layer) const
-{
-  typedef itk::Image<TPixel, VImageDimension> ImageType;
-  typename ImageType::Pointer itkTarget;
-  // mitk::CastToItkImage(m_LayerContainer[layer], itkTarget);
-  itkTarget = ImageToItkImage<TPixel, VImageDimension>(m_LayerContainer[layer]);
-
-  typedef itk::ImageRegionConstIterator<ImageType> SourceIteratorType;
-  typedef itk::ImageRegionIterator<ImageType> TargetIteratorType;
-
-  SourceIteratorType sourceIter(source, source->GetLargestPossibleRegion());
-  sourceIter.GoToBegin();
-
-  TargetIteratorType targetIter(itkTarget, itkTarget->GetLargestPossibleRegion());
-  targetIter.GoToBegin();
-
-  while (!sourceIter.IsAtEnd())
-  {
-    targetIter.Set(sourceIter.Get());
-    ++sourceIter;
-    ++targetIter;
-  }
-}
-
-template <typename ImageType>
-void mitk::LabelSetImage::EraseLabelProcessing(ImageType *itkImage, PixelType pixelValue, unsigned int /*layer*/)
-{
-  typedef itk::ImageRegionIterator<ImageType> IteratorType;
-
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
-
-  while (!iter.IsAtEnd())
-  {
-    PixelType value = iter.Get();
-
-    if (value == pixelValue)
-    {
-      iter.Set(0);
-    }
-    ++iter;
-  }
-}
-
-template <typename ImageType>
-void mitk::LabelSetImage::MergeLabelProcessing(ImageType *itkImage, PixelType pixelValue, PixelType index)
-{
-  typedef itk::ImageRegionIterator<ImageType> IteratorType;
-
-  IteratorType iter(itkImage, itkImage->GetLargestPossibleRegion());
-  iter.GoToBegin();
-
-  while (!iter.IsAtEnd())
-  {
-    if (iter.Get() == index)
-    {
-      iter.Set(pixelValue);
-    }
-    ++iter;
-  }
-}
-
 bool mitk::Equal(const mitk::LabelSetImage &leftHandSide,
                  const mitk::LabelSetImage &rightHandSide,
                  ScalarType eps,
@@ -970,8 +1588,8 @@ bool mitk::Equal(const mitk::LabelSetImage &leftHandSide,
     else
     {
       // layer image data
-      returnValue =
-        mitk::Equal(*leftHandSide.GetLayerImage(layerIndex), *rightHandSide.GetLayerImage(layerIndex), eps, verbose);
+      returnValue = mitk::Equal(
+        *leftHandSide.CreateLayerImage(layerIndex), *rightHandSide.CreateLayerImage(layerIndex), eps, verbose);
       if (!returnValue)
       {
         MITK_INFO(verbose) << "Layer image data not equal.";
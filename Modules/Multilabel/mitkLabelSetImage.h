@@ -18,16 +18,31 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define __mitkLabelSetImage_H_
 
 #include <mitkImage.h>
+#include <mitkLabelIndex.h>
 #include <mitkLabelSet.h>
+#include <mitkSparseLabelLayer.h>
 
 #include <MitkMultilabelExports.h>
 
+#include <mutex>
+
 namespace mitk
 {
   //##Documentation
   //## @brief LabelSetImage class for handling labels and layers in a segmentation session.
   //##
   //## Handles operations for adding, removing, erasing and editing labels and layers.
+  //##
+  //## The image data of the active layer is the LabelSetImage itself. All other layers are
+  //## stored run-length encoded (see mitk::SparseLabelLayer), so that inactive and empty layers
+  //## only need memory for their labeled voxels. They are only converted to a dense mitk::Image
+  //## when they are written through GetLayerImage(). Read access decodes temporary images, see
+  //## the const GetLayerImage(), CreateLayerImage() and CreateLayerSliceImage().
+  //##
+  //## For every time step of the active layer the voxel count, bounding box and centroid of all
+  //## labels are kept in a mitk::LabelIndex. The index is updated incrementally by the editing
+  //## operations of this class and by UpdateLabelIndex(). Any other modification of the image
+  //## data invalidates it, it is rebuilt by a single scan on the next query.
   //## @ingroup Data
 
   class MITKMULTILABEL_EXPORT LabelSetImage : public Image
@@ -79,6 +94,8 @@ namespace mitk
     /**
      * @brief Merges a list of mitk::Labels with the mitk::Label that has a specific value
      *
+     * All labels are merged in a single pass over the layer (see RemapLabels()).
+     *
      * @param pixelValue                  the value of the label that should be the new merged label
      * @param vectorOfSourcePixelValues   the list of label values that should be merge into the specified one
      * @param layer                       the layer in which the merge should be performed
@@ -86,12 +103,69 @@ namespace mitk
     void MergeLabels(PixelType pixelValue, std::vector<PixelType>& vectorOfSourcePixelValues, unsigned int layer = 0);
 
     /**
-      * \brief  */
+     * @brief Replaces label values in the image data of a layer according to a mapping.
+     *
+     * The mapping is converted to a lookup table once and applied in a single, parallel pass over
+     * the layer. Run-length encoded layers are remapped without decoding them. Label values which
+     * are not part of the mapping keep their value, mapping a value to 0 erases it.
+     * The label sets are not changed.
+     *
+     * @param labelMapping   pairs of the current and the new value of the labels that should be changed
+     * @param layer          the layer in which the labels should be remapped
+     */
+    void RemapLabels(const std::map<PixelType, PixelType> &labelMapping, unsigned int layer = 0);
+
+    /**
+     * @brief Sets the center of mass of a label to the voxel of the label nearest to its centroid in the first
+     *        time step. Unlike the centroid, this voxel is part of non-convex or disconnected labels as well.
+     */
     void UpdateCenterOfMass(PixelType pixelValue, unsigned int layer = 0);
 
+    /**
+     * @brief Returns the number of voxels of a label.
+     */
+    std::size_t GetNumberOfLabelVoxels(PixelType pixelValue, unsigned int layer = 0, unsigned int timeStep = 0) const;
+
+    /**
+     * @brief Determines the smallest region (in index coordinates) enclosing all voxels of a label.
+     * @return false if the label has no voxels
+     */
+    bool GetLabelBoundingBox(PixelType pixelValue,
+                             itk::ImageRegion<3> &boundingBox,
+                             unsigned int layer = 0,
+                             unsigned int timeStep = 0) const;
+
+    /**
+     * @brief Determines the centroid of all voxels of a label in index coordinates.
+     * @return false if the label has no voxels
+     */
+    bool GetLabelCentroid(PixelType pixelValue,
+                          mitk::Point3D &centroid,
+                          unsigned int layer = 0,
+                          unsigned int timeStep = 0) const;
+
+    /**
+     * @brief Marks the image as modified after a slice was written into the active layer.
+     *
+     * Instead of invalidating the label index, the voxels which differ between both slices are
+     * accounted for. This is only possible for slices which are aligned with the image axes and
+     * have the voxel size of the image, the label index is invalidated for all other slices.
+     *
+     * @param originalSlice the slice before it was written, its geometry is used for both slices
+     * @param modifiedSlice the slice as it was written into the image
+     * @param timeStep the time step the slice was written to
+     * @param changedRegion optional region of the image which contains all changed voxels, e.g. the extent
+     *        returned by mitkVtkImageOverwrite::GetOverwrittenExtent(). Only the slice pixels inside of it are compared.
+     */
+    void UpdateLabelIndex(const mitk::Image *originalSlice,
+                          const mitk::Image *modifiedSlice,
+                          unsigned int timeStep,
+                          const itk::ImageRegion<3> *changedRegion = nullptr);
+
     /**
      * @brief Removes labels from the mitk::LabelSet of given layer.
-     *        Calls mitk::LabelSetImage::EraseLabels() which also removes the labels from within the image.
+     *        Calls mitk::LabelSetImage::EraseLabels() which also removes the labels from within the image
+     *        in a single pass.
      * @param VectorOfLabelPixelValues a list of labels to be removed
      * @param layer the layer in which the labels should be removed
      */
@@ -108,6 +182,7 @@ namespace mitk
 
     /**
      * @brief Similar to mitk::LabelSetImage::EraseLabel() this funtion erase a list of labels from the image
+     *        All labels are erased in a single pass over the layer (see RemapLabels()).
      * @param VectorOfLabelPixelValues the list of labels that should be remove
      * @param layer the layer for which the labels should be removed
      */
@@ -210,7 +285,8 @@ namespace mitk
     unsigned int GetNumberOfLayers() const;
 
     /**
-     * @brief Adds a new layer to the LabelSetImage. The new layer will be set as the active one
+     * @brief Adds a new layer to the LabelSetImage. The new layer will be set as the active one.
+     *        The new layer is empty and does not allocate image memory until it is activated.
      * @param layer a mitk::LabelSet which will be set as new layer.
      * @return the layer ID of the new layer
      */
@@ -218,7 +294,9 @@ namespace mitk
 
     /**
     * \brief Add a layer based on a provided mitk::Image
-    * \param layerImage is added to the vector of label images
+    * \param layerImage is added to the vector of label images. Images of the label pixel type and
+    *        the dimensions of the LabelSetImage are run-length encoded and not referenced afterwards.
+    *        If nullptr, an empty layer is added.
     * \param lset a label set that will be added to the new layer if provided
     *\return the layer ID of the new layer
     */
@@ -245,10 +323,62 @@ namespace mitk
     void RemoveLayer();
 
     /**
-      * \brief  */
+     * @brief Returns the dense image of a layer for writing.
+     *
+     * For the active layer this is the LabelSetImage itself, so changing it changes the
+     * segmentation directly. Run-length encoded layers are decoded into a new image which
+     * replaces the encoded data until the layer is activated the next time, so the memory
+     * saving of the encoding is lost for that layer. Use the const overload,
+     * CreateLayerImage() or CreateLayerSliceImage() if the image is only read, e.g. for
+     * rendering or writing.
+     */
     mitk::Image *GetLayerImage(unsigned int layer);
 
-    const mitk::Image *GetLayerImage(unsigned int layer) const;
+    /**
+     * @brief Returns the dense image of a layer for reading.
+     *
+     * For the active layer this is the LabelSetImage itself. A run-length encoded layer is
+     * decoded into a temporary image and stays encoded, so keep the returned pointer as long
+     * as the image is used.
+     */
+    mitk::Image::ConstPointer GetLayerImage(unsigned int layer) const;
+
+    /**
+     * @brief Creates a copy of the image data of a layer without changing the way the layer is stored.
+     */
+    mitk::Image::Pointer CreateLayerImage(unsigned int layer) const;
+
+    /**
+     * @brief Decodes a single slice of an inactive, run-length encoded layer.
+     *
+     * The returned 3D image has the thickness of one voxel along sliceDimension and is
+     * positioned in world coordinates where the slice lies in the layer image, so that it
+     * can be resliced like the complete layer image.
+     *
+     * @param layer the inactive layer to decode the slice from
+     * @param sliceDimension the image axis perpendicular to the slice
+     * @param sliceIndex the index of the slice along sliceDimension
+     * @param timeStep the time step of the slice
+     * @param sliceImage a slice image created before by this method. If it has the size of the
+     *        requested slice, it is overwritten and returned instead of allocating a new image.
+     * @return the slice image or nullptr if the layer is active or stored as dense image
+     */
+    mitk::Image::Pointer CreateLayerSliceImage(unsigned int layer,
+                                               unsigned int sliceDimension,
+                                               unsigned int sliceIndex,
+                                               unsigned int timeStep = 0,
+                                               mitk::Image *sliceImage = nullptr) const;
+
+    /**
+     * @brief Returns true if the layer is inactive and stored run-length encoded.
+     */
+    bool IsLayerRunLengthEncoded(unsigned int layer) const;
+
+    /**
+     * @brief Returns the time of the last change of the voxels of a layer, e.g. to find out
+     * whether an image created by CreateLayerImage() or CreateLayerSliceImage() is outdated.
+     */
+    unsigned long GetLayerMTime(unsigned int layer) const;
 
     void OnLabelSetModified();
 
@@ -279,24 +409,31 @@ namespace mitk
     template <typename TPixel, unsigned int VImageDimension>
     void LayerContainerToImageProcessing(itk::Image<TPixel, VImageDimension> *source, unsigned int layer);
 
-    template <typename TPixel, unsigned int VImageDimension>
-    void ImageToLayerContainerProcessing(itk::Image<TPixel, VImageDimension> *source, unsigned int layer) const;
+    /** Encodes the working image into the run-length encoded storage of the given layer. */
+    void ImageToLayerContainer(unsigned int layer);
 
-    template <typename ImageType>
-    void CalculateCenterOfMassProcessing(ImageType *input, PixelType index, unsigned int layer);
+    /** Copies the data of the given layer into the working image. */
+    void LayerContainerToImage(unsigned int layer);
 
-    template <typename ImageType>
-    void ClearBufferProcessing(ImageType *input);
+    /** Decodes a layer into a new image, expects m_LayerMutex to be locked. */
+    mitk::Image::Pointer InternalCreateLayerImage(unsigned int layer) const;
+
+    /** Creates an uninitialized image with the pixel type, dimensions and geometry of the working image. */
+    mitk::Image::Pointer CreateEmptyLayerImage() const;
+
+    /** Returns true if the label index matches the current image data of the active layer. */
+    bool IsLabelIndexUpToDate() const;
+
+    /** Returns the label index of a time step of a layer. The index of the active layer is rebuilt if needed,
+        the index of an inactive layer is computed into inactiveLayerIndex. Expects m_LabelIndexMutex to be locked. */
+    const LabelIndex &GetLabelIndex(unsigned int layer, unsigned int timeStep, LabelIndex &inactiveLayerIndex) const;
 
     template <typename ImageType>
-    void EraseLabelProcessing(ImageType *input, PixelType index, unsigned int layer);
+    void ClearBufferProcessing(ImageType *input);
 
     //  template < typename ImageType >
     //  void ReorderLabelProcessing( ImageType* input, int index, int layer);
 
-    template <typename ImageType>
-    void MergeLabelProcessing(ImageType *input, PixelType pixelValue, PixelType index);
-
     template <typename ImageType>
     void ConcatenateProcessing(ImageType *input, mitk::LabelSetImage *other);
 
@@ -307,7 +444,19 @@ namespace mitk
     void InitializeByLabeledImageProcessing(LabelSetImageType *input, ImageType *other);
 
     std::vector<LabelSet::Pointer> m_LabelSetContainer;
+
+    // Every inactive layer is either stored as image (m_LayerContainer) or run-length encoded
+    // (m_SparseLayerContainer). Encoded layers are only replaced by images by the non-const GetLayerImage().
     std::vector<Image::Pointer> m_LayerContainer;
+    std::vector<SparseLabelLayer> m_SparseLayerContainer;
+    // Guards the decoding of inactive layers by const methods, which may be called from several threads.
+    mutable std::mutex m_LayerMutex;
+
+    // Label index of every time step of the active layer, valid as long as m_LabelIndexTime is newer than the image.
+    mutable std::vector<LabelIndex> m_LabelIndices;
+    mutable itk::TimeStamp m_LabelIndexTime;
+    // Guards the label index, which is rebuilt by const queries. Locked before m_LayerMutex if both are needed.
+    mutable std::mutex m_LabelIndexMutex;
 
     int m_ActiveLayer;
 
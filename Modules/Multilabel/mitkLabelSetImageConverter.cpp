@@ -40,10 +40,19 @@ static void ConvertLabelSetImageToImage(const itk::Image<TPixel, VDimension> *,
     auto vectorImageComposer = ComposeFilterType::New();
     auto activeLayer = labelSetImage->GetActiveLayer();
 
+    // decoded copies of the run-length encoded layers, they have to live until the composer is updated
+    std::vector<mitk::Image::Pointer> decodedLayerImages;
+
     for (decltype(numberOfLayers) layer = 0; layer < numberOfLayers; ++layer)
     {
-      auto layerImage = mitk::ImageToItkImage<TPixel, VDimension>(
-        layer != activeLayer ? labelSetImage->GetLayerImage(layer) : labelSetImage);
+      mitk::Image::ConstPointer mitkLayerImage = labelSetImage.GetPointer();
+      if (layer != activeLayer)
+      {
+        decodedLayerImages.push_back(labelSetImage->CreateLayerImage(layer));
+        mitkLayerImage = decodedLayerImages.back().GetPointer();
+      }
+
+      auto layerImage = mitk::ImageToItkImage<TPixel, VDimension>(mitkLayerImage.GetPointer());
 
       vectorImageComposer->SetInput(layer, layerImage);
     }
@@ -79,7 +88,7 @@ mitk::Image::Pointer mitk::ConvertLabelSetImageToImage(LabelSetImage::ConstPoint
     }
     else
     {
-      AccessByItk_2(labelSetImage->GetLayerImage(0), ::ConvertLabelSetImageToImage, labelSetImage, image);
+      AccessByItk_2(labelSetImage, ::ConvertLabelSetImageToImage, labelSetImage, image);
     }
   }
 
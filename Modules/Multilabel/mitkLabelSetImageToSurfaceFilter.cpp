@@ -18,6 +18,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <mitkImageAccessByItk.h>
 #include <mitkImageCast.h>
+#include <mitkImageTimeSelector.h>
+#include <mitkParallelFor.h>
 
 // itk
 #include <itkAntiAliasBinaryImageFilter.h>
@@ -32,14 +34,28 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 // vtk
 #include <vtkCleanPolyData.h>
+#include <vtkDecimatePro.h>
+#include <vtkDiscreteMarchingCubes.h>
 #include <vtkImageChangeInformation.h>
 #include <vtkImageData.h>
 #include <vtkLinearTransform.h>
 #include <vtkMarchingCubes.h>
+#include <vtkPolyDataNormals.h>
 #include <vtkSmartPointer.h>
+#include <vtkWindowedSincPolyDataFilter.h>
+
+// std
+#include <algorithm>
+#include <set>
 
 mitk::LabelSetImageToSurfaceFilter::LabelSetImageToSurfaceFilter()
-  : m_GenerateAllLabels(false), m_RequestedLabel(1), m_BackgroundLabel(0), m_UseSmoothing(0), m_Sigma(0.1)
+  : m_GenerateAllLabels(false),
+    m_RequestedLabel(1),
+    m_BackgroundLabel(0),
+    m_UseSmoothing(0),
+    m_Sigma(0.1),
+    m_SmoothIterations(15),
+    m_TargetReduction(0.0)
 {
 }
 
@@ -68,9 +84,161 @@ const mitk::Image *mitk::LabelSetImageToSurfaceFilter::GetInput(void)
   return static_cast<const mitk::Image *>(this->ProcessObject::GetInput(0));
 }
 
+mitk::LabelSetImageToSurfaceFilter::LabelType mitk::LabelSetImageToSurfaceFilter::GetLabelOfOutput(
+  unsigned int idx) const
+{
+  auto iter = m_IndexToLabels.find(idx);
+  return iter != m_IndexToLabels.end() ? iter->second : static_cast<LabelType>(m_BackgroundLabel);
+}
+
 void mitk::LabelSetImageToSurfaceFilter::GenerateOutputInformation()
 {
   itkDebugMacro(<< "GenerateOutputInformation()");
+
+  m_IndexToLabels.clear();
+
+  if (!m_GenerateAllLabels)
+    return;
+
+  const mitk::Image *image = this->GetInput();
+  if (!image)
+    return;
+
+  this->DetermineLabelRegions();
+
+  // one output per label which is present in any time step
+  std::set<LabelType> labels;
+  for (const auto &labelRegions : m_LabelRegions)
+  {
+    for (const auto &labelRegion : labelRegions)
+      labels.insert(labelRegion.first);
+  }
+
+  unsigned int numberOfOutputs = 0;
+  for (auto label : labels)
+    m_IndexToLabels[numberOfOutputs++] = label;
+
+  if (0 == numberOfOutputs)
+  {
+    itkWarningMacro("No labels found, the output will be empty");
+    numberOfOutputs = 1;
+  }
+
+  const unsigned int numberOfTimeSteps = image->GetTimeSteps();
+
+  this->SetNumberOfIndexedOutputs(numberOfOutputs);
+  for (unsigned int i = 0; i < numberOfOutputs; ++i)
+  {
+    if (!this->GetOutput(i))
+    {
+      mitk::Surface::Pointer output = static_cast<mitk::Surface *>(this->MakeOutput(0).GetPointer());
+      this->SetNthOutput(i, output.GetPointer());
+    }
+    this->GetOutput(i)->Expand(numberOfTimeSteps);
+  }
+}
+
+void mitk::LabelSetImageToSurfaceFilter::DetermineLabelRegions()
+{
+  const mitk::Image *image = this->GetInput();
+  const unsigned int numberOfTimeSteps = image->GetTimeSteps();
+
+  m_LabelRegions.clear();
+  m_LabelRegions.resize(numberOfTimeSteps);
+
+  auto *labelSetImage = dynamic_cast<const mitk::LabelSetImage *>(image);
+
+  for (unsigned int t = 0; t < numberOfTimeSteps; ++t)
+  {
+    if (labelSetImage)
+    {
+      // the bounding boxes of the active layer are kept up to date by the label index of the image
+      const unsigned int layer = labelSetImage->GetActiveLayer();
+      const mitk::LabelSet *labelSet = labelSetImage->GetLabelSet(layer);
+
+      for (auto iter = labelSet->IteratorConstBegin(); iter != labelSet->IteratorConstEnd(); ++iter)
+      {
+        if (static_cast<int>(iter->first) == m_BackgroundLabel)
+          continue;
+
+        RegionType region;
+        if (labelSetImage->GetLabelBoundingBox(iter->first, region, layer, t))
+          m_LabelRegions[t][iter->first] = region;
+      }
+    }
+    else
+    {
+      mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+      timeSelector->SetInput(image);
+      timeSelector->SetTimeNr(t);
+      timeSelector->Update();
+
+      AccessFixedDimensionByItk_1(timeSelector->GetOutput(), ScanLabelRegions, 3, &m_LabelRegions[t]);
+    }
+  }
+}
+
+template <typename TPixel, unsigned int VDimension>
+void mitk::LabelSetImageToSurfaceFilter::ScanLabelRegions(const itk::Image<TPixel, VDimension> *input,
+                                                          LabelRegionMapType *labelRegions)
+{
+  typedef typename RegionType::IndexType IndexType;
+
+  const RegionType largestRegion = input->GetLargestPossibleRegion();
+  const IndexType &start = largestRegion.GetIndex();
+  const auto &size = largestRegion.GetSize();
+  const TPixel *buffer = input->GetBufferPointer();
+
+  std::map<LabelType, std::pair<IndexType, IndexType>> bounds;
+
+  // the map is only consulted once per run of equal voxels
+  for (unsigned int z = 0; z < size[2]; ++z)
+  {
+    for (unsigned int y = 0; y < size[1]; ++y)
+    {
+      const TPixel *row = buffer + (static_cast<std::size_t>(z) * size[1] + y) * size[0];
+      unsigned int x = 0;
+
+      while (x < size[0])
+      {
+        const TPixel value = row[x];
+        const unsigned int runStart = x;
+        while (x < size[0] && row[x] == value)
+          ++x;
+
+        if (static_cast<int>(value) == m_BackgroundLabel)
+          continue;
+
+        IndexType first = {{start[0] + runStart, start[1] + y, start[2] + z}};
+        IndexType last = first;
+        last[0] = start[0] + x - 1;
+
+        auto iter = bounds.find(static_cast<LabelType>(value));
+        if (iter == bounds.end())
+        {
+          bounds[static_cast<LabelType>(value)] = std::make_pair(first, last);
+        }
+        else
+        {
+          for (unsigned int i = 0; i < 3; ++i)
+          {
+            iter->second.first[i] = std::min(iter->second.first[i], first[i]);
+            iter->second.second[i] = std::max(iter->second.second[i], last[i]);
+          }
+        }
+      }
+    }
+  }
+
+  labelRegions->clear();
+  for (const auto &bound : bounds)
+  {
+    typename RegionType::SizeType regionSize;
+    for (unsigned int i = 0; i < 3; ++i)
+      regionSize[i] = bound.second.second[i] - bound.second.first[i] + 1;
+
+    (*labelRegions)[bound.first] = RegionType(bound.second.first, regionSize);
+  }
 }
 
 void mitk::LabelSetImageToSurfaceFilter::GenerateData()
@@ -83,9 +251,160 @@ void mitk::LabelSetImageToSurfaceFilter::GenerateData()
   if (!outputSurface)
     return;
 
+  if (m_GenerateAllLabels)
+  {
+    for (unsigned int t = 0; t < m_LabelRegions.size(); ++t)
+    {
+      mitk::ImageTimeSelector::Pointer timeSelector = mitk::ImageTimeSelector::New();
+      timeSelector->SetInput(inputImage);
+      timeSelector->SetTimeNr(t);
+      timeSelector->Update();
+
+      AccessFixedDimensionByItk_1(timeSelector->GetOutput(), GenerateLabelSurfaces, 3, t);
+    }
+    return;
+  }
+
   AccessFixedDimensionByItk_1(inputImage, InternalProcessing, 3, outputSurface);
 }
 
+template <typename TPixel, unsigned int VDimension>
+void mitk::LabelSetImageToSurfaceFilter::GenerateLabelSurfaces(const itk::Image<TPixel, VDimension> *input,
+                                                               unsigned int timeStep)
+{
+  const LabelRegionMapType &labelRegions = m_LabelRegions[timeStep];
+
+  vtkSmartPointer<vtkMatrix4x4> indexToWorld = vtkSmartPointer<vtkMatrix4x4>::New();
+  this->GetInput()->GetGeometry(timeStep)->GetVtkTransform()->GetMatrix(indexToWorld);
+
+  // output index and label, the largest labels are handed out first to balance the threads
+  std::vector<std::pair<unsigned int, LabelType>> tasks;
+  for (const auto &indexToLabel : m_IndexToLabels)
+  {
+    if (labelRegions.find(indexToLabel.second) != labelRegions.end())
+      tasks.push_back(indexToLabel);
+  }
+
+  std::sort(tasks.begin(), tasks.end(), [&labelRegions](const std::pair<unsigned int, LabelType> &a,
+                                                        const std::pair<unsigned int, LabelType> &b) {
+    return labelRegions.at(a.second).GetNumberOfPixels() > labelRegions.at(b.second).GetNumberOfPixels();
+  });
+
+  std::vector<vtkSmartPointer<vtkPolyData>> results(tasks.size());
+  mitk::ParallelFor(tasks.size(), [&](std::size_t i) {
+    results[i] = this->ExtractLabelSurface(input, tasks[i].second, labelRegions.at(tasks[i].second), indexToWorld);
+  });
+
+  for (unsigned int i = 0; i < this->GetNumberOfIndexedOutputs(); ++i)
+    this->GetOutput(i)->SetVtkPolyData(vtkSmartPointer<vtkPolyData>::New(), timeStep);
+
+  for (std::size_t i = 0; i < tasks.size(); ++i)
+    this->GetOutput(tasks[i].first)->SetVtkPolyData(results[i], timeStep);
+}
+
+template <typename TPixel, unsigned int VDimension>
+vtkSmartPointer<vtkPolyData> mitk::LabelSetImageToSurfaceFilter::ExtractLabelSurface(
+  const itk::Image<TPixel, VDimension> *input, LabelType label, const RegionType &region, vtkMatrix4x4 *indexToWorld)
+{
+  const RegionType &largestRegion = input->GetLargestPossibleRegion();
+
+  RegionType labelRegion = region;
+  if (!labelRegion.Crop(largestRegion))
+    return vtkSmartPointer<vtkPolyData>::New();
+
+  // the border of one voxel closes the surface, voxels outside of the image count as background
+  RegionType cropRegion = labelRegion;
+  cropRegion.PadByRadius(1);
+
+  const auto &cropIndex = cropRegion.GetIndex();
+  const auto &cropSize = cropRegion.GetSize();
+
+  vtkSmartPointer<vtkImageData> labelImage = vtkSmartPointer<vtkImageData>::New();
+  labelImage->SetDimensions(cropSize[0], cropSize[1], cropSize[2]);
+  labelImage->SetOrigin(cropIndex[0], cropIndex[1], cropIndex[2]);
+  labelImage->SetSpacing(1.0, 1.0, 1.0);
+  labelImage->AllocateScalars(VTK_UNSIGNED_CHAR, 1);
+
+  auto *labelBuffer = static_cast<unsigned char *>(labelImage->GetScalarPointer());
+  std::fill(labelBuffer, labelBuffer + cropRegion.GetNumberOfPixels(), 0);
+
+  const auto &labelIndex = labelRegion.GetIndex();
+  const auto &labelSize = labelRegion.GetSize();
+
+  for (unsigned int z = 0; z < labelSize[2]; ++z)
+  {
+    for (unsigned int y = 0; y < labelSize[1]; ++y)
+    {
+      typename RegionType::IndexType index = {{labelIndex[0], labelIndex[1] + y, labelIndex[2] + z}};
+      const TPixel *inputRow = input->GetBufferPointer() + input->ComputeOffset(index);
+      unsigned char *labelRow =
+        labelBuffer + ((static_cast<std::size_t>(z) + 1) * cropSize[1] + y + 1) * cropSize[0] + 1;
+
+      for (unsigned int x = 0; x < labelSize[0]; ++x)
+        labelRow[x] = static_cast<LabelType>(inputRow[x]) == label ? 1 : 0;
+    }
+  }
+
+  vtkSmartPointer<vtkDiscreteMarchingCubes> marching = vtkSmartPointer<vtkDiscreteMarchingCubes>::New();
+  marching->SetInputData(labelImage);
+  marching->ComputeNormalsOff();
+  marching->ComputeGradientsOff();
+  marching->ComputeScalarsOff();
+  marching->SetValue(0, 1);
+  marching->Update();
+
+  vtkSmartPointer<vtkPolyData> polyData = marching->GetOutput();
+
+  if (m_UseSmoothing && m_SmoothIterations > 0)
+  {
+    vtkSmartPointer<vtkWindowedSincPolyDataFilter> smoother = vtkSmartPointer<vtkWindowedSincPolyDataFilter>::New();
+    smoother->SetInputData(polyData);
+    smoother->SetNumberOfIterations(m_SmoothIterations);
+    smoother->SetPassBand(0.1);
+    smoother->BoundarySmoothingOff();
+    smoother->FeatureEdgeSmoothingOff();
+    smoother->NonManifoldSmoothingOn();
+    smoother->NormalizeCoordinatesOn();
+    smoother->Update();
+    polyData = smoother->GetOutput();
+  }
+
+  if (m_TargetReduction > 0.0)
+  {
+    vtkSmartPointer<vtkDecimatePro> decimate = vtkSmartPointer<vtkDecimatePro>::New();
+    decimate->SetInputData(polyData);
+    decimate->SetTargetReduction(m_TargetReduction);
+    decimate->PreserveTopologyOn();
+    decimate->Update();
+    polyData = decimate->GetOutput();
+  }
+
+  vtkPoints *points = polyData->GetPoints();
+  if (!points)
+    return polyData;
+
+  double(*matrix)[4] = indexToWorld->Element;
+  const vtkIdType numberOfPoints = points->GetNumberOfPoints();
+  double point[3];
+
+  for (vtkIdType i = 0; i < numberOfPoints; ++i)
+  {
+    points->GetPoint(i, point);
+    mitkVtkLinearTransformPoint(matrix, point, point);
+    points->SetPoint(i, point);
+  }
+
+  // a mirroring geometry turns the triangles inside out
+  vtkSmartPointer<vtkPolyDataNormals> normals = vtkSmartPointer<vtkPolyDataNormals>::New();
+  normals->SetInputData(polyData);
+  normals->SplittingOff();
+  normals->ConsistencyOn();
+  normals->SetFlipNormals(indexToWorld->Determinant() < 0.0);
+  normals->Update();
+
+  return normals->GetOutput();
+}
+
 template <typename TPixel, unsigned int VDimension>
 void mitk::LabelSetImageToSurfaceFilter::InternalProcessing(const itk::Image<TPixel, VDimension> *input,
                                                             mitk::Surface * /*surface*/)
@@ -23,10 +23,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkSurfaceSource.h>
 
 #include <vtkMatrix4x4.h>
+#include <vtkPolyData.h>
+#include <vtkSmartPointer.h>
 
 #include <itkImage.h>
 
 #include <map>
+#include <vector>
 
 namespace mitk
 {
@@ -34,6 +37,11 @@ namespace mitk
    * Generates surface meshes from a labelset image.
    * If you want to calculate a surface representation for all available labels,
    * you may call GenerateAllLabelsOn().
+   *
+   * In this mode one output is generated per label (see GetLabelOfOutput()). Each label is extracted
+   * by a discrete marching cubes pass over its bounding box only, the labels are processed in parallel.
+   * The bounding boxes are taken from the label index if the input is a mitk::LabelSetImage. The
+   * meshes can optionally be smoothed (UseSmoothing, SmoothIterations) and decimated (TargetReduction).
    */
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceFilter : public SurfaceSource
   {
@@ -109,6 +117,26 @@ namespace mitk
      */
     itkSetMacro(Sigma, float);
 
+    /**
+     * Sets the number of iterations of the mesh smoothing applied to each label if all labels are
+     * generated and UseSmoothing is set, by default 15
+     */
+    itkSetMacro(SmoothIterations, unsigned int);
+    itkGetMacro(SmoothIterations, unsigned int);
+
+    /**
+     * Sets the fraction of triangles removed from each label mesh if all labels are generated.
+     * A value of 0 (default) disables the decimation.
+     */
+    itkSetClampMacro(TargetReduction, float, 0.0f, 0.99f);
+    itkGetMacro(TargetReduction, float);
+
+    /**
+     * Returns the label represented by the output with the given index, or the background label
+     * if there is no such output.
+     */
+    LabelType GetLabelOfOutput(unsigned int idx) const;
+
   protected:
     LabelSetImageToSurfaceFilter();
 
@@ -133,6 +161,36 @@ namespace mitk
     template <typename TPixel, unsigned int VImageDimension>
     void InternalProcessing(const itk::Image<TPixel, VImageDimension> *input, mitk::Surface *surface);
 
+    typedef itk::ImageRegion<3> RegionType;
+
+    typedef std::map<LabelType, RegionType> LabelRegionMapType;
+
+    /**
+    * Determines the bounding boxes of all labels of the given time step in a single scan
+    */
+    template <typename TPixel, unsigned int VImageDimension>
+    void ScanLabelRegions(const itk::Image<TPixel, VImageDimension> *input, LabelRegionMapType *labelRegions);
+
+    /**
+    * Generates the surfaces of all labels of the given time step, labels are distributed over threads
+    */
+    template <typename TPixel, unsigned int VImageDimension>
+    void GenerateLabelSurfaces(const itk::Image<TPixel, VImageDimension> *input, unsigned int timeStep);
+
+    /**
+    * Extracts the surface of a single label within its region, points are given in world coordinates
+    */
+    template <typename TPixel, unsigned int VImageDimension>
+    vtkSmartPointer<vtkPolyData> ExtractLabelSurface(const itk::Image<TPixel, VImageDimension> *input,
+                                                     LabelType label,
+                                                     const RegionType &region,
+                                                     vtkMatrix4x4 *indexToWorld);
+
+    /**
+    * Determines the labels and their bounding boxes of all time steps
+    */
+    void DetermineLabelRegions();
+
     bool m_GenerateAllLabels;
 
     int m_RequestedLabel;
@@ -143,10 +201,16 @@ namespace mitk
 
     float m_Sigma;
 
+    unsigned int m_SmoothIterations;
+
+    float m_TargetReduction;
+
     LabelMapType m_AvailableLabels;
 
     IndexToLabelMapType m_IndexToLabels;
 
+    std::vector<LabelRegionMapType> m_LabelRegions;
+
     mitk::Vector3D m_InputImageSpacing;
 
     void GenerateData() override;
@@ -19,9 +19,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkLabelSetImage.h"
 #include "mitkLabelSetImageToSurfaceFilter.h"
 
+#include <vtkPolyData.h>
+
 namespace mitk
 {
-  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter() : m_RequestedLabel(1), m_Result(nullptr)
+  LabelSetImageToSurfaceThreadedFilter::LabelSetImageToSurfaceThreadedFilter()
+    : m_RequestedLabel(1), m_GenerateAllLabels(false)
   {
   }
 
@@ -74,10 +77,20 @@ namespace mitk
       MITK_WARN << "\"RequestedLabel\" parameter was not set: will use the default value (" << m_RequestedLabel << ").";
     }
 
+    m_GenerateAllLabels = false;
+    try
+    {
+      this->GetParameter("GenerateAllLabels", m_GenerateAllLabels);
+    }
+    catch (std::invalid_argument &)
+    {
+      // a single label is generated by default
+    }
+
     mitk::LabelSetImageToSurfaceFilter::Pointer filter = mitk::LabelSetImageToSurfaceFilter::New();
     filter->SetInput(image);
     //  filter->SetObserver(obsv);
-    filter->SetGenerateAllLabels(false);
+    filter->SetGenerateAllLabels(m_GenerateAllLabels);
     filter->SetRequestedLabel(m_RequestedLabel);
     filter->SetUseSmoothing(useSmoothing);
 
@@ -101,12 +114,30 @@ namespace mitk
       return false;
     }
 
-    m_Result = filter->GetOutput();
+    m_Results.clear();
 
-    if (m_Result.IsNull() || !m_Result->GetVtkPolyData())
+    if (m_GenerateAllLabels)
+    {
+      for (unsigned int i = 0; i < filter->GetNumberOfIndexedOutputs(); ++i)
+      {
+        mitk::Surface::Pointer result = filter->GetOutput(i);
+        if (result.IsNull() || !result->GetVtkPolyData() || !result->GetVtkPolyData()->GetNumberOfPoints())
+          continue;
+
+        result->DisconnectPipeline();
+        m_Results[filter->GetLabelOfOutput(i)] = result;
+      }
+
+      return !m_Results.empty();
+    }
+
+    mitk::Surface::Pointer result = filter->GetOutput();
+
+    if (result.IsNull() || !result->GetVtkPolyData())
       return false;
 
-    m_Result->DisconnectPipeline();
+    result->DisconnectPipeline();
+    m_Results[m_RequestedLabel] = result;
 
     return true;
   }
@@ -116,17 +147,24 @@ namespace mitk
     LabelSetImage::Pointer image;
     this->GetPointerParameter("Input", image);
 
-    std::string name = this->GetGroupNode()->GetName();
-    name.append("-surf");
+    for (const auto &result : m_Results)
+    {
+      std::string name = this->GetGroupNode()->GetName();
+      mitk::Label *label = image->GetLabel(result.first, image->GetActiveLayer());
+
+      if (m_GenerateAllLabels && label)
+        name.append("-").append(label->GetName());
+      name.append("-surf");
 
-    mitk::DataNode::Pointer node = mitk::DataNode::New();
-    node->SetData(m_Result);
-    node->SetName(name);
+      mitk::DataNode::Pointer node = mitk::DataNode::New();
+      node->SetData(result.second);
+      node->SetName(name);
 
-    mitk::Color color = image->GetLabel(m_RequestedLabel, image->GetActiveLayer())->GetColor();
-    node->SetColor(color);
+      if (label)
+        node->SetColor(label->GetColor());
 
-    this->InsertBelowGroupNode(node);
+      this->InsertBelowGroupNode(node);
+    }
 
     Superclass::ThreadedUpdateSuccessful();
   }
@@ -21,6 +21,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkSurface.h"
 #include <MitkMultilabelExports.h>
 
+#include <map>
+
 namespace mitk
 {
   class MITKMULTILABEL_EXPORT LabelSetImageToSurfaceThreadedFilter : public SegmentationSink
@@ -42,7 +44,8 @@ namespace mitk
 
   private:
     int m_RequestedLabel;
-    Surface::Pointer m_Result;
+    bool m_GenerateAllLabels;
+    std::map<int, Surface::Pointer> m_Results;
   };
 
 } // namespace
@@ -56,6 +56,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkRGBAPixel.h>
 #include <mitkRenderingModeProperty.h>
 
+#include <cmath>
+
 mitk::LabelSetImageVtkMapper2D::LabelSetImageVtkMapper2D()
 {
 }
@@ -105,6 +107,7 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
     localStorage->m_LevelWindowFilterVector.clear();
     localStorage->m_LayerMapperVector.clear();
     localStorage->m_LayerActorVector.clear();
+    localStorage->m_DecodedLayerVector.assign(numberOfLayers, LocalStorage::DecodedLayer());
 
     localStorage->m_Actors = vtkSmartPointer<vtkPropAssembly>::New();
 
@@ -150,20 +153,25 @@ void mitk::LabelSetImageVtkMapper2D::GenerateDataForRenderer(mitk::BaseRenderer
   for (int lidx = 0; lidx < numberOfLayers; ++lidx)
   {
     mitk::Image *layerImage = nullptr;
+    int layerTimeStep = this->GetTimestep();
 
-    // set main input for ExtractSliceFilter
+    // set main input for ExtractSliceFilter, inactive layers are decoded slice-wise if possible
     if (lidx == activeLayer)
+    {
       layerImage = image;
+    }
     else
-      layerImage = image->GetLayerImage(lidx);
+    {
+      layerImage = this->GetInactiveLayerImage(localStorage, image, lidx, worldGeometry, layerTimeStep);
+    }
 
     localStorage->m_ReslicerVector[lidx]->SetInput(layerImage);
     localStorage->m_ReslicerVector[lidx]->SetWorldGeometry(worldGeometry);
-    localStorage->m_ReslicerVector[lidx]->SetTimeStep(this->GetTimestep());
+    localStorage->m_ReslicerVector[lidx]->SetTimeStep(layerTimeStep);
 
     // set the transformation of the image to adapt reslice axis
     localStorage->m_ReslicerVector[lidx]->SetResliceTransformByGeometry(
-      layerImage->GetTimeGeometry()->GetGeometryForTimeStep(this->GetTimestep()));
+      layerImage->GetTimeGeometry()->GetGeometryForTimeStep(layerTimeStep));
 
     // is the geometry of the slice based on the image image or the worldgeometry?
     bool inPlaneResampleExtentByGeometry = false;
@@ -311,6 +319,96 @@ bool mitk::LabelSetImageVtkMapper2D::RenderingGeometryIntersectsImage(const Plan
   return false;
 }
 
+mitk::Image *mitk::LabelSetImageVtkMapper2D::GetInactiveLayerImage(LocalStorage *localStorage,
+                                                                   mitk::LabelSetImage *image,
+                                                                   int layer,
+                                                                   const PlaneGeometry *renderingGeometry,
+                                                                   int &layerTimeStep)
+{
+  LocalStorage::DecodedLayer &decodedLayer = localStorage->m_DecodedLayerVector[layer];
+
+  if (!image->IsLayerRunLengthEncoded(layer))
+  {
+    // dense layers are not decoded by GetLayerImage()
+    decodedLayer = LocalStorage::DecodedLayer();
+    return image->GetLayerImage(layer);
+  }
+
+  const unsigned long layerMTime = image->GetLayerMTime(layer);
+  const int timeStep = this->GetTimestep();
+
+  unsigned int sliceDimension = 0;
+  unsigned int sliceIndex = 0;
+  if (this->GetShownSlice(image, renderingGeometry, sliceDimension, sliceIndex))
+  {
+    if (!decodedLayer.m_IsSlice || decodedLayer.m_Image.IsNull() || decodedLayer.m_LayerMTime != layerMTime ||
+        decodedLayer.m_TimeStep != timeStep || decodedLayer.m_SliceDimension != sliceDimension ||
+        decodedLayer.m_SliceIndex != sliceIndex)
+    {
+      // the buffer of the previously shown slice is reused
+      decodedLayer.m_Image = image->CreateLayerSliceImage(
+        layer, sliceDimension, sliceIndex, timeStep, decodedLayer.m_IsSlice ? decodedLayer.m_Image.GetPointer() : nullptr);
+      decodedLayer.m_IsSlice = true;
+      decodedLayer.m_SliceDimension = sliceDimension;
+      decodedLayer.m_SliceIndex = sliceIndex;
+      decodedLayer.m_TimeStep = timeStep;
+      decodedLayer.m_LayerMTime = layerMTime;
+    }
+
+    layerTimeStep = 0;
+    return decodedLayer.m_Image;
+  }
+
+  // oblique planes need the complete layer, it is decoded into a copy to keep the layer encoded
+  if (decodedLayer.m_IsSlice || decodedLayer.m_Image.IsNull() || decodedLayer.m_LayerMTime != layerMTime)
+  {
+    decodedLayer.m_Image = image->CreateLayerImage(layer);
+    decodedLayer.m_IsSlice = false;
+    decodedLayer.m_TimeStep = -1;
+    decodedLayer.m_LayerMTime = layerMTime;
+  }
+
+  return decodedLayer.m_Image;
+}
+
+bool mitk::LabelSetImageVtkMapper2D::GetShownSlice(const mitk::LabelSetImage *image,
+                                                   const PlaneGeometry *renderingGeometry,
+                                                   unsigned int &sliceDimension,
+                                                   unsigned int &sliceIndex)
+{
+  const int timestep = this->GetTimestep();
+  if (renderingGeometry == nullptr || timestep < 0 || static_cast<unsigned int>(timestep) >= image->GetTimeSteps())
+    return false;
+
+  const SlicedGeometry3D *imageGeometry = image->GetSlicedGeometry(timestep);
+
+  mitk::Vector3D normal = renderingGeometry->GetNormal();
+  normal.Normalize();
+
+  for (unsigned int dim = 0; dim < 3; ++dim)
+  {
+    mitk::Vector3D axis = imageGeometry->GetAxisVector(dim);
+    axis.Normalize();
+
+    // only slices perpendicular to an image axis can be decoded directly
+    if (std::abs(normal * axis) < 1.0 - 1e-6)
+      continue;
+
+    mitk::Point3D index;
+    imageGeometry->WorldToIndex(renderingGeometry->GetCenter(), index);
+    const auto shownSliceIndex = static_cast<int>(std::floor(index[dim] + 0.5));
+
+    if (shownSliceIndex < 0 || shownSliceIndex >= static_cast<int>(image->GetDimension(dim)))
+      return false;
+
+    sliceDimension = dim;
+    sliceIndex = shownSliceIndex;
+    return true;
+  }
+
+  return false;
+}
+
 vtkSmartPointer<vtkPolyData> mitk::LabelSetImageVtkMapper2D::CreateOutlinePolyData(mitk::BaseRenderer *renderer,
                                                                                    vtkImageData *image,
                                                                                    int pixelValue)
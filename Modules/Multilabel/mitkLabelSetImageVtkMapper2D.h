@@ -124,6 +124,20 @@ namespace mitk
       // vtkSmartPointer<vtkMitkLevelWindowFilter> m_LevelWindowFilter;
       std::vector<vtkSmartPointer<vtkMitkLevelWindowFilter>> m_LevelWindowFilterVector;
 
+      /** \brief Decoded image of an inactive, run-length encoded layer: the shown slice or the complete layer. */
+      struct DecodedLayer
+      {
+        mitk::Image::Pointer m_Image;
+        bool m_IsSlice = false;
+        unsigned int m_SliceDimension = 0;
+        unsigned int m_SliceIndex = 0;
+        int m_TimeStep = -1;
+        unsigned long m_LayerMTime = 0;
+      };
+
+      /** \brief Decoded inactive layers, reused as long as neither the layer nor the shown slice changes. */
+      std::vector<DecodedLayer> m_DecodedLayerVector;
+
       /** \brief Default constructor of the local storage. */
       LocalStorage();
       /** \brief Default deconstructor of the local storage. */
@@ -238,6 +252,30 @@ namespace mitk
       * If the distances have different sign, there is an intersection.
       **/
     bool RenderingGeometryIntersectsImage(const PlaneGeometry *renderingGeometry, SlicedGeometry3D *imageGeometry);
+
+    /**
+      * \brief Returns the image of an inactive layer that is resliced for the given rendering geometry.
+      *
+      * Dense layers are resliced directly. Of a run-length encoded layer only the shown slice is decoded if
+      * the rendering geometry is perpendicular to one of the image axes (see LabelSetImage::CreateLayerSliceImage()),
+      * otherwise the complete layer is decoded into a copy. The storage of the layer is never changed, the decoded
+      * image is kept in the local storage until the layer or the shown slice changes.
+      * layerTimeStep is set to the time step of the returned image that is shown.
+      **/
+    mitk::Image *GetInactiveLayerImage(LocalStorage *localStorage,
+                                       mitk::LabelSetImage *image,
+                                       int layer,
+                                       const PlaneGeometry *renderingGeometry,
+                                       int &layerTimeStep);
+
+    /**
+      * \brief Finds the slice of the image that is shown in the rendering geometry.
+      * Returns false if the rendering geometry is not perpendicular to an image axis or outside of the image.
+      **/
+    bool GetShownSlice(const mitk::LabelSetImage *image,
+                       const PlaneGeometry *renderingGeometry,
+                       unsigned int &sliceDimension,
+                       unsigned int &sliceIndex);
   };
 
 } // namespace mitk
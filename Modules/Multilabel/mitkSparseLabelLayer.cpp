@@ -0,0 +1,342 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include "mitkSparseLabelLayer.h"
+
+#include <mitkExceptionMacro.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+mitk::SparseLabelLayer::SparseLabelLayer()
+{
+  std::fill(m_Dimensions, m_Dimensions + 4, 1u);
+}
+
+void mitk::SparseLabelLayer::Initialize(unsigned int dimension, const unsigned int *dimensions)
+{
+  if (dimension < 2 || dimension > 4)
+    mitkThrow() << dimension << "-dimensional layers are not supported.";
+
+  std::fill(m_Dimensions, m_Dimensions + 4, 1u);
+  std::copy(dimensions, dimensions + dimension, m_Dimensions);
+
+  this->Clear();
+}
+
+void mitk::SparseLabelLayer::Encode(const PixelType *buffer)
+{
+  const std::size_t rowLength = m_Dimensions[0];
+  const std::size_t numberOfRows =
+    static_cast<std::size_t>(m_Dimensions[1]) * m_Dimensions[2] * m_Dimensions[3];
+
+  m_MTime.Modified();
+  m_Runs.clear();
+  m_RowOffsets.resize(numberOfRows + 1);
+
+  for (std::size_t row = 0; row < numberOfRows; ++row)
+  {
+    m_RowOffsets[row] = m_Runs.size();
+
+    const PixelType *rowBuffer = buffer + row * rowLength;
+    std::size_t x = 0;
+
+    while (x < rowLength)
+    {
+      const PixelType value = rowBuffer[x];
+
+      if (0 == value)
+      {
+        ++x;
+        continue;
+      }
+
+      const std::size_t start = x;
+      while (x < rowLength && rowBuffer[x] == value)
+        ++x;
+
+      Run run;
+      run.start = static_cast<uint32_t>(start);
+      run.length = static_cast<uint32_t>(x - start);
+      run.value = value;
+      m_Runs.push_back(run);
+    }
+  }
+
+  m_RowOffsets[numberOfRows] = m_Runs.size();
+
+  if (m_Runs.empty())
+  {
+    this->Clear();
+  }
+  else
+  {
+    m_Runs.shrink_to_fit();
+  }
+}
+
+void mitk::SparseLabelLayer::Decode(PixelType *buffer) const
+{
+  const std::size_t rowLength = m_Dimensions[0];
+  const std::size_t numberOfRows =
+    static_cast<std::size_t>(m_Dimensions[1]) * m_Dimensions[2] * m_Dimensions[3];
+
+  std::fill(buffer, buffer + rowLength * numberOfRows, 0);
+
+  if (this->IsEmpty())
+    return;
+
+  for (std::size_t row = 0; row < numberOfRows; ++row)
+  {
+    PixelType *rowBuffer = buffer + row * rowLength;
+
+    for (std::size_t i = m_RowOffsets[row]; i < m_RowOffsets[row + 1]; ++i)
+      std::fill(rowBuffer + m_Runs[i].start, rowBuffer + m_Runs[i].start + m_Runs[i].length, m_Runs[i].value);
+  }
+}
+
+void mitk::SparseLabelLayer::DecodeSlice(unsigned int sliceDimension,
+                                         unsigned int sliceIndex,
+                                         unsigned int timeStep,
+                                         PixelType *buffer) const
+{
+  if (sliceDimension > 2 || sliceIndex >= m_Dimensions[sliceDimension] || timeStep >= m_Dimensions[3])
+    mitkThrow() << "Slice " << sliceIndex << " of dimension " << sliceDimension << " and time step " << timeStep
+                << " is not part of the layer.";
+
+  const unsigned int sizeX = m_Dimensions[0];
+  const unsigned int sizeY = m_Dimensions[1];
+  const unsigned int sizeZ = m_Dimensions[2];
+
+  switch (sliceDimension)
+  {
+    case 0:
+      std::fill(buffer, buffer + static_cast<std::size_t>(sizeY) * sizeZ, 0);
+      break;
+    case 1:
+      std::fill(buffer, buffer + static_cast<std::size_t>(sizeX) * sizeZ, 0);
+      break;
+    default:
+      std::fill(buffer, buffer + static_cast<std::size_t>(sizeX) * sizeY, 0);
+      break;
+  }
+
+  if (this->IsEmpty())
+    return;
+
+  if (0 == sliceDimension)
+  {
+    // every voxel of the slice lies in a different row, look up the run covering the slice index
+    for (unsigned int z = 0; z < sizeZ; ++z)
+    {
+      for (unsigned int y = 0; y < sizeY; ++y)
+        buffer[static_cast<std::size_t>(z) * sizeY + y] = this->GetValue(this->GetRowIndex(y, z, timeStep), sliceIndex);
+    }
+    return;
+  }
+
+  // the slice is made of complete rows
+  const unsigned int numberOfRows = 1 == sliceDimension ? sizeZ : sizeY;
+  for (unsigned int i = 0; i < numberOfRows; ++i)
+  {
+    const std::size_t row =
+      1 == sliceDimension ? this->GetRowIndex(sliceIndex, i, timeStep) : this->GetRowIndex(i, sliceIndex, timeStep);
+    PixelType *rowBuffer = buffer + static_cast<std::size_t>(i) * sizeX;
+
+    for (std::size_t j = m_RowOffsets[row]; j < m_RowOffsets[row + 1]; ++j)
+      std::fill(rowBuffer + m_Runs[j].start, rowBuffer + m_Runs[j].start + m_Runs[j].length, m_Runs[j].value);
+  }
+}
+
+void mitk::SparseLabelLayer::RemapLabels(const std::vector<PixelType> &lookupTable)
+{
+  if (this->IsEmpty())
+    return;
+
+  m_MTime.Modified();
+
+  // runs are compacted in place, a row never grows
+  const std::size_t numberOfRows = m_RowOffsets.size() - 1;
+  std::size_t numberOfRuns = 0;
+
+  for (std::size_t row = 0; row < numberOfRows; ++row)
+  {
+    const std::size_t begin = m_RowOffsets[row];
+    const std::size_t end = m_RowOffsets[row + 1];
+    m_RowOffsets[row] = numberOfRuns;
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      Run run = m_Runs[i];
+      run.value = lookupTable[run.value];
+
+      if (0 == run.value)
+        continue;
+
+      if (numberOfRuns > m_RowOffsets[row])
+      {
+        Run &previous = m_Runs[numberOfRuns - 1];
+        if (previous.value == run.value && previous.start + previous.length == run.start)
+        {
+          previous.length += run.length;
+          continue;
+        }
+      }
+
+      m_Runs[numberOfRuns++] = run;
+    }
+  }
+
+  m_RowOffsets[numberOfRows] = numberOfRuns;
+  m_Runs.resize(numberOfRuns);
+
+  if (m_Runs.empty())
+    this->Clear();
+}
+
+void mitk::SparseLabelLayer::FillLabelIndex(unsigned int timeStep, LabelIndex &labelIndex) const
+{
+  if (timeStep >= m_Dimensions[3])
+    mitkThrow() << "Time step " << timeStep << " is not part of the layer.";
+
+  labelIndex.Clear();
+
+  if (this->IsEmpty())
+    return;
+
+  LabelIndex::IndexType index;
+
+  for (unsigned int z = 0; z < m_Dimensions[2]; ++z)
+  {
+    index[2] = z;
+    for (unsigned int y = 0; y < m_Dimensions[1]; ++y)
+    {
+      index[1] = y;
+      const std::size_t row = this->GetRowIndex(y, z, timeStep);
+
+      for (std::size_t i = m_RowOffsets[row]; i < m_RowOffsets[row + 1]; ++i)
+      {
+        index[0] = m_Runs[i].start;
+        labelIndex.AddRun(m_Runs[i].value, index, m_Runs[i].length);
+      }
+    }
+  }
+}
+
+bool mitk::SparseLabelLayer::FindNearestVoxel(PixelType value,
+                                              unsigned int timeStep,
+                                              const LabelIndex::RegionType &searchRegion,
+                                              const mitk::Point3D &point,
+                                              LabelIndex::IndexType &nearestIndex) const
+{
+  if (timeStep >= m_Dimensions[3])
+    mitkThrow() << "Time step " << timeStep << " is not part of the layer.";
+
+  if (this->IsEmpty())
+    return false;
+
+  const LabelIndex::IndexType lower = searchRegion.GetIndex();
+  const LabelIndex::IndexType upper = searchRegion.GetUpperIndex();
+  const double nearestX = std::floor(point[0] + 0.5);
+  double minDistance = std::numeric_limits<double>::max();
+
+  for (auto z = std::max<itk::IndexValueType>(lower[2], 0);
+       z <= std::min<itk::IndexValueType>(upper[2], m_Dimensions[2] - 1);
+       ++z)
+  {
+    for (auto y = std::max<itk::IndexValueType>(lower[1], 0);
+         y <= std::min<itk::IndexValueType>(upper[1], m_Dimensions[1] - 1);
+         ++y)
+    {
+      const double distanceYZ = (y - point[1]) * (y - point[1]) + (z - point[2]) * (z - point[2]);
+      if (distanceYZ >= minDistance)
+        continue;
+
+      const std::size_t row = this->GetRowIndex(y, z, timeStep);
+      for (std::size_t i = m_RowOffsets[row]; i < m_RowOffsets[row + 1]; ++i)
+      {
+        const Run &run = m_Runs[i];
+        const double runBegin = std::max<double>(run.start, lower[0]);
+        const double runEnd = std::min<double>(run.start + run.length - 1, upper[0]);
+
+        if (run.value != value || runBegin > runEnd)
+          continue;
+
+        // the voxel of the run nearest to the point
+        const double x = std::min(std::max(nearestX, runBegin), runEnd);
+        const double distance = distanceYZ + (x - point[0]) * (x - point[0]);
+
+        if (distance < minDistance)
+        {
+          minDistance = distance;
+          nearestIndex[0] = static_cast<itk::IndexValueType>(x);
+          nearestIndex[1] = y;
+          nearestIndex[2] = z;
+        }
+      }
+    }
+  }
+
+  return minDistance < std::numeric_limits<double>::max();
+}
+
+void mitk::SparseLabelLayer::Clear()
+{
+  m_MTime.Modified();
+  std::vector<std::size_t>().swap(m_RowOffsets);
+  std::vector<Run>().swap(m_Runs);
+}
+
+bool mitk::SparseLabelLayer::IsEmpty() const
+{
+  return m_Runs.empty();
+}
+
+std::size_t mitk::SparseLabelLayer::GetNumberOfRuns() const
+{
+  return m_Runs.size();
+}
+
+std::size_t mitk::SparseLabelLayer::GetMemorySize() const
+{
+  return m_RowOffsets.capacity() * sizeof(std::size_t) + m_Runs.capacity() * sizeof(Run);
+}
+
+unsigned long mitk::SparseLabelLayer::GetMTime() const
+{
+  return m_MTime.GetMTime();
+}
+
+std::size_t mitk::SparseLabelLayer::GetRowIndex(unsigned int y, unsigned int z, unsigned int timeStep) const
+{
+  return (static_cast<std::size_t>(timeStep) * m_Dimensions[2] + z) * m_Dimensions[1] + y;
+}
+
+mitk::SparseLabelLayer::PixelType mitk::SparseLabelLayer::GetValue(std::size_t row, unsigned int x) const
+{
+  auto begin = m_Runs.begin() + m_RowOffsets[row];
+  auto end = m_Runs.begin() + m_RowOffsets[row + 1];
+
+  // first run starting behind x, the run before it is the only candidate covering x
+  auto run = std::upper_bound(begin, end, x, [](unsigned int value, const Run &r) { return value < r.start; });
+
+  if (run == begin)
+    return 0;
+
+  --run;
+  return x < run->start + run->length ? run->value : 0;
+}
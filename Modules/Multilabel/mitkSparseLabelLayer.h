@@ -0,0 +1,154 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef __mitkSparseLabelLayer_H_
+#define __mitkSparseLabelLayer_H_
+
+#include <mitkLabel.h>
+#include <mitkLabelIndex.h>
+
+#include <MitkMultilabelExports.h>
+
+#include <itkTimeStamp.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mitk
+{
+  /**
+   * @brief Run-length encoded storage of a single layer of a mitk::LabelSetImage.
+   *
+   * Every image row (all voxels with the same y, z and time step) is stored as a list of runs
+   * of equal, non-exterior label values. Exterior voxels (value 0) are not stored at all, so the
+   * memory needed by a layer scales with the number of label boundaries along x instead of the
+   * number of voxels. An empty layer does not allocate any memory.
+   *
+   * Besides the conversion from and to a dense buffer, single slices perpendicular to any of the
+   * three image axes can be decoded without decoding the whole volume (see DecodeSlice()).
+   *
+   * @ingroup Data
+   */
+  class MITKMULTILABEL_EXPORT SparseLabelLayer
+  {
+  public:
+    typedef mitk::Label::PixelType PixelType;
+
+    SparseLabelLayer();
+
+    /**
+     * @brief Initializes an empty layer (all voxels exterior).
+     * @param dimension number of image dimensions (2 to 4)
+     * @param dimensions size of the image in every dimension
+     */
+    void Initialize(unsigned int dimension, const unsigned int *dimensions);
+
+    /**
+     * @brief Encodes a dense buffer of the size given in Initialize() (all time steps, x running fastest).
+     */
+    void Encode(const PixelType *buffer);
+
+    /**
+     * @brief Decodes the layer into a dense buffer of the size given in Initialize().
+     */
+    void Decode(PixelType *buffer) const;
+
+    /**
+     * @brief Decodes a single slice perpendicular to an image axis.
+     *
+     * The buffer has to hold the voxels of the slice, the remaining two axes are ordered
+     * as in the volume (the lower axis runs fastest):
+     *  - sliceDimension 0: y * z voxels
+     *  - sliceDimension 1: x * z voxels
+     *  - sliceDimension 2: x * y voxels
+     */
+    void DecodeSlice(unsigned int sliceDimension,
+                     unsigned int sliceIndex,
+                     unsigned int timeStep,
+                     PixelType *buffer) const;
+
+    /**
+     * @brief Replaces the value of every labeled voxel by lookupTable[value].
+     *
+     * The lookup table has to contain an entry for every possible pixel value. Runs mapped to
+     * the exterior are removed, adjacent runs mapped to the same value are joined.
+     */
+    void RemapLabels(const std::vector<PixelType> &lookupTable);
+
+    /**
+     * @brief Fills a label index with the runs of one time step, the layer is not decoded.
+     */
+    void FillLabelIndex(unsigned int timeStep, LabelIndex &labelIndex) const;
+
+    /**
+     * @brief Finds the voxel of a label within a search region of one time step that is nearest to a point
+     *        given in index coordinates, the layer is not decoded.
+     * @return false if the label has no voxels within the search region
+     */
+    bool FindNearestVoxel(PixelType value,
+                          unsigned int timeStep,
+                          const LabelIndex::RegionType &searchRegion,
+                          const mitk::Point3D &point,
+                          LabelIndex::IndexType &nearestIndex) const;
+
+    /**
+     * @brief Removes all runs, all voxels become exterior.
+     */
+    void Clear();
+
+    /**
+     * @brief Returns true if no voxel of the layer is labeled.
+     */
+    bool IsEmpty() const;
+
+    /**
+     * @brief Returns the number of runs of labeled voxels.
+     */
+    std::size_t GetNumberOfRuns() const;
+
+    /**
+     * @brief Returns the number of bytes allocated for the encoded layer.
+     */
+    std::size_t GetMemorySize() const;
+
+    /**
+     * @brief Returns the time of the last change of the encoded voxels.
+     */
+    unsigned long GetMTime() const;
+
+  private:
+    struct Run
+    {
+      uint32_t start;
+      uint32_t length;
+      PixelType value;
+    };
+
+    std::size_t GetRowIndex(unsigned int y, unsigned int z, unsigned int timeStep) const;
+    PixelType GetValue(std::size_t row, unsigned int x) const;
+
+    unsigned int m_Dimensions[4];
+
+    /** Offsets of the first run of every row into m_Runs, one additional entry marks the end.
+        Empty as long as the layer does not contain any labeled voxel. */
+    std::vector<std::size_t> m_RowOffsets;
+    std::vector<Run> m_Runs;
+
+    itk::TimeStamp m_MTime;
+  };
+} // namespace mitk
+
+#endif // __mitkSparseLabelLayer_H_
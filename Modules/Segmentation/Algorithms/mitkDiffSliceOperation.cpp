@@ -16,14 +16,108 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkDiffSliceOperation.h"
 
+#include "mitkVtkImageOverwrite.h"
+
+#include <mitkExtractSliceFilter.h>
 #include <mitkImage.h>
+#include <mitkImageReadAccessor.h>
+#include <mitkImageWriteAccessor.h>
 
 #include <itkCommand.h>
 
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+  bool HaveSameLayout(const mitk::Image *slice, const mitk::Image *referenceSlice)
+  {
+    return referenceSlice != nullptr && slice->GetPixelType() == referenceSlice->GetPixelType() &&
+           slice->GetDimension(0) == referenceSlice->GetDimension(0) &&
+           slice->GetDimension(1) == referenceSlice->GetDimension(1) && 1 == slice->GetDimension(2) &&
+           1 == referenceSlice->GetDimension(2);
+  }
+
+  /** Determines the bounding box of all pixels which differ between both slices */
+  itk::ImageRegion<2> DetermineChangedRegion(const mitk::Image *slice, const mitk::Image *referenceSlice)
+  {
+    const long sizeX = slice->GetDimension(0);
+    const long sizeY = slice->GetDimension(1);
+    const std::size_t pixelSize = slice->GetPixelType().GetSize();
+    const std::size_t rowSize = sizeX * pixelSize;
+
+    mitk::ImageReadAccessor sliceAccessor(slice);
+    mitk::ImageReadAccessor referenceAccessor(referenceSlice);
+    const auto *sliceData = static_cast<const char *>(sliceAccessor.GetData());
+    const auto *referenceData = static_cast<const char *>(referenceAccessor.GetData());
+
+    long minX = sizeX;
+    long maxX = -1;
+    long minY = sizeY;
+    long maxY = -1;
+
+    for (long y = 0; y < sizeY; ++y)
+    {
+      const char *sliceRow = sliceData + y * rowSize;
+      const char *referenceRow = referenceData + y * rowSize;
+
+      if (0 == std::memcmp(sliceRow, referenceRow, rowSize))
+        continue;
+
+      minY = std::min(minY, y);
+      maxY = y;
+
+      long x = 0;
+      while (0 == std::memcmp(sliceRow + x * pixelSize, referenceRow + x * pixelSize, pixelSize))
+        ++x;
+      minX = std::min(minX, x);
+
+      x = sizeX - 1;
+      while (0 == std::memcmp(sliceRow + x * pixelSize, referenceRow + x * pixelSize, pixelSize))
+        --x;
+      maxX = std::max(maxX, x);
+    }
+
+    itk::ImageRegion<2> region;
+    if (maxY < 0)
+      return region;
+
+    region.SetIndex(0, minX);
+    region.SetIndex(1, minY);
+    region.SetSize(0, maxX - minX + 1);
+    region.SetSize(1, maxY - minY + 1);
+    return region;
+  }
+
+  void CopyRegion(const mitk::Image *source,
+                  const itk::Index<2> &sourceIndex,
+                  mitk::Image *target,
+                  const itk::Index<2> &targetIndex,
+                  const itk::Size<2> &size)
+  {
+    const std::size_t pixelSize = source->GetPixelType().GetSize();
+    const std::size_t sourceRowSize = source->GetDimension(0) * pixelSize;
+    const std::size_t targetRowSize = target->GetDimension(0) * pixelSize;
+
+    mitk::ImageReadAccessor sourceAccessor(source);
+    mitk::ImageWriteAccessor targetAccessor(target);
+    const auto *sourceData = static_cast<const char *>(sourceAccessor.GetData());
+    auto *targetData = static_cast<char *>(targetAccessor.GetData());
+
+    for (std::size_t y = 0; y < size[1]; ++y)
+    {
+      std::memcpy(targetData + (targetIndex[1] + y) * targetRowSize + targetIndex[0] * pixelSize,
+                  sourceData + (sourceIndex[1] + y) * sourceRowSize + sourceIndex[0] * pixelSize,
+                  size[0] * pixelSize);
+    }
+  }
+}
+
 mitk::DiffSliceOperation::DiffSliceOperation() : Operation(1)
 {
   m_TimeStep = 0;
-  m_zlibSliceContainer = nullptr;
+  m_UncompressedSize = 0;
+  m_SliceSize.Fill(0);
   m_Image = nullptr;
   m_WorldGeometry = nullptr;
   m_SliceGeometry = nullptr;
@@ -38,6 +132,43 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
                                              BaseGeometry *currentWorldGeometry)
   : Operation(1)
 
+{
+  this->Initialize(imageVolume, sliceGeometry, timestep, currentWorldGeometry);
+
+  itk::ImageRegion<2> region;
+  region.SetSize(0, slice->GetDimension(0));
+  region.SetSize(1, slice->GetDimension(1));
+  this->StoreSliceRegion(slice, region);
+}
+
+mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
+                                             Image *slice,
+                                             Image *referenceSlice,
+                                             SlicedGeometry3D *sliceGeometry,
+                                             unsigned int timestep,
+                                             BaseGeometry *currentWorldGeometry)
+  : Operation(1)
+{
+  this->Initialize(imageVolume, sliceGeometry, timestep, currentWorldGeometry);
+
+  itk::ImageRegion<2> region;
+  if (HaveSameLayout(slice, referenceSlice))
+  {
+    region = DetermineChangedRegion(slice, referenceSlice);
+  }
+  else
+  {
+    region.SetSize(0, slice->GetDimension(0));
+    region.SetSize(1, slice->GetDimension(1));
+  }
+
+  this->StoreSliceRegion(slice, region);
+}
+
+void mitk::DiffSliceOperation::Initialize(mitk::Image *imageVolume,
+                                          SlicedGeometry3D *sliceGeometry,
+                                          unsigned int timestep,
+                                          BaseGeometry *currentWorldGeometry)
 {
   m_WorldGeometry = currentWorldGeometry->Clone();
 
@@ -52,9 +183,6 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
 
   m_TimeStep = timestep;
 
-  m_zlibSliceContainer = CompressedImageContainer::New();
-  m_zlibSliceContainer->SetImage(slice);
-
   m_Image = imageVolume;
   m_DeleteObserverTag = 0;
 
@@ -73,10 +201,50 @@ mitk::DiffSliceOperation::DiffSliceOperation(mitk::Image *imageVolume,
     m_ImageIsValid = false;
 }
 
+void mitk::DiffSliceOperation::StoreSliceRegion(mitk::Image *slice, const itk::ImageRegion<2> &region)
+{
+  m_SliceSize[0] = slice->GetDimension(0);
+  m_SliceSize[1] = slice->GetDimension(1);
+  m_SliceRegion = region;
+
+  // copy the region on the calling thread, the caller may reuse the slice afterwards
+  Image::Pointer regionImage;
+  if (region.GetSize() == m_SliceSize)
+  {
+    regionImage = slice->Clone();
+  }
+  else if (region.GetNumberOfPixels() > 0)
+  {
+    const unsigned int dimensions[] = {static_cast<unsigned int>(region.GetSize(0)),
+                                       static_cast<unsigned int>(region.GetSize(1))};
+    regionImage = Image::New();
+    regionImage->Initialize(slice->GetPixelType(), 2, dimensions);
+
+    itk::Index<2> origin;
+    origin.Fill(0);
+    CopyRegion(slice, region.GetIndex(), regionImage, origin, region.GetSize());
+  }
+
+  m_UncompressedSize = region.GetNumberOfPixels() * slice->GetPixelType().GetSize();
+
+  m_zlibSliceContainer = std::async(std::launch::async, [regionImage]() mutable {
+                           CompressedImageContainer::Pointer container;
+                           if (regionImage.IsNotNull())
+                           {
+                             container = CompressedImageContainer::New();
+                             container->SetImage(regionImage);
+                             regionImage = nullptr;
+                           }
+                           return container;
+                         }).share();
+}
+
 mitk::DiffSliceOperation::~DiffSliceOperation()
 {
   m_WorldGeometry = nullptr;
-  m_zlibSliceContainer = nullptr;
+
+  // waits for a running compression
+  m_zlibSliceContainer = std::shared_future<CompressedImageContainer::Pointer>();
 
   if (m_ImageIsValid)
   {
@@ -88,13 +256,85 @@ mitk::DiffSliceOperation::~DiffSliceOperation()
 
 mitk::Image::Pointer mitk::DiffSliceOperation::GetSlice()
 {
-  Image::Pointer image = m_zlibSliceContainer->GetImage();
-  return image;
+  if (!m_zlibSliceContainer.valid())
+    return nullptr;
+
+  CompressedImageContainer::Pointer container = m_zlibSliceContainer.get();
+  Image::Pointer regionImage = container.IsNotNull() ? container->GetImage() : nullptr;
+
+  if (m_SliceRegion.GetSize() == m_SliceSize)
+    return regionImage;
+
+  // only the changed region is stored, the remaining pixels did not change and are taken from the volume
+  Image::Pointer slice = this->ExtractCurrentSlice();
+
+  if (slice.IsNull() || regionImage.IsNull())
+    return slice;
+
+  if (slice->GetDimension(0) != m_SliceSize[0] || slice->GetDimension(1) != m_SliceSize[1] ||
+      slice->GetPixelType() != regionImage->GetPixelType())
+  {
+    MITK_ERROR << "Slice of the image volume does not match the stored slice region.";
+    return slice;
+  }
+
+  itk::Index<2> origin;
+  origin.Fill(0);
+  CopyRegion(regionImage, origin, slice, m_SliceRegion.GetIndex(), m_SliceRegion.GetSize());
+
+  return slice;
+}
+
+std::size_t mitk::DiffSliceOperation::GetMemorySize() const
+{
+  std::size_t memorySize = sizeof(DiffSliceOperation);
+
+  if (m_zlibSliceContainer.valid())
+  {
+    if (m_zlibSliceContainer.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+    {
+      const CompressedImageContainer::Pointer &container = m_zlibSliceContainer.get();
+      if (container.IsNotNull())
+        memorySize += container->GetCompressedSize();
+    }
+    else
+    {
+      memorySize += m_UncompressedSize;
+    }
+  }
+
+  return memorySize;
+}
+
+mitk::Image::Pointer mitk::DiffSliceOperation::ExtractCurrentSlice()
+{
+  if (!m_ImageIsValid)
+    return nullptr;
+
+  // use the same reslice algorithm as for overwriting
+  vtkSmartPointer<mitkVtkImageOverwrite> reslice = vtkSmartPointer<mitkVtkImageOverwrite>::New();
+  reslice->SetOverwriteMode(false);
+  reslice->Modified();
+
+  mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New(reslice);
+  extractor->SetInput(m_Image);
+  extractor->SetTimeStep(m_TimeStep);
+  extractor->SetWorldGeometry(dynamic_cast<PlaneGeometry *>(m_WorldGeometry.GetPointer()));
+  extractor->SetVtkOutputRequest(false);
+  extractor->SetResliceTransformByGeometry(m_Image->GetGeometry(m_TimeStep));
+
+  extractor->Modified();
+  extractor->Update();
+
+  Image::Pointer slice = extractor->GetOutput();
+  slice->DisconnectPipeline();
+
+  return slice;
 }
 
 bool mitk::DiffSliceOperation::IsValid()
 {
-  return m_ImageIsValid && m_zlibSliceContainer.IsNotNull() && (m_WorldGeometry.IsNotNull()); // TODO improve
+  return m_ImageIsValid && m_zlibSliceContainer.valid() && (m_WorldGeometry.IsNotNull()); // TODO improve
 }
 
 void mitk::DiffSliceOperation::OnImageDeleted()
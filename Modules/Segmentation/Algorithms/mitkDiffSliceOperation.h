@@ -21,8 +21,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkSegmentationExports.h>
 #include <mitkOperation.h>
 
+#include <itkImageRegion.h>
 #include <vtkSmartPointer.h>
 
+#include <future>
+
 namespace mitk
 {
   class Image;
@@ -38,6 +41,10 @@ namespace mitk
      currentWorldGeometry   specifies the axis where the slice has to be applied in the volume.
 
     This Operation can be used to realize undo-redo functionality for e.g. segmentation purposes.
+
+    If a reference slice is given, only the bounding box of the pixels which differ between slice and
+    reference slice is stored. The remaining pixels are taken from the image volume when the operation
+    is applied. The stored pixels are compressed in a background thread.
   */
   class MITKSEGMENTATION_EXPORT DiffSliceOperation : public Operation
   {
@@ -54,9 +61,22 @@ namespace mitk
     */
     DiffSliceOperation();
 
-    /** \brief */
+    /** \brief Creates an operation storing the complete slice. */
+    DiffSliceOperation(mitk::Image *imageVolume,
+                       mitk::Image *slice,
+                       SlicedGeometry3D *sliceGeometry,
+                       unsigned int timestep,
+                       BaseGeometry *currentWorldGeometry);
+
+    /** \brief Creates an operation storing only the pixels of slice in the region where it differs from referenceSlice.
+
+      The operation is meant to be applied while the image volume contains referenceSlice, e.g. the slice
+      before an edit for the redo operation and the edited slice for the undo operation.
+      The complete slice is stored if both slices do not have the same pixel type and size.
+    */
     DiffSliceOperation(mitk::Image *imageVolume,
                        mitk::Image *slice,
+                       mitk::Image *referenceSlice,
                        SlicedGeometry3D *sliceGeometry,
                        unsigned int timestep,
                        BaseGeometry *currentWorldGeometry);
@@ -70,9 +90,17 @@ namespace mitk
     mitk::Image *GetImage() { return this->m_Image; }
     /** \brief Set thee slice to be applied.*/
     void SetImage(vtkImageData *slice) { this->m_Slice = slice; }
-    /** \brief Get the slice that is applied in the operation.*/
+    /** \brief Get the slice that is applied in the operation.
+
+      If only a region of the slice is stored, the remaining pixels are extracted from the image volume.
+    */
     Image::Pointer GetSlice();
 
+    /** \brief Returns the number of bytes held by the operation, i.e. the size of the compressed
+      slice region or, while the compression is still running, its uncompressed size.
+    */
+    std::size_t GetMemorySize() const override;
+
     /** \brief Get timeStep.*/
     void SetTimeStep(unsigned int timestep) { this->m_TimeStep = timestep; }
     /** \brief Set timeStep*/
@@ -91,7 +119,26 @@ namespace mitk
     /** \brief Callback for image observer.*/
     void OnImageDeleted();
 
-    CompressedImageContainer::Pointer m_zlibSliceContainer;
+    /** \brief Initializes the geometries and the image observer.*/
+    void Initialize(mitk::Image *imageVolume,
+                    SlicedGeometry3D *sliceGeometry,
+                    unsigned int timestep,
+                    BaseGeometry *currentWorldGeometry);
+
+    /** \brief Copies a region of the slice and starts its compression in a background thread.*/
+    void StoreSliceRegion(mitk::Image *slice, const itk::ImageRegion<2> &region);
+
+    /** \brief Extracts the slice of the image volume that is overwritten by the operation.*/
+    Image::Pointer ExtractCurrentSlice();
+
+    /** \brief The compressed slice region, nullptr if the region is empty.*/
+    std::shared_future<CompressedImageContainer::Pointer> m_zlibSliceContainer;
+
+    std::size_t m_UncompressedSize;
+
+    itk::ImageRegion<2> m_SliceRegion;
+
+    itk::Size<2> m_SliceSize;
 
     mitk::Image *m_Image;
 
@@ -19,7 +19,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkDiffSliceOperation.h"
 #include "mitkRenderingManager.h"
 #include "mitkSegTool2D.h"
+#include "mitkSegmentationInterpolationController.h"
 #include <mitkExtractSliceFilter.h>
+#include <mitkImageRegionModifiedEvent.h>
 #include <mitkVtkImageOverwrite.h>
 
 // VTK
@@ -44,6 +46,29 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
   // chak if the operation is valid
   if (imageOperation->IsValid())
   {
+    // keep the slice before the change for the slice interpolation
+    mitk::Image::Pointer originalSlice;
+    SegmentationInterpolationController *interpolator =
+      SegmentationInterpolationController::InterpolatorForImage(imageOperation->GetImage());
+
+    if (interpolator)
+    {
+      mitk::ExtractSliceFilter::Pointer originalSliceExtractor = mitk::ExtractSliceFilter::New();
+      originalSliceExtractor->SetInput(imageOperation->GetImage());
+      originalSliceExtractor->SetTimeStep(imageOperation->GetTimeStep());
+      originalSliceExtractor->SetWorldGeometry(dynamic_cast<PlaneGeometry *>(imageOperation->GetWorldGeometry()));
+      originalSliceExtractor->SetResliceTransformByGeometry(
+        imageOperation->GetImage()->GetGeometry(imageOperation->GetTimeStep()));
+      originalSliceExtractor->Modified();
+      originalSliceExtractor->Update();
+
+      originalSlice = originalSliceExtractor->GetOutput();
+      originalSlice->DisconnectPipeline();
+
+      // block the complete scan of the image, the slice difference is passed after the change
+      interpolator->BlockModified(true);
+    }
+
     // the actual overwrite filter (vtk)
     vtkSmartPointer<mitkVtkImageOverwrite> reslice = vtkSmartPointer<mitkVtkImageOverwrite>::New();
 
@@ -66,6 +91,26 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
     extractor->Modified();
     extractor->Update();
 
+    // only the voxels in the overwritten extent changed, the region stays empty if nothing changed
+    int overwrittenExtent[6];
+    reslice->GetOverwrittenExtent(overwrittenExtent);
+    itk::ImageRegion<3> changedRegion;
+    if (overwrittenExtent[0] <= overwrittenExtent[1])
+    {
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        changedRegion.SetIndex(i, overwrittenExtent[2 * i]);
+        changedRegion.SetSize(i, overwrittenExtent[2 * i + 1] - overwrittenExtent[2 * i] + 1);
+      }
+    }
+
+    // observers that keep results up to date (e.g. image statistics) only have to visit the changed region
+    if (changedRegion.GetNumberOfPixels() > 0)
+    {
+      imageOperation->GetImage()->InvokeEvent(
+        ImageRegionModifiedEvent(changedRegion, imageOperation->GetTimeStep()));
+    }
+
     // make sure the modification is rendered
     RenderingManager::GetInstance()->RequestUpdateAll();
     imageOperation->GetImage()->Modified();
@@ -82,6 +127,17 @@ void mitk::DiffSliceOperationApplier::ExecuteOperation(Operation *operation)
     mitk::Image::Pointer slice2 = extractor2->GetOutput();
     mitk::PlaneGeometry::Pointer plane = dynamic_cast<PlaneGeometry *>(imageOperation->GetWorldGeometry());
     slice2->DisconnectPipeline();
+
+    if (interpolator)
+    {
+      interpolator->BlockModified(false);
+
+      if (!interpolator->SetChangedSlice(originalSlice, slice2, imageOperation->GetTimeStep(), &changedRegion))
+      {
+        // the slice is not aligned with the image axes, scan the whole image
+        imageOperation->GetImage()->Modified();
+      }
+    }
     mitk::SegTool2D::UpdateSurfaceInterpolation(slice2, imageOperation->GetImage(), plane, true);
   }
 }
@@ -31,6 +31,8 @@ mitk::ImageLiveWireContourModelFilter::ImageLiveWireContourModelFilter()
   m_CostFunction = CostFunctionType::New();
   m_ShortestPathFilter = ShortestPathImageFilterType::New();
   m_ShortestPathFilter->SetCostFunction(m_CostFunction);
+  // the start point is fixed while the end point follows the mouse, so continue the last search
+  m_ShortestPathFilter->SetReuseSearchTree(true);
   m_UseDynamicCostMap = false;
   m_TimeStep = 0;
 }
@@ -41,98 +41,9 @@ void mitk::ManualSegmentationToSurfaceFilter::GenerateData()
 {
   mitk::Surface *surface = this->GetOutput();
   auto *image = (mitk::Image *)GetInput();
-  mitk::Image::RegionType outputRegion = image->GetRequestedRegion();
 
-  int tstart = outputRegion.GetIndex(3);
-  int tmax = tstart + outputRegion.GetSize(3); // GetSize()==1 - will aber 0 haben, wenn nicht zeitaufgeloest
-
-  ScalarType thresholdExpanded = this->m_Threshold;
-
-  if ((tmax - tstart) > 0)
-  {
-    ProgressBar::GetInstance()->AddStepsToDo(4 * (tmax - tstart));
-  }
-  else
-  {
-    ProgressBar::GetInstance()->AddStepsToDo(4);
-  }
-
-  for (int t = tstart; t < tmax; ++t)
-  {
-    vtkSmartPointer<vtkImageData> vtkimage = image->GetVtkImageData(t);
-
-    // Median -->smooth 3D
-    // MITK_INFO << (m_MedianFilter3D ? "Applying median..." : "No median filtering");
-    if (m_MedianFilter3D)
-    {
-      vtkImageMedian3D *median = vtkImageMedian3D::New();
-      median->SetInputData(vtkimage);                                                       // RC++ (VTK < 5.0)
-      median->SetKernelSize(m_MedianKernelSizeX, m_MedianKernelSizeY, m_MedianKernelSizeZ); // Std: 3x3x3
-      median->ReleaseDataFlagOn();
-      median->UpdateInformation();
-      median->Update();
-      vtkimage = median->GetOutput(); //->Out
-      median->Delete();
-    }
-    ProgressBar::GetInstance()->Progress();
-
-    // Interpolate image spacing
-    // MITK_INFO << (m_Interpolation ? "Resampling..." : "No resampling");
-    if (m_Interpolation)
-    {
-      vtkImageResample *imageresample = vtkImageResample::New();
-      imageresample->SetInputData(vtkimage);
-
-      // Set Spacing Manual to 1mm in each direction (Original spacing is lost during image processing)
-      imageresample->SetAxisOutputSpacing(0, m_InterpolationX);
-      imageresample->SetAxisOutputSpacing(1, m_InterpolationY);
-      imageresample->SetAxisOutputSpacing(2, m_InterpolationZ);
-      imageresample->UpdateInformation();
-      imageresample->Update();
-      vtkimage = imageresample->GetOutput(); //->Output
-      imageresample->Delete();
-    }
-    ProgressBar::GetInstance()->Progress();
-
-    // MITK_INFO << (m_UseGaussianImageSmooth ? "Applying gaussian smoothing..." : "No gaussian smoothing");
-    if (m_UseGaussianImageSmooth) // gauss
-    {
-      vtkImageShiftScale *scalefilter = vtkImageShiftScale::New();
-      scalefilter->SetScale(100);
-      scalefilter->SetInputData(vtkimage);
-      scalefilter->Update();
-
-      vtkImageGaussianSmooth *gaussian = vtkImageGaussianSmooth::New();
-      gaussian->SetInputConnection(scalefilter->GetOutputPort());
-      gaussian->SetDimensionality(3);
-      gaussian->SetRadiusFactor(0.49);
-      gaussian->SetStandardDeviation(m_GaussianStandardDeviation);
-      gaussian->ReleaseDataFlagOn();
-      gaussian->UpdateInformation();
-      gaussian->Update();
-
-      vtkimage = scalefilter->GetOutput();
-
-      double range[2];
-      vtkimage->GetScalarRange(range);
-
-      if (range[1] != 0) // too little slices, image smoothing eliminates all segmentation pixels
-      {
-        vtkimage = gaussian->GetOutput(); //->Out
-      }
-      else
-      {
-        MITK_INFO << "Smoothing would remove all pixels of the segmentation. Use unsmoothed result instead.";
-      }
-      gaussian->Delete();
-      scalefilter->Delete();
-    }
-    ProgressBar::GetInstance()->Progress();
-
-    // Create surface for t-Slice
-    CreateSurface(t, vtkimage, surface, thresholdExpanded);
-    ProgressBar::GetInstance()->Progress();
-  }
+  // the time steps are pre-processed and converted concurrently, see PreprocessImage()
+  Superclass::GenerateData();
 
   // MITK_INFO << "Updating Time Geometry to ensure right timely displaying";
   // Fixing wrong time geometry
@@ -153,6 +64,78 @@ void mitk::ManualSegmentationToSurfaceFilter::GenerateData()
   }
 };
 
+vtkSmartPointer<vtkImageData> mitk::ManualSegmentationToSurfaceFilter::PreprocessImage(vtkImageData *image)
+{
+  vtkSmartPointer<vtkImageData> vtkimage = image;
+
+  // Median -->smooth 3D
+  // MITK_INFO << (m_MedianFilter3D ? "Applying median..." : "No median filtering");
+  if (m_MedianFilter3D)
+  {
+    vtkImageMedian3D *median = vtkImageMedian3D::New();
+    median->SetInputData(vtkimage);                                                       // RC++ (VTK < 5.0)
+    median->SetKernelSize(m_MedianKernelSizeX, m_MedianKernelSizeY, m_MedianKernelSizeZ); // Std: 3x3x3
+    median->ReleaseDataFlagOn();
+    median->UpdateInformation();
+    median->Update();
+    vtkimage = median->GetOutput(); //->Out
+    median->Delete();
+  }
+
+  // Interpolate image spacing
+  // MITK_INFO << (m_Interpolation ? "Resampling..." : "No resampling");
+  if (m_Interpolation)
+  {
+    vtkImageResample *imageresample = vtkImageResample::New();
+    imageresample->SetInputData(vtkimage);
+
+    // Set Spacing Manual to 1mm in each direction (Original spacing is lost during image processing)
+    imageresample->SetAxisOutputSpacing(0, m_InterpolationX);
+    imageresample->SetAxisOutputSpacing(1, m_InterpolationY);
+    imageresample->SetAxisOutputSpacing(2, m_InterpolationZ);
+    imageresample->UpdateInformation();
+    imageresample->Update();
+    vtkimage = imageresample->GetOutput(); //->Output
+    imageresample->Delete();
+  }
+
+  // MITK_INFO << (m_UseGaussianImageSmooth ? "Applying gaussian smoothing..." : "No gaussian smoothing");
+  if (m_UseGaussianImageSmooth) // gauss
+  {
+    vtkImageShiftScale *scalefilter = vtkImageShiftScale::New();
+    scalefilter->SetScale(100);
+    scalefilter->SetInputData(vtkimage);
+    scalefilter->Update();
+
+    vtkImageGaussianSmooth *gaussian = vtkImageGaussianSmooth::New();
+    gaussian->SetInputConnection(scalefilter->GetOutputPort());
+    gaussian->SetDimensionality(3);
+    gaussian->SetRadiusFactor(0.49);
+    gaussian->SetStandardDeviation(m_GaussianStandardDeviation);
+    gaussian->ReleaseDataFlagOn();
+    gaussian->UpdateInformation();
+    gaussian->Update();
+
+    vtkimage = scalefilter->GetOutput();
+
+    double range[2];
+    vtkimage->GetScalarRange(range);
+
+    if (range[1] != 0) // too little slices, image smoothing eliminates all segmentation pixels
+    {
+      vtkimage = gaussian->GetOutput(); //->Out
+    }
+    else
+    {
+      MITK_INFO << "Smoothing would remove all pixels of the segmentation. Use unsmoothed result instead.";
+    }
+    gaussian->Delete();
+    scalefilter->Delete();
+  }
+
+  return vtkimage;
+}
+
 void mitk::ManualSegmentationToSurfaceFilter::SetMedianKernelSize(int x, int y, int z)
 {
   m_MedianKernelSizeX = x;
@@ -152,6 +152,11 @@ namespace mitk
     ManualSegmentationToSurfaceFilter();
     ~ManualSegmentationToSurfaceFilter() override;
 
+    /**
+     * Applies the enabled median, interpolation and Gaussian filters to the image of a time step.
+     */
+    vtkSmartPointer<vtkImageData> PreprocessImage(vtkImageData *vtkimage) override;
+
     bool m_MedianFilter3D;
     int m_MedianKernelSizeX, m_MedianKernelSizeY, m_MedianKernelSizeZ;
     bool m_UseGaussianImageSmooth; // Gaussian Filter
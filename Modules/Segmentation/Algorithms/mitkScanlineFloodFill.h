@@ -0,0 +1,256 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#ifndef mitkScanlineFloodFill_h_Included
+#define mitkScanlineFloodFill_h_Included
+
+#include <itkImageRegion.h>
+#include <itkImageRegionIteratorWithIndex.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace mitk
+{
+  /**
+    \brief Scanline flood fill on a packed bit mask.
+
+    Fills all pixels of a region that are face connected to a seed and accepted by a predicate.
+    A run along the first dimension is filled at once, and only the first pixel of every run of
+    candidates in the neighboring rows is put on the stack. The filled pixels are kept as one bit
+    per pixel together with their bounding box, so no intermediate image is allocated.
+
+    The predicate is called with the linear offset of a pixel in the region. If the region is the
+    buffered region of an image, this is the offset into the image buffer. Fill() may be called
+    several times to grow from more than one seed, filled pixels are never tested again.
+
+    The fill works in 2D and 3D. To grow within a single slice of a volume, pass a region that is
+    one pixel thick in the slice direction.
+  */
+  template <unsigned int VDimension>
+  class ScanlineFloodFill
+  {
+  public:
+    typedef itk::ImageRegion<VDimension> RegionType;
+    typedef typename RegionType::IndexType IndexType;
+    typedef typename RegionType::SizeType SizeType;
+    typedef std::size_t OffsetType;
+
+    ScanlineFloodFill() { this->Initialize(RegionType()); }
+    explicit ScanlineFloodFill(const RegionType &region) { this->Initialize(region); }
+
+    /** \brief Clears the mask and sets the region that may be filled. */
+    void Initialize(const RegionType &region)
+    {
+      m_Region = region;
+
+      OffsetType numberOfPixels = 1;
+      for (unsigned int i = 0; i < VDimension; ++i)
+      {
+        m_Strides[i] = numberOfPixels;
+        numberOfPixels *= region.GetSize(i);
+      }
+
+      m_NumberOfPixels = numberOfPixels;
+      m_Bits.assign((numberOfPixels + 63) / 64, 0);
+      m_NumberOfFilledPixels = 0;
+    }
+
+    /**
+      \brief Fills the pixels connected to seed that are accepted by inside(offset).
+      \return the number of newly filled pixels
+    */
+    template <typename TPredicate>
+    OffsetType Fill(const IndexType &seed, TPredicate inside)
+    {
+      if (!m_Region.IsInside(seed))
+        return 0;
+
+      const OffsetType filledBefore = m_NumberOfFilledPixels;
+      const OffsetType rowLength = m_Region.GetSize(0);
+
+      std::vector<OffsetType> stack;
+      stack.push_back(this->ComputeOffset(seed));
+
+      while (!stack.empty())
+      {
+        const OffsetType offset = stack.back();
+        stack.pop_back();
+
+        if (this->IsFilled(offset) || !inside(offset))
+          continue;
+
+        // grow the run along the row in both directions
+        const OffsetType rowStart = offset - offset % rowLength;
+        OffsetType first = offset;
+        while (first > rowStart && !this->IsFilled(first - 1) && inside(first - 1))
+          --first;
+
+        OffsetType last = offset;
+        while (last + 1 < rowStart + rowLength && !this->IsFilled(last + 1) && inside(last + 1))
+          ++last;
+
+        for (OffsetType i = first; i <= last; ++i)
+          this->SetFilled(i);
+
+        const IndexType firstIndex = this->ComputeIndex(first);
+        IndexType lastIndex = firstIndex;
+        lastIndex[0] += static_cast<typename IndexType::IndexValueType>(last - first);
+        this->GrowBoundingBox(firstIndex, lastIndex);
+
+        m_NumberOfFilledPixels += last - first + 1;
+
+        // the rows above and below the run in every other dimension
+        for (unsigned int i = 1; i < VDimension; ++i)
+        {
+          if (firstIndex[i] > m_Region.GetIndex(i))
+            this->PushRuns(first - m_Strides[i], last - m_Strides[i], inside, stack);
+
+          if (firstIndex[i] < m_Region.GetUpperIndex()[i])
+            this->PushRuns(first + m_Strides[i], last + m_Strides[i], inside, stack);
+        }
+      }
+
+      return m_NumberOfFilledPixels - filledBefore;
+    }
+
+    /** \brief Fills from every pixel on the border of the region, e.g. to find the background around an object. */
+    template <typename TPredicate>
+    OffsetType FillFromBorder(TPredicate inside)
+    {
+      const OffsetType filledBefore = m_NumberOfFilledPixels;
+      const IndexType upperIndex = m_Region.GetUpperIndex();
+
+      for (OffsetType offset = 0; offset < m_NumberOfPixels; ++offset)
+      {
+        const IndexType index = this->ComputeIndex(offset);
+
+        bool isBorder = false;
+        for (unsigned int i = 0; i < VDimension && !isBorder; ++i)
+          isBorder = index[i] == m_Region.GetIndex(i) || index[i] == upperIndex[i];
+
+        if (isBorder && !this->IsFilled(offset))
+          this->Fill(index, inside);
+      }
+
+      return m_NumberOfFilledPixels - filledBefore;
+    }
+
+    bool IsFilled(OffsetType offset) const { return 0 != ((m_Bits[offset >> 6] >> (offset & 63)) & 1); }
+    bool IsFilled(const IndexType &index) const
+    {
+      return m_Region.IsInside(index) && this->IsFilled(this->ComputeOffset(index));
+    }
+
+    OffsetType ComputeOffset(const IndexType &index) const
+    {
+      OffsetType offset = 0;
+      for (unsigned int i = 0; i < VDimension; ++i)
+        offset += static_cast<OffsetType>(index[i] - m_Region.GetIndex(i)) * m_Strides[i];
+      return offset;
+    }
+
+    IndexType ComputeIndex(OffsetType offset) const
+    {
+      IndexType index;
+      for (unsigned int i = VDimension; i > 0; --i)
+      {
+        index[i - 1] =
+          m_Region.GetIndex(i - 1) + static_cast<typename IndexType::IndexValueType>(offset / m_Strides[i - 1]);
+        offset %= m_Strides[i - 1];
+      }
+      return index;
+    }
+
+    const RegionType &GetRegion() const { return m_Region; }
+    OffsetType GetNumberOfFilledPixels() const { return m_NumberOfFilledPixels; }
+
+    /** \brief Returns the bounding box of all filled pixels, its size is zero if no pixel is filled. */
+    RegionType GetBoundingBox() const
+    {
+      RegionType boundingBox;
+      if (0 == m_NumberOfFilledPixels)
+        return boundingBox;
+
+      SizeType size;
+      for (unsigned int i = 0; i < VDimension; ++i)
+        size[i] = static_cast<typename SizeType::SizeValueType>(m_BoundingBoxUpper[i] - m_BoundingBoxLower[i] + 1);
+
+      boundingBox.SetIndex(m_BoundingBoxLower);
+      boundingBox.SetSize(size);
+      return boundingBox;
+    }
+
+    /** \brief Sets the filled pixels of image to value, other pixels are not touched. */
+    template <typename TImage>
+    void Write(TImage *image, typename TImage::PixelType value) const
+    {
+      RegionType boundingBox = this->GetBoundingBox();
+      if (!boundingBox.Crop(image->GetBufferedRegion()))
+        return;
+
+      itk::ImageRegionIteratorWithIndex<TImage> iterator(image, boundingBox);
+      for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+      {
+        if (this->IsFilled(iterator.GetIndex()))
+          iterator.Set(value);
+      }
+    }
+
+  private:
+    void SetFilled(OffsetType offset) { m_Bits[offset >> 6] |= std::uint64_t(1) << (offset & 63); }
+
+    template <typename TPredicate>
+    void PushRuns(OffsetType first, OffsetType last, TPredicate &inside, std::vector<OffsetType> &stack) const
+    {
+      bool inRun = false;
+      for (OffsetType offset = first; offset <= last; ++offset)
+      {
+        const bool isCandidate = !this->IsFilled(offset) && inside(offset);
+        if (isCandidate && !inRun)
+          stack.push_back(offset);
+        inRun = isCandidate;
+      }
+    }
+
+    void GrowBoundingBox(const IndexType &first, const IndexType &last)
+    {
+      if (0 == m_NumberOfFilledPixels)
+      {
+        m_BoundingBoxLower = first;
+        m_BoundingBoxUpper = last;
+        return;
+      }
+
+      for (unsigned int i = 0; i < VDimension; ++i)
+      {
+        m_BoundingBoxLower[i] = std::min(m_BoundingBoxLower[i], first[i]);
+        m_BoundingBoxUpper[i] = std::max(m_BoundingBoxUpper[i], last[i]);
+      }
+    }
+
+    RegionType m_Region;
+    OffsetType m_Strides[VDimension];
+    OffsetType m_NumberOfPixels;
+    OffsetType m_NumberOfFilledPixels;
+    std::vector<std::uint64_t> m_Bits;
+    IndexType m_BoundingBoxLower;
+    IndexType m_BoundingBoxUpper;
+  };
+}
+
+#endif
@@ -48,9 +48,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #undef VTK_USE_UINT64
 #define VTK_USE_UINT64 0
 
+#include <algorithm>
 #include <cfloat>
 #include <climits>
 #include <cmath>
+#include <cstring>
 
 vtkStandardNewMacro(mitkVtkImageOverwrite);
 
@@ -106,10 +108,40 @@ inline int vtkResliceRound(double x)
 #endif
 }
 
+//----------------------------------------------------------------------------
+// An extent whose maximum is below its minimum contains no voxel
+static void vtkResliceEmptyExtent(int extent[6])
+{
+  for (int i = 0; i < 3; ++i)
+  {
+    extent[2 * i] = 0;
+    extent[2 * i + 1] = -1;
+  }
+}
+
+static void vtkResliceGrowExtent(int extent[6], const int index[3])
+{
+  if (extent[1] < extent[0])
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      extent[2 * i] = extent[2 * i + 1] = index[i];
+    }
+    return;
+  }
+
+  for (int i = 0; i < 3; ++i)
+  {
+    extent[2 * i] = std::min(extent[2 * i], index[i]);
+    extent[2 * i + 1] = std::max(extent[2 * i + 1], index[i]);
+  }
+}
+
 //----------------------------------------------------------------------------
 mitkVtkImageOverwrite::mitkVtkImageOverwrite()
 {
   m_Overwrite_Mode = false;
+  vtkResliceEmptyExtent(m_OverwrittenExtent);
   this->GetOutput()->AllocateScalars(VTK_UNSIGNED_INT, 1); // VTK6_TODO where should the image be allocated?
 }
 
@@ -429,6 +461,8 @@ static int vtkNearestNeighborInterpolation(T *&outPtr,
 
   inPtr += inIdX0 * inInc[0] + inIdY0 * inInc[1] + inIdZ0 * inInc[2];
 
+  // in overwrite mode 1 is only returned if the voxel changed
+  int result = self->IsOverwriteMode() ? 0 : 1;
   do
   {
     if (!self->IsOverwriteMode())
@@ -439,12 +473,17 @@ static int vtkNearestNeighborInterpolation(T *&outPtr,
     else
     {
       // copy from output to input in overwrite mode
-      *(const_cast<T *>(inPtr)) = *outPtr++;
+      if (*inPtr != *outPtr)
+      {
+        *(const_cast<T *>(inPtr)) = *outPtr;
+        result = 1;
+      }
+      outPtr++;
       inPtr++;
     }
   } while (--numscalars);
 
-  return 1;
+  return result;
 }
 
 //--------------------------------------------------------------------------
@@ -773,6 +812,15 @@ static void vtkImageResliceExecute(mitkVtkImageOverwrite *self,
   // get the stencil
   vtkImageStencilData *stencil = self->GetStencil();
 
+  // the voxels changed in overwrite mode, wrapped or mirrored indices are not tracked
+  const bool trackOverwrittenExtent = self->IsOverwriteMode() && mode != VTK_RESLICE_WRAP && mode != VTK_RESLICE_MIRROR;
+  int overwrittenExtent[6];
+  vtkResliceEmptyExtent(overwrittenExtent);
+  if (self->IsOverwriteMode() && !trackOverwrittenExtent)
+  {
+    inData->GetExtent(overwrittenExtent);
+  }
+
   // Loop through output voxels
   for (idZ = outExt[4]; idZ <= outExt[5]; idZ++)
   {
@@ -821,7 +869,12 @@ static void vtkImageResliceExecute(mitkVtkImageOverwrite *self,
           point[2] = (point[2] - inOrigin[2]) * inInvSpacing[2];
 
           // interpolate output voxel from input data set
-          interpolate(outPtr, inPtr, inExt, inInc, numscalars, point, mode, background, self);
+          if (interpolate(outPtr, inPtr, inExt, inInc, numscalars, point, mode, background, self) &&
+              trackOverwrittenExtent)
+          {
+            int index[3] = {vtkResliceRound(point[0]), vtkResliceRound(point[1]), vtkResliceRound(point[2])};
+            vtkResliceGrowExtent(overwrittenExtent, index);
+          }
         }
       }
       outPtr = static_cast<void *>(static_cast<char *>(outPtr) + outIncY * scalarSize);
@@ -830,6 +883,272 @@ static void vtkImageResliceExecute(mitkVtkImageOverwrite *self,
   }
 
   vtkFreeBackgroundPixel(self, &background);
+
+  self->AddOverwrittenExtent(overwrittenExtent);
+}
+
+//----------------------------------------------------------------------------
+// Checks whether every output voxel maps onto exactly one input voxel, i.e. the
+// reslice axes are aligned to the input grid and the spacings match. In that
+// case the input index of the output voxel (idX, idY, idZ) is
+// start + (idX - outExt[0]) * axes[0] + (idY - outExt[2]) * axes[1] + (idZ - outExt[4]) * axes[2]
+// with all components of axes in {-1, 0, 1}.
+static bool vtkResliceGetAlignedMapping(mitkVtkImageOverwrite *self,
+                                        vtkImageData *inData,
+                                        vtkImageData *outData,
+                                        const int outExt[6],
+                                        int start[3],
+                                        int axes[3][3])
+{
+  if (self->GetResliceTransform() || self->GetStencil() || self->GetMirror() || self->GetWrap())
+  {
+    return false;
+  }
+
+  double matrix[4][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}, {0, 0, 0, 1}};
+  if (vtkMatrix4x4 *resliceAxes = self->GetResliceAxes())
+  {
+    for (int i = 0; i < 4; ++i)
+    {
+      for (int j = 0; j < 4; ++j)
+      {
+        matrix[i][j] = resliceAxes->GetElement(i, j);
+      }
+    }
+    if (matrix[3][0] != 0.0 || matrix[3][1] != 0.0 || matrix[3][2] != 0.0 || matrix[3][3] != 1.0)
+    {
+      return false;
+    }
+  }
+
+  const double *inOrigin = inData->GetOrigin();
+  const double *inSpacing = inData->GetSpacing();
+  const double *outOrigin = outData->GetOrigin();
+  const double *outSpacing = outData->GetSpacing();
+
+  // the tolerance is far below the rounding error that would make a difference
+  const double tolerance = 1e-6;
+
+  // the input index of the first output voxel
+  double firstPoint[3];
+  for (int j = 0; j < 3; ++j)
+  {
+    firstPoint[j] = outExt[2 * j] * outSpacing[j] + outOrigin[j];
+  }
+  for (int i = 0; i < 3; ++i)
+  {
+    double point = matrix[i][3];
+    for (int j = 0; j < 3; ++j)
+    {
+      point += matrix[i][j] * firstPoint[j];
+    }
+    point = (point - inOrigin[i]) / inSpacing[i];
+
+    start[i] = vtkResliceRound(point);
+    if (std::abs(point - start[i]) > 0.5 - tolerance)
+    {
+      return false;
+    }
+  }
+
+  // the input index step per output voxel, an output axis of one voxel never steps
+  for (int j = 0; j < 3; ++j)
+  {
+    for (int i = 0; i < 3; ++i)
+    {
+      if (outExt[2 * j] == outExt[2 * j + 1])
+      {
+        axes[j][i] = 0;
+        continue;
+      }
+
+      const double step = matrix[i][j] * outSpacing[j] / inSpacing[i];
+      axes[j][i] = vtkResliceRound(step);
+      if (std::abs(step - axes[j][i]) > tolerance || axes[j][i] < -1 || axes[j][i] > 1)
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Executes the filter for a slice that is aligned to the input grid, see
+// vtkResliceGetAlignedMapping. Does the same as vtkImageResliceExecute with
+// nearest neighbor interpolation, but copies whole rows.
+static void vtkImageResliceAlignedExecute(mitkVtkImageOverwrite *self,
+                                          vtkImageData *inData,
+                                          vtkImageData *outData,
+                                          int outExt[6],
+                                          const int start[3],
+                                          const int axes[3][3])
+{
+  int inExt[6];
+  inData->GetExtent(inExt);
+
+  vtkIdType inInc[3];
+  inData->GetIncrements(inInc);
+
+  const int numscalars = inData->GetNumberOfScalarComponents();
+  const std::size_t pixelSize = static_cast<std::size_t>(outData->GetScalarSize()) * numscalars;
+  const bool overwrite = self->IsOverwriteMode();
+
+  // the distance of neighboring row voxels in the input
+  const vtkIdType inStepX =
+    (axes[0][0] * inInc[0] + axes[0][1] * inInc[1] + axes[0][2] * inInc[2]) * outData->GetScalarSize();
+
+  // the 'mode' specifies what to do with the 'pad' (out-of-bounds) area, as in vtkImageResliceExecute
+  int mode = VTK_RESLICE_BACKGROUND;
+  if (self->GetMirror())
+  {
+    mode = VTK_RESLICE_MIRROR;
+  }
+  else if (self->GetWrap())
+  {
+    mode = VTK_RESLICE_WRAP;
+  }
+  else if (self->GetBorder())
+  {
+    mode = VTK_RESLICE_BORDER;
+  }
+
+  void *background;
+  vtkAllocBackgroundPixel(self, &background, numscalars);
+
+  int overwrittenExtent[6];
+  vtkResliceEmptyExtent(overwrittenExtent);
+
+  for (int idZ = outExt[4]; idZ <= outExt[5]; idZ++)
+  {
+    for (int idY = outExt[2]; idY <= outExt[3]; idY++)
+    {
+      // input index of the first voxel of the row
+      int rowStart[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        rowStart[i] = start[i] + (idY - outExt[2]) * axes[1][i] + (idZ - outExt[4]) * axes[2][i];
+      }
+
+      // the part of the row inside the input extent
+      int first = 0;
+      int last = outExt[1] - outExt[0];
+      for (int i = 0; i < 3; ++i)
+      {
+        const int lower = inExt[2 * i] - rowStart[i];
+        const int upper = inExt[2 * i + 1] - rowStart[i];
+
+        if (axes[0][i] == 0)
+        {
+          if (lower > 0 || upper < 0)
+          {
+            last = first - 1;
+          }
+        }
+        else if (axes[0][i] == 1)
+        {
+          first = std::max(first, lower);
+          last = std::min(last, upper);
+        }
+        else
+        {
+          first = std::max(first, -upper);
+          last = std::min(last, -lower);
+        }
+      }
+
+      char *outRow = static_cast<char *>(outData->GetScalarPointer(outExt[0], idY, idZ));
+      const int length = outExt[1] - outExt[0] + 1;
+
+      // voxels outside of the input get the background, like in vtkNearestNeighborInterpolation
+      if (mode == VTK_RESLICE_BACKGROUND || mode == VTK_RESLICE_BORDER)
+      {
+        for (int idX = 0; idX < length; ++idX)
+        {
+          if (idX == first && first <= last)
+          {
+            idX = last;
+            continue;
+          }
+          memcpy(outRow + idX * pixelSize, background, pixelSize);
+        }
+      }
+
+      if (first > last)
+      {
+        continue;
+      }
+
+      int firstIndex[3];
+      for (int i = 0; i < 3; ++i)
+      {
+        firstIndex[i] = rowStart[i] + first * axes[0][i];
+      }
+
+      char *inVoxel = static_cast<char *>(inData->GetScalarPointer(firstIndex[0], firstIndex[1], firstIndex[2]));
+      char *outVoxel = outRow + first * pixelSize;
+      const int count = last - first + 1;
+
+      if (overwrite)
+      {
+        // only the voxels which change are tracked
+        int firstChanged = count;
+        int lastChanged = -1;
+        for (int idX = 0; idX < count; ++idX)
+        {
+          if (memcmp(inVoxel + idX * inStepX, outVoxel + idX * pixelSize, pixelSize) != 0)
+          {
+            firstChanged = std::min(firstChanged, idX);
+            lastChanged = idX;
+          }
+        }
+
+        if (firstChanged <= lastChanged)
+        {
+          int firstChangedIndex[3];
+          int lastChangedIndex[3];
+          for (int i = 0; i < 3; ++i)
+          {
+            firstChangedIndex[i] = firstIndex[i] + firstChanged * axes[0][i];
+            lastChangedIndex[i] = firstIndex[i] + lastChanged * axes[0][i];
+          }
+          vtkResliceGrowExtent(overwrittenExtent, firstChangedIndex);
+          vtkResliceGrowExtent(overwrittenExtent, lastChangedIndex);
+        }
+      }
+
+      if (inStepX == static_cast<vtkIdType>(pixelSize))
+      {
+        if (overwrite)
+        {
+          memcpy(inVoxel, outVoxel, count * pixelSize);
+        }
+        else
+        {
+          memcpy(outVoxel, inVoxel, count * pixelSize);
+        }
+      }
+      else
+      {
+        for (int idX = 0; idX < count; ++idX, inVoxel += inStepX, outVoxel += pixelSize)
+        {
+          if (overwrite)
+          {
+            memcpy(inVoxel, outVoxel, pixelSize);
+          }
+          else
+          {
+            memcpy(outVoxel, inVoxel, pixelSize);
+          }
+        }
+      }
+    }
+  }
+
+  vtkFreeBackgroundPixel(self, &background);
+
+  self->AddOverwrittenExtent(overwrittenExtent);
 }
 
 void mitkVtkImageOverwrite::SetOverwriteMode(bool b)
@@ -843,6 +1162,38 @@ void mitkVtkImageOverwrite::SetInputSlice(vtkImageData *slice)
   this->SetOutput(slice);
 }
 
+void mitkVtkImageOverwrite::GetOverwrittenExtent(int extent[6])
+{
+  std::lock_guard<std::mutex> lock(m_OverwrittenExtentMutex);
+  std::copy(m_OverwrittenExtent, m_OverwrittenExtent + 6, extent);
+}
+
+void mitkVtkImageOverwrite::AddOverwrittenExtent(const int extent[6])
+{
+  if (extent[1] < extent[0])
+  {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(m_OverwrittenExtentMutex);
+  const int first[3] = {extent[0], extent[2], extent[4]};
+  const int last[3] = {extent[1], extent[3], extent[5]};
+  vtkResliceGrowExtent(m_OverwrittenExtent, first);
+  vtkResliceGrowExtent(m_OverwrittenExtent, last);
+}
+
+int mitkVtkImageOverwrite::RequestData(vtkInformation *request,
+                                       vtkInformationVector **inputVector,
+                                       vtkInformationVector *outputVector)
+{
+  {
+    std::lock_guard<std::mutex> lock(m_OverwrittenExtentMutex);
+    vtkResliceEmptyExtent(m_OverwrittenExtent);
+  }
+
+  return Superclass::RequestData(request, inputVector, outputVector);
+}
+
 //----------------------------------------------------------------------------
 // This method is passed a input and output region, and executes the filter
 // algorithm to fill the output from the input or vice versa.
@@ -880,6 +1231,15 @@ void mitkVtkImageOverwrite::ThreadedRequestData(vtkInformation *vtkNotUsed(reque
     return;
   }
 
+  // slices aligned to the input grid are copied row by row
+  int start[3];
+  int axes[3][3];
+  if (vtkResliceGetAlignedMapping(this, inData[0][0], outData[0], outExt, start, axes))
+  {
+    vtkImageResliceAlignedExecute(this, inData[0][0], outData[0], outExt, start, axes);
+    return;
+  }
+
   // Now that we know that we need the input, get the input pointer
   void *inPtr = inData[0][0]->GetScalarPointerForExtent(inExt);
 
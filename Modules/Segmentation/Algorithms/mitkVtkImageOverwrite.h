@@ -20,6 +20,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkSegmentationExports.h>
 #include <vtkImageReslice.h>
 
+#include <mutex>
+
 /** \brief A vtk Filter based on vtkImageReslice with the aditional feature to write a slice into the given input
 volume.
   All optimizations for e.g. the plane directions or interpolation are stripped away, the algorithm only interpolates
@@ -48,6 +50,10 @@ for round trip use extract->edit->overwrite, because it is nearly impossible to
     - Set the slice to that has to be overwritten in the volume ( SetInputSlice(vtkImageData*)
 
     After calling Update() there is no need to retrieve the output as the input volume is modified.
+    GetOverwrittenExtent() tells which part of the volume was changed.
+
+  If the slice is aligned to the voxel grid of the volume, i.e. every slice pixel maps onto exactly one
+  voxel, the rows are copied directly instead of transforming every pixel.
 
     \sa vtkImageReslice
     (Note that the execute and interpolation functions are no members and thus can not be overriden)
@@ -69,12 +75,29 @@ public:
     */
   void SetInputSlice(vtkImageData *slice);
 
+  /** \brief Returns the extent of the input volume that was changed by the last update in overwrite mode.
+    Voxels which already had the value of the slice are not counted. The extent is empty
+    (extent[1] < extent[0]) if no voxel changed. With wrapping or mirroring it is the whole volume.
+    */
+  void GetOverwrittenExtent(int extent[6]);
+
+  /** \brief Merges the extent of voxels changed by one thread into the overwritten extent. */
+  void AddOverwrittenExtent(const int extent[6]);
+
 protected:
   mitkVtkImageOverwrite();
   ~mitkVtkImageOverwrite() override;
 
   bool m_Overwrite_Mode;
 
+  int m_OverwrittenExtent[6];
+  std::mutex m_OverwrittenExtentMutex;
+
+  /** Overridden from vtkImageReslice to reset the overwritten extent before the threads start. */
+  int RequestData(vtkInformation *request,
+                  vtkInformationVector **inputVector,
+                  vtkInformationVector *outputVector) override;
+
   /** Overridden from vtkImageReslice. \sa vtkImageReslice::ThreadedRequestData */
   void ThreadedRequestData(vtkInformation *vtkNotUsed(request),
                                    vtkInformationVector **vtkNotUsed(inputVector),
@@ -21,6 +21,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkImageTimeSelector.h"
 #include <mitkExtractSliceFilter.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkParallelFor.h>
 //#include <mitkPlaneGeometry.h>
 
 #include "mitkShapeBasedInterpolationAlgorithm.h"
@@ -29,6 +30,115 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <itkImage.h>
 #include <itkImageSliceConstIteratorWithIndex.h>
 
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+  /**
+    Determines the image index of the first slice pixel and the index steps along both slice axes.
+    Returns false if the slice axes are not aligned with distinct image axes.
+  */
+  bool MapSliceToVolume(const mitk::BaseGeometry *sliceGeometry,
+                        const mitk::BaseGeometry *imageGeometry,
+                        itk::Index<3> &origin,
+                        itk::Offset<3> *steps)
+  {
+    mitk::Point3D sliceIndices[3];
+    mitk::FillVector3D(sliceIndices[0], 0.0, 0.0, 0.0);
+    mitk::FillVector3D(sliceIndices[1], 1.0, 0.0, 0.0);
+    mitk::FillVector3D(sliceIndices[2], 0.0, 1.0, 0.0);
+
+    mitk::Point3D imageIndices[3];
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      mitk::Point3D world;
+      sliceGeometry->IndexToWorld(sliceIndices[i], world);
+      imageGeometry->WorldToIndex(world, imageIndices[i]);
+    }
+
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      origin[i] = static_cast<itk::IndexValueType>(std::floor(imageIndices[0][i] + 0.5));
+      if (std::abs(imageIndices[0][i] - origin[i]) > 0.25)
+        return false;
+    }
+
+    unsigned int stepAxes[2] = {0, 0};
+    for (unsigned int axis = 0; axis < 2; ++axis)
+    {
+      unsigned int numberOfUnitSteps = 0;
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        const double step = imageIndices[axis + 1][i] - imageIndices[0][i];
+        steps[axis][i] = static_cast<itk::OffsetValueType>(std::floor(step + 0.5));
+
+        if (std::abs(step - steps[axis][i]) > 1e-3 || std::abs(steps[axis][i]) > 1)
+          return false;
+
+        if (0 != steps[axis][i])
+        {
+          stepAxes[axis] = i;
+          ++numberOfUnitSteps;
+        }
+      }
+
+      if (1 != numberOfUnitSteps)
+        return false;
+    }
+
+    return stepAxes[0] != stepAxes[1];
+  }
+
+  /**
+    Determines the range [begin, end) of the pixels along both slice axes which are mapped into region by
+    MapSliceToVolume(). Returns false if no slice pixel lies in region.
+  */
+  bool GetSliceRange(const itk::Index<3> &origin,
+                     const itk::Offset<3> *steps,
+                     const itk::ImageRegion<3> &region,
+                     const unsigned int *sliceSize,
+                     unsigned int *begin,
+                     unsigned int *end)
+  {
+    const itk::Index<3> lower = region.GetIndex();
+    const itk::Index<3> upper = region.GetUpperIndex();
+
+    // the image axis along the slice normal is constant within the slice
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      if (0 == steps[0][i] && 0 == steps[1][i] && (origin[i] < lower[i] || origin[i] > upper[i]))
+        return false;
+    }
+
+    for (unsigned int axis = 0; axis < 2; ++axis)
+    {
+      itk::IndexValueType first = 0;
+      itk::IndexValueType last = static_cast<itk::IndexValueType>(sliceSize[axis]) - 1;
+
+      for (unsigned int i = 0; i < 3; ++i)
+      {
+        if (0 == steps[axis][i])
+          continue;
+
+        // pixel p is mapped to origin[i] + steps[axis][i] * p with a step of 1 or -1
+        const itk::IndexValueType toLower = (lower[i] - origin[i]) * steps[axis][i];
+        const itk::IndexValueType toUpper = (upper[i] - origin[i]) * steps[axis][i];
+        first = std::max(first, std::min(toLower, toUpper));
+        last = std::min(last, std::max(toLower, toUpper));
+      }
+
+      if (first > last)
+        return false;
+
+      begin[axis] = static_cast<unsigned int>(first);
+      end[axis] = static_cast<unsigned int>(last + 1);
+    }
+
+    return true;
+  }
+}
+
 mitk::SegmentationInterpolationController::InterpolatorMapType
   mitk::SegmentationInterpolationController::s_InterpolatorForImage; // static member initialization
 
@@ -47,7 +157,7 @@ mitk::SegmentationInterpolationController *mitk::SegmentationInterpolationContro
 }
 
 mitk::SegmentationInterpolationController::SegmentationInterpolationController()
-  : m_BlockModified(false), m_2DInterpolationActivated(false)
+  : m_BlockModified(false), m_2DInterpolationActivated(false), m_ChangedRegionTimeStep(0)
 {
 }
 
@@ -244,6 +354,192 @@ void mitk::SegmentationInterpolationController::SetChangedSlice(const Image *sli
   Modified();
 }
 
+bool mitk::SegmentationInterpolationController::SetChangedSlice(const Image *originalSlice,
+                                                                const Image *modifiedSlice,
+                                                                unsigned int timeStep,
+                                                                const itk::ImageRegion<3> *changedRegion)
+{
+  if (!originalSlice || !modifiedSlice || m_Segmentation.IsNull())
+    return false;
+  if (timeStep >= m_SegmentationCountInSlice.size())
+    return false;
+
+  if (originalSlice->GetPixelType() != modifiedSlice->GetPixelType() ||
+      originalSlice->GetPixelType() != m_Segmentation->GetPixelType() ||
+      originalSlice->GetDimension(0) != modifiedSlice->GetDimension(0) ||
+      originalSlice->GetDimension(1) != modifiedSlice->GetDimension(1) || originalSlice->GetDimension(2) != 1 ||
+      modifiedSlice->GetDimension(2) != 1)
+    return false;
+
+  SliceToVolumeMapping mapping;
+  mapping.timeStep = timeStep;
+
+  if (!MapSliceToVolume(
+        originalSlice->GetGeometry(), m_Segmentation->GetGeometry(timeStep), mapping.origin, mapping.steps))
+    return false;
+
+  // only the slice pixels inside of the image and the changed region can differ
+  itk::ImageRegion<3> region;
+  for (unsigned int dim = 0; dim < 3; ++dim)
+    region.SetSize(dim, m_SegmentationCountInSlice[timeStep][dim].size());
+
+  const unsigned int sliceSize[2] = {modifiedSlice->GetDimension(0), modifiedSlice->GetDimension(1)};
+  if ((changedRegion != nullptr && !region.Crop(*changedRegion)) ||
+      !GetSliceRange(mapping.origin, mapping.steps, region, sliceSize, mapping.begin, mapping.end))
+    return true;
+
+  AccessFixedDimensionByItk_2(originalSlice, ScanSliceDifference, 2, modifiedSlice, mapping);
+
+  Modified();
+  return true;
+}
+
+void mitk::SegmentationInterpolationController::BeginChangedRegion(const itk::ImageRegion<3> &region,
+                                                                   unsigned int timeStep)
+{
+  m_ChangedRegion = region;
+  m_ChangedRegionTimeStep = timeStep;
+
+  this->ScanRegion(m_ChangedRegion, m_ChangedRegionTimeStep, -1);
+
+  m_BlockModified = true;
+}
+
+void mitk::SegmentationInterpolationController::EndChangedRegion()
+{
+  this->ScanRegion(m_ChangedRegion, m_ChangedRegionTimeStep, 1);
+
+  m_BlockModified = false;
+  Modified();
+}
+
+void mitk::SegmentationInterpolationController::ScanRegion(const itk::ImageRegion<3> &region,
+                                                           unsigned int timeStep,
+                                                           int factor)
+{
+  if (m_Segmentation.IsNull() || timeStep >= m_SegmentationCountInSlice.size())
+    return;
+
+  ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
+  timeSelector->SetInput(m_Segmentation);
+  timeSelector->SetTimeNr(timeStep);
+  timeSelector->UpdateLargestPossibleRegion();
+  Image::Pointer segmentation3D = timeSelector->GetOutput();
+
+  AccessFixedDimensionByItk_n(segmentation3D, ScanVolumeRegion, 3, (region, timeStep, factor));
+}
+
+template <typename DATATYPE>
+void mitk::SegmentationInterpolationController::ScanSliceDifference(const itk::Image<DATATYPE, 2> *originalSlice,
+                                                                    const Image *modifiedSlice,
+                                                                    const SliceToVolumeMapping &mapping)
+{
+  ImageReadAccessor readAccess(modifiedSlice);
+  const auto *originalPixels = originalSlice->GetBufferPointer();
+  const auto *modifiedPixels = static_cast<const DATATYPE *>(readAccess.GetData());
+
+  const unsigned int sizeX = modifiedSlice->GetDimension(0);
+
+  std::vector<DirtyVectorType> &counts = m_SegmentationCountInSlice[mapping.timeStep];
+
+  // the range only contains pixels inside of the image, pixels outside of it are not written
+  for (unsigned int y = mapping.begin[1]; y < mapping.end[1]; ++y)
+  {
+    for (unsigned int x = mapping.begin[0]; x < mapping.end[0]; ++x)
+    {
+      const std::size_t i = static_cast<std::size_t>(y) * sizeX + x;
+      if (originalPixels[i] == modifiedPixels[i])
+        continue;
+
+      itk::Index<3> index;
+      for (unsigned int dim = 0; dim < 3; ++dim)
+        index[dim] = mapping.origin[dim] + mapping.steps[0][dim] * x + mapping.steps[1][dim] * y;
+
+      const long difference = static_cast<long>(modifiedPixels[i]) - static_cast<long>(originalPixels[i]);
+
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        assert((signed)counts[dim][index[dim]] + difference >= 0);
+        counts[dim][index[dim]] = static_cast<unsigned int>(counts[dim][index[dim]] + difference);
+      }
+    }
+  }
+}
+
+template <typename DATATYPE>
+void mitk::SegmentationInterpolationController::ScanVolumeRegion(const itk::Image<DATATYPE, 3> *volume,
+                                                                 const itk::ImageRegion<3> &region,
+                                                                 unsigned int timeStep,
+                                                                 int factor)
+{
+  // an empty region would leave no slice for the threads to scan
+  itk::ImageRegion<3> scanRegion = region;
+  if (!scanRegion.Crop(volume->GetLargestPossibleRegion()) || 0 == scanRegion.GetNumberOfPixels())
+    return;
+
+  const itk::Size<3> size = volume->GetLargestPossibleRegion().GetSize();
+  const itk::Index<3> &regionIndex = scanRegion.GetIndex();
+  const itk::Size<3> &regionSize = scanRegion.GetSize();
+  const DATATYPE *buffer = volume->GetBufferPointer();
+
+  std::vector<DirtyVectorType> &counts = m_SegmentationCountInSlice[timeStep];
+  std::vector<long long> sliceDifferences(regionSize[2], 0);
+
+  // every chunk is a block of slices, its rows and columns are summed up separately
+  const std::size_t numberOfChunks = mitk::GetNumberOfParallelChunks(regionSize[2]);
+
+  std::vector<std::vector<long long>> columnDifferences(numberOfChunks, std::vector<long long>(regionSize[0], 0));
+  std::vector<std::vector<long long>> rowDifferences(numberOfChunks, std::vector<long long>(regionSize[1], 0));
+
+  mitk::ParallelForChunks(regionSize[2], [&](std::size_t zBegin, std::size_t zEnd, std::size_t chunk) {
+    std::vector<long long> &columns = columnDifferences[chunk];
+    std::vector<long long> &rows = rowDifferences[chunk];
+
+    for (std::size_t z = zBegin; z < zEnd; ++z)
+    {
+      long long sliceSum = 0;
+      for (unsigned int y = 0; y < regionSize[1]; ++y)
+      {
+        const DATATYPE *row =
+          buffer + ((regionIndex[2] + z) * size[1] + regionIndex[1] + y) * size[0] + regionIndex[0];
+
+        long long rowSum = 0;
+        for (unsigned int x = 0; x < regionSize[0]; ++x)
+        {
+          const auto value = static_cast<long long>(row[x]);
+          columns[x] += value;
+          rowSum += value;
+        }
+
+        rows[y] += rowSum;
+        sliceSum += rowSum;
+      }
+      sliceDifferences[z] = sliceSum;
+    }
+  });
+
+  for (std::size_t chunk = 0; chunk < numberOfChunks; ++chunk)
+  {
+    for (unsigned int x = 0; x < regionSize[0]; ++x)
+    {
+      assert((signed)counts[0][regionIndex[0] + x] + factor * columnDifferences[chunk][x] >= 0);
+      counts[0][regionIndex[0] + x] += factor * columnDifferences[chunk][x];
+    }
+
+    for (unsigned int y = 0; y < regionSize[1]; ++y)
+    {
+      assert((signed)counts[1][regionIndex[1] + y] + factor * rowDifferences[chunk][y] >= 0);
+      counts[1][regionIndex[1] + y] += factor * rowDifferences[chunk][y];
+    }
+  }
+
+  for (unsigned int z = 0; z < regionSize[2]; ++z)
+  {
+    assert((signed)counts[2][regionIndex[2] + z] + factor * sliceDifferences[z] >= 0);
+    counts[2][regionIndex[2] + z] += factor * sliceDifferences[z];
+  }
+}
+
 template <typename DATATYPE>
 void mitk::SegmentationInterpolationController::ScanChangedSlice(const itk::Image<DATATYPE, 2> *,
                                                                  const SetChangedSliceOptions &options)
@@ -353,8 +649,8 @@ void mitk::SegmentationInterpolationController::ScanChangedVolume(const itk::Ima
 }
 
 template <typename DATATYPE>
-void mitk::SegmentationInterpolationController::ScanWholeVolume(const itk::Image<DATATYPE, 3> *,
-                                                                const Image *volume,
+void mitk::SegmentationInterpolationController::ScanWholeVolume(const itk::Image<DATATYPE, 3> *volume,
+                                                                const Image *,
                                                                 unsigned int timeStep)
 {
   if (!volume)
@@ -362,16 +658,7 @@ void mitk::SegmentationInterpolationController::ScanWholeVolume(const itk::Image
   if (timeStep >= m_SegmentationCountInSlice.size())
     return;
 
-  ImageReadAccessor readAccess(volume, volume->GetVolumeData(timeStep));
-
-  for (unsigned int slice = 0; slice < volume->GetDimension(2); ++slice)
-  {
-    const auto *rawVolume =
-      static_cast<const DATATYPE *>(readAccess.GetData()); // we again promise not to change anything, we'll just count
-    const DATATYPE *rawSlice = rawVolume + (volume->GetDimension(0) * volume->GetDimension(1) * slice);
-
-    ScanChangedSlice<DATATYPE>(nullptr, SetChangedSliceOptions(2, slice, 0, 1, timeStep, rawSlice));
-  }
+  this->ScanVolumeRegion(volume, volume->GetLargestPossibleRegion(), timeStep, 1);
 }
 
 void mitk::SegmentationInterpolationController::PrintStatus()
@@ -22,6 +22,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkSegmentationExports.h>
 
 #include <itkImage.h>
+#include <itkImageRegion.h>
 #include <itkObjectFactory.h>
 
 #include <map>
@@ -58,6 +59,10 @@ namespace mitk
     slice of an image. There is a static method InterpolatorForImage(), which can be used to find out if there already
     is an interpolator
     instance for a specified image. OverwriteImageFilter uses this to get to know its interpolator.
+    Tools which write a reslice of the image can pass the slice before and after the change instead of a difference
+    image. Operations changing a bounded 3D region, like mitk::FastMarchingTool3D adding its result to the
+    segmentation, call BeginChangedRegion() before and EndChangedRegion() after the change. Operations replacing
+    the whole volume rely on the complete scan triggered by Modified().
 
     SegmentationInterpolationController needs to maintain some information about the image slices (in every dimension).
     This information is stored internally in m_SegmentationCountInSlice, which is basically three std::vectors (one for
@@ -134,6 +139,35 @@ namespace mitk
                          unsigned int timeStep);
     void SetChangedVolume(const Image *sliceDiff, unsigned int timeStep);
 
+    /**
+      \brief Update after changing a single slice, given the slice before and after the change.
+
+      Both slices have to be reslices of the segmentation (e.g. created by mitk::ExtractSliceFilter) with the same
+      geometry and pixel type. The slice axes are mapped to the image axes by means of the slice geometry.
+
+      \param changedRegion optional region of the image which contains all changed pixels, e.g. the extent returned by
+             mitkVtkImageOverwrite::GetOverwrittenExtent(). Only the slice pixels inside of it are compared.
+
+      \return false if the slice is not aligned with the image axes, the caller has to trigger a complete scan then
+    */
+    bool SetChangedSlice(const Image *originalSlice,
+                         const Image *modifiedSlice,
+                         unsigned int timeStep,
+                         const itk::ImageRegion<3> *changedRegion = nullptr);
+
+    /**
+      \brief Prepares an update for a change of the segmentation inside region.
+
+      Removes the pixels in region from the internal counts and blocks reactions to Modified() events until
+      EndChangedRegion() is called, which adds the pixels of the changed region again.
+    */
+    void BeginChangedRegion(const itk::ImageRegion<3> &region, unsigned int timeStep);
+
+    /**
+      \brief Finishes an update started by BeginChangedRegion().
+    */
+    void EndChangedRegion();
+
     /**
       \brief Generates an interpolated image for the given slice.
 
@@ -181,6 +215,20 @@ namespace mitk
       const void *pixelData;
     };
 
+    /**
+      \brief Protected class of mitk::SegmentationInterpolationController. Maps slice pixels to image indices.
+    */
+    class MITKSEGMENTATION_EXPORT SliceToVolumeMapping
+    {
+    public:
+      itk::Index<3> origin;
+      itk::Offset<3> steps[2];
+      unsigned int timeStep;
+      // range of slice pixels along both slice axes which are compared
+      unsigned int begin[2];
+      unsigned int end[2];
+    };
+
     typedef std::vector<unsigned int> DirtyVectorType;
     // typedef std::vector< DirtyVectorType[3] > TimeResolvedDirtyVectorType; // cannot work with C++, so next line is
     // used for implementation
@@ -200,6 +248,21 @@ namespace mitk
     template <typename DATATYPE>
     void ScanWholeVolume(const itk::Image<DATATYPE, 3> *, const Image *volume, unsigned int timeStep);
 
+    /// internal scan of the difference of two reslices
+    template <typename DATATYPE>
+    void ScanSliceDifference(const itk::Image<DATATYPE, 2> *originalSlice,
+                             const Image *modifiedSlice,
+                             const SliceToVolumeMapping &mapping);
+
+    /// internal scan of a region, the pixel values multiplied by factor are added to the counts
+    template <typename DATATYPE>
+    void ScanVolumeRegion(const itk::Image<DATATYPE, 3> *volume,
+                          const itk::ImageRegion<3> &region,
+                          unsigned int timeStep,
+                          int factor);
+
+    void ScanRegion(const itk::ImageRegion<3> &region, unsigned int timeStep, int factor);
+
     void PrintStatus();
 
     /**
@@ -219,6 +282,9 @@ namespace mitk
     Image::ConstPointer m_ReferenceImage;
     bool m_BlockModified;
     bool m_2DInterpolationActivated;
+
+    itk::ImageRegion<3> m_ChangedRegion;
+    unsigned int m_ChangedRegionTimeStep;
   };
 
 } // namespace
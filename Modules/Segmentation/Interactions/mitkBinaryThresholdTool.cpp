@@ -16,7 +16,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkBinaryThresholdTool.h"
 
+#include "mitkBaseRenderer.h"
 #include "mitkBoundingObjectToSegmentationFilter.h"
+#include "mitkSegTool2D.h"
 #include "mitkToolManager.h"
 
 #include "mitkColorProperty.h"
@@ -29,12 +31,15 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkImageAccessByItk.h"
 #include "mitkImageCast.h"
+#include "mitkImagePixelWriteAccessor.h"
+#include "mitkImageReadAccessor.h"
 #include "mitkImageStatisticsHolder.h"
 #include "mitkImageTimeSelector.h"
 #include "mitkLabelSetImage.h"
 #include "mitkMaskAndCutRoiImageFilter.h"
 #include "mitkPadImageFilter.h"
 #include <itkBinaryThresholdImageFilter.h>
+#include <itkImageRegionConstIteratorWithIndex.h>
 #include <itkImageRegionIterator.h>
 
 // us
@@ -53,6 +58,11 @@ mitk::BinaryThresholdTool::BinaryThresholdTool()
     m_CurrentThresholdValue(0.0),
     m_IsFloatImage(false)
 {
+  m_VolumePreviewRequest.OldBinary = false;
+  m_VolumePreviewRequest.LowerThreshold = 0.0;
+  m_VolumePreviewRequest.UpperThreshold = 0.0;
+  m_PendingRequest = m_VolumePreviewRequest;
+
   m_ThresholdFeedbackNode = DataNode::New();
   m_ThresholdFeedbackNode->SetProperty("color", ColorProperty::New(0.0, 1.0, 0.0));
   m_ThresholdFeedbackNode->SetProperty("name", StringProperty::New("Thresholding feedback"));
@@ -108,6 +118,13 @@ void mitk::BinaryThresholdTool::Deactivated()
     mitk::MessageDelegate<mitk::BinaryThresholdTool>(this, &mitk::BinaryThresholdTool::OnRoiDataChanged);
   m_NodeForThresholding = nullptr;
   m_OriginalImageNode = nullptr;
+  m_VolumePreviewIsUpToDate = false;
+  {
+    std::lock_guard<std::mutex> lock(m_PendingPreviewMutex);
+    m_VolumePreviewRequest.Input = nullptr;
+    m_VolumePreviewRequest.Target = nullptr;
+    m_PendingPreview = nullptr;
+  }
   try
   {
     if (DataStorage *storage = m_ToolManager->GetDataStorage())
@@ -151,12 +168,18 @@ void mitk::BinaryThresholdTool::SetThresholdValue(double value)
     // based on the value range of the current image (as big as possible, as small as necessary).
     // m_ThresholdFeedbackNode->SetProperty( "levelwindow", LevelWindowProperty::New(
     // LevelWindow(m_CurrentThresholdValue, 0.01) ) );
-    UpdatePreview();
+
+    // the whole image is thresholded later, see UpdateVolumePreview()
+    if (!this->UpdateSlicePreview())
+      this->UpdatePreview();
   }
 }
 
 void mitk::BinaryThresholdTool::AcceptCurrentThresholdValue()
 {
+  if (!m_VolumePreviewIsUpToDate)
+    this->UpdatePreview();
+
   CreateNewSegmentationFromThreshold(m_NodeForThresholding);
 
   RenderingManager::GetInstance()->RequestUpdateAll();
@@ -354,7 +377,8 @@ void mitk::BinaryThresholdTool::OnRoiDataChanged()
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::BinaryThresholdTool::ITKThresholding(itk::Image<TPixel, VImageDimension> *originalImage,
                                                 Image *segmentation,
-                                                double thresholdValue,
+                                                double lowerThreshold,
+                                                double upperThreshold,
                                                 unsigned int timeStep)
 {
   typedef itk::Image<TPixel, VImageDimension> ImageType;
@@ -363,8 +387,8 @@ void mitk::BinaryThresholdTool::ITKThresholding(itk::Image<TPixel, VImageDimensi
 
   typename ThresholdFilterType::Pointer filter = ThresholdFilterType::New();
   filter->SetInput(originalImage);
-  filter->SetLowerThreshold(thresholdValue);
-  filter->SetUpperThreshold(m_SensibleMaximumThresholdValue);
+  filter->SetLowerThreshold(lowerThreshold);
+  filter->SetUpperThreshold(upperThreshold);
   filter->SetInsideValue(1);
   filter->SetOutsideValue(0);
   filter->Update();
@@ -375,7 +399,8 @@ void mitk::BinaryThresholdTool::ITKThresholding(itk::Image<TPixel, VImageDimensi
 template <typename TPixel, unsigned int VImageDimension>
 void mitk::BinaryThresholdTool::ITKThresholdingOldBinary(itk::Image<TPixel, VImageDimension> *originalImage,
                                                          Image *segmentation,
-                                                         double thresholdValue,
+                                                         double lowerThreshold,
+                                                         double upperThreshold,
                                                          unsigned int timeStep)
 {
   typedef itk::Image<TPixel, VImageDimension> ImageType;
@@ -384,8 +409,8 @@ void mitk::BinaryThresholdTool::ITKThresholdingOldBinary(itk::Image<TPixel, VIma
 
   typename ThresholdFilterType::Pointer filter = ThresholdFilterType::New();
   filter->SetInput(originalImage);
-  filter->SetLowerThreshold(thresholdValue);
-  filter->SetUpperThreshold(m_SensibleMaximumThresholdValue);
+  filter->SetLowerThreshold(lowerThreshold);
+  filter->SetUpperThreshold(upperThreshold);
   filter->SetInsideValue(1);
   filter->SetOutsideValue(0);
   filter->Update();
@@ -393,30 +418,248 @@ void mitk::BinaryThresholdTool::ITKThresholdingOldBinary(itk::Image<TPixel, VIma
   segmentation->SetVolume((void *)(filter->GetOutput()->GetPixelContainer()->GetBufferPointer()), timeStep);
 }
 
+template <typename TOutputPixel, typename TPixel, unsigned int VImageDimension>
+static void ThresholdSlice(itk::Image<TPixel, VImageDimension> *originalImage,
+                           mitk::Image *segmentation,
+                           double lowerThreshold,
+                           double upperThreshold,
+                           unsigned int timeStep,
+                           int sliceDimension,
+                           int sliceIndex)
+{
+  typedef itk::Image<TPixel, VImageDimension> ImageType;
+
+  // same comparison as itk::BinaryThresholdImageFilter
+  const TPixel lower = static_cast<TPixel>(lowerThreshold);
+  const TPixel upper = static_cast<TPixel>(upperThreshold);
+
+  typename ImageType::RegionType region = originalImage->GetLargestPossibleRegion();
+  region.SetIndex(sliceDimension, region.GetIndex(sliceDimension) + sliceIndex);
+  region.SetSize(sliceDimension, 1);
+
+  // the preview has the layout of the original image
+  mitk::ImagePixelWriteAccessor<TOutputPixel, VImageDimension> accessor(segmentation,
+                                                                        segmentation->GetVolumeData(timeStep));
+  TOutputPixel *buffer = accessor.GetData();
+
+  itk::ImageRegionConstIteratorWithIndex<ImageType> iterator(originalImage, region);
+  for (iterator.GoToBegin(); !iterator.IsAtEnd(); ++iterator)
+  {
+    const TPixel value = iterator.Get();
+    buffer[originalImage->ComputeOffset(iterator.GetIndex())] = (lower <= value && value <= upper) ? 1 : 0;
+  }
+}
+
+template <typename TPixel, unsigned int VImageDimension>
+void mitk::BinaryThresholdTool::ITKThresholdingSlice(itk::Image<TPixel, VImageDimension> *originalImage,
+                                                     Image *segmentation,
+                                                     double lowerThreshold,
+                                                     double upperThreshold,
+                                                     unsigned int timeStep,
+                                                     int sliceDimension,
+                                                     int sliceIndex)
+{
+  if (m_IsOldBinary)
+  {
+    ThresholdSlice<unsigned char>(
+      originalImage, segmentation, lowerThreshold, upperThreshold, timeStep, sliceDimension, sliceIndex);
+  }
+  else
+  {
+    ThresholdSlice<mitk::Tool::DefaultSegmentationDataType>(
+      originalImage, segmentation, lowerThreshold, upperThreshold, timeStep, sliceDimension, sliceIndex);
+  }
+}
+
+void mitk::BinaryThresholdTool::ThresholdVolume(
+  Image *thresholdImage, Image *segmentation, double lowerThreshold, double upperThreshold, bool oldBinary)
+{
+  for (unsigned int timeStep = 0; timeStep < thresholdImage->GetTimeSteps(); ++timeStep)
+  {
+    ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
+    timeSelector->SetInput(thresholdImage);
+    timeSelector->SetTimeNr(timeStep);
+    timeSelector->UpdateLargestPossibleRegion();
+    Image::Pointer feedBackImage3D = timeSelector->GetOutput();
+
+    if (oldBinary)
+    {
+      AccessByItk_n(
+        feedBackImage3D, ITKThresholdingOldBinary, (segmentation, lowerThreshold, upperThreshold, timeStep));
+    }
+    else
+    {
+      AccessByItk_n(feedBackImage3D, ITKThresholding, (segmentation, lowerThreshold, upperThreshold, timeStep));
+    }
+  }
+}
+
 void mitk::BinaryThresholdTool::UpdatePreview()
 {
   mitk::Image::Pointer thresholdImage = dynamic_cast<mitk::Image *>(m_NodeForThresholding->GetData());
   mitk::Image::Pointer previewImage = dynamic_cast<mitk::Image *>(m_ThresholdFeedbackNode->GetData());
   if (thresholdImage && previewImage)
   {
-    for (unsigned int timeStep = 0; timeStep < thresholdImage->GetTimeSteps(); ++timeStep)
+    this->ThresholdVolume(
+      thresholdImage, previewImage, m_CurrentThresholdValue, m_SensibleMaximumThresholdValue, m_IsOldBinary);
+
+    m_VolumePreviewIsUpToDate = true;
+    this->UpdateVolumePreviewRequest();
+
+    RenderingManager::GetInstance()->RequestUpdateAll();
+  }
+}
+
+bool mitk::BinaryThresholdTool::UpdateSlicePreview()
+{
+  mitk::Image::Pointer thresholdImage = dynamic_cast<mitk::Image *>(m_NodeForThresholding->GetData());
+  mitk::Image::Pointer previewImage = dynamic_cast<mitk::Image *>(m_ThresholdFeedbackNode->GetData());
+  if (thresholdImage.IsNull() || previewImage.IsNull() || thresholdImage->GetDimension() != 3 ||
+      previewImage->GetDimension() < 3)
+    return false;
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    if (thresholdImage->GetDimension(i) != previewImage->GetDimension(i))
+      return false;
+  }
+
+  struct Slice
+  {
+    unsigned int TimeStep;
+    int Dimension;
+    int Index;
+  };
+  std::vector<Slice> slices;
+
+  for (const auto &rendererEntry : BaseRenderer::baseRendererMap)
+  {
+    const BaseRenderer *renderer = rendererEntry.second;
+    if (renderer->GetMapperID() != BaseRenderer::Standard2D)
+      continue;
+
+    const PlaneGeometry *plane = renderer->GetCurrentWorldPlaneGeometry();
+    const int timeStep = renderer->GetTimeStep(thresholdImage);
+    if (nullptr == plane || timeStep < 0 || static_cast<unsigned int>(timeStep) >= thresholdImage->GetTimeSteps())
+      continue;
+
+    Slice slice;
+    slice.TimeStep = timeStep;
+    if (!SegTool2D::DetermineAffectedImageSlice(thresholdImage, plane, slice.Dimension, slice.Index))
     {
-      ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
-      timeSelector->SetInput(thresholdImage);
-      timeSelector->SetTimeNr(timeStep);
-      timeSelector->UpdateLargestPossibleRegion();
-      Image::Pointer feedBackImage3D = timeSelector->GetOutput();
+      // an oblique plane cuts through many slices
+      if (slice.Dimension < 0)
+        return false;
 
-      if (m_IsOldBinary)
-      {
-        AccessByItk_n(feedBackImage3D, ITKThresholdingOldBinary, (previewImage, m_CurrentThresholdValue, timeStep));
-      }
-      else
-      {
-        AccessByItk_n(feedBackImage3D, ITKThresholding, (previewImage, m_CurrentThresholdValue, timeStep));
-      }
+      // the plane does not show the image
+      continue;
     }
 
-    RenderingManager::GetInstance()->RequestUpdateAll();
+    slices.push_back(slice);
+  }
+
+  if (slices.empty())
+    return false;
+
+  for (const auto &slice : slices)
+  {
+    ImageTimeSelector::Pointer timeSelector = ImageTimeSelector::New();
+    timeSelector->SetInput(thresholdImage);
+    timeSelector->SetTimeNr(slice.TimeStep);
+    timeSelector->UpdateLargestPossibleRegion();
+    Image::Pointer feedBackImage3D = timeSelector->GetOutput();
+
+    AccessFixedDimensionByItk_n(feedBackImage3D,
+                                ITKThresholdingSlice,
+                                3,
+                                (previewImage,
+                                 m_CurrentThresholdValue,
+                                 m_SensibleMaximumThresholdValue,
+                                 slice.TimeStep,
+                                 slice.Dimension,
+                                 slice.Index));
+  }
+
+  previewImage->Modified();
+
+  m_VolumePreviewIsUpToDate = false;
+  this->UpdateVolumePreviewRequest();
+
+  RenderingManager::GetInstance()->RequestUpdateAll();
+  return true;
+}
+
+bool mitk::BinaryThresholdTool::VolumePreviewRequest::operator==(const VolumePreviewRequest &other) const
+{
+  return Input == other.Input && Target == other.Target && LowerThreshold == other.LowerThreshold &&
+         UpperThreshold == other.UpperThreshold && OldBinary == other.OldBinary;
+}
+
+void mitk::BinaryThresholdTool::UpdateVolumePreviewRequest()
+{
+  std::lock_guard<std::mutex> lock(m_PendingPreviewMutex);
+
+  m_VolumePreviewRequest.Input =
+    m_NodeForThresholding.IsNotNull() ? dynamic_cast<Image *>(m_NodeForThresholding->GetData()) : nullptr;
+  m_VolumePreviewRequest.Target = dynamic_cast<Image *>(m_ThresholdFeedbackNode->GetData());
+  m_VolumePreviewRequest.LowerThreshold = m_CurrentThresholdValue;
+  m_VolumePreviewRequest.UpperThreshold = m_SensibleMaximumThresholdValue;
+  m_VolumePreviewRequest.OldBinary = m_IsOldBinary;
+}
+
+void mitk::BinaryThresholdTool::UpdateVolumePreview()
+{
+  VolumePreviewRequest request;
+  {
+    std::lock_guard<std::mutex> lock(m_PendingPreviewMutex);
+    request = m_VolumePreviewRequest;
+  }
+
+  if (request.Input.IsNull() || request.Target.IsNull())
+    return;
+
+  // the preview node is rendered meanwhile, so the result goes into an image of its own
+  Image::Pointer result = Image::New();
+  result->Initialize(request.Target);
+  this->ThresholdVolume(request.Input, result, request.LowerThreshold, request.UpperThreshold, request.OldBinary);
+
+  std::lock_guard<std::mutex> lock(m_PendingPreviewMutex);
+  m_PendingRequest = request;
+  m_PendingPreview = result;
+}
+
+void mitk::BinaryThresholdTool::ShowVolumePreview()
+{
+  Image::Pointer result;
+  Image::Pointer target;
+  {
+    std::lock_guard<std::mutex> lock(m_PendingPreviewMutex);
+
+    // the threshold changed while the result was computed
+    if (m_PendingPreview.IsNotNull() && m_PendingRequest == m_VolumePreviewRequest)
+    {
+      result = m_PendingPreview;
+      target = m_PendingRequest.Target;
+    }
+
+    m_PendingPreview = nullptr;
+  }
+
+  if (result.IsNull() || m_VolumePreviewIsUpToDate ||
+      target.GetPointer() != dynamic_cast<Image *>(m_ThresholdFeedbackNode->GetData()))
+    return;
+
+  for (unsigned int timeStep = 0; timeStep < result->GetTimeSteps(); ++timeStep)
+  {
+    ImageReadAccessor accessor(result, result->GetVolumeData(timeStep));
+    target->SetVolume(accessor.GetData(), timeStep);
   }
+
+  m_VolumePreviewIsUpToDate = true;
+  RenderingManager::GetInstance()->RequestUpdateAll();
+}
+
+bool mitk::BinaryThresholdTool::IsVolumePreviewUpToDate() const
+{
+  return m_VolumePreviewIsUpToDate;
 }
@@ -24,6 +24,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include <itkImage.h>
 
+#include <mutex>
+
 namespace us
 {
   class ModuleResource;
@@ -34,6 +36,11 @@ namespace mitk
   /**
   \brief Calculates the segmented volumes for binary images.
 
+  While the threshold is changed, only the slices shown in the 2D render windows are thresholded.
+  The preview of the whole image is computed by UpdateVolumePreview(), which may run on another
+  thread, and shown by ShowVolumePreview(). AcceptCurrentThresholdValue() completes an outdated
+  preview before the segmentation is created.
+
   \ingroup ToolManagerEtAl
   \sa mitk::Tool
   \sa QmitkInteractiveSegmentation
@@ -60,6 +67,24 @@ namespace mitk
     virtual void AcceptCurrentThresholdValue();
     virtual void CancelThresholding();
 
+    /**
+      \brief Thresholds all time steps of the image with the current threshold.
+
+      The result is kept until ShowVolumePreview() is called. This method does not touch
+      the preview node, so it may be called from another thread.
+    */
+    void UpdateVolumePreview();
+
+    /**
+      \brief Copies the result of UpdateVolumePreview() to the preview node.
+
+      Results for an outdated threshold are discarded. Must be called from the GUI thread.
+    */
+    void ShowVolumePreview();
+
+    /// \brief Returns whether the whole preview matches the current threshold.
+    bool IsVolumePreviewUpToDate() const;
+
   protected:
     BinaryThresholdTool(); // purposely hidden
     ~BinaryThresholdTool() override;
@@ -71,16 +96,34 @@ namespace mitk
     void OnRoiDataChanged();
     void UpdatePreview();
 
+    /// \brief Thresholds the slices shown in the 2D render windows.
+    /// Returns false if a slice is not aligned to the image or no 2D render window shows it.
+    bool UpdateSlicePreview();
+
     template <typename TPixel, unsigned int VImageDimension>
     void ITKThresholding(itk::Image<TPixel, VImageDimension> *originalImage,
                          mitk::Image *segmentation,
-                         double thresholdValue,
+                         double lowerThreshold,
+                         double upperThreshold,
                          unsigned int timeStep);
     template <typename TPixel, unsigned int VImageDimension>
     void ITKThresholdingOldBinary(itk::Image<TPixel, VImageDimension> *originalImage,
                                   mitk::Image *segmentation,
-                                  double thresholdValue,
+                                  double lowerThreshold,
+                                  double upperThreshold,
                                   unsigned int timeStep);
+    template <typename TPixel, unsigned int VImageDimension>
+    void ITKThresholdingSlice(itk::Image<TPixel, VImageDimension> *originalImage,
+                              mitk::Image *segmentation,
+                              double lowerThreshold,
+                              double upperThreshold,
+                              unsigned int timeStep,
+                              int sliceDimension,
+                              int sliceIndex);
+
+    /// \brief Thresholds all time steps of thresholdImage into segmentation.
+    void ThresholdVolume(
+      Image *thresholdImage, Image *segmentation, double lowerThreshold, double upperThreshold, bool oldBinary);
 
     DataNode::Pointer m_ThresholdFeedbackNode;
     DataNode::Pointer m_OriginalImageNode;
@@ -92,6 +135,30 @@ namespace mitk
     bool m_IsFloatImage;
 
     bool m_IsOldBinary = false;
+
+    // the preview of the whole image matches m_CurrentThresholdValue
+    bool m_VolumePreviewIsUpToDate = false;
+
+    /// \brief Everything UpdateVolumePreview() needs, captured in the GUI thread.
+    struct VolumePreviewRequest
+    {
+      Image::Pointer Input;
+      Image::Pointer Target;
+      double LowerThreshold;
+      double UpperThreshold;
+      bool OldBinary;
+
+      bool operator==(const VolumePreviewRequest &other) const;
+    };
+
+    /// \brief Captures the current image, preview and threshold for UpdateVolumePreview().
+    void UpdateVolumePreviewRequest();
+
+    // guarded by m_PendingPreviewMutex
+    VolumePreviewRequest m_VolumePreviewRequest;
+    VolumePreviewRequest m_PendingRequest;
+    Image::Pointer m_PendingPreview;
+    std::mutex m_PendingPreviewMutex;
   };
 
 } // namespace
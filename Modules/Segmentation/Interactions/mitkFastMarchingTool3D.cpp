@@ -21,9 +21,17 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "mitkInteractionConst.h"
 #include "mitkRenderingManager.h"
 
+#include "itkExtractImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkImageRegionIterator.h"
 #include "itkOrImageFilter.h"
 #include "mitkImageCast.h"
 #include "mitkImageTimeSelector.h"
+#include "mitkSegmentationInterpolationController.h"
+
+#include <algorithm>
+#include <cmath>
 
 // us
 #include <usGetModuleContext.h>
@@ -36,6 +44,45 @@ namespace mitk
   MITK_TOOL_MACRO(MITKSEGMENTATION_EXPORT, FastMarchingTool3D, "FastMarching3D tool");
 }
 
+namespace
+{
+  // bounding region of all pixels other than 0, the region is empty if there are none
+  template <typename TImage>
+  itk::ImageRegion<3> GetForegroundRegion(const TImage *image)
+  {
+    itk::Index<3> minimum;
+    itk::Index<3> maximum;
+    minimum.Fill(itk::NumericTraits<itk::IndexValueType>::max());
+    maximum.Fill(itk::NumericTraits<itk::IndexValueType>::NonpositiveMin());
+
+    itk::ImageRegionConstIteratorWithIndex<TImage> iter(image, image->GetLargestPossibleRegion());
+    for (; !iter.IsAtEnd(); ++iter)
+    {
+      if (iter.Get() == 0)
+        continue;
+
+      const itk::Index<3> &index = iter.GetIndex();
+      for (unsigned int dim = 0; dim < 3; ++dim)
+      {
+        minimum[dim] = std::min(minimum[dim], index[dim]);
+        maximum[dim] = std::max(maximum[dim], index[dim]);
+      }
+    }
+
+    itk::ImageRegion<3> region;
+    if (minimum[0] > maximum[0])
+      return region;
+
+    itk::Size<3> size;
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      size[dim] = maximum[dim] - minimum[dim] + 1;
+
+    region.SetIndex(minimum);
+    region.SetSize(size);
+    return region;
+  }
+} // namespace
+
 mitk::FastMarchingTool3D::FastMarchingTool3D()
   : /*FeedbackContourTool*/ AutoSegmentationTool(),
     m_NeedUpdate(true),
@@ -47,7 +94,9 @@ mitk::FastMarchingTool3D::FastMarchingTool3D()
     m_Alpha(-0.5),
     m_Beta(3.0),
     m_PointSetAddObserverTag(0),
-    m_PointSetRemoveObserverTag(0)
+    m_PointSetRemoveObserverTag(0),
+    m_UpdateId(0),
+    m_RunningUpdateId(0)
 {
 }
 
@@ -91,14 +140,12 @@ const char *mitk::FastMarchingTool3D::GetName() const
 void mitk::FastMarchingTool3D::SetUpperThreshold(double value)
 {
   m_UpperThreshold = value / 10.0;
-  m_ThresholdFilter->SetUpperThreshold(m_UpperThreshold);
   m_NeedUpdate = true;
 }
 
 void mitk::FastMarchingTool3D::SetLowerThreshold(double value)
 {
   m_LowerThreshold = value / 10.0;
-  m_ThresholdFilter->SetLowerThreshold(m_LowerThreshold);
   m_NeedUpdate = true;
 }
 
@@ -107,7 +154,6 @@ void mitk::FastMarchingTool3D::SetBeta(double value)
   if (m_Beta != value)
   {
     m_Beta = value;
-    m_SigmoidFilter->SetBeta(m_Beta);
     m_NeedUpdate = true;
   }
 }
@@ -119,7 +165,6 @@ void mitk::FastMarchingTool3D::SetSigma(double value)
     if (value > 0.0)
     {
       m_Sigma = value;
-      m_GradientMagnitudeFilter->SetSigma(m_Sigma);
       m_NeedUpdate = true;
     }
   }
@@ -130,7 +175,6 @@ void mitk::FastMarchingTool3D::SetAlpha(double value)
   if (m_Alpha != value)
   {
     m_Alpha = value;
-    m_SigmoidFilter->SetAlpha(m_Alpha);
     m_NeedUpdate = true;
   }
 }
@@ -140,7 +184,6 @@ void mitk::FastMarchingTool3D::SetStoppingValue(double value)
   if (m_StoppingValue != value)
   {
     m_StoppingValue = value;
-    m_FastMarchingFilter->SetStoppingValue(m_StoppingValue);
     m_NeedUpdate = true;
   }
 }
@@ -177,43 +220,8 @@ void mitk::FastMarchingTool3D::Activated()
 
   m_ProgressCommand = mitk::ToolCommand::New();
 
-  m_ThresholdFilter = ThresholdingFilterType::New();
-  m_ThresholdFilter->SetLowerThreshold(m_LowerThreshold);
-  m_ThresholdFilter->SetUpperThreshold(m_UpperThreshold);
-  m_ThresholdFilter->SetOutsideValue(0);
-  m_ThresholdFilter->SetInsideValue(1.0);
-
-  m_SmoothFilter = SmoothingFilterType::New();
-  m_SmoothFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  m_SmoothFilter->SetTimeStep(0.05);
-  m_SmoothFilter->SetNumberOfIterations(2);
-  m_SmoothFilter->SetConductanceParameter(9.0);
-
-  m_GradientMagnitudeFilter = GradientFilterType::New();
-  m_GradientMagnitudeFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  m_GradientMagnitudeFilter->SetSigma(m_Sigma);
-
-  m_SigmoidFilter = SigmoidFilterType::New();
-  m_SigmoidFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  m_SigmoidFilter->SetAlpha(m_Alpha);
-  m_SigmoidFilter->SetBeta(m_Beta);
-  m_SigmoidFilter->SetOutputMinimum(0.0);
-  m_SigmoidFilter->SetOutputMaximum(1.0);
-
-  m_FastMarchingFilter = FastMarchingFilterType::New();
-  m_FastMarchingFilter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
-  m_FastMarchingFilter->SetStoppingValue(m_StoppingValue);
-
   m_SeedContainer = NodeContainer::New();
   m_SeedContainer->Initialize();
-  m_FastMarchingFilter->SetTrialPoints(m_SeedContainer);
-
-  // set up pipeline
-  m_SmoothFilter->SetInput(m_ReferenceImageAsITK);
-  m_GradientMagnitudeFilter->SetInput(m_SmoothFilter->GetOutput());
-  m_SigmoidFilter->SetInput(m_GradientMagnitudeFilter->GetOutput());
-  m_FastMarchingFilter->SetInput(m_SigmoidFilter->GetOutput());
-  m_ThresholdFilter->SetInput(m_FastMarchingFilter->GetOutput());
 
   m_ToolManager->GetDataStorage()->Add(m_SeedsAsPointSetNode, m_ToolManager->GetWorkingData(0));
 
@@ -232,13 +240,18 @@ void mitk::FastMarchingTool3D::Activated()
 
 void mitk::FastMarchingTool3D::Deactivated()
 {
+  // wait for a running update before the feature images are released
+  this->CancelUpdate();
+  {
+    std::lock_guard<std::mutex> lock(m_UpdateMutex);
+    m_FeatureImages.clear();
+    m_ResultImage = nullptr;
+    m_PendingResult = nullptr;
+  }
+
   m_ToolManager->GetDataStorage()->Remove(this->m_ResultImageNode);
   m_ToolManager->GetDataStorage()->Remove(this->m_SeedsAsPointSetNode);
   this->ClearSeeds();
-  this->m_SmoothFilter->RemoveAllObservers();
-  this->m_SigmoidFilter->RemoveAllObservers();
-  this->m_GradientMagnitudeFilter->RemoveAllObservers();
-  this->m_FastMarchingFilter->RemoveAllObservers();
   m_ResultImageNode = nullptr;
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
@@ -261,6 +274,9 @@ void mitk::FastMarchingTool3D::Deactivated()
 
 void mitk::FastMarchingTool3D::Initialize()
 {
+  this->CancelUpdate();
+  std::lock_guard<std::mutex> lock(m_UpdateMutex);
+
   m_ReferenceImage = dynamic_cast<mitk::Image *>(m_ToolManager->GetReferenceData(0)->GetData());
   if (m_ReferenceImage->GetTimeGeometry()->CountTimeSteps() > 1)
   {
@@ -270,15 +286,15 @@ void mitk::FastMarchingTool3D::Initialize()
     timeSelector->UpdateLargestPossibleRegion();
     m_ReferenceImage = timeSelector->GetOutput();
   }
+  // the feature images are cached per time step until the tool is deactivated
   CastToItkImage(m_ReferenceImage, m_ReferenceImageAsITK);
-  m_SmoothFilter->SetInput(m_ReferenceImageAsITK);
   m_NeedUpdate = true;
 }
 
 void mitk::FastMarchingTool3D::ConfirmSegmentation()
 {
   // combine preview image with current working segmentation
-  if (dynamic_cast<mitk::Image *>(m_ResultImageNode->GetData()))
+  if (dynamic_cast<mitk::Image *>(m_ResultImageNode->GetData()) && m_ResultImage.IsNotNull())
   {
     // logical or combination of preview and segmentation slice
     OutputImageType::Pointer segmentationImageInITK = OutputImageType::New();
@@ -300,16 +316,25 @@ void mitk::FastMarchingTool3D::ConfirmSegmentation()
     typedef itk::OrImageFilter<OutputImageType, OutputImageType> OrImageFilterType;
     OrImageFilterType::Pointer orFilter = OrImageFilterType::New();
 
-    orFilter->SetInput(0, m_ThresholdFilter->GetOutput());
+    orFilter->SetInput(0, m_ResultImage);
     orFilter->SetInput(1, segmentationImageInITK);
     orFilter->Update();
 
+    // only the pixels of the result can change, so the interpolation just rescans their bounding region
+    mitk::SegmentationInterpolationController *interpolator =
+      mitk::SegmentationInterpolationController::InterpolatorForImage(workingImage);
+    if (interpolator != nullptr)
+      interpolator->BeginChangedRegion(GetForegroundRegion(m_ResultImage.GetPointer()), m_CurrentTimeStep);
+
     // set image volume in current time step from itk image
-    workingImage->SetVolume((void *)(m_ThresholdFilter->GetOutput()->GetPixelContainer()->GetBufferPointer()),
+    workingImage->SetVolume((void *)(orFilter->GetOutput()->GetPixelContainer()->GetBufferPointer()),
                             m_CurrentTimeStep);
     this->m_ResultImageNode->SetVisibility(false);
     this->ClearSeeds();
     workingImage->Modified();
+
+    if (interpolator != nullptr)
+      interpolator->EndChangedRegion();
   }
 
   mitk::RenderingManager::GetInstance()->RequestUpdateAll();
@@ -332,14 +357,18 @@ void mitk::FastMarchingTool3D::OnAddPoint()
   const double seedValue = 0.0;
   node.SetValue(seedValue);
   node.SetIndex(seedPosition);
-  this->m_SeedContainer->InsertElement(this->m_SeedContainer->Size(), node);
-  m_FastMarchingFilter->Modified();
 
-  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+  // the seeds of a running update are outdated
+  this->CancelUpdate();
+  {
+    std::lock_guard<std::mutex> lock(m_UpdateMutex);
+    this->m_SeedContainer->InsertElement(this->m_SeedContainer->Size(), node);
+    m_NeedUpdate = true;
+  }
 
-  m_NeedUpdate = true;
+  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
-  this->Update();
+  this->RequestUpdate();
 
   m_ReadyMessage.Send();
 }
@@ -350,37 +379,43 @@ void mitk::FastMarchingTool3D::OnDelete()
   if (!(this->m_SeedContainer->empty()))
   {
     // delete last element of seeds container
-    this->m_SeedContainer->pop_back();
-    m_FastMarchingFilter->Modified();
+    this->CancelUpdate();
+    {
+      std::lock_guard<std::mutex> lock(m_UpdateMutex);
+      this->m_SeedContainer->pop_back();
+      m_NeedUpdate = true;
+    }
 
     mitk::RenderingManager::GetInstance()->RequestUpdateAll();
 
-    m_NeedUpdate = true;
+    this->RequestUpdate();
+  }
+}
 
+void mitk::FastMarchingTool3D::RequestUpdate()
+{
+  // a GUI runs the update in the background, without one the tool is updated right away
+  if (m_UpdateRequestedMessage.HasListeners())
+    m_UpdateRequestedMessage.Send();
+  else
     this->Update();
-  }
 }
 
 void mitk::FastMarchingTool3D::Update()
 {
-  const unsigned int progress_steps = 200;
-
   if (m_NeedUpdate)
   {
-    m_ProgressCommand->AddStepsToDo(progress_steps);
-
     // remove interaction with poinset while updating
     m_SeedPointInteractor->SetDataNode(nullptr);
     CurrentlyBusy.Send(true);
     try
     {
-      m_ThresholdFilter->Update();
+      this->UpdatePreview();
     }
     catch (itk::ExceptionObject &excep)
     {
       MITK_ERROR << "Exception caught: " << excep.GetDescription();
 
-      m_ProgressCommand->SetProgress(progress_steps);
       CurrentlyBusy.Send(false);
 
       std::string msg = excep.GetDescription();
@@ -388,28 +423,268 @@ void mitk::FastMarchingTool3D::Update()
 
       return;
     }
-    m_ProgressCommand->SetProgress(progress_steps);
     CurrentlyBusy.Send(false);
 
-    // make output visible
-    mitk::Image::Pointer result = mitk::Image::New();
-    CastToMitkImage(m_ThresholdFilter->GetOutput(), result);
-    result->GetGeometry()->SetOrigin(m_ReferenceImage->GetGeometry()->GetOrigin());
-    result->GetGeometry()->SetIndexToWorldTransform(m_ReferenceImage->GetGeometry()->GetIndexToWorldTransform());
-    m_ResultImageNode->SetData(result);
-    m_ResultImageNode->SetVisibility(true);
-    mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+    this->ShowPreview();
 
     // add interaction with poinset again
     m_SeedPointInteractor->SetDataNode(m_SeedsAsPointSetNode);
   }
 }
 
+void mitk::FastMarchingTool3D::UpdatePreview()
+{
+  std::lock_guard<std::mutex> lock(m_UpdateMutex);
+  const unsigned int updateId = m_UpdateId;
+
+  if (!m_NeedUpdate || m_ReferenceImageAsITK.IsNull())
+    return;
+
+  const InternalImageType::RegionType largestRegion = m_ReferenceImageAsITK->GetLargestPossibleRegion();
+
+  std::vector<itk::Index<3>> seeds;
+  for (auto it = m_SeedContainer->Begin(); it != m_SeedContainer->End(); ++it)
+  {
+    if (largestRegion.IsInside(it->Value().GetIndex()))
+      seeds.push_back(it->Value().GetIndex());
+  }
+
+  OutputImageType::Pointer result = OutputImageType::New();
+  result->SetRegions(largestRegion);
+  result->SetSpacing(m_ReferenceImageAsITK->GetSpacing());
+  result->SetOrigin(m_ReferenceImageAsITK->GetOrigin());
+  result->SetDirection(m_ReferenceImageAsITK->GetDirection());
+  result->Allocate();
+  result->FillBuffer(0);
+
+  if (!seeds.empty())
+  {
+    InternalImageType::RegionType region = this->ComputeRegionOfInterest(seeds);
+    FeatureImages &features = m_FeatureImages[m_CurrentTimeStep];
+
+    if (features.SmoothedImage.IsNull() || !features.Region.IsInside(region))
+    {
+      // grow the cached region, so the former seeds stay inside
+      if (features.SmoothedImage.IsNotNull())
+      {
+        InternalImageType::IndexType lower, upper;
+        for (unsigned int i = 0; i < 3; ++i)
+        {
+          lower[i] = std::min(region.GetIndex(i), features.Region.GetIndex(i));
+          upper[i] = std::max(region.GetUpperIndex()[i], features.Region.GetUpperIndex()[i]);
+        }
+        region.SetIndex(lower);
+        region.SetUpperIndex(upper);
+      }
+
+      typedef itk::ExtractImageFilter<InternalImageType, InternalImageType> ExtractFilterType;
+      ExtractFilterType::Pointer extractFilter = ExtractFilterType::New();
+      extractFilter->SetInput(m_ReferenceImageAsITK);
+      extractFilter->SetExtractionRegion(region);
+      extractFilter->SetDirectionCollapseToSubmatrix();
+
+      SmoothingFilterType::Pointer smoothFilter = SmoothingFilterType::New();
+      smoothFilter->SetInput(extractFilter->GetOutput());
+      smoothFilter->SetTimeStep(0.05);
+      smoothFilter->SetNumberOfIterations(2);
+      smoothFilter->SetConductanceParameter(9.0);
+
+      if (!this->UpdateFilter(extractFilter, updateId) || !this->UpdateFilter(smoothFilter, updateId))
+        return;
+
+      features.Region = region;
+      features.SmoothedImage = smoothFilter->GetOutput();
+      features.SmoothedImage->DisconnectPipeline();
+      features.SpeedImage = nullptr;
+    }
+
+    if (features.SpeedImage.IsNull() || features.Sigma != m_Sigma || features.Alpha != m_Alpha ||
+        features.Beta != m_Beta)
+    {
+      GradientFilterType::Pointer gradientMagnitudeFilter = GradientFilterType::New();
+      gradientMagnitudeFilter->SetInput(features.SmoothedImage);
+      gradientMagnitudeFilter->SetSigma(m_Sigma);
+
+      SigmoidFilterType::Pointer sigmoidFilter = SigmoidFilterType::New();
+      sigmoidFilter->SetInput(gradientMagnitudeFilter->GetOutput());
+      sigmoidFilter->SetAlpha(m_Alpha);
+      sigmoidFilter->SetBeta(m_Beta);
+      sigmoidFilter->SetOutputMinimum(0.0);
+      sigmoidFilter->SetOutputMaximum(1.0);
+
+      if (!this->UpdateFilter(gradientMagnitudeFilter, updateId) || !this->UpdateFilter(sigmoidFilter, updateId))
+        return;
+
+      features.SpeedImage = sigmoidFilter->GetOutput();
+      features.SpeedImage->DisconnectPipeline();
+      features.Sigma = m_Sigma;
+      features.Alpha = m_Alpha;
+      features.Beta = m_Beta;
+    }
+
+    // only the fast marching runs again for new seeds
+    NodeContainer::Pointer trialPoints = NodeContainer::New();
+    trialPoints->Initialize();
+    for (const auto &seed : seeds)
+    {
+      NodeType node;
+      node.SetValue(0.0);
+      node.SetIndex(seed);
+      trialPoints->InsertElement(trialPoints->Size(), node);
+    }
+
+    FastMarchingFilterType::Pointer fastMarchingFilter = FastMarchingFilterType::New();
+    fastMarchingFilter->SetInput(features.SpeedImage);
+    fastMarchingFilter->SetTrialPoints(trialPoints);
+    fastMarchingFilter->SetStoppingValue(m_StoppingValue);
+
+    ThresholdingFilterType::Pointer thresholdFilter = ThresholdingFilterType::New();
+    thresholdFilter->SetInput(fastMarchingFilter->GetOutput());
+    thresholdFilter->SetLowerThreshold(m_LowerThreshold);
+    thresholdFilter->SetUpperThreshold(m_UpperThreshold);
+    thresholdFilter->SetOutsideValue(0);
+    thresholdFilter->SetInsideValue(1.0);
+
+    if (!this->UpdateFilter(fastMarchingFilter, updateId) || !this->UpdateFilter(thresholdFilter, updateId))
+      return;
+
+    // copy the region of interest into the result of the whole image
+    itk::ImageRegionConstIterator<OutputImageType> regionIt(thresholdFilter->GetOutput(), features.Region);
+    itk::ImageRegionIterator<OutputImageType> resultIt(result, features.Region);
+    for (; !regionIt.IsAtEnd(); ++regionIt, ++resultIt)
+    {
+      resultIt.Set(regionIt.Get());
+    }
+  }
+
+  {
+    std::lock_guard<std::mutex> pendingLock(m_PendingResultMutex);
+    m_PendingResult = result;
+  }
+  m_NeedUpdate = false;
+}
+
+void mitk::FastMarchingTool3D::ShowPreview()
+{
+  OutputImageType::Pointer result;
+  {
+    std::lock_guard<std::mutex> lock(m_PendingResultMutex);
+    result = m_PendingResult;
+    m_PendingResult = nullptr;
+  }
+
+  if (result.IsNull() || m_ResultImageNode.IsNull())
+    return;
+
+  m_ResultImage = result;
+
+  // make output visible
+  mitk::Image::Pointer resultImage = mitk::Image::New();
+  CastToMitkImage(m_ResultImage, resultImage);
+  resultImage->GetGeometry()->SetOrigin(m_ReferenceImage->GetGeometry()->GetOrigin());
+  resultImage->GetGeometry()->SetIndexToWorldTransform(m_ReferenceImage->GetGeometry()->GetIndexToWorldTransform());
+  m_ResultImageNode->SetData(resultImage);
+  m_ResultImageNode->SetVisibility(true);
+  mitk::RenderingManager::GetInstance()->RequestUpdateAll();
+}
+
+void mitk::FastMarchingTool3D::CancelUpdate()
+{
+  // the running filter is aborted by OnFilterProgress(), as ITK resets the abort flag when an update starts
+  ++m_UpdateId;
+}
+
+bool mitk::FastMarchingTool3D::IsCanceled(unsigned int updateId) const
+{
+  return m_UpdateId != updateId;
+}
+
+bool mitk::FastMarchingTool3D::UpdateFilter(itk::ProcessObject *filter, unsigned int updateId)
+{
+  if (this->IsCanceled(updateId))
+    return false;
+
+  m_RunningUpdateId = updateId;
+
+  auto progressCommand = itk::MemberCommand<mitk::FastMarchingTool3D>::New();
+  progressCommand->SetCallbackFunction(this, &mitk::FastMarchingTool3D::OnFilterProgress);
+  const unsigned long progressObserverTag = filter->AddObserver(itk::ProgressEvent(), progressCommand);
+
+  // the progress bar is advanced by every progress event of the filter and completed when it is done
+  const unsigned int progressSteps = 100;
+  m_ProgressCommand->AddStepsToDo(progressSteps);
+  const unsigned long progressBarObserverTag = filter->AddObserver(itk::ProgressEvent(), m_ProgressCommand);
+
+  try
+  {
+    filter->Update();
+  }
+  catch (const itk::ProcessAborted &)
+  {
+    // CancelUpdate() was called, the result is discarded below
+  }
+  catch (...)
+  {
+    filter->RemoveObserver(progressObserverTag);
+    filter->RemoveObserver(progressBarObserverTag);
+    m_ProgressCommand->SetProgress(progressSteps);
+    throw;
+  }
+
+  filter->RemoveObserver(progressObserverTag);
+  filter->RemoveObserver(progressBarObserverTag);
+  m_ProgressCommand->SetProgress(progressSteps);
+  return !this->IsCanceled(updateId);
+}
+
+void mitk::FastMarchingTool3D::OnFilterProgress(itk::Object *caller, const itk::EventObject &)
+{
+  if (this->IsCanceled(m_RunningUpdateId))
+    static_cast<itk::ProcessObject *>(caller)->AbortGenerateDataOn();
+}
+
+mitk::FastMarchingTool3D::InternalImageType::RegionType mitk::FastMarchingTool3D::ComputeRegionOfInterest(
+  const std::vector<itk::Index<3>> &seeds) const
+{
+  // The speed image is at most 1, so the front stops within a distance of the stopping value (in mm) to the seeds.
+  // The gradient magnitude needs about 4 sigma around the reached voxels, the smoothing one voxel per iteration.
+  const InternalImageType::SpacingType spacing = m_ReferenceImageAsITK->GetSpacing();
+  const double margin = m_StoppingValue + 4.0 * m_Sigma;
+
+  InternalImageType::IndexType lower = seeds.front();
+  InternalImageType::IndexType upper = seeds.front();
+  for (const auto &seed : seeds)
+  {
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      lower[i] = std::min(lower[i], seed[i]);
+      upper[i] = std::max(upper[i], seed[i]);
+    }
+  }
+
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    const auto radius = static_cast<itk::IndexValueType>(std::ceil(margin / spacing[i])) + 3;
+    lower[i] -= radius;
+    upper[i] += radius;
+  }
+
+  InternalImageType::RegionType region;
+  region.SetIndex(lower);
+  region.SetUpperIndex(upper);
+  region.Crop(m_ReferenceImageAsITK->GetLargestPossibleRegion());
+  return region;
+}
+
 void mitk::FastMarchingTool3D::ClearSeeds()
 {
   // clear seeds for FastMarching as well as the PointSet for visualization
-  if (this->m_SeedContainer.IsNotNull())
-    this->m_SeedContainer->Initialize();
+  this->CancelUpdate();
+  {
+    std::lock_guard<std::mutex> lock(m_UpdateMutex);
+    if (this->m_SeedContainer.IsNotNull())
+      this->m_SeedContainer->Initialize();
+  }
 
   if (this->m_SeedsAsPointSet.IsNotNull())
   {
@@ -437,9 +712,6 @@ void mitk::FastMarchingTool3D::ClearSeeds()
     m_PointSetRemoveObserverTag = m_SeedsAsPointSet->AddObserver(mitk::PointSetRemoveEvent(), pointRemovedCommand);
   }
 
-  if (this->m_FastMarchingFilter.IsNotNull())
-    m_FastMarchingFilter->Modified();
-
   this->m_NeedUpdate = true;
 }
 
@@ -457,7 +729,11 @@ void mitk::FastMarchingTool3D::SetCurrentTimeStep(int t)
 {
   if (m_CurrentTimeStep != t)
   {
-    m_CurrentTimeStep = t;
+    this->CancelUpdate();
+    {
+      std::lock_guard<std::mutex> lock(m_UpdateMutex);
+      m_CurrentTimeStep = t;
+    }
 
     this->Initialize();
   }
@@ -26,8 +26,13 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkMessage.h"
 
+#include "itkCommand.h"
 #include "itkImage.h"
 
+#include <atomic>
+#include <map>
+#include <mutex>
+
 // itk filter
 #include "itkBinaryThresholdImageFilter.h"
 #include "itkCurvatureAnisotropicDiffusionImageFilter.h"
@@ -50,12 +55,25 @@ namespace mitk
       Smoothing->GradientMagnitude->SigmoidFunction->FastMarching->Threshold
     The resulting binary image is seen as a segmentation of an object.
 
+    The pipeline only runs in a region of interest around the seeds. As the speed image is at most 1,
+    no voxel further away from a seed than the stopping value can be reached, so the region grows with
+    the seeds and the stopping value. The smoothed image and the speed image of that region are cached
+    per time step, thus adding a seed only runs the fast marching and changing alpha, beta or sigma
+    does not smooth again.
+
+    UpdatePreview() may run on a background thread while ShowPreview() is called in the GUI thread
+    afterwards. CancelUpdate() aborts a running update whose parameters are outdated.
+
     For detailed documentation see ITK Software Guide section 9.3.1 Fast Marching Segmentation.
   */
   class MITKSEGMENTATION_EXPORT FastMarchingTool3D : public AutoSegmentationTool
   {
     mitkNewMessageMacro(Ready);
 
+    /// Sent when the seeds changed. A listener has to run UpdatePreview() and ShowPreview() afterwards,
+    /// e.g. in the background. Without listener the seed handlers call Update() right away.
+    mitkNewMessageMacro(UpdateRequested);
+
   public:
     mitkClassMacro(FastMarchingTool3D, AutoSegmentationTool) itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
@@ -110,6 +128,15 @@ namespace mitk
     /// \brief Updates the itk pipeline and shows the result of FastMarching.
     void Update();
 
+    /// \brief Computes the result of FastMarching without showing it. May be called from a background thread.
+    void UpdatePreview();
+
+    /// \brief Shows the result of the last finished UpdatePreview(). Has to be called from the GUI thread.
+    void ShowPreview();
+
+    /// \brief Aborts a running UpdatePreview(), e.g. because the parameters changed again.
+    void CancelUpdate();
+
   protected:
     FastMarchingTool3D();
     ~FastMarchingTool3D() override;
@@ -124,9 +151,35 @@ namespace mitk
     /// \brief Delete action of StateMachine pattern
     virtual void OnDelete();
 
+    /// \brief Sends UpdateRequested or, if nobody listens, calls Update().
+    void RequestUpdate();
+
     /// \brief Reset all relevant inputs of the itk pipeline.
     void Reset();
 
+    /// \brief Smoothed and speed image of a region of the reference image at one time step.
+    struct FeatureImages
+    {
+      InternalImageType::RegionType Region;
+      InternalImageType::Pointer SmoothedImage;
+      InternalImageType::Pointer SpeedImage;
+      float Sigma;
+      float Alpha;
+      float Beta;
+    };
+
+    /// \brief Returns the region that contains every voxel the front can reach from the seeds.
+    InternalImageType::RegionType ComputeRegionOfInterest(const std::vector<itk::Index<3>> &seeds) const;
+
+    /// \brief Runs an itk filter unless the update is canceled, returns false if it was canceled.
+    bool UpdateFilter(itk::ProcessObject *filter, unsigned int updateId);
+
+    /// \brief Checks if the update was canceled by CancelUpdate() since it started.
+    bool IsCanceled(unsigned int updateId) const;
+
+    /// \brief Aborts the running filter if its update was canceled, observes the progress of the filter.
+    void OnFilterProgress(itk::Object *caller, const itk::EventObject &);
+
     mitk::ToolCommand::Pointer m_ProgressCommand;
 
     Image::Pointer m_ReferenceImage;
@@ -146,6 +199,16 @@ namespace mitk
 
     InternalImageType::Pointer m_ReferenceImageAsITK; // the reference image as itk::Image
 
+    std::map<int, FeatureImages> m_FeatureImages; // cached feature images per time step
+
+    OutputImageType::Pointer m_ResultImage;   // the shown result of FastMarching
+    OutputImageType::Pointer m_PendingResult; // result of the last UpdatePreview() that is not shown yet
+
+    std::mutex m_UpdateMutex;             // held while UpdatePreview() runs
+    std::mutex m_PendingResultMutex;      // guards m_PendingResult
+    std::atomic<unsigned int> m_UpdateId; // increased by CancelUpdate() to outdate running updates
+    unsigned int m_RunningUpdateId;       // the id of the update whose filter is currently running
+
     mitk::DataNode::Pointer m_ResultImageNode; // holds the result as a preview image
 
     mitk::DataNode::Pointer m_SeedsAsPointSetNode; // used to visualize the seed points
@@ -153,12 +216,6 @@ namespace mitk
     mitk::PointSetDataInteractor::Pointer m_SeedPointInteractor;
     unsigned int m_PointSetAddObserverTag;
     unsigned int m_PointSetRemoveObserverTag;
-
-    ThresholdingFilterType::Pointer m_ThresholdFilter;
-    SmoothingFilterType::Pointer m_SmoothFilter;
-    GradientFilterType::Pointer m_GradientMagnitudeFilter;
-    SigmoidFilterType::Pointer m_SigmoidFilter;
-    FastMarchingFilterType::Pointer m_FastMarchingFilter;
   };
 
 } // namespace
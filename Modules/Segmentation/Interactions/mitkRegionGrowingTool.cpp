@@ -37,12 +37,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 // ITK
 #include "mitkITKImageImport.h"
 #include "mitkImageAccessByItk.h"
-#include <itkConnectedComponentImageFilter.h>
-#include <itkConnectedThresholdImageFilter.h>
+#include "mitkScanlineFloodFill.h"
+#include <itkImageRegionConstIteratorWithIndex.h>
 #include <itkImageRegionIteratorWithIndex.h>
-#include <itkNeighborhoodIterator.h>
-
-#include <itkImageDuplicator.h>
 
 namespace mitk
 {
@@ -186,7 +183,7 @@ void mitk::RegionGrowingTool::IsInsideSegmentation(itk::Image<TPixel, imageDimen
   }
 }
 
-// Do the region growing (i.e. call an ITK filter that does it)
+// Do the region growing (i.e. a scanline flood fill within the thresholds)
 template <typename TPixel, unsigned int imageDimension>
 void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimension> *inputImage,
                                                  itk::Index<imageDimension> seedIndex,
@@ -198,88 +195,89 @@ void mitk::RegionGrowingTool::StartRegionGrowing(itk::Image<TPixel, imageDimensi
 
   typedef itk::Image<TPixel, imageDimension> InputImageType;
   typedef itk::Image<DefaultSegmentationDataType, imageDimension> OutputImageType;
+  typedef ScanlineFloodFill<imageDimension> FloodFillType;
+  typedef typename FloodFillType::RegionType RegionType;
+  typedef typename FloodFillType::IndexType IndexType;
 
-  typedef itk::ConnectedThresholdImageFilter<InputImageType, OutputImageType> RegionGrowingFilterType;
-  typename RegionGrowingFilterType::Pointer regionGrower = RegionGrowingFilterType::New();
-
-  // perform region growing in desired segmented region
-  regionGrower->SetInput(inputImage);
-  regionGrower->AddSeed(seedIndex);
-
-  regionGrower->SetLower(thresholds[0]);
-  regionGrower->SetUpper(thresholds[1]);
-
-  try
-  {
-    regionGrower->Update();
-  }
-  catch (...)
-  {
-    return; // Should we do something?
-  }
-
-  typename OutputImageType::Pointer resultImage = regionGrower->GetOutput();
+  const RegionType region = inputImage->GetBufferedRegion();
+  const TPixel *inputBuffer = inputImage->GetBufferPointer();
 
-  // Smooth result: Every pixel is replaced by the majority of the neighborhood
-  typedef itk::NeighborhoodIterator<OutputImageType> NeighborhoodIteratorType;
-  typedef itk::ImageRegionIterator<OutputImageType> ImageIteratorType;
+  // the same bounds as itk::ConnectedThresholdImageFilter
+  const TPixel lower = static_cast<TPixel>(thresholds[0]);
+  const TPixel upper = static_cast<TPixel>(thresholds[1]);
 
-  typename NeighborhoodIteratorType::RadiusType radius;
+  // perform region growing in desired segmented region
+  FloodFillType regionGrower(region);
+  regionGrower.Fill(seedIndex, [inputBuffer, lower, upper](std::size_t offset) {
+    return lower <= inputBuffer[offset] && inputBuffer[offset] <= upper;
+  });
+
+  // Smooth result: Every pixel is replaced by the majority of the neighborhood. Pixels farther from the grown region
+  // than the radius get no vote for it, so only its padded bounding box is visited.
+  typename RegionType::SizeType radius;
   radius.Fill(2); // for now, maybe make this something the user can adjust in the preferences?
 
-  typedef itk::ImageDuplicator< OutputImageType > DuplicatorType;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage(resultImage);
-  duplicator->Update();
+  unsigned int neighborhoodSize = 1;
+  for (unsigned int i = 0; i < imageDimension; ++i)
+    neighborhoodSize *= 2 * radius[i] + 1;
 
-  typename OutputImageType::Pointer resultDup = duplicator->GetOutput();
+  RegionType smoothingRegion = regionGrower.GetBoundingBox();
+  smoothingRegion.PadByRadius(radius);
+  smoothingRegion.Crop(region);
 
-  NeighborhoodIteratorType neighborhoodIterator(radius, resultDup, resultDup->GetRequestedRegion());
-  ImageIteratorType imageIterator(resultImage, resultImage->GetRequestedRegion());
+  std::vector<bool> smoothed(region.GetNumberOfPixels(), false);
+  const IndexType upperIndex = region.GetUpperIndex();
 
-  for (neighborhoodIterator.GoToBegin(), imageIterator.GoToBegin(); !neighborhoodIterator.IsAtEnd();
-       ++neighborhoodIterator, ++imageIterator)
+  itk::ImageRegionConstIteratorWithIndex<InputImageType> smoothingIterator(inputImage, smoothingRegion);
+  for (smoothingIterator.GoToBegin(); !smoothingIterator.IsAtEnd(); ++smoothingIterator)
   {
-    DefaultSegmentationDataType voteYes(0);
-    DefaultSegmentationDataType voteNo(0);
+    const IndexType center = smoothingIterator.GetIndex();
+    unsigned int voteYes(0);
 
-    for (unsigned int i = 0; i < neighborhoodIterator.Size(); ++i)
+    // neighbors outside the image repeat the border pixels, like itk::ZeroFluxNeumannBoundaryCondition
+    for (unsigned int n = 0; n < neighborhoodSize; ++n)
     {
-      if (neighborhoodIterator.GetPixel(i) > 0)
-      {
-        voteYes += 1;
-      }
-      else
+      IndexType neighbor;
+      unsigned int remainder = n;
+      for (unsigned int i = 0; i < imageDimension; ++i)
       {
-        voteNo += 1;
+        const auto width = 2 * radius[i] + 1;
+        const auto position = center[i] + static_cast<typename IndexType::IndexValueType>(remainder % width) -
+                              static_cast<typename IndexType::IndexValueType>(radius[i]);
+        neighbor[i] = std::max(region.GetIndex(i), std::min(upperIndex[i], position));
+        remainder /= width;
       }
-    }
 
-    if (voteYes > voteNo)
-    {
-      imageIterator.Set(1);
-    }
-    else
-    {
-      imageIterator.Set(0);
+      if (regionGrower.IsFilled(regionGrower.ComputeOffset(neighbor)))
+        ++voteYes;
     }
+
+    if (2 * voteYes > neighborhoodSize)
+      smoothed[regionGrower.ComputeOffset(center)] = true;
   }
 
-  if (resultImage.IsNull())
+  // The smoothing can split the region, only the part that contains the seed is kept
+  FloodFillType component(region);
+  component.Fill(seedIndex, [&smoothed](std::size_t offset) { return smoothed[offset]; });
+
+  if (0 == component.GetNumberOfFilledPixels())
   {
     MITK_DEBUG << "Region growing result is empty.";
+    m_ConnectedComponentValue = 0;
+  }
+  else
+  {
+    m_ConnectedComponentValue = 1;
   }
 
-  // Can potentially have multiple regions, use connected component image filter to label disjunct regions
-  typedef itk::ConnectedComponentImageFilter<OutputImageType, OutputImageType> ConnectedComponentImageFilterType;
-  typename ConnectedComponentImageFilterType::Pointer connectedComponentFilter =
-    ConnectedComponentImageFilterType::New();
-  connectedComponentFilter->SetInput(resultImage);
-  connectedComponentFilter->Update();
-  typename OutputImageType::Pointer resultImageCC = connectedComponentFilter->GetOutput();
-  m_ConnectedComponentValue = resultImageCC->GetPixel(seedIndex);
+  typename OutputImageType::Pointer resultImage = OutputImageType::New();
+  resultImage->SetRegions(region);
+  resultImage->CopyInformation(inputImage);
+  resultImage->Allocate();
+  resultImage->FillBuffer(0);
+  component.Write(resultImage.GetPointer(), 1);
 
-  outputImage = mitk::GrabItkImageMemory(resultImageCC);
+  outputImage = mitk::GrabItkImageMemory(resultImage);
 }
 
 void mitk::RegionGrowingTool::OnMousePressed(StateMachineAction *, InteractionEvent *interactionEvent)
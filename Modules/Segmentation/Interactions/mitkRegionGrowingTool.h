@@ -125,7 +125,7 @@ namespace mitk
                               bool *result);
 
     /**
-     * @brief Template that calls an ITK filter to do the region growing.
+     * @brief Template that grows the region with a scanline flood fill, smoothes it and keeps the part with the seed.
      */
     template <typename TPixel, unsigned int imageDimension>
     void StartRegionGrowing(itk::Image<TPixel, imageDimension> *itkImage,
@@ -37,10 +37,12 @@ See LICENSE.txt or http://www.mitk.org for details.
 // Includes for 3DSurfaceInterpolation
 #include "mitkImageTimeSelector.h"
 #include "mitkImageToContourFilter.h"
+#include "mitkSegmentationInterpolationController.h"
 #include "mitkSurfaceInterpolationController.h"
 
 // includes for resling and overwriting
 #include <mitkExtractSliceFilter.h>
+#include <mitkImageRegionModifiedEvent.h>
 #include <mitkVtkImageOverwrite.h>
 #include <vtkImageData.h>
 #include <vtkSmartPointer.h>
@@ -373,14 +375,8 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   auto *image = dynamic_cast<Image *>(workingNode->GetData());
 
   /*============= BEGIN undo/redo feature block ========================*/
-  // Create undo operation by caching the not yet modified slices
+  // Cache the not yet modified slice, the undo operation only stores the pixels changed by the edit
   mitk::Image::Pointer originalSlice = GetAffectedImageSliceAs2DImage(sliceInfo.plane, image, sliceInfo.timestep);
-  auto *undoOperation =
-    new DiffSliceOperation(image,
-                           originalSlice,
-                           dynamic_cast<SlicedGeometry3D *>(originalSlice->GetGeometry()),
-                           sliceInfo.timestep,
-                           sliceInfo.plane);
   /*============= END undo/redo feature block ========================*/
 
   // Make sure that for reslicing and overwriting the same alogrithm is used. We can specify the mode of the vtk
@@ -404,15 +400,62 @@ void mitk::SegTool2D::WriteSliceToVolume(const mitk::SegTool2D::SliceInformation
   extractor->Modified();
   extractor->Update();
 
-  // the image was modified within the pipeline, but not marked so
-  image->Modified();
-  image->GetVtkImageData()->Modified();
+  // only the voxels in the overwritten extent changed, nothing has to be updated if it is empty
+  int overwrittenExtent[6];
+  reslice->GetOverwrittenExtent(overwrittenExtent);
+  if (overwrittenExtent[0] <= overwrittenExtent[1])
+  {
+    itk::ImageRegion<3> changedRegion;
+    for (unsigned int i = 0; i < 3; ++i)
+    {
+      changedRegion.SetIndex(i, overwrittenExtent[2 * i]);
+      changedRegion.SetSize(i, overwrittenExtent[2 * i + 1] - overwrittenExtent[2 * i] + 1);
+    }
+
+    // the slice interpolation accounts for the changed pixels instead of scanning the whole image again
+    SegmentationInterpolationController *interpolator =
+      SegmentationInterpolationController::InterpolatorForImage(image);
+    const bool interpolatorUpdated =
+      interpolator != nullptr &&
+      interpolator->SetChangedSlice(originalSlice, extractor->GetOutput(), sliceInfo.timestep, &changedRegion);
+
+    if (interpolatorUpdated)
+      interpolator->BlockModified(true);
+
+    // observers that keep results up to date (e.g. image statistics) only have to visit the changed region
+    image->InvokeEvent(ImageRegionModifiedEvent(changedRegion, sliceInfo.timestep));
+
+    // the image was modified within the pipeline, but not marked so
+    // label set images account for the changed voxels in their label index instead of rebuilding it
+    auto *labelSetImage = dynamic_cast<LabelSetImage *>(image);
+    if (labelSetImage != nullptr)
+    {
+      labelSetImage->UpdateLabelIndex(originalSlice, extractor->GetOutput(), sliceInfo.timestep, &changedRegion);
+    }
+    else
+    {
+      image->Modified();
+    }
+    image->GetVtkImageData()->Modified();
+
+    if (interpolatorUpdated)
+      interpolator->BlockModified(false);
+  }
 
   /*============= BEGIN undo/redo feature block ========================*/
-  // specify the undo operation with the edited slice
+  // create undo and redo operation holding the changed region of the original and the edited slice
+  auto *undoOperation =
+    new DiffSliceOperation(image,
+                           originalSlice,
+                           extractor->GetOutput(),
+                           dynamic_cast<SlicedGeometry3D *>(originalSlice->GetGeometry()),
+                           sliceInfo.timestep,
+                           sliceInfo.plane);
+
   auto *doOperation =
     new DiffSliceOperation(image,
                            extractor->GetOutput(),
+                           originalSlice,
                            dynamic_cast<SlicedGeometry3D *>(sliceInfo.slice->GetGeometry()),
                            sliceInfo.timestep,
                            sliceInfo.plane);
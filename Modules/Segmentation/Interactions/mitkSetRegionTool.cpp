@@ -25,9 +25,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkITKImageImport.h>
 #include <mitkImagePixelReadAccessor.h>
 #include <mitkImageToContourModelFilter.h>
+#include <mitkScanlineFloodFill.h>
 
-#include <itkBinaryFillholeImageFilter.h>
-#include <itkConnectedThresholdImageFilter.h>
+#include <itkImageRegionIteratorWithIndex.h>
 
 mitk::SetRegionTool::SetRegionTool(int paintingPixelValue)
   : FeedbackContourTool("PressMoveRelease"), m_PaintingPixelValue(paintingPixelValue)
@@ -81,8 +81,8 @@ void mitk::SetRegionTool::OnMousePressed(StateMachineAction *, InteractionEvent
 
   typedef itk::Image<DefaultSegmentationDataType, 2> InputImageType;
   typedef InputImageType::IndexType IndexType;
-  typedef itk::ConnectedThresholdImageFilter<InputImageType, InputImageType> RegionGrowingFilterType;
-  RegionGrowingFilterType::Pointer regionGrower = RegionGrowingFilterType::New();
+  typedef InputImageType::RegionType RegionType;
+  typedef ScanlineFloodFill<2> FloodFillType;
 
   // convert world coordinates to image indices
   IndexType seedIndex;
@@ -91,23 +91,40 @@ void mitk::SetRegionTool::OnMousePressed(StateMachineAction *, InteractionEvent
   // perform region growing in desired segmented region
   InputImageType::Pointer itkImage = InputImageType::New();
   CastToItkImage(workingSlice, itkImage);
-  regionGrower->SetInput(itkImage);
-  regionGrower->AddSeed(seedIndex);
 
-  InputImageType::PixelType bound = itkImage->GetPixel(seedIndex);
+  const RegionType region = itkImage->GetBufferedRegion();
+  const InputImageType::PixelType *buffer = itkImage->GetBufferPointer();
+  const InputImageType::PixelType bound = itkImage->GetPixel(seedIndex);
 
-  regionGrower->SetLower(bound);
-  regionGrower->SetUpper(bound);
-  regionGrower->SetReplaceValue(1);
+  FloodFillType regionGrower(region);
+  regionGrower.Fill(seedIndex, [buffer, bound](std::size_t offset) { return buffer[offset] == bound; });
 
-  itk::BinaryFillholeImageFilter<InputImageType>::Pointer fillHolesFilter =
-    itk::BinaryFillholeImageFilter<InputImageType>::New();
+  // Fill the holes: everything in the bounding box that the background around it does not reach. All pixels outside
+  // of the bounding box are connected to the border of the slice, so a margin of one pixel is enough.
+  RegionType holesRegion = regionGrower.GetBoundingBox();
+  holesRegion.PadByRadius(1);
+  holesRegion.Crop(region);
 
-  fillHolesFilter->SetInput(regionGrower->GetOutput());
-  fillHolesFilter->SetForegroundValue(1);
+  FloodFillType background(holesRegion);
+  background.FillFromBorder([&regionGrower, &background](std::size_t offset) {
+    return !regionGrower.IsFilled(background.ComputeIndex(offset));
+  });
+
+  InputImageType::Pointer itkResultImage = InputImageType::New();
+  itkResultImage->SetRegions(region);
+  itkResultImage->CopyInformation(itkImage);
+  itkResultImage->Allocate();
+  itkResultImage->FillBuffer(0);
+
+  itk::ImageRegionIteratorWithIndex<InputImageType> resultIterator(itkResultImage, holesRegion);
+  for (resultIterator.GoToBegin(); !resultIterator.IsAtEnd(); ++resultIterator)
+  {
+    if (!background.IsFilled(resultIterator.GetIndex()))
+      resultIterator.Set(1);
+  }
 
   // Store result and preview
-  mitk::Image::Pointer resultImage = mitk::GrabItkImageMemory(fillHolesFilter->GetOutput());
+  mitk::Image::Pointer resultImage = mitk::GrabItkImageMemory(itkResultImage);
   resultImage->SetGeometry(workingSlice->GetGeometry());
   // Get the current working color
   DataNode *workingNode(m_ToolManager->GetWorkingData(0));
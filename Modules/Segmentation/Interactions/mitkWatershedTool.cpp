@@ -49,7 +49,8 @@ namespace mitk
   MITK_TOOL_MACRO(MITKSEGMENTATION_EXPORT, WatershedTool, "Watershed tool");
 }
 
-mitk::WatershedTool::WatershedTool() : m_Threshold(0.0), m_Level(0.0)
+mitk::WatershedTool::WatershedTool()
+  : m_Threshold(0.0), m_Level(0.0), m_CachedReferenceImageMTime(0), m_CachedTimeStep(0)
 {
 }
 
@@ -64,6 +65,10 @@ void mitk::WatershedTool::Activated()
 
 void mitk::WatershedTool::Deactivated()
 {
+  m_CachedReferenceImage = nullptr;
+  m_MagnitudeImage = nullptr;
+  m_WatershedFilter = nullptr;
+
   Superclass::Deactivated();
 }
 
@@ -93,6 +98,18 @@ void mitk::WatershedTool::DoIt()
     return;
 
   unsigned int timestep = mitk::RenderingManager::GetInstance()->GetTimeNavigationController()->GetTime()->GetPos();
+
+  // the cached images are only valid for the same reference image and time step
+  if (m_CachedReferenceImage.GetPointer() != input.GetPointer() || m_CachedReferenceImageMTime != input->GetMTime() ||
+      m_CachedTimeStep != timestep)
+  {
+    m_CachedReferenceImage = input.GetPointer();
+    m_CachedReferenceImageMTime = input->GetMTime();
+    m_CachedTimeStep = timestep;
+    m_MagnitudeImage = nullptr;
+    m_WatershedFilter = nullptr;
+  }
+
   input = Get3DImage(input, timestep);
 
   mitk::Image::Pointer output;
@@ -145,27 +162,44 @@ template <typename TPixel, unsigned int VImageDimension>
 void mitk::WatershedTool::ITKWatershed(itk::Image<TPixel, VImageDimension> *originalImage,
                                        mitk::Image::Pointer &segmentation)
 {
-  typedef itk::WatershedImageFilter<itk::Image<float, VImageDimension>> WatershedFilter;
-  typedef itk::GradientMagnitudeRecursiveGaussianImageFilter<itk::Image<TPixel, VImageDimension>,
-                                                             itk::Image<float, VImageDimension>>
+  typedef itk::Image<float, VImageDimension> MagnitudeImageType;
+  typedef itk::WatershedImageFilter<MagnitudeImageType> WatershedFilter;
+  typedef itk::GradientMagnitudeRecursiveGaussianImageFilter<itk::Image<TPixel, VImageDimension>, MagnitudeImageType>
     MagnitudeFilter;
 
-  // at first add a gradient magnitude filter
-  typename MagnitudeFilter::Pointer magnitude = MagnitudeFilter::New();
-  magnitude->SetInput(originalImage);
-  magnitude->SetSigma(1.0);
+  // at first compute the gradient magnitude, unless it is cached
+  typename MagnitudeImageType::Pointer magnitudeImage =
+    dynamic_cast<MagnitudeImageType *>(m_MagnitudeImage.GetPointer());
+  if (magnitudeImage.IsNull())
+  {
+    typename MagnitudeFilter::Pointer magnitude = MagnitudeFilter::New();
+    magnitude->SetInput(originalImage);
+    magnitude->SetSigma(1.0);
+    magnitude->Update();
+
+    magnitudeImage = magnitude->GetOutput();
+    magnitudeImage->DisconnectPipeline();
+    m_MagnitudeImage = magnitudeImage;
+    m_WatershedFilter = nullptr;
+  }
 
   // use the progress bar
   mitk::ToolCommand::Pointer command = mitk::ToolCommand::New();
   command->AddStepsToDo(60);
 
-  // then add the watershed filter to the pipeline
-  typename WatershedFilter::Pointer watershed = WatershedFilter::New();
-  watershed->SetInput(magnitude->GetOutput());
+  // then run the watershed filter, it only repeats the stages affected by a changed threshold or level
+  typename WatershedFilter::Pointer watershed = dynamic_cast<WatershedFilter *>(m_WatershedFilter.GetPointer());
+  if (watershed.IsNull())
+  {
+    watershed = WatershedFilter::New();
+    watershed->SetInput(magnitudeImage);
+    m_WatershedFilter = watershed;
+  }
   watershed->SetThreshold(m_Threshold);
   watershed->SetLevel(m_Level);
-  watershed->AddObserver(itk::ProgressEvent(), command);
+  unsigned long observerTag = watershed->AddObserver(itk::ProgressEvent(), command);
   watershed->Update();
+  watershed->RemoveObserver(observerTag);
 
   // then make sure, that the output has the desired pixel type
   typedef itk::CastImageFilter<typename WatershedFilter::OutputImageType,
@@ -39,6 +39,10 @@ namespace mitk
 
     Wraps ITK Watershed Filter into tool concept of MITK. For more information look into ITK documentation.
 
+    The gradient magnitude image and the watershed filter are kept as long as the reference image and
+    the time step do not change, so trying another threshold or level does not compute the gradient
+    again and a new level only merges the existing basins.
+
     \warning Only to be instantiated by mitk::ToolManager.
 
     $Darth Vader$
@@ -84,6 +88,15 @@ namespace mitk
     double m_Threshold;
     /** \brief Threshold parameter of the ITK Watershed Image Filter. See ITK Documentation for more information. */
     double m_Level;
+
+    /** \brief Reference image and time step the cached images belong to. */
+    itk::SmartPointer<const Image> m_CachedReferenceImage;
+    unsigned long m_CachedReferenceImageMTime;
+    unsigned int m_CachedTimeStep;
+
+    /** \brief Gradient magnitude of the reference image and the watershed filter of the last run. */
+    itk::DataObject::Pointer m_MagnitudeImage;
+    itk::ProcessObject::Pointer m_WatershedFilter;
   };
 
 } // namespace
@@ -134,6 +134,10 @@ int mitkOverwriteSliceFilterTest(int, char *[])
 stop:
   MITK_TEST_CONDITION(areSame, "test overwrite unmodified slice");
 
+  int unchangedExtent[6];
+  resliceIdx->GetOverwrittenExtent(unchangedExtent);
+  MITK_TEST_CONDITION(unchangedExtent[1] < unchangedExtent[0], "test empty overwritten extent of unmodified slice");
+
   /* ============= edit slice ============*/
   int idX = std::abs(VolumeSize - 59);
   int idY = std::abs(VolumeSize - 23);
@@ -155,6 +159,13 @@ stop:
   slicer2->Modified();
   slicer2->Update();
 
+  int overwrittenExtent[6];
+  resliceIdx2->GetOverwrittenExtent(overwrittenExtent);
+  MITK_TEST_CONDITION(overwrittenExtent[0] == idX && overwrittenExtent[1] == idX && overwrittenExtent[2] == idY &&
+                        overwrittenExtent[3] == idY && overwrittenExtent[4] == sliceindex &&
+                        overwrittenExtent[5] == sliceindex,
+                      "test overwritten extent");
+
   /* ============= check ============*/
   areSame = true;
 
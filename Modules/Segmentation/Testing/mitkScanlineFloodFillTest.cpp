@@ -0,0 +1,160 @@
+/*===================================================================
+
+The Medical Imaging Interaction Toolkit (MITK)
+
+Copyright (c) German Cancer Research Center,
+Division of Medical and Biological Informatics.
+All rights reserved.
+
+This software is distributed WITHOUT ANY WARRANTY; without
+even the implied warranty of MERCHANTABILITY or FITNESS FOR
+A PARTICULAR PURPOSE.
+
+See LICENSE.txt or http://www.mitk.org for details.
+
+===================================================================*/
+
+#include <mitkScanlineFloodFill.h>
+#include <mitkTestFixture.h>
+#include <mitkTestingMacros.h>
+
+#include <itkImage.h>
+
+#include <functional>
+
+class mitkScanlineFloodFillTestSuite : public mitk::TestFixture
+{
+  CPPUNIT_TEST_SUITE(mitkScanlineFloodFillTestSuite);
+  MITK_TEST(TestFill2D);
+  MITK_TEST(TestFill3D);
+  MITK_TEST(TestFillFromBorder);
+  MITK_TEST(TestWrite);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  typedef itk::Image<unsigned char, 2> ImageType2D;
+  typedef itk::Image<unsigned char, 3> ImageType3D;
+
+  template <typename TImage>
+  static typename TImage::Pointer CreateImage(unsigned int size)
+  {
+    typename TImage::SizeType imageSize;
+    imageSize.Fill(size);
+
+    typename TImage::Pointer image = TImage::New();
+    image->SetRegions(imageSize);
+    image->Allocate();
+    image->FillBuffer(0);
+    return image;
+  }
+
+  template <typename TImage>
+  static std::function<bool(std::size_t)> IsValue(TImage *image, unsigned char value)
+  {
+    const unsigned char *buffer = image->GetBufferPointer();
+    return [buffer, value](std::size_t offset) { return buffer[offset] == value; };
+  }
+
+public:
+  void TestFill2D()
+  {
+    // a U-shaped region, the fill has to go down one arm and up the other
+    ImageType2D::Pointer image = CreateImage<ImageType2D>(10);
+    for (int i = 2; i <= 7; ++i)
+    {
+      image->SetPixel({{2, i}}, 1);
+      image->SetPixel({{6, i}}, 1);
+    }
+    for (int i = 2; i <= 6; ++i)
+      image->SetPixel({{i, 7}}, 1);
+
+    // an unconnected pixel
+    image->SetPixel({{9, 0}}, 1);
+
+    mitk::ScanlineFloodFill<2> fill(image->GetBufferedRegion());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(15), fill.Fill({{2, 2}}, IsValue(image.GetPointer(), 1)));
+
+    CPPUNIT_ASSERT_MESSAGE("Other arm not filled", fill.IsFilled({{6, 2}}));
+    CPPUNIT_ASSERT_MESSAGE("Unconnected pixel filled", !fill.IsFilled({{9, 0}}));
+    CPPUNIT_ASSERT_MESSAGE("Inside of the U filled", !fill.IsFilled({{4, 4}}));
+
+    const ImageType2D::RegionType boundingBox = fill.GetBoundingBox();
+    CPPUNIT_ASSERT_EQUAL(ImageType2D::IndexType({{2, 2}}), boundingBox.GetIndex());
+    CPPUNIT_ASSERT_EQUAL(ImageType2D::SizeType({{5, 6}}), boundingBox.GetSize());
+
+    // filled pixels are not filled again
+    CPPUNIT_ASSERT_EQUAL(std::size_t(0), fill.Fill({{6, 2}}, IsValue(image.GetPointer(), 1)));
+  }
+
+  void TestFill3D()
+  {
+    // two squares in different slices that are connected by a chain of voxels
+    ImageType3D::Pointer image = CreateImage<ImageType3D>(8);
+    for (int y = 1; y <= 3; ++y)
+    {
+      for (int x = 1; x <= 3; ++x)
+      {
+        image->SetPixel({{x, y, 2}}, 1);
+        image->SetPixel({{x + 3, y + 3, 4}}, 1);
+      }
+    }
+    image->SetPixel({{3, 3, 3}}, 1);
+    image->SetPixel({{4, 4, 3}}, 1);
+    image->SetPixel({{3, 4, 3}}, 1);
+
+    mitk::ScanlineFloodFill<3> fill(image->GetBufferedRegion());
+    CPPUNIT_ASSERT_EQUAL(std::size_t(21), fill.Fill({{1, 1, 2}}, IsValue(image.GetPointer(), 1)));
+    CPPUNIT_ASSERT_MESSAGE("Upper slice not filled", fill.IsFilled({{6, 6, 4}}));
+
+    // restricted to a single slice the fill stays within it
+    ImageType3D::RegionType slice = image->GetBufferedRegion();
+    slice.SetIndex(2, 2);
+    slice.SetSize(2, 1);
+
+    mitk::ScanlineFloodFill<3> sliceFill(slice);
+    CPPUNIT_ASSERT_EQUAL(std::size_t(9), sliceFill.Fill({{1, 1, 2}}, [&](std::size_t offset) {
+      return 1 == image->GetPixel(sliceFill.ComputeIndex(offset));
+    }));
+  }
+
+  void TestFillFromBorder()
+  {
+    // a ring with a hole in the middle
+    ImageType2D::Pointer image = CreateImage<ImageType2D>(7);
+    for (int y = 1; y <= 5; ++y)
+    {
+      for (int x = 1; x <= 5; ++x)
+      {
+        if (x == 1 || x == 5 || y == 1 || y == 5)
+          image->SetPixel({{x, y}}, 1);
+      }
+    }
+
+    mitk::ScanlineFloodFill<2> background(image->GetBufferedRegion());
+    background.FillFromBorder(IsValue(image.GetPointer(), 0));
+
+    CPPUNIT_ASSERT_EQUAL(std::size_t(49 - 25), background.GetNumberOfFilledPixels());
+    CPPUNIT_ASSERT_MESSAGE("Hole reached from the border", !background.IsFilled({{3, 3}}));
+  }
+
+  void TestWrite()
+  {
+    ImageType2D::Pointer image = CreateImage<ImageType2D>(6);
+    for (int x = 0; x < 6; ++x)
+      image->SetPixel({{x, 3}}, 1);
+
+    mitk::ScanlineFloodFill<2> fill(image->GetBufferedRegion());
+    fill.Fill({{0, 3}}, IsValue(image.GetPointer(), 1));
+
+    ImageType2D::Pointer result = CreateImage<ImageType2D>(6);
+    fill.Write(result.GetPointer(), 5);
+
+    for (int y = 0; y < 6; ++y)
+    {
+      for (int x = 0; x < 6; ++x)
+        CPPUNIT_ASSERT_EQUAL(static_cast<unsigned char>(y == 3 ? 5 : 0), result->GetPixel({{x, y}}));
+    }
+  }
+};
+
+MITK_TEST_SUITE_REGISTRATION(mitkScanlineFloodFill)
@@ -35,6 +35,7 @@ class mitkSegmentationInterpolationTestSuite : public mitk::TestFixture
   MITK_TEST(Equal_Axial_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
   MITK_TEST(Equal_Frontal_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
   MITK_TEST(Equal_Sagittal_TestInterpolationAndReferenceInterpolation_ReturnsTrue);
+  MITK_TEST(ChangedRegionAndSlice_TestIncrementalUpdate_InterpolatesAccordingly);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -148,6 +149,17 @@ private:
     }
   }
 
+  const mitk::PlaneGeometry *GetAxialPlane(const itk::Index<3> &index,
+                                           mitk::SliceNavigationController *navigationController)
+  {
+    navigationController->SetInputWorldTimeGeometry(m_SegmentationImage->GetTimeGeometry());
+    navigationController->Update(mitk::SliceNavigationController::Axial);
+    mitk::Point3D pointMM;
+    m_SegmentationImage->GetTimeGeometry()->GetGeometryForTimeStep(0)->IndexToWorld(index, pointMM);
+    navigationController->SelectSliceByPoint(pointMM);
+    return navigationController->GetCurrentPlaneGeometry();
+  }
+
   mitk::Image::Pointer m_ReferenceImage;
   mitk::Image::Pointer m_SegmentationImage;
   itk::Index<3> m_CenterPoint;
@@ -203,6 +215,80 @@ public:
     mitk::SliceNavigationController::ViewDirection viewDirection = mitk::SliceNavigationController::Sagittal;
     testRoutine(viewDirection);
   }
+
+  void ChangedRegionAndSlice_TestIncrementalUpdate_InterpolatesAccordingly()
+  {
+    m_InterpolationController->SetSegmentationVolume(m_SegmentationImage);
+
+    mitk::SliceNavigationController::Pointer navigationController = mitk::SliceNavigationController::New();
+    auto centerPlane = GetAxialPlane(m_CenterPoint, navigationController);
+    CPPUNIT_ASSERT_MESSAGE("Interpolated empty segmentation.",
+                           m_InterpolationController->Interpolate(2, m_CenterPoint[2], centerPlane, 0).IsNull());
+
+    // segment the slices below and above the center in a 3D region
+    itk::ImageRegion<3> region;
+    region.SetIndex(0, m_CenterPoint[0] - 1);
+    region.SetIndex(1, m_CenterPoint[1] - 1);
+    region.SetIndex(2, m_CenterPoint[2] - 1);
+    region.SetSize(0, 3);
+    region.SetSize(1, 3);
+    region.SetSize(2, 3);
+
+    m_InterpolationController->BeginChangedRegion(region, 0);
+    {
+      mitk::ImagePixelWriteAccessor<mitk::Tool::DefaultSegmentationDataType, 3> writeAccessor(m_SegmentationImage);
+      itk::Index<3> currentPoint;
+      for (int z = -1; z <= 1; z += 2)
+      {
+        for (int y = -1; y <= 1; ++y)
+        {
+          for (int x = -1; x <= 1; ++x)
+          {
+            currentPoint[0] = m_CenterPoint[0] + x;
+            currentPoint[1] = m_CenterPoint[1] + y;
+            currentPoint[2] = m_CenterPoint[2] + z;
+            writeAccessor.SetPixelByIndexSafe(currentPoint, 1);
+          }
+        }
+      }
+    }
+    m_SegmentationImage->Modified();
+    m_InterpolationController->EndChangedRegion();
+
+    centerPlane = GetAxialPlane(m_CenterPoint, navigationController);
+    CPPUNIT_ASSERT_MESSAGE("No interpolation after changing a region.",
+                           m_InterpolationController->Interpolate(2, m_CenterPoint[2], centerPlane, 0).IsNotNull());
+
+    // clear the slice below the center
+    itk::Index<3> lowerPoint = m_CenterPoint;
+    lowerPoint[2] -= 1;
+    auto lowerPlane = GetAxialPlane(lowerPoint, navigationController);
+
+    mitk::ExtractSliceFilter::Pointer extractor = mitk::ExtractSliceFilter::New();
+    extractor->SetInput(m_SegmentationImage);
+    extractor->SetTimeStep(0);
+    extractor->SetWorldGeometry(lowerPlane);
+    extractor->SetResliceTransformByGeometry(m_SegmentationImage->GetTimeGeometry()->GetGeometryForTimeStep(0));
+    extractor->Update();
+    mitk::Image::Pointer originalSlice = extractor->GetOutput();
+    originalSlice->DisconnectPipeline();
+
+    mitk::Image::Pointer modifiedSlice = originalSlice->Clone();
+    {
+      mitk::ImageWriteAccessor sliceAccessor(modifiedSlice);
+      memset(sliceAccessor.GetData(),
+             0,
+             modifiedSlice->GetDimension(0) * modifiedSlice->GetDimension(1) *
+               sizeof(mitk::Tool::DefaultSegmentationDataType));
+    }
+
+    CPPUNIT_ASSERT_MESSAGE("Axis-aligned slice was not accepted.",
+                           m_InterpolationController->SetChangedSlice(originalSlice, modifiedSlice, 0));
+
+    centerPlane = GetAxialPlane(m_CenterPoint, navigationController);
+    CPPUNIT_ASSERT_MESSAGE("Interpolated without segmentation below.",
+                           m_InterpolationController->Interpolate(2, m_CenterPoint[2], centerPlane, 0).IsNull());
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkSegmentationInterpolation)
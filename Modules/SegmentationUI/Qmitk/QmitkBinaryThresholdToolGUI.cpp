@@ -33,7 +33,8 @@ QmitkBinaryThresholdToolGUI::QmitkBinaryThresholdToolGUI()
     m_RangeMin(0),
     m_RangeMax(0),
     m_ChangingSlider(false),
-    m_ChangingSpinner(false)
+    m_ChangingSpinner(false),
+    m_RestartVolumePreview(false)
 {
   // create the visible widgets
   QBoxLayout *mainLayout = new QVBoxLayout(this);
@@ -71,10 +72,17 @@ QmitkBinaryThresholdToolGUI::QmitkBinaryThresholdToolGUI()
   mainLayout->addWidget(okButton);
 
   connect(this, SIGNAL(NewToolAssociated(mitk::Tool *)), this, SLOT(OnNewToolAssociated(mitk::Tool *)));
+
+  m_RestTimer.setSingleShot(true);
+  m_RestTimer.setInterval(300);
+  connect(&m_RestTimer, SIGNAL(timeout()), this, SLOT(OnThresholdResting()));
+  connect(&m_Watcher, SIGNAL(finished()), this, SLOT(OnVolumePreviewFinished()));
 }
 
 QmitkBinaryThresholdToolGUI::~QmitkBinaryThresholdToolGUI()
 {
+  this->WaitForVolumePreview();
+
   // !!!
   if (m_BinaryThresholdTool.IsNotNull())
   {
@@ -88,6 +96,8 @@ QmitkBinaryThresholdToolGUI::~QmitkBinaryThresholdToolGUI()
 
 void QmitkBinaryThresholdToolGUI::OnNewToolAssociated(mitk::Tool *tool)
 {
+  this->WaitForVolumePreview();
+
   if (m_BinaryThresholdTool.IsNotNull())
   {
     m_BinaryThresholdTool->IntervalBordersChanged -=
@@ -117,6 +127,7 @@ void QmitkBinaryThresholdToolGUI::OnSpinnerValueChanged()
     double doubleVal = m_Spinner->value();
     int intVal = this->DoubleToSliderInt(doubleVal);
     m_BinaryThresholdTool->SetThresholdValue(doubleVal);
+    m_RestTimer.start();
     if (m_ChangingSlider == false)
       m_Slider->setValue(intVal);
     m_ChangingSpinner = false;
@@ -157,11 +168,55 @@ void QmitkBinaryThresholdToolGUI::OnAcceptThresholdPreview()
 
   if (m_BinaryThresholdTool.IsNotNull())
   {
+    // a finished update spares the tool thresholding the whole image again
+    this->WaitForVolumePreview();
+    m_BinaryThresholdTool->ShowVolumePreview();
+
     this->thresholdAccepted();
     m_BinaryThresholdTool->AcceptCurrentThresholdValue();
   }
 }
 
+void QmitkBinaryThresholdToolGUI::OnThresholdResting()
+{
+  if (m_BinaryThresholdTool.IsNull() || m_BinaryThresholdTool->IsVolumePreviewUpToDate())
+    return;
+
+  // the running update is outdated, OnVolumePreviewFinished() starts again for the current threshold
+  if (m_Watcher.isRunning())
+  {
+    m_RestartVolumePreview = true;
+    return;
+  }
+
+  mitk::BinaryThresholdTool::Pointer tool = m_BinaryThresholdTool;
+  m_Future = RunInBackground([tool]() { tool->UpdateVolumePreview(); });
+  m_Watcher.setFuture(m_Future);
+}
+
+void QmitkBinaryThresholdToolGUI::OnVolumePreviewFinished()
+{
+  if (m_BinaryThresholdTool.IsNull())
+    return;
+
+  m_BinaryThresholdTool->ShowVolumePreview();
+
+  if (m_RestartVolumePreview)
+  {
+    m_RestartVolumePreview = false;
+    this->OnThresholdResting();
+  }
+}
+
+void QmitkBinaryThresholdToolGUI::WaitForVolumePreview()
+{
+  m_RestTimer.stop();
+  m_RestartVolumePreview = false;
+
+  if (m_Watcher.isRunning())
+    m_Watcher.waitForFinished();
+}
+
 void QmitkBinaryThresholdToolGUI::OnThresholdingIntervalBordersChanged(double lower, double upper, bool isFloat)
 {
   m_isFloat = isFloat;
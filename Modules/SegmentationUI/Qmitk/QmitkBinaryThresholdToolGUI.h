@@ -22,6 +22,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <MitkSegmentationUIExports.h>
 
 #include <QDoubleSpinBox>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QTimer>
 
 class QSlider;
 /**
@@ -35,6 +38,9 @@ class QSlider;
 
   If the pixeltype is INT, then we do not need any conversion.
 
+  While the slider moves, the tool only updates the visible slices. Once it rests, the preview of the
+  whole image is computed in the background.
+
   Last contributor: $Author$
 */
 class MITKSEGMENTATIONUI_EXPORT QmitkBinaryThresholdToolGUI : public QmitkToolGUI
@@ -69,6 +75,11 @@ protected slots:
   /// \brief Called when Slider value has changed. Consider: Slider contains INT values
   void OnSliderValueChanged(int value);
 
+  /// \brief Starts the update of the whole preview once the threshold has not changed for a while.
+  void OnThresholdResting();
+
+  void OnVolumePreviewFinished();
+
 protected:
   QmitkBinaryThresholdToolGUI();
   ~QmitkBinaryThresholdToolGUI() override;
@@ -79,6 +90,9 @@ protected:
   /// \brief When Spinner (double value) has changed, we need to convert it to a respective int value for the slider
   int DoubleToSliderInt(double val);
 
+  /// \brief Waits for a running update of the whole preview.
+  void WaitForVolumePreview();
+
   QSlider *m_Slider;
   QDoubleSpinBox *m_Spinner;
 
@@ -93,6 +107,11 @@ protected:
   bool m_ChangingSlider, m_ChangingSpinner;
 
   mitk::BinaryThresholdTool::Pointer m_BinaryThresholdTool;
+
+  QTimer m_RestTimer;
+  QFuture<void> m_Future;
+  QFutureWatcher<void> m_Watcher;
+  bool m_RestartVolumePreview;
 };
 
 #endif
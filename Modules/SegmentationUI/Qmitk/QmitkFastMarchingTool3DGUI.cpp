@@ -192,6 +192,7 @@ QmitkFastMarchingTool3DGUI::QmitkFastMarchingTool3DGUI() : QmitkToolGUI(), m_Tim
   connect(m_btConfirm, SIGNAL(clicked()), this, SLOT(OnConfirmSegmentation()));
 
   connect(this, SIGNAL(NewToolAssociated(mitk::Tool *)), this, SLOT(OnNewToolAssociated(mitk::Tool *)));
+  connect(&m_Watcher, SIGNAL(finished()), this, SLOT(OnUpdateFinished()));
 
   m_slSigma->setDecimals(2);
   m_slBeta->setDecimals(2);
@@ -202,23 +203,31 @@ QmitkFastMarchingTool3DGUI::QmitkFastMarchingTool3DGUI() : QmitkToolGUI(), m_Tim
 
 QmitkFastMarchingTool3DGUI::~QmitkFastMarchingTool3DGUI()
 {
+  this->CancelUpdate();
+
   if (m_FastMarchingTool.IsNotNull())
   {
     m_FastMarchingTool->CurrentlyBusy -=
       mitk::MessageDelegate1<QmitkFastMarchingTool3DGUI, bool>(this, &QmitkFastMarchingTool3DGUI::BusyStateChanged);
     m_FastMarchingTool->RemoveReadyListener(
       mitk::MessageDelegate<QmitkFastMarchingTool3DGUI>(this, &QmitkFastMarchingTool3DGUI::OnFastMarchingToolReady));
+    m_FastMarchingTool->RemoveUpdateRequestedListener(
+      mitk::MessageDelegate<QmitkFastMarchingTool3DGUI>(this, &QmitkFastMarchingTool3DGUI::OnUpdateRequested));
   }
 }
 
 void QmitkFastMarchingTool3DGUI::OnNewToolAssociated(mitk::Tool *tool)
 {
+  this->CancelUpdate();
+
   if (m_FastMarchingTool.IsNotNull())
   {
     m_FastMarchingTool->CurrentlyBusy -=
       mitk::MessageDelegate1<QmitkFastMarchingTool3DGUI, bool>(this, &QmitkFastMarchingTool3DGUI::BusyStateChanged);
     m_FastMarchingTool->RemoveReadyListener(
       mitk::MessageDelegate<QmitkFastMarchingTool3DGUI>(this, &QmitkFastMarchingTool3DGUI::OnFastMarchingToolReady));
+    m_FastMarchingTool->RemoveUpdateRequestedListener(
+      mitk::MessageDelegate<QmitkFastMarchingTool3DGUI>(this, &QmitkFastMarchingTool3DGUI::OnUpdateRequested));
   }
 
   m_FastMarchingTool = dynamic_cast<mitk::FastMarchingTool3D *>(tool);
@@ -229,6 +238,8 @@ void QmitkFastMarchingTool3DGUI::OnNewToolAssociated(mitk::Tool *tool)
       mitk::MessageDelegate1<QmitkFastMarchingTool3DGUI, bool>(this, &QmitkFastMarchingTool3DGUI::BusyStateChanged);
     m_FastMarchingTool->AddReadyListener(
       mitk::MessageDelegate<QmitkFastMarchingTool3DGUI>(this, &QmitkFastMarchingTool3DGUI::OnFastMarchingToolReady));
+    m_FastMarchingTool->AddUpdateRequestedListener(
+      mitk::MessageDelegate<QmitkFastMarchingTool3DGUI>(this, &QmitkFastMarchingTool3DGUI::OnUpdateRequested));
 
     // listen to timestep change events
     mitk::BaseRenderer::Pointer renderer;
@@ -246,58 +257,75 @@ void QmitkFastMarchingTool3DGUI::Update()
 {
   if (m_FastMarchingTool.IsNotNull())
   {
+    // the parameters of a running update are outdated
+    this->CancelUpdate();
+
     m_FastMarchingTool->SetLowerThreshold(this->m_slwThreshold->minimumValue());
     m_FastMarchingTool->SetUpperThreshold(this->m_slwThreshold->maximumValue());
     m_FastMarchingTool->SetStoppingValue(this->m_slStoppingValue->value());
     m_FastMarchingTool->SetSigma(this->m_slSigma->value());
     m_FastMarchingTool->SetAlpha(this->m_slAlpha->value());
     m_FastMarchingTool->SetBeta(this->m_slBeta->value());
-    m_FastMarchingTool->Update();
+
+    mitk::FastMarchingTool3D::Pointer tool = m_FastMarchingTool;
+    m_Future = RunInBackground([tool]() { tool->UpdatePreview(); });
+    m_Watcher.setFuture(m_Future);
+  }
+}
+
+void QmitkFastMarchingTool3DGUI::CancelUpdate()
+{
+  if (m_Watcher.isRunning())
+  {
+    if (m_FastMarchingTool.IsNotNull())
+      m_FastMarchingTool->CancelUpdate();
+    m_Watcher.waitForFinished();
   }
 }
 
-void QmitkFastMarchingTool3DGUI::OnThresholdChanged(double lower, double upper)
+void QmitkFastMarchingTool3DGUI::OnUpdateFinished()
+{
+  if (m_FastMarchingTool.IsNotNull())
+    m_FastMarchingTool->ShowPreview();
+}
+
+void QmitkFastMarchingTool3DGUI::OnThresholdChanged(double, double)
 {
   if (m_FastMarchingTool.IsNotNull())
   {
-    m_FastMarchingTool->SetLowerThreshold(lower);
-    m_FastMarchingTool->SetUpperThreshold(upper);
+    // Update() cancels a running update before passing all parameters to the tool
     this->Update();
   }
 }
 
-void QmitkFastMarchingTool3DGUI::OnBetaChanged(double value)
+void QmitkFastMarchingTool3DGUI::OnBetaChanged(double)
 {
   if (m_FastMarchingTool.IsNotNull())
   {
-    m_FastMarchingTool->SetBeta(value);
     this->Update();
   }
 }
 
-void QmitkFastMarchingTool3DGUI::OnSigmaChanged(double value)
+void QmitkFastMarchingTool3DGUI::OnSigmaChanged(double)
 {
   if (m_FastMarchingTool.IsNotNull())
   {
-    m_FastMarchingTool->SetSigma(value);
     this->Update();
   }
 }
 
-void QmitkFastMarchingTool3DGUI::OnAlphaChanged(double value)
+void QmitkFastMarchingTool3DGUI::OnAlphaChanged(double)
 {
   if (m_FastMarchingTool.IsNotNull())
   {
-    m_FastMarchingTool->SetAlpha(value);
     this->Update();
   }
 }
 
-void QmitkFastMarchingTool3DGUI::OnStoppingValueChanged(double value)
+void QmitkFastMarchingTool3DGUI::OnStoppingValueChanged(double)
 {
   if (m_FastMarchingTool.IsNotNull())
   {
-    m_FastMarchingTool->SetStoppingValue(value);
     this->Update();
   }
 }
@@ -324,6 +352,7 @@ void QmitkFastMarchingTool3DGUI::OnConfirmSegmentation()
   if (m_FastMarchingTool.IsNotNull())
   {
     m_btConfirm->setEnabled(false);
+    this->CancelUpdate();
     m_FastMarchingTool->ConfirmSegmentation();
   }
 }
@@ -364,6 +393,12 @@ void QmitkFastMarchingTool3DGUI::OnFastMarchingToolReady()
   this->m_btConfirm->setEnabled(true);
 }
 
+void QmitkFastMarchingTool3DGUI::OnUpdateRequested()
+{
+  // the seeds changed, the fast marching runs in the background like for changed parameters
+  this->Update();
+}
+
 void QmitkFastMarchingTool3DGUI::EnableWidgets(bool enable)
 {
   m_slSigma->setEnabled(enable);
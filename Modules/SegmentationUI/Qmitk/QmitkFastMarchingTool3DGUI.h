@@ -27,6 +27,9 @@ class QPushButton;
 
 #include "QmitkStepperAdapter.h"
 
+#include <QFuture>
+#include <QFutureWatcher>
+
 /**
 \ingroup org_mitk_gui_qt_interactivesegmentation_internal
 \brief GUI for mitk::FastMarchingTool.
@@ -55,6 +58,7 @@ protected slots:
   void Refetch();
   void SetStepper(mitk::Stepper *);
   void OnClearSeeds();
+  void OnUpdateFinished();
 
 protected:
   QmitkFastMarchingTool3DGUI();
@@ -64,6 +68,9 @@ protected:
 
   void Update();
 
+  /// \brief Cancels a running update of the tool and waits for it.
+  void CancelUpdate();
+
   ctkRangeWidget *m_slwThreshold;
   ctkSliderWidget *m_slStoppingValue;
   ctkSliderWidget *m_slSigma;
@@ -78,7 +85,12 @@ protected:
   bool m_TimeIsConnected;
   mitk::Stepper::Pointer m_TimeStepper;
 
+  // the tool is updated in the background, so the sliders stay responsive
+  QFuture<void> m_Future;
+  QFutureWatcher<void> m_Watcher;
+
   void OnFastMarchingToolReady();
+  void OnUpdateRequested();
 
 private:
   void EnableWidgets(bool);
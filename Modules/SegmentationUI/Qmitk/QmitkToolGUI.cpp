@@ -16,6 +16,8 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "QmitkToolGUI.h"
 
+#include <QtConcurrentRun>
+
 #include <iostream>
 
 QmitkToolGUI::~QmitkToolGUI()
@@ -44,3 +46,17 @@ void QmitkToolGUI::SetTool(mitk::Tool *tool)
 
   emit(NewToolAssociated(tool));
 }
+
+QFuture<void> QmitkToolGUI::RunInBackground(const std::function<void()> &computation)
+{
+  return QtConcurrent::run([computation]() {
+    try
+    {
+      computation();
+    }
+    catch (const itk::ExceptionObject &e)
+    {
+      MITK_ERROR << "Exception caught: " << e.GetDescription();
+    }
+  });
+}
@@ -18,8 +18,11 @@ See LICENSE.txt or http://www.mitk.org for details.
 #define QmitkToolGUI_h_Included
 
 #include <MitkSegmentationUIExports.h>
+#include <QFuture>
 #include <qwidget.h>
 
+#include <functional>
+
 #include "mitkCommon.h"
 #include "mitkTool.h"
 
@@ -61,6 +64,10 @@ protected:
   mitk::Tool::Pointer m_Tool;
 
   virtual void BusyStateChanged(bool){};
+
+  /// \brief Runs a computation of the tool in a background thread.
+  /// itk exceptions cannot be passed on to the GUI thread and are logged instead.
+  static QFuture<void> RunInBackground(const std::function<void()> &computation);
 };
 
 #endif
@@ -18,6 +18,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkCreateDistanceImageFromSurfaceFilter.h>
 #include <mitkIOUtil.h>
 #include <mitkImageAccessByItk.h>
+#include <mitkImagePixelReadAccessor.h>
 #include <mitkTestFixture.h>
 #include <mitkTestingMacros.h>
 
@@ -29,6 +30,7 @@ class mitkCreateDistanceImageFromSurfaceFilterTestSuite : public mitk::TestFixtu
   vtkDebugLeaks::SetExitError(0);
   MITK_TEST(TestCreateDistanceImageForLiver);
   MITK_TEST(TestCreateDistanceImageForTube);
+  MITK_TEST(TestCompactSupportSolverForLiver);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -131,6 +133,82 @@ public:
     CPPUNIT_ASSERT_MESSAGE("HolesDistanceImages are not equal!",
                            mitk::Equal(*(holesDistanceImageReference), *(holeDistanceImage), 0.0001, true));
   }
+
+  mitk::Image::Pointer InterpolateLiver(mitk::CreateDistanceImageFromSurfaceFilter::SolverMode solverMode)
+  {
+    unsigned int NUMBER_OF_LIVER_CONTOURS = 18;
+
+    std::vector<mitk::Surface::Pointer> liverContours;
+    for (unsigned int i = 0; i <= NUMBER_OF_LIVER_CONTOURS; ++i)
+    {
+      std::stringstream s;
+      s << "SurfaceInterpolation/InterpolateLiver/LiverContourWithNormals_";
+      s << i;
+      s << ".vtk";
+      liverContours.push_back(mitk::IOUtil::Load<mitk::Surface>(GetTestDataFilePath(s.str())));
+    }
+
+    mitk::Image::Pointer segmentationImage =
+      mitk::IOUtil::Load<mitk::Image>(GetTestDataFilePath("SurfaceInterpolation/Reference/LiverSegmentation.nrrd"));
+
+    mitk::ComputeContourSetNormalsFilter::Pointer normalsFilter = mitk::ComputeContourSetNormalsFilter::New();
+    mitk::CreateDistanceImageFromSurfaceFilter::Pointer interpolateSurfaceFilter =
+      mitk::CreateDistanceImageFromSurfaceFilter::New();
+    interpolateSurfaceFilter->SetSolverMode(solverMode);
+
+    itk::ImageBase<3>::Pointer itkImage = itk::ImageBase<3>::New();
+    AccessFixedDimensionByItk_1(segmentationImage, GetImageBase, 3, itkImage);
+    interpolateSurfaceFilter->SetReferenceImage(itkImage.GetPointer());
+
+    for (unsigned int j = 0; j < liverContours.size(); j++)
+    {
+      normalsFilter->SetInput(j, liverContours.at(j));
+      interpolateSurfaceFilter->SetInput(j, normalsFilter->GetOutput(j));
+    }
+
+    interpolateSurfaceFilter->Update();
+
+    return interpolateSurfaceFilter->GetOutput();
+  }
+
+  // The compactly supported solver must result in (almost) the same inside/outside classification as the dense one
+  void TestCompactSupportSolverForLiver()
+  {
+    mitk::Image::Pointer denseDistanceImage = InterpolateLiver(mitk::CreateDistanceImageFromSurfaceFilter::DenseSolver);
+    mitk::Image::Pointer compactDistanceImage =
+      InterpolateLiver(mitk::CreateDistanceImageFromSurfaceFilter::CompactSupportSolver);
+
+    CPPUNIT_ASSERT(compactDistanceImage.IsNotNull());
+    CPPUNIT_ASSERT_MESSAGE("Distance images differ in geometry!",
+                           mitk::Equal(*(denseDistanceImage->GetGeometry()),
+                                       *(compactDistanceImage->GetGeometry()),
+                                       mitk::eps,
+                                       true));
+
+    mitk::ImagePixelReadAccessor<double, 3> denseAccessor(denseDistanceImage);
+    mitk::ImagePixelReadAccessor<double, 3> compactAccessor(compactDistanceImage);
+
+    const std::size_t numberOfVoxels = static_cast<std::size_t>(denseDistanceImage->GetDimension(0)) *
+                                       denseDistanceImage->GetDimension(1) * denseDistanceImage->GetDimension(2);
+    std::size_t numberOfInsideVoxels = 0;
+    std::size_t numberOfDifferentVoxels = 0;
+
+    for (std::size_t i = 0; i < numberOfVoxels; ++i)
+    {
+      const bool isInsideDense = denseAccessor.GetData()[i] < 0;
+      const bool isInsideCompact = compactAccessor.GetData()[i] < 0;
+
+      if (isInsideDense)
+        ++numberOfInsideVoxels;
+
+      if (isInsideDense != isInsideCompact)
+        ++numberOfDifferentVoxels;
+    }
+
+    CPPUNIT_ASSERT(numberOfInsideVoxels > 0);
+    CPPUNIT_ASSERT_MESSAGE("Compactly supported solver differs from dense solver!",
+                           numberOfDifferentVoxels < numberOfInsideVoxels / 20);
+  }
 };
 
 MITK_TEST_SUITE_REGISTRATION(mitkCreateDistanceImageFromSurfaceFilter)
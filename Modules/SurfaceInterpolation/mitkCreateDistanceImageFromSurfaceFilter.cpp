@@ -16,6 +16,7 @@ See LICENSE.txt or http://www.mitk.org for details.
 
 #include "mitkCreateDistanceImageFromSurfaceFilter.h"
 #include "mitkImageCast.h"
+#include "mitkParallelFor.h"
 
 #include "vtkCellArray.h"
 #include "vtkCellData.h"
@@ -23,10 +24,34 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "vtkPolyData.h"
 #include "vtkSmartPointer.h"
 
-#include "itkImageRegionIteratorWithIndex.h"
-#include "itkNeighborhoodIterator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-#include <queue>
+namespace
+{
+  // Above this number of centers the dense system becomes too expensive to solve
+  const unsigned int MaximumNumberOfDenseCenters = 4500;
+
+  // Number of contour points used for the coarse dense approximation of the compactly supported solver
+  const unsigned int MaximumNumberOfCoarseContourPoints = 333;
+
+  // Grid cells are addressed by 21 bits per dimension
+  const long MaximumCenterGridCoordinate = (1l << 21) - 1;
+
+  /**
+  * \brief Wendland's compactly supported function Phi(r) = (1 - r)^4 (4r + 1), r is normalized to the support radius.
+  */
+  double EvaluateWendlandFunction(double r)
+  {
+    if (r >= 1.0)
+      return 0.0;
+
+    const double oneMinusR = 1.0 - r;
+    const double squaredOneMinusR = oneMinusR * oneMinusR;
+    return squaredOneMinusR * squaredOneMinusR * (4.0 * r + 1.0);
+  }
+}
 
 void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 {
@@ -109,7 +134,12 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateEmptyDistanceImage()
 }
 
 mitk::CreateDistanceImageFromSurfaceFilter::CreateDistanceImageFromSurfaceFilter()
-  : m_DistanceImageSpacing(0.0), m_DistanceImageDefaultBufferValue(0.0)
+  : m_DistanceImageSpacing(0.0),
+    m_DistanceImageDefaultBufferValue(0.0),
+    m_SolverMode(AutomaticSolver),
+    m_UseCompactSupport(false),
+    m_SupportRadius(0.0),
+    m_CurrentSupportRadius(0.0)
 {
   m_DistanceImageVolume = 50000;
   this->m_UseProgressBar = false;
@@ -134,7 +164,7 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(1);
 
-  m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+  this->SolveEquationSystem();
 
   if (this->m_UseProgressBar)
     mitk::ProgressBar::GetInstance()->Progress(2);
@@ -147,6 +177,9 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateData()
 
   m_Centers.clear();
   m_Normals.clear();
+  m_ContourCentroids.clear();
+  m_CoarseCenters.clear();
+  m_CenterGrid.clear();
 }
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
@@ -174,6 +207,8 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
   for (unsigned int i = 0; i < numberOfInputs; i++)
   {
+    const std::size_t numberOfPreviousCenters = m_Centers.size();
+
     auto currentSurface = this->GetInput(i);
     polyData = currentSurface->GetVtkPolyData();
 
@@ -219,6 +254,17 @@ void mitk::CreateDistanceImageFromSurfaceFilter::PreprocessContourPoints()
 
       } // end for all points
     }   // end for all cells
+
+    // remember the centroid of each contour to derive the support radius of compactly supported functions
+    if (m_Centers.size() > numberOfPreviousCenters)
+    {
+      PointType centroid(0.0);
+      for (auto centerIter = m_Centers.begin() + numberOfPreviousCenters; centerIter != m_Centers.end(); ++centerIter)
+        centroid += *centerIter;
+
+      centroid /= static_cast<double>(m_Centers.size() - numberOfPreviousCenters);
+      m_ContourCentroids.push_back(centroid);
+    }
   }     // end for all outputs
 }
 
@@ -268,10 +314,21 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   // Now we have created all centers and all function values. Next step is to create the solution matrix
   numberOfCenters = m_Centers.size();
 
-  m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
-
   m_Weights.resize(numberOfCenters);
 
+  m_UseCompactSupport = CompactSupportSolver == m_SolverMode ||
+                        (AutomaticSolver == m_SolverMode && numberOfCenters > MaximumNumberOfDenseCenters);
+
+  if (m_UseCompactSupport)
+  {
+    m_SolutionMatrix.resize(0, 0);
+    this->CreateSparseSolutionMatrix();
+    return;
+  }
+
+  m_SparseSolutionMatrix.resize(0, 0);
+  m_SolutionMatrix.resize(numberOfCenters, numberOfCenters);
+
   PointType p1;
   PointType p2;
   double norm;
@@ -290,23 +347,208 @@ void mitk::CreateDistanceImageFromSurfaceFilter::CreateSolutionMatrixAndFunction
   }
 }
 
+std::uint64_t mitk::CreateDistanceImageFromSurfaceFilter::GetCenterGridKey(long x, long y, long z) const
+{
+  return (static_cast<std::uint64_t>(x) << 42) | (static_cast<std::uint64_t>(y) << 21) |
+         static_cast<std::uint64_t>(z);
+}
+
+template <typename TCallback>
+void mitk::CreateDistanceImageFromSurfaceFilter::ForEachCenterInSupport(const PointType &p, TCallback callback) const
+{
+  // the cells have the support radius as edge length, so all centers in support are in the neighboring cells
+  const PointType offset = (p - m_CenterGridOrigin) / m_CurrentSupportRadius;
+  const long cell[] = {static_cast<long>(std::floor(offset[0])),
+                       static_cast<long>(std::floor(offset[1])),
+                       static_cast<long>(std::floor(offset[2]))};
+
+  for (long z = std::max(0l, cell[2] - 1); z <= std::min(MaximumCenterGridCoordinate, cell[2] + 1); ++z)
+  {
+    for (long y = std::max(0l, cell[1] - 1); y <= std::min(MaximumCenterGridCoordinate, cell[1] + 1); ++y)
+    {
+      for (long x = std::max(0l, cell[0] - 1); x <= std::min(MaximumCenterGridCoordinate, cell[0] + 1); ++x)
+      {
+        auto gridCell = m_CenterGrid.find(this->GetCenterGridKey(x, y, z));
+        if (gridCell == m_CenterGrid.end())
+          continue;
+
+        for (unsigned int centerIndex : gridCell->second)
+        {
+          const double distance = (p - m_Centers[centerIndex]).two_norm();
+          if (distance < m_CurrentSupportRadius)
+            callback(centerIndex, distance);
+        }
+      }
+    }
+  }
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateSparseSolutionMatrix()
+{
+  this->CreateCenterGrid();
+
+  typedef Eigen::Triplet<double> TripletType;
+
+  const unsigned int numberOfCenters = m_Centers.size();
+
+  // each chunk collects the lower triangle of its rows, the matrix is symmetric
+  std::vector<std::vector<TripletType>> triplets(GetNumberOfParallelChunks(numberOfCenters));
+
+  ParallelForChunks(numberOfCenters, [this, &triplets](std::size_t begin, std::size_t end, std::size_t chunk) {
+    for (auto i = static_cast<unsigned int>(begin); i < end; ++i)
+    {
+      this->ForEachCenterInSupport(m_Centers[i], [&](unsigned int j, double distance) {
+        if (j <= i)
+          triplets[chunk].emplace_back(i, j, EvaluateWendlandFunction(distance / m_CurrentSupportRadius));
+      });
+    }
+  });
+
+  std::vector<TripletType> allTriplets;
+  std::size_t numberOfTriplets = 0;
+  for (const auto &chunkTriplets : triplets)
+    numberOfTriplets += chunkTriplets.size();
+
+  allTriplets.reserve(numberOfTriplets);
+  for (auto &chunkTriplets : triplets)
+  {
+    allTriplets.insert(allTriplets.end(), chunkTriplets.begin(), chunkTriplets.end());
+    std::vector<TripletType>().swap(chunkTriplets);
+  }
+
+  m_SparseSolutionMatrix.resize(numberOfCenters, numberOfCenters);
+  m_SparseSolutionMatrix.setFromTriplets(allTriplets.begin(), allTriplets.end());
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::SolveEquationSystem()
+{
+  if (!m_UseCompactSupport)
+  {
+    m_Weights = m_SolutionMatrix.partialPivLu().solve(m_FunctionValues);
+    return;
+  }
+
+  // The compactly supported functions vanish far from the centers and cannot describe the inside and outside
+  // of the surface on their own. They therefore interpolate the residual of a coarse dense approximation
+  // computed from a subset of the contour points.
+  const unsigned int numberOfContourPoints = m_Centers.size() / 3;
+  const unsigned int step =
+    (numberOfContourPoints + MaximumNumberOfCoarseContourPoints - 1) / MaximumNumberOfCoarseContourPoints;
+
+  std::vector<unsigned int> coarseCenterIndices;
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    for (unsigned int j = 0; j < numberOfContourPoints; j += step)
+      coarseCenterIndices.push_back(i * numberOfContourPoints + j);
+  }
+
+  const unsigned int numberOfCoarseCenters = coarseCenterIndices.size();
+  Eigen::MatrixXd coarseSolutionMatrix(numberOfCoarseCenters, numberOfCoarseCenters);
+  Eigen::VectorXd coarseFunctionValues(numberOfCoarseCenters);
+
+  m_CoarseCenters.clear();
+  for (unsigned int i = 0; i < numberOfCoarseCenters; ++i)
+  {
+    m_CoarseCenters.push_back(m_Centers[coarseCenterIndices[i]]);
+    coarseFunctionValues[i] = m_FunctionValues[coarseCenterIndices[i]];
+  }
+
+  for (unsigned int i = 0; i < numberOfCoarseCenters; ++i)
+  {
+    for (unsigned int j = 0; j < numberOfCoarseCenters; ++j)
+      coarseSolutionMatrix(i, j) = (m_CoarseCenters[i] - m_CoarseCenters[j]).two_norm();
+  }
+
+  m_CoarseWeights = coarseSolutionMatrix.partialPivLu().solve(coarseFunctionValues);
+
+  Eigen::VectorXd residualFunctionValues(m_Centers.size());
+  for (unsigned int i = 0; i < m_Centers.size(); ++i)
+    residualFunctionValues[i] = m_FunctionValues[i] - this->CalculateCoarseDistanceValue(m_Centers[i]);
+
+  // The matrix is positive definite for Wendland's function, only its lower triangle is stored
+  Eigen::ConjugateGradient<Eigen::SparseMatrix<double>, Eigen::Lower> solver;
+  solver.setTolerance(1e-5);
+  solver.compute(m_SparseSolutionMatrix);
+
+  if (Eigen::Success == solver.info())
+  {
+    m_Weights = solver.solve(residualFunctionValues);
+
+    if (Eigen::Success == solver.info())
+      return;
+  }
+
+  MITK_WARN << "mitk::CreateDistanceImageFromSurfaceFilter: Iterative solver did not converge, using sparse "
+               "factorization.";
+
+  Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>, Eigen::Lower> factorization(m_SparseSolutionMatrix);
+  m_Weights = factorization.solve(residualFunctionValues);
+}
+
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateCoarseDistanceValue(const PointType &p) const
+{
+  double distanceValue(0);
+  for (unsigned int i = 0; i < m_CoarseCenters.size(); ++i)
+    distanceValue += (p - m_CoarseCenters[i]).two_norm() * m_CoarseWeights[i];
+
+  return distanceValue;
+}
+
+void mitk::CreateDistanceImageFromSurfaceFilter::CreateCenterGrid()
+{
+  m_CurrentSupportRadius = m_SupportRadius;
+
+  if (m_CurrentSupportRadius <= 0.0)
+  {
+    // the support has to bridge the largest gap between a contour and its nearest neighboring contour
+    double largestGap = 0.0;
+    for (std::size_t i = 0; i < m_ContourCentroids.size(); ++i)
+    {
+      double nearestDistance = std::numeric_limits<double>::max();
+      for (std::size_t j = 0; j < m_ContourCentroids.size(); ++j)
+      {
+        if (i != j)
+          nearestDistance = std::min(nearestDistance, (m_ContourCentroids[i] - m_ContourCentroids[j]).two_norm());
+      }
+
+      if (nearestDistance < std::numeric_limits<double>::max())
+        largestGap = std::max(largestGap, nearestDistance);
+    }
+
+    m_CurrentSupportRadius = std::max(1.5 * largestGap, 4.0 * m_DistanceImageSpacing);
+  }
+
+  m_CenterGridOrigin = m_Centers.at(0);
+  for (const auto &center : m_Centers)
+  {
+    for (unsigned int dim = 0; dim < 3; ++dim)
+      m_CenterGridOrigin[dim] = std::min(m_CenterGridOrigin[dim], center[dim]);
+  }
+
+  m_CenterGrid.clear();
+  for (unsigned int i = 0; i < m_Centers.size(); ++i)
+  {
+    const PointType offset = (m_Centers[i] - m_CenterGridOrigin) / m_CurrentSupportRadius;
+    m_CenterGrid[this->GetCenterGridKey(offset[0], offset[1], offset[2])].push_back(i);
+  }
+}
+
 void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
 {
   /*
   * Now we must calculate the distance for each pixel. But instead of calculating the distance value
   * for all of the image's pixels we proceed similar to the region growing algorithm:
   *
-  * 1. Take the first pixel from the narrowband_point_list and calculate the distance for each neighbor (6er)
-  * 2. If the current index's distance value is below a certain threshold push it into the list
-  * 3. Next iteration take the next index from the list and originAsIndex with 1. again
+  * 1. Take all pixels of the current front and collect their neighbors (6er) which have not been checked yet
+  * 2. Calculate the distance of all collected neighbors in parallel
+  * 3. Neighbors whose distance value is below a certain threshold form the next front
   *
-  * This is done until the narrowband_point_list is empty.
+  * This is done until the front is empty.
   */
 
-  typedef itk::ImageRegionIteratorWithIndex<DistanceImageType> ImageIterator;
-  typedef itk::NeighborhoodIterator<DistanceImageType> NeighborhoodImageIterator;
+  const DistanceImageType::RegionType region = m_DistanceImageITK->GetLargestPossibleRegion();
+  const DistanceImageType::SizeType size = region.GetSize();
 
-  std::queue<DistanceImageType::IndexType> narrowbandPoints;
   PointType currentPoint = m_Centers.at(0);
   double distance = this->CalculateDistanceValue(currentPoint);
 
@@ -320,101 +562,94 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   DistanceImageType::IndexType currentIndex;
   m_DistanceImageITK->TransformPhysicalPointToIndex(currentPointAsPoint, currentIndex);
 
-  assert(
-    m_DistanceImageITK->GetLargestPossibleRegion().IsInside(currentIndex)); // we are quite certain this should hold
+  assert(region.IsInside(currentIndex)); // we are quite certain this should hold
 
-  narrowbandPoints.push(currentIndex);
   m_DistanceImageITK->SetPixel(currentIndex, distance);
 
-  NeighborhoodImageIterator::RadiusType radius;
-  radius.Fill(1);
-  NeighborhoodImageIterator nIt(radius, m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
-  unsigned int relativeNbIdx[] = {4, 10, 12, 14, 16, 22};
+  // every pixel is evaluated at most once
+  std::vector<bool> isChecked(region.GetNumberOfPixels(), false);
+  isChecked[m_DistanceImageITK->ComputeOffset(currentIndex)] = true;
+
+  std::vector<IndexType> front(1, currentIndex);
+  std::vector<IndexType> neighbors;
+  std::vector<double> distances;
 
-  bool isInBounds = false;
-  while (!narrowbandPoints.empty())
+  while (!front.empty())
   {
-    nIt.SetLocation(narrowbandPoints.front());
-    narrowbandPoints.pop();
+    neighbors.clear();
 
-    unsigned int *relativeNb = &relativeNbIdx[0];
-    for (int i = 0; i < 6; i++)
+    for (const auto &index : front)
     {
-      nIt.GetPixel(*relativeNb, isInBounds);
-      if (isInBounds && nIt.GetPixel(*relativeNb) == m_DistanceImageDefaultBufferValue)
+      for (unsigned int dim = 0; dim < 3; ++dim)
       {
-        currentIndex = nIt.GetIndex(*relativeNb);
+        for (int direction = -1; direction <= 1; direction += 2)
+        {
+          IndexType neighbor = index;
+          neighbor[dim] += direction;
 
-        // Transform the currently checked point from index-coordinates to
-        // world-coordinates
-        m_DistanceImageITK->TransformIndexToPhysicalPoint(currentIndex, currentPointAsPoint);
+          if (!region.IsInside(neighbor))
+            continue;
 
-        // create a vnl_vector
-        currentPoint[0] = currentPointAsPoint[0];
-        currentPoint[1] = currentPointAsPoint[1];
-        currentPoint[2] = currentPointAsPoint[2];
+          const auto offset = m_DistanceImageITK->ComputeOffset(neighbor);
+          if (isChecked[offset])
+            continue;
 
-        // and check the distance
-        distance = this->CalculateDistanceValue(currentPoint);
-        if (std::fabs(distance) <= m_DistanceImageSpacing * 2)
-        {
-          nIt.SetPixel(*relativeNb, distance);
-          narrowbandPoints.push(currentIndex);
+          isChecked[offset] = true;
+          neighbors.push_back(neighbor);
         }
       }
-      relativeNb++;
     }
-  }
-
-  ImageIterator imgRegionIterator(m_DistanceImageITK, m_DistanceImageITK->GetLargestPossibleRegion());
-  imgRegionIterator.GoToBegin();
 
-  double prevPixelVal = 1;
+    this->CalculateDistanceValues(neighbors, distances);
 
-  DistanceImageType::IndexType _size;
-  _size.Fill(-1);
-  _size += m_DistanceImageITK->GetLargestPossibleRegion().GetSize();
+    front.clear();
+    for (std::size_t i = 0; i < neighbors.size(); ++i)
+    {
+      if (std::fabs(distances[i]) <= m_DistanceImageSpacing * 2)
+      {
+        m_DistanceImageITK->SetPixel(neighbors[i], distances[i]);
+        front.push_back(neighbors[i]);
+      }
+    }
+  }
 
   // Set every pixel inside the surface to -m_DistanceImageDefaultBufferValue except the edge point (so that the
-  // received surface is closed)
-  while (!imgRegionIterator.IsAtEnd())
-  {
-    if (imgRegionIterator.Get() == m_DistanceImageDefaultBufferValue && prevPixelVal < 0)
+  // received surface is closed). The image rows are independent as each of them starts and ends at the edge,
+  // so blocks of slices are processed in parallel.
+  double *buffer = m_DistanceImageITK->GetBufferPointer();
+  const double defaultValue = m_DistanceImageDefaultBufferValue;
+
+  ParallelForChunks(size[2], [buffer, defaultValue, size](std::size_t zBegin, std::size_t zEnd, std::size_t) {
+    for (std::size_t z = zBegin; z < zEnd; ++z)
     {
-      while (imgRegionIterator.Get() == m_DistanceImageDefaultBufferValue)
+      for (unsigned int y = 0; y < size[1]; ++y)
       {
-        if (imgRegionIterator.GetIndex()[0] == _size[0] || imgRegionIterator.GetIndex()[1] == _size[1] ||
-            imgRegionIterator.GetIndex()[2] == _size[2] || imgRegionIterator.GetIndex()[0] == 0U ||
-            imgRegionIterator.GetIndex()[1] == 0U || imgRegionIterator.GetIndex()[2] == 0U)
-        {
-          imgRegionIterator.Set(m_DistanceImageDefaultBufferValue);
-          prevPixelVal = m_DistanceImageDefaultBufferValue;
-          ++imgRegionIterator;
-          break;
-        }
-        else
+        double *row = buffer + (z * size[1] + y) * size[0];
+        const bool isEdgeRow = 0 == y || 0 == z || size[1] - 1 == y || size[2] - 1 == z;
+
+        double prevPixelVal = 1;
+        for (unsigned int x = 0; x < size[0]; ++x)
         {
-          imgRegionIterator.Set((-1) * m_DistanceImageDefaultBufferValue);
-          ++imgRegionIterator;
-          prevPixelVal = (-1) * m_DistanceImageDefaultBufferValue;
+          const bool isEdge = isEdgeRow || 0 == x || size[0] - 1 == x;
+
+          if (row[x] == defaultValue && prevPixelVal < 0)
+          {
+            row[x] = isEdge ? defaultValue : -defaultValue;
+            prevPixelVal = row[x];
+          }
+          else if (isEdge)
+          {
+            row[x] = defaultValue;
+            prevPixelVal = defaultValue;
+          }
+          else
+          {
+            prevPixelVal = row[x];
+          }
         }
       }
     }
-    else if (imgRegionIterator.GetIndex()[0] == _size[0] || imgRegionIterator.GetIndex()[1] == _size[1] ||
-             imgRegionIterator.GetIndex()[2] == _size[2] || imgRegionIterator.GetIndex()[0] == 0U ||
-             imgRegionIterator.GetIndex()[1] == 0U || imgRegionIterator.GetIndex()[2] == 0U)
-
-    {
-      imgRegionIterator.Set(m_DistanceImageDefaultBufferValue);
-      prevPixelVal = m_DistanceImageDefaultBufferValue;
-      ++imgRegionIterator;
-    }
-    else
-    {
-      prevPixelVal = imgRegionIterator.Get();
-      ++imgRegionIterator;
-    }
-  }
+  });
 
   Image::Pointer resultImage = this->GetOutput();
 
@@ -423,23 +658,56 @@ void mitk::CreateDistanceImageFromSurfaceFilter::FillDistanceImage()
   CastToMitkImage(m_DistanceImageITK, resultImage);
 }
 
-double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(PointType p)
+void mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValues(const std::vector<IndexType> &indices,
+                                                                         std::vector<double> &distances) const
 {
-  double distanceValue(0);
-  PointType p1;
-  PointType p2;
-  double norm;
+  distances.resize(indices.size());
+
+  // thread creation does not pay off for small fronts
+  const std::size_t minimumChunkSize = 64;
+
+  auto calculate = [this, &indices, &distances](std::size_t begin, std::size_t end, std::size_t) {
+    DistanceImageType::PointType point;
+    PointType p;
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      // Transform the currently checked point from index-coordinates to world-coordinates
+      m_DistanceImageITK->TransformIndexToPhysicalPoint(indices[i], point);
+      p[0] = point[0];
+      p[1] = point[1];
+      p[2] = point[2];
+
+      distances[i] = this->CalculateDistanceValue(p);
+    }
+  };
+
+  ParallelForChunks(indices.size(), calculate, minimumChunkSize);
+}
 
-  CenterList::iterator centerIter;
+double mitk::CreateDistanceImageFromSurfaceFilter::CalculateDistanceValue(const PointType &p) const
+{
+  if (m_UseCompactSupport)
+  {
+    double distanceValue = this->CalculateCoarseDistanceValue(p);
 
-  unsigned int count(0);
-  for (centerIter = m_Centers.begin(); centerIter != m_Centers.end(); centerIter++)
+    this->ForEachCenterInSupport(p, [&](unsigned int centerIndex, double distance) {
+      distanceValue += m_Weights[centerIndex] * EvaluateWendlandFunction(distance / m_CurrentSupportRadius);
+    });
+
+    return distanceValue;
+  }
+
+  double distanceValue(0);
+
+  const unsigned int numberOfCenters = m_Centers.size();
+  for (unsigned int i = 0; i < numberOfCenters; ++i)
   {
-    p1 = *centerIter;
-    p2 = p - p1;
-    norm = p2.two_norm();
-    distanceValue = distanceValue + (norm * m_Weights[count]);
-    ++count;
+    const PointType &center = m_Centers[i];
+    const double dx = p[0] - center[0];
+    const double dy = p[1] - center[1];
+    const double dz = p[2] - center[2];
+    distanceValue += std::sqrt(dx * dx + dy * dy + dz * dz) * m_Weights[i];
   }
   return distanceValue;
 }
@@ -450,15 +718,18 @@ void mitk::CreateDistanceImageFromSurfaceFilter::GenerateOutputInformation()
 
 void mitk::CreateDistanceImageFromSurfaceFilter::PrintEquationSystem()
 {
+  const Eigen::MatrixXd solutionMatrix =
+    m_UseCompactSupport ? Eigen::MatrixXd(m_SparseSolutionMatrix) : m_SolutionMatrix;
+
   std::stringstream out;
-  out << "Nummber of rows: " << m_SolutionMatrix.rows() << " ****** Number of columns: " << m_SolutionMatrix.cols()
+  out << "Nummber of rows: " << solutionMatrix.rows() << " ****** Number of columns: " << solutionMatrix.cols()
       << endl;
   out << "[ ";
-  for (int i = 0; i < m_SolutionMatrix.rows(); i++)
+  for (int i = 0; i < solutionMatrix.rows(); i++)
   {
-    for (int j = 0; j < m_SolutionMatrix.cols(); j++)
+    for (int j = 0; j < solutionMatrix.cols(); j++)
     {
-      out << m_SolutionMatrix(i, j) << "   ";
+      out << solutionMatrix(i, j) << "   ";
     }
     out << ";" << endl;
   }
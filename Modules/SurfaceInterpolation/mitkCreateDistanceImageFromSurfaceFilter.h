@@ -28,6 +28,10 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include "itkImageBase.h"
 
 #include <Eigen/Dense>
+#include <Eigen/Sparse>
+
+#include <cstdint>
+#include <unordered_map>
 
 namespace mitk
 {
@@ -37,6 +41,12 @@ namespace mitk
 
          The interpolation itself is performed via Radial Basis Function Interpolation.
 
+         By default, small equation systems are solved densely with Phi(r) = r. Larger systems use the
+         compactly supported Wendland function Phi(r) = (1 - r/s)^4 (4r/s + 1) with support radius s, which
+         results in a sparse system that is solved iteratively (see SetSolverMode()). The compactly supported
+         functions interpolate the residual of a coarse dense approximation based on a subset of the contour points,
+         which provides the inside and outside far from the contours.
+
          ATTENTION:
          This filter needs beside the edge points of the delineated contours additionally the normals for each
          edge point.
@@ -78,6 +88,17 @@ namespace mitk
 
     typedef std::vector<Surface::Pointer> SurfaceList;
 
+    /** \brief Method used to set up and solve the interpolation equation system. */
+    enum SolverMode
+    {
+      /** Dense system with Phi(r) = r, needs O(N^2) memory and O(N^3) time. */
+      DenseSolver,
+      /** Sparse system with a compactly supported radial basis function on top of a coarse dense approximation. */
+      CompactSupportSolver,
+      /** Dense solver for small systems, compactly supported solver otherwise. */
+      AutomaticSolver
+    };
+
     mitkClassMacro(CreateDistanceImageFromSurfaceFilter, ImageSource);
     itkFactorylessNewMacro(Self) itkCloneMacro(Self)
 
@@ -124,6 +145,21 @@ namespace mitk
 
     void SetReferenceImage(itk::ImageBase<3>::Pointer referenceImage);
 
+    /**
+      \brief Set the method used to solve the interpolation equation system, default is AutomaticSolver
+    */
+    itkSetEnumMacro(SolverMode, SolverMode);
+    itkGetEnumMacro(SolverMode, SolverMode);
+
+    /**
+      \brief Set the support radius in mm of the compactly supported radial basis function.
+
+      If set to 0 (default), the radius is derived from the distances between the input contours so that
+      the support bridges the gaps between neighboring contours.
+    */
+    itkSetMacro(SupportRadius, double);
+    itkGetMacro(SupportRadius, double);
+
   protected:
     CreateDistanceImageFromSurfaceFilter();
     ~CreateDistanceImageFromSurfaceFilter() override;
@@ -132,7 +168,32 @@ namespace mitk
 
   private:
     void CreateSolutionMatrixAndFunctionValues();
-    double CalculateDistanceValue(PointType p);
+    void CreateSparseSolutionMatrix();
+    void SolveEquationSystem();
+    double CalculateDistanceValue(const PointType &p) const;
+
+    /**
+    * \brief Calculates the distance values of the given pixels in parallel.
+    */
+    void CalculateDistanceValues(const std::vector<IndexType> &indices, std::vector<double> &distances) const;
+    double CalculateCoarseDistanceValue(const PointType &p) const;
+
+    /**
+    * \brief Determines the support radius of the compactly supported radial basis function
+    * and sorts all centers into a grid with the support radius as cell size.
+    */
+    void CreateCenterGrid();
+
+    /**
+    * \brief Returns the key of the grid cell with the given cell coordinates.
+    */
+    std::uint64_t GetCenterGridKey(long x, long y, long z) const;
+
+    /**
+    * \brief Calls callback(centerIndex, distance) for each center closer to p than the support radius.
+    */
+    template <typename TCallback>
+    void ForEachCenterInSupport(const PointType &p, TCallback callback) const;
 
     void FillDistanceImage();
 
@@ -161,11 +222,16 @@ namespace mitk
     // Datastructures for the interpolation
     CenterList m_Centers;
     NormalList m_Normals;
+    CenterList m_ContourCentroids;
 
     Eigen::MatrixXd m_SolutionMatrix;
+    Eigen::SparseMatrix<double> m_SparseSolutionMatrix;
     Eigen::VectorXd m_FunctionValues;
     Eigen::VectorXd m_Weights;
 
+    CenterList m_CoarseCenters;
+    Eigen::VectorXd m_CoarseWeights;
+
     DistanceImageType::Pointer m_DistanceImageITK;
     itk::ImageBase<3>::Pointer m_ReferenceImage;
 
@@ -175,6 +241,15 @@ namespace mitk
 
     bool m_UseProgressBar;
     unsigned int m_ProgressStepSize;
+
+    SolverMode m_SolverMode;
+    bool m_UseCompactSupport;
+    double m_SupportRadius;
+    double m_CurrentSupportRadius;
+
+    // centers of the compactly supported solver sorted into cubic cells with the support radius as edge length
+    std::unordered_map<std::uint64_t, std::vector<unsigned int>> m_CenterGrid;
+    PointType m_CenterGridOrigin;
   };
 
 } // namespace
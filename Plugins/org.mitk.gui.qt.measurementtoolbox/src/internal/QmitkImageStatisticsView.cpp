@@ -35,7 +35,9 @@ See LICENSE.txt or http://www.mitk.org for details.
 #include <mitkStatisticsToMaskRelationRule.h>
 #include <mitkStatusBar.h>
 
+#include "mitkImageStatisticsCache.h"
 #include "mitkImageStatisticsContainerManager.h"
+#include <mitkImageRegionModifiedEvent.h>
 #include <mitkPlanarFigureInteractor.h>
 
 const std::string QmitkImageStatisticsView::VIEW_ID = "org.mitk.views.imagestatistics";
@@ -51,6 +53,7 @@ QmitkImageStatisticsView::~QmitkImageStatisticsView()
   {
     m_selectedPlanarFigure->RemoveObserver(m_PlanarFigureObserverTag);
   }
+  this->ObserveMask(nullptr);
 
   if (!m_CalculationJob->isFinished())
   {
@@ -164,6 +167,20 @@ void QmitkImageStatisticsView::OnSliderWidgetIntensityProfileChanged()
 
 void QmitkImageStatisticsView::PartClosed(const berry::IWorkbenchPartReference::Pointer &) {}
 
+void QmitkImageStatisticsView::NodeRemoved(const mitk::DataNode *node)
+{
+  // results of removed data can never be hit again
+  if (nullptr != node && nullptr != node->GetData())
+  {
+    mitk::ImageStatisticsCache::GetInstance()->Remove(node->GetData());
+
+    if (node->GetData() == m_ObservedMask)
+    {
+      this->ObserveMask(nullptr);
+    }
+  }
+}
+
 void QmitkImageStatisticsView::FillHistogramWidget(const std::vector<const HistogramType *> &histogram,
                                                    const std::vector<std::string> &dataLabels)
 {
@@ -294,6 +311,9 @@ void QmitkImageStatisticsView::CalculateOrGetStatistics()
       }
     }
 
+    // the statistics of 3D masks are kept up to date while they are edited
+    this->ObserveMask(3 == image->GetDimension() && nullptr != mask && 3 == mask->GetDimension() ? mask : nullptr);
+
     mitk::ImageStatisticsContainer::ConstPointer imageStatistics;
     if (mask)
     {
@@ -358,6 +378,7 @@ void QmitkImageStatisticsView::CalculateOrGetStatistics()
   }
   else
   {
+    this->ObserveMask(nullptr);
     ResetGUI();
   }
   m_ForceRecompute = false;
@@ -539,6 +560,93 @@ void QmitkImageStatisticsView::OnStatisticsCalculationEnds()
     m_Controls.widget_histogram->setEnabled(false);
   }
   m_Controls.label_currentlyComputingStatistics->setVisible(false);
+
+  // the mask was edited during the calculation
+  if (m_RestartCalculation)
+  {
+    m_RestartCalculation = false;
+    this->UpdateStatisticsOfEditedMask();
+  }
+}
+
+void QmitkImageStatisticsView::ObserveMask(mitk::Image *mask)
+{
+  if (mask == m_ObservedMask)
+  {
+    return;
+  }
+
+  if (m_ObservedMask.IsNotNull())
+  {
+    m_ObservedMask->RemoveObserver(m_MaskRegionObserverTag);
+    m_ObservedMask->RemoveObserver(m_MaskModifiedObserverTag);
+  }
+
+  m_ObservedMask = mask;
+  m_MaskRegionModified = false;
+  m_RestartCalculation = false;
+
+  if (m_ObservedMask.IsNotNull())
+  {
+    ITKEventCommandType::Pointer regionListener = ITKEventCommandType::New();
+    regionListener->SetCallbackFunction(this, &QmitkImageStatisticsView::OnMaskRegionModified);
+    m_MaskRegionObserverTag = m_ObservedMask->AddObserver(mitk::ImageRegionModifiedEvent(), regionListener);
+
+    ITKCommandType::Pointer modifiedListener = ITKCommandType::New();
+    modifiedListener->SetCallbackFunction(this, &QmitkImageStatisticsView::OnMaskModified);
+    m_MaskModifiedObserverTag = m_ObservedMask->AddObserver(itk::ModifiedEvent(), modifiedListener);
+  }
+}
+
+void QmitkImageStatisticsView::OnMaskRegionModified(const itk::Object * /*caller*/, const itk::EventObject &event)
+{
+  auto regionEvent = dynamic_cast<const mitk::ImageRegionModifiedEvent *>(&event);
+  if (nullptr == regionEvent)
+  {
+    return;
+  }
+
+  // the image is marked modified right after the region was changed
+  m_MaskRegionModified = true;
+  m_CalculationJob->AddChangedMaskRegion(regionEvent->GetRegion());
+}
+
+void QmitkImageStatisticsView::OnMaskModified()
+{
+  if (!m_MaskRegionModified)
+  {
+    // any voxel of the mask may have changed, the statistics have to be computed from scratch
+    m_CalculationJob->InvalidateChangedMaskRegions();
+    return;
+  }
+
+  m_MaskRegionModified = false;
+  this->UpdateStatisticsOfEditedMask();
+}
+
+void QmitkImageStatisticsView::UpdateStatisticsOfEditedMask()
+{
+  if (m_ObservedMask.IsNull() || m_selectedImageNode.IsNull() || m_CalculationJob->GetIgnoreZeroValueVoxel())
+  {
+    return;
+  }
+
+  // the changed regions are collected until the running calculation ends
+  if (m_CalculationJob->isRunning())
+  {
+    m_RestartCalculation = true;
+    return;
+  }
+
+  auto image = dynamic_cast<const mitk::Image *>(m_selectedImageNode->GetData());
+  if (m_CalculationJob->GetStatisticsImage() != image || m_CalculationJob->GetMaskImage() != m_ObservedMask)
+  {
+    // statistics taken from the data storage were not computed by the job
+    m_CalculationJob->Initialize(image, m_ObservedMask, nullptr);
+  }
+
+  m_CalculationJob->start();
+  m_Controls.label_currentlyComputingStatistics->setVisible(true);
 }
 
 void QmitkImageStatisticsView::OnRequestHistogramUpdate(unsigned int nBins)
@@ -65,6 +65,9 @@ protected:
   virtual void Hidden() override;
   virtual void SetFocus() override;
 
+  /** \brief Removes the cached statistics of the data of removed nodes */
+  virtual void NodeRemoved(const mitk::DataNode *node) override;
+
   /** \brief Is called right before the view closes (before the destructor) */
   virtual void PartClosed(const berry::IWorkbenchPartReference::Pointer&) override;
  
@@ -93,6 +96,9 @@ protected:
   virtual void CreateConnections();
 
   void OnStatisticsCalculationEnds();
+  void OnMaskRegionModified(const itk::Object *caller, const itk::EventObject &event);
+  void OnMaskModified();
+  void UpdateStatisticsOfEditedMask();
   void OnRequestHistogramUpdate(unsigned int nBins);
   void OnCheckBoxIgnoreZeroStateChanged(int state);
   void OnSliderWidgetHistogramChanged(double value);
@@ -111,14 +117,24 @@ private:
 
   void SetupRelationRules(mitk::ImageStatisticsContainer::Pointer, mitk::BaseData::ConstPointer mask);
 
+  void ObserveMask(mitk::Image *mask);
+
   mitk::DataNode::Pointer GetNodeForStatisticsContainer(mitk::ImageStatisticsContainer::ConstPointer container);
 
   typedef itk::SimpleMemberCommand< QmitkImageStatisticsView > ITKCommandType;
+  typedef itk::MemberCommand< QmitkImageStatisticsView > ITKEventCommandType;
   QmitkImageStatisticsCalculationJob * m_CalculationJob = nullptr;
   mitk::DataNode::ConstPointer m_selectedImageNode = nullptr, m_selectedMaskNode = nullptr;
 
   mitk::PlanarFigure::Pointer m_selectedPlanarFigure=nullptr;
   long m_PlanarFigureObserverTag;
   bool m_ForceRecompute = false;
+
+  // the statistics are updated while the selected mask is edited
+  mitk::Image::Pointer m_ObservedMask = nullptr;
+  long m_MaskRegionObserverTag;
+  long m_MaskModifiedObserverTag;
+  bool m_MaskRegionModified = false;
+  bool m_RestartCalculation = false;
 };
 #endif // QmitkImageStatisticsView_H__INCLUDED